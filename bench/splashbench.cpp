@@ -0,0 +1,886 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * splash-bench measures the wall-clock performance of libSplash
+ * for all combinations of the given collectors, operations, data sizes,
+ * datatypes and storage layouts.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "splash/splash.h"
+
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+#include <mpi.h>
+#endif
+
+#define RESULT_OK 0
+#define RESULT_ERROR 1
+
+using namespace splash;
+
+typedef struct
+{
+    std::string filename;
+    std::vector<std::string> collectors;
+    std::vector<std::string> operations;
+    std::vector<std::string> sizes;
+    std::vector<std::string> types;
+    std::vector<std::string> storages;
+    Dimensions topology;
+    bool merged;
+    bool showHelp;
+    uint32_t repetitions;
+    uint32_t warmup;
+    std::string format;
+    std::string output;
+    std::string baseline;
+    double tolerance;
+    int mpiRank;
+    int mpiSize;
+} Options;
+
+/**
+ * a single benchmark configuration
+ */
+typedef struct
+{
+    std::string collector;
+    std::string operation;
+    std::string sizeName;
+    std::string type;
+    std::string storage;
+    Dimensions size;
+    uint32_t ndims;
+} Config;
+
+typedef struct
+{
+    Config config;
+    std::string name;
+    uint64_t bytes;
+    uint64_t ops;
+    std::vector<double> times;
+} Result;
+
+/**
+ * benchmark datasets of all supported types
+ */
+typedef struct
+{
+    ColTypeInt8 ctInt8;
+    ColTypeInt32 ctInt32;
+    ColTypeInt64 ctInt64;
+    ColTypeFloat ctFloat;
+    ColTypeDouble ctDouble;
+} BenchTypes;
+
+static BenchTypes benchTypes;
+
+/* helper functions */
+
+void initOptions(Options& options)
+{
+    options.filename = "splash_bench";
+    options.collectors.push_back("serial");
+    options.operations.push_back("write");
+    options.sizes.push_back("128x128x128");
+    options.types.push_back("float");
+    options.storages.push_back("chunked");
+    options.merged = false;
+    options.showHelp = false;
+    options.repetitions = 10;
+    options.warmup = 1;
+    options.format = "text";
+    options.output = "";
+    options.baseline = "";
+    options.tolerance = 10.0;
+    options.mpiRank = 0;
+    options.mpiSize = 1;
+    options.topology.set(1, 1, 1);
+}
+
+double getWallTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec * 1.0e-9;
+}
+
+std::vector<std::string> splitList(const std::string &list, char separator)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, separator))
+    {
+        if (!item.empty())
+            items.push_back(item);
+    }
+
+    return items;
+}
+
+bool parseSize(const std::string &sizeName, Dimensions &size, uint32_t &ndims)
+{
+    std::vector<std::string> extents = splitList(sizeName, 'x');
+    if (extents.empty() || extents.size() > DSP_DIM_MAX)
+        return false;
+
+    hsize_t values[DSP_DIM_MAX];
+    for (size_t i = 0; i < extents.size(); ++i)
+    {
+        values[i] = strtoull(extents[i].c_str(), NULL, 10);
+        if (values[i] == 0)
+            return false;
+    }
+
+    ndims = extents.size();
+    size = Dimensions(ndims, values);
+    return true;
+}
+
+const CollectionType* getType(const std::string &name)
+{
+    if (name == "int8")
+        return &benchTypes.ctInt8;
+    if (name == "int32")
+        return &benchTypes.ctInt32;
+    if (name == "int64")
+        return &benchTypes.ctInt64;
+    if (name == "float")
+        return &benchTypes.ctFloat;
+    if (name == "double")
+        return &benchTypes.ctDouble;
+
+    return NULL;
+}
+
+template<typename T>
+void fillData(void *data, size_t elements, size_t offset)
+{
+    T *values = (T*) data;
+    for (size_t i = 0; i < elements; ++i)
+        values[i] = (T) ((offset + i) % 127);
+}
+
+void fillData(const std::string &type, void *data, size_t elements, size_t offset)
+{
+    if (type == "int8")
+        fillData<int8_t>(data, elements, offset);
+    else if (type == "int32")
+        fillData<int32_t>(data, elements, offset);
+    else if (type == "int64")
+        fillData<int64_t>(data, elements, offset);
+    else if (type == "float")
+        fillData<float>(data, elements, offset);
+    else
+        fillData<double>(data, elements, offset);
+}
+
+Dimensions indexToPosition(size_t index, const Dimensions topology)
+{
+    return Dimensions(index % topology[0], (index / topology[0]) % topology[1],
+            index / (topology[0] * topology[1]));
+}
+
+Domain getGlobalDomain(const Config &config, const Dimensions topology)
+{
+    // the topology only spans the first 3 dimensions
+    Dimensions extended_topology(topology);
+    extended_topology.setRank(config.ndims, 1);
+
+    return Domain(Dimensions(0, 0, 0), config.size * extended_topology);
+}
+
+double getPercentile(const std::vector<double> &sorted, double percentile)
+{
+    size_t index = (size_t) ceil(percentile / 100.0 * sorted.size());
+    if (index > 0)
+        index--;
+
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+double getMean(const std::vector<double> &times)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < times.size(); ++i)
+        sum += times[i];
+
+    return sum / times.size();
+}
+
+double getBandwidth(const Result &result)
+{
+    return (double) result.bytes / getMean(result.times) / (1024.0 * 1024.0);
+}
+
+int parseCmdLine(int argc, char **argv, Options& options)
+{
+    std::stringstream usage_stream;
+    usage_stream << "Usage " << argv[0] << " [options]";
+
+    std::stringstream full_desc_stream;
+    full_desc_stream << usage_stream.str() << std::endl <<
+            " --help,-h\t\t\t print this help message" << std::endl <<
+            " --file,-f\t<file>\t\t common part of the benchmark filenames" << std::endl <<
+            " --collector,-c\t<list>\t\t serial" <<
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+            ",parallel" <<
+#endif
+            " (default serial)" << std::endl <<
+            " --op,-o\t<list>\t\t write,append,read,grid,poly (default write)" << std::endl <<
+            " --size,-s\t<list>\t\t local sizes per process, e.g. 1048576,128x128x128" << std::endl <<
+            " --type,-t\t<list>\t\t int8,int32,int64,float,double (default float)" << std::endl <<
+            " --storage\t<list>\t\t chunked,deflate,contiguous (default chunked)" << std::endl <<
+            " --topology\t<x,y,z>\t\t process topology for serial files (default: number of processes)" << std::endl <<
+            " --merged,-m\t\t\t read domains across all files with FAT_READ_MERGED" << std::endl <<
+            " --repetitions,-r <n>\t\t measured repetitions (default 10)" << std::endl <<
+            " --warmup,-w\t<n>\t\t unmeasured repetitions (default 1)" << std::endl <<
+            " --format\t<format>\t text,csv,json (default text)" << std::endl <<
+            " --output\t<file>\t\t write results to file" << std::endl <<
+            " --baseline,-b\t<file>\t\t compare bandwidth with CSV results of a previous run" << std::endl <<
+            " --tolerance\t<percent>\t allowed bandwidth regression (default 10)";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *option = argv[i];
+        const char *next_option = NULL;
+        if (i < argc - 1)
+            next_option = argv[i + 1];
+
+        // help
+        if ((strcmp(option, "-h") == 0) || (strcmp(option, "--help") == 0))
+        {
+            if (options.mpiRank == 0)
+                std::cout << full_desc_stream.str() << std::endl;
+            options.showHelp = true;
+            return RESULT_OK;
+        }
+
+        // merged
+        if ((strcmp(option, "-m") == 0) || (strcmp(option, "--merged") == 0))
+        {
+            options.merged = true;
+            continue;
+        }
+
+        // all other options require an argument
+        if (next_option == NULL)
+        {
+            std::cerr << "Missing argument for " << option << std::endl;
+            std::cerr << usage_stream.str() << std::endl;
+            return RESULT_ERROR;
+        }
+
+        if ((strcmp(option, "-f") == 0) || (strcmp(option, "--file") == 0))
+            options.filename = next_option;
+        else if ((strcmp(option, "-c") == 0) || (strcmp(option, "--collector") == 0))
+            options.collectors = splitList(next_option, ',');
+        else if ((strcmp(option, "-o") == 0) || (strcmp(option, "--op") == 0))
+            options.operations = splitList(next_option, ',');
+        else if ((strcmp(option, "-s") == 0) || (strcmp(option, "--size") == 0))
+            options.sizes = splitList(next_option, ',');
+        else if ((strcmp(option, "-t") == 0) || (strcmp(option, "--type") == 0))
+            options.types = splitList(next_option, ',');
+        else if (strcmp(option, "--storage") == 0)
+            options.storages = splitList(next_option, ',');
+        else if (strcmp(option, "--topology") == 0)
+        {
+            std::vector<std::string> extents = splitList(next_option, ',');
+            if (extents.size() != 3)
+            {
+                std::cerr << "Invalid topology " << next_option << std::endl;
+                return RESULT_ERROR;
+            }
+            options.topology.set(atoi(extents[0].c_str()), atoi(extents[1].c_str()),
+                    atoi(extents[2].c_str()));
+        } else if ((strcmp(option, "-r") == 0) || (strcmp(option, "--repetitions") == 0))
+            options.repetitions = atoi(next_option);
+        else if ((strcmp(option, "-w") == 0) || (strcmp(option, "--warmup") == 0))
+            options.warmup = atoi(next_option);
+        else if (strcmp(option, "--format") == 0)
+            options.format = next_option;
+        else if (strcmp(option, "--output") == 0)
+            options.output = next_option;
+        else if ((strcmp(option, "-b") == 0) || (strcmp(option, "--baseline") == 0))
+            options.baseline = next_option;
+        else if (strcmp(option, "--tolerance") == 0)
+            options.tolerance = atof(next_option);
+        else
+        {
+            std::cerr << "Unknown option " << option << std::endl;
+            std::cerr << usage_stream.str() << std::endl;
+            return RESULT_ERROR;
+        }
+
+        i++;
+    }
+
+    if (options.repetitions == 0)
+    {
+        std::cerr << "At least one repetition is required" << std::endl;
+        return RESULT_ERROR;
+    }
+
+    if (options.format != "text" && options.format != "csv" && options.format != "json")
+    {
+        std::cerr << "Unknown format " << options.format << std::endl;
+        return RESULT_ERROR;
+    }
+
+    return RESULT_OK;
+}
+
+/**
+ * Returns an error message if a configuration is not supported, an empty string otherwise.
+ */
+std::string checkConfig(const Options& options, const Config &config)
+{
+    if (config.collector != "serial" && config.collector != "parallel")
+        return "unknown collector";
+
+#if (SPLASH_SUPPORTED_PARALLEL!=1)
+    if (config.collector == "parallel")
+        return "parallel libSplash is not available";
+#endif
+
+    if (config.collector == "parallel" &&
+            options.topology.getScalarSize() != (size_t) options.mpiSize)
+        return "topology must match the number of processes";
+
+    if (config.operation != "write" && config.operation != "append" &&
+            config.operation != "read" && config.operation != "grid" &&
+            config.operation != "poly")
+        return "unknown operation";
+
+    if (getType(config.type) == NULL)
+        return "unknown type";
+
+    if (config.storage != "chunked" && config.storage != "deflate" &&
+            config.storage != "contiguous")
+        return "unknown storage";
+
+    if (config.ndims > 1 && (config.operation == "append" || config.operation == "poly"))
+        return "operation requires a 1-dimensional size";
+
+    return "";
+}
+
+/* benchmark functions */
+
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+
+void mpiBarrier()
+{
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+double mpiMaxTime(double time)
+{
+    double max_time = time;
+    MPI_Allreduce(&time, &max_time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return max_time;
+}
+
+#else
+
+void mpiBarrier()
+{
+}
+
+double mpiMaxTime(double time)
+{
+    return time;
+}
+
+#endif
+
+/**
+ * Runs a single configuration with the SerialDataCollector.
+ * Every process handles all MPI positions of the topology
+ * whose index modulo the number of processes is its rank,
+ * each position writes its own file.
+ */
+void runSerial(const Options& options, Result &result, void *data)
+{
+    const Config &config = result.config;
+    const CollectionType &type = *getType(config.type);
+    const Domain global_domain = getGlobalDomain(config, options.topology);
+
+    std::vector<Dimensions> positions;
+    for (size_t i = options.mpiRank; i < options.topology.getScalarSize(); i += options.mpiSize)
+        positions.push_back(indexToPosition(i, options.topology));
+
+    DataCollector::FileCreationAttr attr;
+    DataCollector::initFileCreationAttr(attr);
+    attr.enableCompression = (config.storage == "deflate");
+    attr.contiguousLayout = (config.storage == "contiguous");
+    attr.mpiSize.set(options.topology);
+
+    std::vector<DomainCollector*> collectors;
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        collectors.push_back(new DomainCollector(100));
+        attr.fileAccType = DataCollector::FAT_CREATE;
+        attr.mpiPosition.set(positions[i]);
+        collectors[i]->open(options.filename.c_str(), attr);
+    }
+
+    const bool is_read = (config.operation == "read" || config.operation == "grid" ||
+            config.operation == "poly");
+    if (is_read)
+    {
+        // write the data once and reopen for reading
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            const Domain local_domain(positions[i] * config.size, config.size);
+            if (config.operation == "read")
+                collectors[i]->write(0, type, config.ndims, Selection(config.size), "data", data);
+            else
+                collectors[i]->writeDomain(0, type, config.ndims, Selection(config.size), "data",
+                    local_domain, global_domain,
+                    config.operation == "grid" ? DomainCollector::GridType : DomainCollector::PolyType,
+                    data);
+            collectors[i]->close();
+
+            if (!options.merged || config.operation == "read")
+            {
+                attr.fileAccType = DataCollector::FAT_READ;
+                attr.mpiPosition.set(positions[i]);
+                collectors[i]->open(options.filename.c_str(), attr);
+            }
+        }
+
+        if (options.merged && config.operation != "read" && !collectors.empty())
+        {
+            mpiBarrier();
+            attr.fileAccType = DataCollector::FAT_READ_MERGED;
+            collectors[0]->open(options.filename.c_str(), attr);
+        }
+    }
+
+    const size_t total_reps = options.warmup + options.repetitions;
+    for (size_t rep = 0; rep < total_reps; ++rep)
+    {
+        mpiBarrier();
+        double start = getWallTime();
+
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            const Domain local_domain(positions[i] * config.size, config.size);
+            Dimensions size_read;
+
+            if (config.operation == "write")
+                collectors[i]->write(rep, type, config.ndims, Selection(config.size), "data", data);
+            else if (config.operation == "append")
+                collectors[i]->append(0, type, config.size.getScalarSize(), "data", data);
+            else if (config.operation == "read")
+                collectors[i]->read(0, "data", size_read, data);
+            else
+            {
+                // with merged files, the request is shifted by half a subdomain
+                // to intersect with the files of neighbouring positions
+                DomainCollector *dc = options.merged ? collectors[0] : collectors[i];
+                Domain request = local_domain;
+                if (options.merged && config.operation == "grid")
+                {
+                    for (uint32_t d = 0; d < config.ndims; ++d)
+                    {
+                        request.getOffset()[d] = std::min(
+                                request.getOffset()[d] + config.size[d] / 2,
+                                global_domain.getSize()[d] - config.size[d]);
+                    }
+                }
+
+                DomainCollector::DomDataClass data_class;
+                DataContainer *container = dc->readDomain(0, "data", request, &data_class);
+                delete container;
+            }
+        }
+
+        double time = mpiMaxTime(getWallTime() - start);
+        if (rep >= options.warmup)
+            result.times.push_back(time);
+    }
+
+    for (size_t i = 0; i < collectors.size(); ++i)
+    {
+        collectors[i]->close();
+        delete collectors[i];
+    }
+
+    result.ops = options.topology.getScalarSize();
+    result.bytes = result.ops * config.size.getScalarSize() * type.getSize();
+}
+
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+
+/**
+ * Runs a single configuration with the ParallelDomainCollector,
+ * all processes write to a single file per iteration.
+ */
+void runParallel(const Options& options, Result &result, void *data)
+{
+    const Config &config = result.config;
+    const CollectionType &type = *getType(config.type);
+    const Dimensions position = indexToPosition(options.mpiRank, options.topology);
+    const Domain global_domain = getGlobalDomain(config, options.topology);
+    const Domain local_domain(position * config.size, config.size);
+
+    Dimensions global_offset = position * config.size;
+    global_offset.setRank(config.ndims, 0);
+
+    ParallelDomainCollector pdc(MPI_COMM_WORLD, MPI_INFO_NULL, options.topology, 100);
+
+    DataCollector::FileCreationAttr attr;
+    DataCollector::initFileCreationAttr(attr);
+    attr.enableCompression = (config.storage == "deflate");
+    attr.contiguousLayout = (config.storage == "contiguous");
+    attr.fileAccType = DataCollector::FAT_CREATE;
+    pdc.open(options.filename.c_str(), attr);
+
+    const bool is_read = (config.operation == "read" || config.operation == "grid" ||
+            config.operation == "poly");
+    if (is_read)
+    {
+        if (config.operation == "read")
+            pdc.write(0, type, config.ndims, Selection(config.size), "data", data);
+        else
+            pdc.writeDomain(0, type, config.ndims, Selection(config.size), "data",
+                local_domain, global_domain,
+                config.operation == "grid" ? DomainCollector::GridType : DomainCollector::PolyType,
+                data);
+        pdc.close();
+
+        attr.fileAccType = DataCollector::FAT_READ;
+        pdc.open(options.filename.c_str(), attr);
+    }
+
+    const size_t total_reps = options.warmup + options.repetitions;
+    for (size_t rep = 0; rep < total_reps; ++rep)
+    {
+        mpiBarrier();
+        double start = getWallTime();
+
+        Dimensions size_read;
+        if (config.operation == "write")
+            pdc.write(rep, type, config.ndims, Selection(config.size), "data", data);
+        else if (config.operation == "append")
+            pdc.reserveAndAppend(rep, type, config.size.getScalarSize(), "data", data, NULL);
+        else if (config.operation == "read")
+            pdc.read(0, config.size, global_offset, "data", size_read, data);
+        else
+        {
+            DomainCollector::DomDataClass data_class;
+            DataContainer *container = pdc.readDomain(0, "data", local_domain, &data_class);
+            delete container;
+        }
+
+        double time = mpiMaxTime(getWallTime() - start);
+        if (rep >= options.warmup)
+            result.times.push_back(time);
+    }
+
+    pdc.close();
+    pdc.finalize();
+
+    result.ops = options.mpiSize;
+    result.bytes = result.ops * config.size.getScalarSize() * type.getSize();
+}
+
+#endif
+
+/* output functions */
+
+void writeText(std::ostream &out, const std::vector<Result> &results)
+{
+    out << std::left << std::setw(48) << "benchmark" << std::right <<
+            std::setw(12) << "MiB/s" << std::setw(12) << "ops/s" <<
+            std::setw(12) << "mean ms" << std::setw(12) << "p50 ms" <<
+            std::setw(12) << "p90 ms" << std::setw(12) << "p99 ms" <<
+            std::setw(12) << "max ms" << std::endl;
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &result = results[i];
+        std::vector<double> sorted = result.times;
+        std::sort(sorted.begin(), sorted.end());
+        const double mean = getMean(sorted);
+
+        out << std::left << std::setw(48) << result.name << std::right <<
+                std::fixed << std::setprecision(2) <<
+                std::setw(12) << getBandwidth(result) <<
+                std::setw(12) << result.ops / mean <<
+                std::setprecision(3) <<
+                std::setw(12) << mean * 1.0e3 <<
+                std::setw(12) << getPercentile(sorted, 50.0) * 1.0e3 <<
+                std::setw(12) << getPercentile(sorted, 90.0) * 1.0e3 <<
+                std::setw(12) << getPercentile(sorted, 99.0) * 1.0e3 <<
+                std::setw(12) << sorted.back() * 1.0e3 << std::endl;
+    }
+}
+
+void writeCSV(std::ostream &out, const std::vector<Result> &results, int mpiSize)
+{
+    out << "name,collector,op,type,size,storage,processes,repetitions,bytes," <<
+            "mean_s,min_s,p50_s,p90_s,p99_s,max_s,bandwidth_mibs,ops_per_s" << std::endl;
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &result = results[i];
+        const Config &config = result.config;
+        std::vector<double> sorted = result.times;
+        std::sort(sorted.begin(), sorted.end());
+        const double mean = getMean(sorted);
+
+        out << result.name << "," << config.collector << "," << config.operation << "," <<
+                config.type << "," << config.sizeName << "," << config.storage << "," <<
+                mpiSize << "," << sorted.size() << "," << result.bytes << "," <<
+                std::scientific << std::setprecision(6) <<
+                mean << "," << sorted.front() << "," <<
+                getPercentile(sorted, 50.0) << "," << getPercentile(sorted, 90.0) << "," <<
+                getPercentile(sorted, 99.0) << "," << sorted.back() << "," <<
+                std::fixed << std::setprecision(3) <<
+                getBandwidth(result) << "," << result.ops / mean << std::endl;
+    }
+}
+
+void writeJSON(std::ostream &out, const std::vector<Result> &results, int mpiSize)
+{
+    out << "{\n  \"processes\": " << mpiSize << ",\n  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &result = results[i];
+        const Config &config = result.config;
+        std::vector<double> sorted = result.times;
+        std::sort(sorted.begin(), sorted.end());
+        const double mean = getMean(sorted);
+
+        out << (i > 0 ? "," : "") << "\n    {\"name\": \"" << result.name <<
+                "\", \"collector\": \"" << config.collector <<
+                "\", \"op\": \"" << config.operation <<
+                "\", \"type\": \"" << config.type <<
+                "\", \"size\": \"" << config.sizeName <<
+                "\", \"storage\": \"" << config.storage <<
+                "\", \"repetitions\": " << sorted.size() <<
+                ", \"bytes\": " << result.bytes <<
+                std::scientific << std::setprecision(6) <<
+                ", \"mean_s\": " << mean <<
+                ", \"min_s\": " << sorted.front() <<
+                ", \"p50_s\": " << getPercentile(sorted, 50.0) <<
+                ", \"p90_s\": " << getPercentile(sorted, 90.0) <<
+                ", \"p99_s\": " << getPercentile(sorted, 99.0) <<
+                ", \"max_s\": " << sorted.back() <<
+                std::fixed << std::setprecision(3) <<
+                ", \"bandwidth_mibs\": " << getBandwidth(result) <<
+                ", \"ops_per_s\": " << result.ops / mean << "}";
+    }
+
+    out << "\n  ]\n}" << std::endl;
+}
+
+/**
+ * Compares the bandwidth of all results with the CSV results of a previous run.
+ *
+ * @return RESULT_ERROR if a benchmark is slower than the baseline by more than the tolerance
+ */
+int compareBaseline(const Options& options, const std::vector<Result> &results)
+{
+    std::ifstream file(options.baseline.c_str());
+    if (!file)
+    {
+        std::cerr << "Failed to open baseline " << options.baseline << std::endl;
+        return RESULT_ERROR;
+    }
+
+    // bandwidth by benchmark name, the column is found by the header
+    std::map<std::string, double> baseline;
+    std::string line;
+    size_t column = 0;
+    if (std::getline(file, line))
+    {
+        std::vector<std::string> header = splitList(line, ',');
+        column = std::find(header.begin(), header.end(), "bandwidth_mibs") - header.begin();
+    }
+
+    while (std::getline(file, line))
+    {
+        std::vector<std::string> fields = splitList(line, ',');
+        if (fields.size() > column)
+            baseline[fields[0]] = atof(fields[column].c_str());
+    }
+
+    int result = RESULT_OK;
+    std::cout << std::endl << "comparison with " << options.baseline << ":" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        std::map<std::string, double>::const_iterator iter = baseline.find(results[i].name);
+        if (iter == baseline.end() || iter->second <= 0.0)
+        {
+            std::cout << std::left << std::setw(48) << results[i].name << " no baseline" << std::endl;
+            continue;
+        }
+
+        const double bandwidth = getBandwidth(results[i]);
+        const double change = (bandwidth / iter->second - 1.0) * 100.0;
+        const bool regression = change < -options.tolerance;
+
+        std::cout << std::left << std::setw(48) << results[i].name << std::right <<
+                std::fixed << std::setprecision(2) <<
+                std::setw(12) << iter->second << " -> " << std::setw(12) << bandwidth <<
+                " MiB/s (" << std::showpos << change << std::noshowpos << "%)" <<
+                (regression ? " REGRESSION" : "") << std::endl;
+
+        if (regression)
+            result = RESULT_ERROR;
+    }
+
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    int result = RESULT_OK;
+
+    Options options;
+    initOptions(options);
+
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &options.mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &options.mpiSize);
+#endif
+    options.topology.set(options.mpiSize, 1, 1);
+
+    result = parseCmdLine(argc, argv, options);
+
+    std::vector<Config> configs;
+    for (size_t c = 0; result == RESULT_OK && !options.showHelp && c < options.collectors.size(); ++c)
+        for (size_t o = 0; o < options.operations.size(); ++o)
+            for (size_t s = 0; s < options.sizes.size(); ++s)
+                for (size_t t = 0; t < options.types.size(); ++t)
+                    for (size_t st = 0; st < options.storages.size(); ++st)
+                    {
+                        Config config;
+                        config.collector = options.collectors[c];
+                        config.operation = options.operations[o];
+                        config.sizeName = options.sizes[s];
+                        config.type = options.types[t];
+                        config.storage = options.storages[st];
+
+                        if (!parseSize(config.sizeName, config.size, config.ndims))
+                        {
+                            std::cerr << "Invalid size " << config.sizeName << std::endl;
+                            result = RESULT_ERROR;
+                            break;
+                        }
+
+                        configs.push_back(config);
+                    }
+
+    std::vector<Result> results;
+    for (size_t i = 0; result == RESULT_OK && i < configs.size(); ++i)
+    {
+        Result bench_result;
+        bench_result.config = configs[i];
+        bench_result.name = configs[i].collector + "/" + configs[i].operation + "/" +
+                configs[i].type + "/" + configs[i].sizeName + "/" + configs[i].storage;
+        if (options.merged && configs[i].collector == "serial" &&
+                (configs[i].operation == "grid" || configs[i].operation == "poly"))
+            bench_result.name += "/merged";
+
+        const std::string error = checkConfig(options, configs[i]);
+        if (!error.empty())
+        {
+            if (options.mpiRank == 0)
+                std::cerr << "Skipping " << bench_result.name << ": " << error << std::endl;
+            continue;
+        }
+
+        const size_t elements = configs[i].size.getScalarSize();
+        char *data = new char[elements * getType(configs[i].type)->getSize()];
+        fillData(configs[i].type, data, elements, elements * options.mpiRank);
+
+        try
+        {
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+            if (configs[i].collector == "parallel")
+                runParallel(options, bench_result, data);
+            else
+#endif
+                runSerial(options, bench_result, data);
+
+            results.push_back(bench_result);
+        } catch (DCException e)
+        {
+            std::cerr << "[" << options.mpiRank << "] " << bench_result.name <<
+                    " failed: " << e.what() << std::endl;
+            result = RESULT_ERROR;
+        }
+
+        delete[] data;
+    }
+
+    if (options.mpiRank == 0 && !results.empty())
+    {
+        std::ofstream file;
+        if (!options.output.empty())
+        {
+            file.open(options.output.c_str());
+            if (!file)
+            {
+                std::cerr << "Failed to open " << options.output << std::endl;
+                result = RESULT_ERROR;
+            }
+        }
+        std::ostream &out = options.output.empty() ? std::cout : file;
+
+        if (options.format == "csv")
+            writeCSV(out, results, options.mpiSize);
+        else if (options.format == "json")
+            writeJSON(out, results, options.mpiSize);
+        else
+            writeText(out, results);
+
+        if (!options.baseline.empty() && compareBaseline(options, results) != RESULT_OK)
+            result = RESULT_ERROR;
+    }
+
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+    MPI_Finalize();
+#endif
+
+    return result;
+}
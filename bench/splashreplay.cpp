@@ -0,0 +1,928 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * splash-replay replays a workload trace recorded by a RecordingCollector
+ * with synthetic data and reports the time of each phase between
+ * opening and closing a file.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <set>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "splash/splash.h"
+
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+#include <mpi.h>
+#endif
+
+#define RESULT_OK 0
+#define RESULT_ERROR 1
+
+using namespace splash;
+
+typedef struct
+{
+    std::string trace;
+    std::string collector;
+    std::string path;
+    std::string defaultType;
+    bool synthesize;
+    bool showHelp;
+    int mpiRank;
+    int mpiSize;
+} Options;
+
+/**
+ * a single recorded call
+ */
+typedef struct
+{
+    double start;
+    double duration;
+    std::string method;
+    std::vector<std::string> args;
+} Call;
+
+/**
+ * all calls between opening and closing a file
+ */
+typedef struct
+{
+    std::string filename;
+    DataCollector::FileAccType accType;
+    Dimensions mpiPosition;
+    Dimensions mpiSize;
+    bool enableCompression;
+    bool contiguousLayout;
+    double recordedTime;
+    std::vector<Call> calls;
+} Phase;
+
+typedef struct
+{
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t errors;
+    double time;
+} OpStats;
+
+typedef struct
+{
+    std::string name;
+    double recordedTime;
+    double time;
+    std::map<std::string, OpStats> ops;
+} PhaseResult;
+
+/**
+ * CollectionType for datatypes which are recorded by their size only
+ */
+class ColTypeOpaque : public CollectionType
+{
+public:
+
+    ColTypeOpaque(size_t size) :
+    size(size)
+    {
+        type = H5Tcreate(H5T_OPAQUE, size);
+    }
+
+    ~ColTypeOpaque()
+    {
+        H5Tclose(type);
+    }
+
+    size_t getSize() const
+    {
+        return size;
+    }
+
+private:
+    size_t size;
+};
+
+typedef struct
+{
+    ColTypeInt8 ctInt8;
+    ColTypeInt16 ctInt16;
+    ColTypeInt32 ctInt32;
+    ColTypeInt64 ctInt64;
+    ColTypeUInt8 ctUInt8;
+    ColTypeUInt16 ctUInt16;
+    ColTypeUInt32 ctUInt32;
+    ColTypeUInt64 ctUInt64;
+    ColTypeFloat ctFloat;
+    ColTypeDouble ctDouble;
+} ReplayTypes;
+
+static ReplayTypes replayTypes;
+static std::map<std::string, ColTypeOpaque*> opaqueTypes;
+static std::vector<char> syntheticData;
+
+/* helper functions */
+
+void initOptions(Options& options)
+{
+    options.trace = "";
+    options.collector = "serial";
+    options.path = ".";
+    options.defaultType = "f4";
+    options.synthesize = true;
+    options.showHelp = false;
+    options.mpiRank = 0;
+    options.mpiSize = 1;
+}
+
+double getWallTime()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec * 1.0e-9;
+}
+
+std::vector<std::string> splitList(const std::string &list, char separator)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, separator))
+        items.push_back(item);
+
+    return items;
+}
+
+Dimensions parseDims(const std::string &value)
+{
+    std::vector<std::string> extents = splitList(value, ',');
+    if (extents.empty() || extents.size() > DSP_DIM_MAX)
+        throw DCException("invalid dimensions " + value);
+
+    hsize_t values[DSP_DIM_MAX];
+    for (size_t i = 0; i < extents.size(); ++i)
+        values[i] = strtoull(extents[i].c_str(), NULL, 10);
+
+    return Dimensions(extents.size(), values);
+}
+
+const CollectionType& getType(const std::string &code)
+{
+    if (code == "i1")
+        return replayTypes.ctInt8;
+    if (code == "i2")
+        return replayTypes.ctInt16;
+    if (code == "i4")
+        return replayTypes.ctInt32;
+    if (code == "i8")
+        return replayTypes.ctInt64;
+    if (code == "u1")
+        return replayTypes.ctUInt8;
+    if (code == "u2")
+        return replayTypes.ctUInt16;
+    if (code == "u4")
+        return replayTypes.ctUInt32;
+    if (code == "u8")
+        return replayTypes.ctUInt64;
+    if (code == "f4")
+        return replayTypes.ctFloat;
+    if (code == "f8")
+        return replayTypes.ctDouble;
+
+    // all other datatypes are replayed as opaque data of the same size
+    const size_t size = (code.size() > 1) ? strtoul(code.c_str() + 1, NULL, 10) : 0;
+    if (size == 0)
+        throw DCException("invalid datatype " + code);
+
+    std::map<std::string, ColTypeOpaque*>::const_iterator iter = opaqueTypes.find(code);
+    if (iter != opaqueTypes.end())
+        return *(iter->second);
+
+    ColTypeOpaque *type = new ColTypeOpaque(size);
+    opaqueTypes[code] = type;
+    return *type;
+}
+
+/**
+ * Returns a buffer of at least \p bytes with synthetic data.
+ */
+void *getData(size_t bytes)
+{
+    if (syntheticData.size() < bytes)
+    {
+        const size_t old_size = syntheticData.size();
+        syntheticData.resize(bytes);
+        for (size_t i = old_size; i < bytes; ++i)
+            syntheticData[i] = (char) (i % 127);
+    }
+
+    return syntheticData.empty() ? NULL : &(syntheticData[0]);
+}
+
+const char *getName(const std::string &name)
+{
+    return name.empty() ? NULL : name.c_str();
+}
+
+std::string getTarget(const Options& options, const std::string &filename)
+{
+    std::string basename = filename;
+    const size_t pos = basename.find_last_of('/');
+    if (pos != std::string::npos)
+        basename = basename.substr(pos + 1);
+
+    return options.path + "/" + basename;
+}
+
+const char *getAccessName(DataCollector::FileAccType accType)
+{
+    switch (accType)
+    {
+        case DataCollector::FAT_CREATE:
+            return "create";
+        case DataCollector::FAT_READ:
+            return "read";
+        case DataCollector::FAT_READ_MERGED:
+            return "merged";
+        case DataCollector::FAT_WRITE:
+            return "write";
+        default:
+            return "inmemory";
+    }
+}
+
+int parseCmdLine(int argc, char **argv, Options& options)
+{
+    std::stringstream usage_stream;
+    usage_stream << "Usage " << argv[0] << " [options] --trace <file>";
+
+    std::stringstream full_desc_stream;
+    full_desc_stream << usage_stream.str() << std::endl <<
+            " --help,-h\t\t\t print this help message" << std::endl <<
+            " --trace,-t\t<file>\t\t workload trace, %r is replaced by the MPI rank" << std::endl <<
+            " --collector,-c\t<name>\t\t serial" <<
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+            ",parallel" <<
+#endif
+            " (default serial)" << std::endl <<
+            " --path,-p\t<dir>\t\t directory for replayed files (default .)" << std::endl <<
+            " --type\t\t<code>\t\t datatype of datasets which are read but not written (default f4)" << std::endl <<
+            " --no-synthesize\t\t do not create missing files for read phases";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *option = argv[i];
+        const char *next_option = NULL;
+        if (i < argc - 1)
+            next_option = argv[i + 1];
+
+        // help
+        if ((strcmp(option, "-h") == 0) || (strcmp(option, "--help") == 0))
+        {
+            if (options.mpiRank == 0)
+                std::cout << full_desc_stream.str() << std::endl;
+            options.showHelp = true;
+            return RESULT_OK;
+        }
+
+        // synthesize
+        if (strcmp(option, "--no-synthesize") == 0)
+        {
+            options.synthesize = false;
+            continue;
+        }
+
+        // all other options require an argument
+        if (next_option == NULL)
+        {
+            std::cerr << "Missing argument for " << option << std::endl;
+            std::cerr << usage_stream.str() << std::endl;
+            return RESULT_ERROR;
+        }
+
+        if ((strcmp(option, "-t") == 0) || (strcmp(option, "--trace") == 0))
+            options.trace = next_option;
+        else if ((strcmp(option, "-c") == 0) || (strcmp(option, "--collector") == 0))
+            options.collector = next_option;
+        else if ((strcmp(option, "-p") == 0) || (strcmp(option, "--path") == 0))
+            options.path = next_option;
+        else if (strcmp(option, "--type") == 0)
+            options.defaultType = next_option;
+        else
+        {
+            std::cerr << "Unknown option " << option << std::endl;
+            std::cerr << usage_stream.str() << std::endl;
+            return RESULT_ERROR;
+        }
+
+        i++;
+    }
+
+    if (options.trace.empty())
+    {
+        std::cerr << "No trace file specified" << std::endl;
+        std::cerr << usage_stream.str() << std::endl;
+        return RESULT_ERROR;
+    }
+
+    if (options.collector != "serial"
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+            && options.collector != "parallel"
+#endif
+            )
+    {
+        std::cerr << "Unsupported collector " << options.collector << std::endl;
+        return RESULT_ERROR;
+    }
+
+    const size_t pos = options.trace.find("%r");
+    if (pos != std::string::npos)
+    {
+        std::stringstream rank;
+        rank << options.mpiRank;
+        options.trace.replace(pos, 2, rank.str());
+    }
+
+    return RESULT_OK;
+}
+
+/**
+ * Reads all phases of a trace file.
+ * Calls outside of phases and failed calls are not replayed.
+ */
+int readTrace(const Options& options, std::vector<Phase> &phases)
+{
+    std::ifstream file(options.trace.c_str());
+    if (!file)
+    {
+        std::cerr << "Failed to open trace " << options.trace << std::endl;
+        return RESULT_ERROR;
+    }
+
+    Phase *phase = NULL;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::vector<std::string> fields = splitList(line, '\t');
+        if (fields.size() < 4)
+        {
+            std::cerr << "Invalid trace line: " << line << std::endl;
+            return RESULT_ERROR;
+        }
+
+        Call call;
+        call.start = atof(fields[0].c_str());
+        call.duration = atof(fields[1].c_str());
+        call.method = fields[3];
+        call.args.assign(fields.begin() + 4, fields.end());
+
+        if (fields[2] != "ok")
+            continue;
+
+        if (call.method == "open")
+        {
+            if (call.args.size() < 6)
+            {
+                std::cerr << "Invalid trace line: " << line << std::endl;
+                return RESULT_ERROR;
+            }
+
+            phases.push_back(Phase());
+            phase = &(phases.back());
+            phase->accType = (DataCollector::FileAccType) atoi(call.args[0].c_str());
+            try
+            {
+                phase->mpiPosition = parseDims(call.args[1]);
+                phase->mpiSize = parseDims(call.args[2]);
+            } catch (DCException e)
+            {
+                std::cerr << "Invalid trace line: " << line << std::endl;
+                return RESULT_ERROR;
+            }
+            phase->enableCompression = atoi(call.args[3].c_str()) != 0;
+            phase->contiguousLayout = atoi(call.args[4].c_str()) != 0;
+            phase->filename = call.args[5];
+            phase->recordedTime = -call.start;
+            continue;
+        }
+
+        if (phase == NULL)
+            continue;
+
+        if (call.method == "close")
+        {
+            phase->recordedTime += call.start + call.duration;
+            phase = NULL;
+            continue;
+        }
+
+        phase->calls.push_back(call);
+    }
+
+    return RESULT_OK;
+}
+
+/* replay functions */
+
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+
+void mpiBarrier()
+{
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+double mpiMaxTime(double time)
+{
+    double max_time = time;
+    MPI_Allreduce(&time, &max_time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return max_time;
+}
+
+#else
+
+void mpiBarrier()
+{
+}
+
+double mpiMaxTime(double time)
+{
+    return time;
+}
+
+#endif
+
+DataCollector *createCollector(const Options& options, const Phase &phase)
+{
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+    if (options.collector == "parallel")
+        return new ParallelDataCollector(MPI_COMM_WORLD, MPI_INFO_NULL,
+            phase.mpiSize, 100);
+#else
+    (void) options;
+    (void) phase;
+#endif
+
+    return new SerialDataCollector(100);
+}
+
+void deleteCollector(DataCollector *dc)
+{
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+    ParallelDataCollector *pdc = dynamic_cast<ParallelDataCollector*> (dc);
+    if (pdc != NULL)
+        pdc->finalize();
+#endif
+
+    delete dc;
+}
+
+void initAttr(const Phase &phase, DataCollector::FileCreationAttr &attr)
+{
+    DataCollector::initFileCreationAttr(attr);
+    attr.fileAccType = phase.accType;
+    attr.mpiPosition = phase.mpiPosition;
+    attr.mpiSize = phase.mpiSize;
+    attr.enableCompression = phase.enableCompression;
+    attr.contiguousLayout = phase.contiguousLayout;
+}
+
+/**
+ * Creates a file with all datasets and attributes which are read
+ * in a phase, using the sizes returned to the recorded application.
+ * Only supported for the serial collector.
+ */
+void synthesize(const Options& options, const Phase &phase,
+        std::map<std::string, std::string> &types)
+{
+    SerialDataCollector sdc(1);
+    DataCollector::FileCreationAttr attr;
+    initAttr(phase, attr);
+    attr.fileAccType = DataCollector::FAT_CREATE;
+    sdc.open(getTarget(options, phase.filename).c_str(), attr);
+
+    // memory datatypes of typed reads are the best guess for the file datatype
+    for (size_t i = 0; i < phase.calls.size(); ++i)
+    {
+        const Call &call = phase.calls[i];
+        if ((call.method == "readType" || call.method == "readComponents") &&
+                types.count(call.args[1]) == 0)
+            types[call.args[1]] = call.args[5];
+    }
+
+    std::set<std::string> written;
+    for (size_t i = 0; i < phase.calls.size(); ++i)
+    {
+        const Call &call = phase.calls[i];
+        const std::vector<std::string> &args = call.args;
+
+        try
+        {
+            if (call.method == "read" || call.method == "readType" ||
+                    call.method == "readComponents")
+            {
+                const std::string key = args[0] + "/" + args[1];
+                if (written.count(key) > 0)
+                    continue;
+
+                if (types.count(args[1]) == 0)
+                    types[args[1]] = options.defaultType;
+
+                const CollectionType &type = getType(types[args[1]]);
+                const Dimensions size = parseDims(args.back());
+                sdc.write(atoi(args[0].c_str()), type, size.getRank(), Selection(size),
+                        args[1].c_str(), getData(size.getScalarSize() * type.getSize()));
+                written.insert(key);
+            } else if (call.method == "readAttribute")
+            {
+                const CollectionType &type = getType(options.defaultType);
+                sdc.writeAttribute(atoi(args[0].c_str()), type, getName(args[1]),
+                        args[2].c_str(), getData(type.getSize()));
+            } else if (call.method == "readGlobalAttribute")
+            {
+                const CollectionType &type = getType(options.defaultType);
+                sdc.writeGlobalAttribute(type, args[0].c_str(), getData(type.getSize()));
+            }
+        } catch (DCException e)
+        {
+            // missing datasets or attributes are reported as errors by the replay
+        }
+    }
+
+    sdc.close();
+}
+
+bool fileExists(const Options& options, const Phase &phase)
+{
+    std::stringstream filename;
+    filename << getTarget(options, phase.filename) << "_" << phase.mpiPosition[0] <<
+            "_" << phase.mpiPosition[1] << "_" << phase.mpiPosition[2] << ".h5";
+
+    struct stat file_stat;
+    return stat(filename.str().c_str(), &file_stat) == 0;
+}
+
+/**
+ * Replays a single call.
+ *
+ * @return number of bytes of data written or read
+ */
+uint64_t replayCall(const Options& options, DataCollector &dc, const Call &call,
+        std::map<std::string, std::string> &types)
+{
+    const std::string &method = call.method;
+    const std::vector<std::string> &args = call.args;
+    const int32_t id = args.empty() ? 0 : atoi(args[0].c_str());
+    static char attributeBuffer[1024 * 1024];
+
+    if (method == "getMaxID")
+        dc.getMaxID();
+    else if (method == "getMPISize")
+    {
+        Dimensions mpi_size;
+        dc.getMPISize(mpi_size);
+    } else if (method == "getEntryIDs")
+    {
+        size_t count = 0;
+        dc.getEntryIDs(NULL, &count);
+        if (atoi(args[0].c_str()) != 0)
+        {
+            std::vector<int32_t> ids(count + 1);
+            dc.getEntryIDs(&(ids[0]), &count);
+        }
+    } else if (method == "getEntriesForID")
+    {
+        size_t count = 0;
+        dc.getEntriesForID(id, NULL, &count);
+        if (atoi(args[1].c_str()) != 0)
+        {
+            std::vector<DataCollector::DCEntry> entries(count + 1);
+            dc.getEntriesForID(id, &(entries[0]), &count);
+        }
+    } else if (method == "write" || method == "writeComponents")
+    {
+        // components are written as a single buffer
+        types[args[1]] = args[2];
+        const CollectionType &type = getType(args[2]);
+        const uint32_t ndims = atoi(args[3].c_str());
+        Selection select(parseDims(args[4]), parseDims(args[5]),
+                parseDims(args[6]), parseDims(args[7]));
+
+        // scattered selections are replayed as dense selections
+        if (args[8].size() > 1 && atoi(args[8].c_str() + 1) > 0)
+            select = Selection(select.count);
+
+        const size_t elements = select.count.getScalarSize();
+        dc.write(id, type, ndims, select, args[1].c_str(),
+                getData(select.size.getScalarSize() * type.getSize()));
+        return elements * type.getSize();
+    } else if (method == "append")
+    {
+        types[args[1]] = args[2];
+        const CollectionType &type = getType(args[2]);
+        const size_t count = strtoull(args[3].c_str(), NULL, 10);
+        const size_t offset = strtoull(args[4].c_str(), NULL, 10);
+        const size_t stride = strtoull(args[5].c_str(), NULL, 10);
+
+        dc.append(id, type, count, offset, stride, args[1].c_str(),
+                getData((offset + count * stride) * type.getSize()));
+        return count * type.getSize();
+    } else if (method == "remove")
+    {
+        if (args.size() > 1)
+            dc.remove(id, args[1].c_str());
+        else
+            dc.remove(id);
+    } else if (method == "createReference")
+    {
+        if (args.size() > 4)
+            dc.createReference(id, args[1].c_str(), atoi(args[2].c_str()),
+                args[3].c_str(), parseDims(args[4]), parseDims(args[5]),
+                parseDims(args[6]));
+        else
+            dc.createReference(id, args[1].c_str(), atoi(args[2].c_str()),
+                args[3].c_str());
+    } else if (method == "readGlobalAttribute")
+    {
+        Dimensions mpi_position;
+        if (args.size() > 1)
+            mpi_position = parseDims(args[1]);
+        dc.readGlobalAttribute(args[0].c_str(), attributeBuffer,
+                (args.size() > 1) ? &mpi_position : NULL);
+    } else if (method == "writeGlobalAttribute")
+    {
+        dc.writeGlobalAttribute(getType(args[1]), args[0].c_str(), getData(4096));
+    } else if (method == "readAttribute")
+    {
+        Dimensions mpi_position;
+        if (args.size() > 3)
+            mpi_position = parseDims(args[3]);
+        dc.readAttribute(id, getName(args[1]), args[2].c_str(), attributeBuffer,
+                (args.size() > 3) ? &mpi_position : NULL);
+    } else if (method == "writeAttribute")
+    {
+        dc.writeAttribute(id, getType(args[3]), getName(args[1]), args[2].c_str(),
+                getData(4096));
+    } else if (method == "read" || method == "readType" || method == "readComponents")
+    {
+        // components are read to a single buffer
+        if (method != "read")
+            types[args[1]] = args[5];
+
+        const bool read_data = atoi(args[2].c_str()) != 0;
+        const size_t type_size = getType(types.count(args[1]) > 0 ?
+            types[args[1]] : options.defaultType).getSize();
+
+        Dimensions size_read;
+        if (args.size() == 4)
+        {
+            // the size in the file is required to allocate a buffer
+            void *buf = NULL;
+            if (read_data)
+            {
+                dc.read(id, args[1].c_str(), size_read, NULL);
+                buf = getData(size_read.getScalarSize() * type_size);
+            }
+
+            dc.read(id, args[1].c_str(), size_read, buf);
+            return read_data ? size_read.getScalarSize() * type_size : 0;
+        }
+
+        const Dimensions dst_buffer = parseDims(args[3]);
+        const Dimensions dst_offset = parseDims(args[4]);
+        void *buf = read_data ? getData(dst_buffer.getScalarSize() * type_size) : NULL;
+        if (method == "readType")
+            dc.read(id, getType(args[5]), args[1].c_str(), dst_buffer, dst_offset,
+                size_read, buf);
+        else
+            dc.read(id, args[1].c_str(), dst_buffer, dst_offset, size_read, buf);
+
+        return read_data ? size_read.getScalarSize() * type_size : 0;
+    } else
+        throw DCException("unsupported method " + method);
+
+    return 0;
+}
+
+/**
+ * Replays all calls of a phase.
+ */
+void replayPhase(const Options& options, const Phase &phase, PhaseResult &result,
+        std::map<std::string, std::string> &types)
+{
+    DataCollector::FileCreationAttr attr;
+    initAttr(phase, attr);
+    const std::string target = getTarget(options, phase.filename);
+
+    DataCollector *dc = createCollector(options, phase);
+
+    mpiBarrier();
+    const double start = getWallTime();
+
+    double op_start = getWallTime();
+    OpStats &open_stats = result.ops["open"];
+    open_stats.calls++;
+    bool opened = true;
+    try
+    {
+        dc->open(target.c_str(), attr);
+    } catch (DCException e)
+    {
+        open_stats.errors++;
+        opened = false;
+        std::cerr << "[" << options.mpiRank << "] open " << target <<
+                " failed: " << e.what() << std::endl;
+    }
+    open_stats.time += getWallTime() - op_start;
+
+    for (size_t i = 0; opened && i < phase.calls.size(); ++i)
+    {
+        const Call &call = phase.calls[i];
+        OpStats &stats = result.ops[call.method];
+        stats.calls++;
+
+        op_start = getWallTime();
+        try
+        {
+            stats.bytes += replayCall(options, *dc, call, types);
+        } catch (DCException e)
+        {
+            stats.errors++;
+        }
+        stats.time += getWallTime() - op_start;
+    }
+
+    if (opened)
+    {
+        op_start = getWallTime();
+        OpStats &close_stats = result.ops["close"];
+        close_stats.calls++;
+        try
+        {
+            dc->close();
+        } catch (DCException e)
+        {
+            close_stats.errors++;
+        }
+        close_stats.time += getWallTime() - op_start;
+    }
+
+    result.time = mpiMaxTime(getWallTime() - start);
+    deleteCollector(dc);
+}
+
+/* output functions */
+
+void writeText(std::ostream &out, const std::vector<PhaseResult> &results)
+{
+    out << std::left << std::setw(40) << "phase/op" << std::right <<
+            std::setw(10) << "calls" << std::setw(12) << "MiB" <<
+            std::setw(12) << "errors" << std::setw(14) << "recorded s" <<
+            std::setw(12) << "replay s" << std::endl;
+
+    double recorded_time = 0.0, time = 0.0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const PhaseResult &result = results[i];
+        uint64_t calls = 0, bytes = 0, errors = 0;
+        for (std::map<std::string, OpStats>::const_iterator iter = result.ops.begin();
+                iter != result.ops.end(); ++iter)
+        {
+            calls += iter->second.calls;
+            bytes += iter->second.bytes;
+            errors += iter->second.errors;
+        }
+
+        out << std::left << std::setw(40) << result.name << std::right <<
+                std::fixed << std::setw(10) << calls <<
+                std::setprecision(2) << std::setw(12) << bytes / (1024.0 * 1024.0) <<
+                std::setw(12) << errors <<
+                std::setprecision(6) << std::setw(14) << result.recordedTime <<
+                std::setw(12) << result.time << std::endl;
+
+        for (std::map<std::string, OpStats>::const_iterator iter = result.ops.begin();
+                iter != result.ops.end(); ++iter)
+        {
+            const OpStats &stats = iter->second;
+            out << "  " << std::left << std::setw(38) << iter->first << std::right <<
+                    std::setw(10) << stats.calls <<
+                    std::setprecision(2) << std::setw(12) << stats.bytes / (1024.0 * 1024.0) <<
+                    std::setw(12) << stats.errors <<
+                    std::setprecision(6) << std::setw(14) << "" <<
+                    std::setw(12) << stats.time << std::endl;
+        }
+
+        recorded_time += result.recordedTime;
+        time += result.time;
+    }
+
+    out << std::left << std::setw(74) << "total" << std::right <<
+            std::setprecision(6) << std::setw(14) << recorded_time <<
+            std::setw(12) << time << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int result = RESULT_OK;
+
+    Options options;
+    initOptions(options);
+
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &options.mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &options.mpiSize);
+#endif
+
+    result = parseCmdLine(argc, argv, options);
+
+    std::vector<Phase> phases;
+    if (result == RESULT_OK && !options.showHelp)
+        result = readTrace(options, phases);
+
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+    // all processes must replay the same number of phases
+    int num_phases = phases.size(), max_phases = 0;
+    MPI_Allreduce(&num_phases, &max_phases, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (result == RESULT_OK && num_phases != max_phases)
+    {
+        std::cerr << "[" << options.mpiRank << "] trace " << options.trace <<
+                " has " << num_phases << " phases, expected " << max_phases << std::endl;
+        result = RESULT_ERROR;
+    }
+#endif
+
+    std::map<std::string, std::string> types;
+    std::vector<PhaseResult> results;
+    for (size_t i = 0; result == RESULT_OK && i < phases.size(); ++i)
+    {
+        const Phase &phase = phases[i];
+
+        PhaseResult phase_result;
+        std::stringstream name;
+        name << i << ":" << getAccessName(phase.accType) << ":" <<
+                getTarget(options, phase.filename);
+        phase_result.name = name.str();
+        phase_result.recordedTime = mpiMaxTime(phase.recordedTime);
+        phase_result.time = 0.0;
+
+        if (options.synthesize && options.collector == "serial" &&
+                (phase.accType == DataCollector::FAT_READ ||
+                phase.accType == DataCollector::FAT_WRITE) &&
+                !fileExists(options, phase))
+        {
+            try
+            {
+                synthesize(options, phase, types);
+            } catch (DCException e)
+            {
+                std::cerr << "[" << options.mpiRank << "] " << phase_result.name <<
+                        ": failed to create synthetic file: " << e.what() << std::endl;
+            }
+        }
+
+        replayPhase(options, phase, phase_result, types);
+        results.push_back(phase_result);
+    }
+
+    if (options.mpiRank == 0 && !results.empty())
+        writeText(std::cout, results);
+
+    for (std::map<std::string, ColTypeOpaque*>::iterator iter = opaqueTypes.begin();
+            iter != opaqueTypes.end(); ++iter)
+        delete iter->second;
+
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+    MPI_Finalize();
+#endif
+
+    return result;
+}
@@ -24,6 +24,7 @@
 #include <sstream>
 
 #include "splash/core/DCAttribute.hpp"
+#include "splash/IOStatistics.hpp"
 
 namespace splash
 {
@@ -57,6 +58,9 @@ namespace splash
             H5Aclose(attr);
             throw DCException(getExceptionString(name, "Attribute could not be read"));
         }
+
+        IOStatistics::addTransfer(H5Tget_size(attr_type));
+        H5Tclose(attr_type);
         
         H5Aclose(attr);
     }
@@ -83,6 +87,8 @@ namespace splash
             throw DCException(getExceptionString(name, "Attribute could not be written"));
         }
 
+        IOStatistics::addTransfer(H5Tget_size(type));
+
         H5Aclose(attr);
     }
 
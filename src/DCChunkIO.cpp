@@ -0,0 +1,616 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash. 
+ * 
+ * libSplash is free software: you can redistribute it and/or modify 
+ * it under the terms of of either the GNU General Public License or 
+ * the GNU Lesser General Public License as published by 
+ * the Free Software Foundation, either version 3 of the License, or 
+ * (at your option) any later version. 
+ * libSplash is distributed in the hope that it will be useful, 
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU General Public License and the GNU Lesser General Public License 
+ * for more details. 
+ * 
+ * You should have received a copy of the GNU General Public License 
+ * and the GNU Lesser General Public License along with libSplash. 
+ * If not, see <http://www.gnu.org/licenses/>. 
+ */
+
+#define SPLASH_LOG_CATEGORY splash::LOG_DATASET
+
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <pthread.h>
+#include <zlib.h>
+
+#include "splash/core/DCChunkIO.hpp"
+#include "splash/IOStatistics.hpp"
+#include "splash/core/logging.hpp"
+#include "splash/sdc_defines.hpp"
+
+// bits of the HDF5 filter mask, set if the respective filter was skipped
+#define DC_MASK_SHUFFLE 0x1
+#define DC_MASK_DEFLATE 0x2
+
+namespace splash
+{
+
+    /**
+     * A single (compressed) chunk.
+     */
+    typedef struct
+    {
+        uint8_t *data;
+        size_t size;
+        uint32_t filterMask;
+    } ChunkData;
+
+    /**
+     * Describes a direct chunk transfer between a region of a dataset
+     * and a memory buffer. All arrays are normalized to DSP_DIM_MAX dimensions.
+     */
+    typedef struct
+    {
+        size_t typeSize;
+        int deflateLevel;
+        hsize_t chunkDims[DSP_DIM_MAX];
+        hsize_t numChunks[DSP_DIM_MAX];
+        hsize_t regionOffset[DSP_DIM_MAX];
+        hsize_t regionSize[DSP_DIM_MAX];
+        uint8_t *buffer;
+        hsize_t bufferSize[DSP_DIM_MAX];
+        hsize_t bufferOffset[DSP_DIM_MAX];
+        std::vector<ChunkData> chunks;
+        std::vector<uint8_t> fillValue;
+    } ChunkTransfer;
+
+    /**
+     * Queue of jobs processed by a pool of threads.
+     */
+    typedef struct
+    {
+        size_t numJobs;
+        size_t nextJob;
+        bool success;
+        pthread_mutex_t mutex;
+        bool (*func)(size_t job, void *userData);
+        void *userData;
+    } JobQueue;
+
+    static void normalizeDims(uint32_t ndims, const hsize_t *src, hsize_t *dst,
+            hsize_t fill)
+    {
+        const uint32_t start = DSP_DIM_MAX - ndims;
+        for (uint32_t i = 0; i < DSP_DIM_MAX; ++i)
+            dst[i] = (i < start) ? fill : src[i - start];
+    }
+
+    static size_t getScalarSize(const hsize_t *dims)
+    {
+        size_t size = 1;
+        for (uint32_t i = 0; i < DSP_DIM_MAX; ++i)
+            size *= dims[i];
+        return size;
+    }
+
+    static void getChunkPosition(const ChunkTransfer *transfer, size_t index,
+            hsize_t *offset, hsize_t *extent)
+    {
+        for (int i = DSP_DIM_MAX - 1; i >= 0; --i)
+        {
+            offset[i] = (index % transfer->numChunks[i]) * transfer->chunkDims[i];
+            extent[i] = std::min(transfer->chunkDims[i], transfer->regionSize[i] - offset[i]);
+            index /= transfer->numChunks[i];
+        }
+    }
+
+    /**
+     * Copies a block between two dense row-major buffers.
+     */
+    static void copyBlock(size_t typeSize, const hsize_t *blockSize,
+            const uint8_t *src, const hsize_t *srcDims, const hsize_t *srcOffset,
+            uint8_t *dst, const hsize_t *dstDims, const hsize_t *dstOffset)
+    {
+        const uint32_t last = DSP_DIM_MAX - 1;
+        const size_t row_bytes = blockSize[last] * typeSize;
+
+        size_t num_rows = 1;
+        for (uint32_t i = 0; i < last; ++i)
+            num_rows *= blockSize[i];
+
+        for (size_t row = 0; row < num_rows; ++row)
+        {
+            // linear row index to position within the block, fastest dimension last
+            size_t rest = row;
+            size_t src_index = 0;
+            size_t dst_index = 0;
+            size_t src_stride = srcDims[last];
+            size_t dst_stride = dstDims[last];
+            for (int i = last - 1; i >= 0; --i)
+            {
+                const hsize_t pos = rest % blockSize[i];
+                rest /= blockSize[i];
+
+                src_index += (srcOffset[i] + pos) * src_stride;
+                dst_index += (dstOffset[i] + pos) * dst_stride;
+                src_stride *= srcDims[i];
+                dst_stride *= dstDims[i];
+            }
+            src_index += srcOffset[last];
+            dst_index += dstOffset[last];
+
+            memcpy(dst + dst_index * typeSize, src + src_index * typeSize, row_bytes);
+        }
+    }
+
+    static bool compressChunk(size_t job, void *userData)
+    {
+        ChunkTransfer *transfer = (ChunkTransfer*) userData;
+        ChunkData &chunk = transfer->chunks[job];
+
+        hsize_t chunk_offset[DSP_DIM_MAX], chunk_extent[DSP_DIM_MAX];
+        const hsize_t zero[DSP_DIM_MAX] = {0, 0, 0};
+        getChunkPosition(transfer, job, chunk_offset, chunk_extent);
+
+        const size_t num_elements = getScalarSize(transfer->chunkDims);
+        const size_t chunk_bytes = num_elements * transfer->typeSize;
+
+        uint8_t *raw = new (std::nothrow) uint8_t[chunk_bytes];
+        uint8_t *shuffled = new (std::nothrow) uint8_t[chunk_bytes];
+        uLongf compressed_bytes = compressBound(chunk_bytes);
+        uint8_t *compressed = new (std::nothrow) uint8_t[compressed_bytes];
+
+        if (!raw || !shuffled || !compressed)
+        {
+            delete[] raw;
+            delete[] shuffled;
+            delete[] compressed;
+            return false;
+        }
+
+        // chunks at the end of the dataset are padded
+        if (getScalarSize(chunk_extent) != num_elements)
+            memset(raw, 0, chunk_bytes);
+
+        copyBlock(transfer->typeSize, chunk_extent,
+                transfer->buffer, transfer->regionSize, chunk_offset,
+                raw, transfer->chunkDims, zero);
+
+        // byte shuffling as done by H5Z_FILTER_SHUFFLE
+        for (size_t b = 0; b < transfer->typeSize; ++b)
+            for (size_t i = 0; i < num_elements; ++i)
+                shuffled[b * num_elements + i] = raw[i * transfer->typeSize + b];
+
+        delete[] raw;
+
+        if (compress2(compressed, &compressed_bytes, shuffled, chunk_bytes,
+                transfer->deflateLevel) == Z_OK && compressed_bytes < chunk_bytes)
+        {
+            chunk.data = compressed;
+            chunk.size = compressed_bytes;
+            chunk.filterMask = 0;
+            delete[] shuffled;
+        } else
+        {
+            // the optional deflate filter is skipped if it does not reduce size
+            chunk.data = shuffled;
+            chunk.size = chunk_bytes;
+            chunk.filterMask = DC_MASK_DEFLATE;
+            delete[] compressed;
+        }
+
+        return true;
+    }
+
+    static bool decompressChunk(size_t job, void *userData)
+    {
+        ChunkTransfer *transfer = (ChunkTransfer*) userData;
+        ChunkData &chunk = transfer->chunks[job];
+
+        hsize_t chunk_offset[DSP_DIM_MAX], chunk_extent[DSP_DIM_MAX];
+        hsize_t dst_offset[DSP_DIM_MAX];
+        const hsize_t zero[DSP_DIM_MAX] = {0, 0, 0};
+        getChunkPosition(transfer, job, chunk_offset, chunk_extent);
+
+        for (uint32_t i = 0; i < DSP_DIM_MAX; ++i)
+            dst_offset[i] = transfer->bufferOffset[i] + chunk_offset[i];
+
+        const size_t num_elements = getScalarSize(transfer->chunkDims);
+        const size_t chunk_bytes = num_elements * transfer->typeSize;
+
+        uint8_t *raw = new (std::nothrow) uint8_t[chunk_bytes];
+        uint8_t *unshuffled = new (std::nothrow) uint8_t[chunk_bytes];
+        bool success = (raw != NULL) && (unshuffled != NULL);
+
+        if (success)
+        {
+            if (chunk.data == NULL)
+            {
+                // chunk has not been allocated, use the fill value as H5Dread does
+                for (size_t i = 0; i < num_elements; ++i)
+                    memcpy(unshuffled + i * transfer->typeSize,
+                        &(transfer->fillValue[0]), transfer->typeSize);
+            } else
+            {
+                if (chunk.filterMask & DC_MASK_DEFLATE)
+                {
+                    success = (chunk.size == chunk_bytes);
+                    if (success)
+                        memcpy(raw, chunk.data, chunk_bytes);
+                } else
+                {
+                    uLongf raw_bytes = chunk_bytes;
+                    success = (uncompress(raw, &raw_bytes, chunk.data, chunk.size) == Z_OK) &&
+                            (raw_bytes == chunk_bytes);
+                }
+
+                if (chunk.filterMask & DC_MASK_SHUFFLE)
+                    memcpy(unshuffled, raw, chunk_bytes);
+                else
+                {
+                    for (size_t b = 0; b < transfer->typeSize; ++b)
+                        for (size_t i = 0; i < num_elements; ++i)
+                            unshuffled[i * transfer->typeSize + b] = raw[b * num_elements + i];
+                }
+            }
+        }
+
+        if (success)
+        {
+            copyBlock(transfer->typeSize, chunk_extent,
+                    unshuffled, transfer->chunkDims, zero,
+                    transfer->buffer, transfer->bufferSize, dst_offset);
+        }
+
+        delete[] raw;
+        delete[] unshuffled;
+
+        return success;
+    }
+
+    static void* workerThread(void *param)
+    {
+        JobQueue *queue = (JobQueue*) param;
+
+        while (true)
+        {
+            pthread_mutex_lock(&(queue->mutex));
+            const size_t job = queue->nextJob++;
+            pthread_mutex_unlock(&(queue->mutex));
+
+            if (job >= queue->numJobs)
+                break;
+
+            if (!queue->func(job, queue->userData))
+            {
+                pthread_mutex_lock(&(queue->mutex));
+                queue->success = false;
+                pthread_mutex_unlock(&(queue->mutex));
+            }
+        }
+
+        return NULL;
+    }
+
+    /**
+     * Tests if a dataset is chunked and uses exactly the shuffle and deflate
+     * filters as set by DCDataSet.
+     */
+    static bool getFilterInfo(hid_t dataset, uint32_t ndims, hsize_t *chunkDims,
+            int *deflateLevel)
+    {
+        hid_t dcpl = H5Dget_create_plist(dataset);
+        if (dcpl < 0)
+            return false;
+
+        bool supported = (H5Pget_layout(dcpl) == H5D_CHUNKED) &&
+                (H5Pget_chunk(dcpl, ndims, chunkDims) == (int) ndims) &&
+                (H5Pget_nfilters(dcpl) == 2);
+
+        if (supported)
+        {
+            unsigned int flags = 0;
+            unsigned int cd_values[4];
+            size_t cd_nelmts = 4;
+
+            supported = (H5Pget_filter2(dcpl, 0, &flags, &cd_nelmts, cd_values,
+                    0, NULL, NULL) == H5Z_FILTER_SHUFFLE);
+
+            cd_nelmts = 4;
+            supported = supported && (H5Pget_filter2(dcpl, 1, &flags, &cd_nelmts,
+                    cd_values, 0, NULL, NULL) == H5Z_FILTER_DEFLATE) && (cd_nelmts > 0);
+
+            if (supported)
+                *deflateLevel = cd_values[0];
+        }
+
+        H5Pclose(dcpl);
+        return supported;
+    }
+
+    /**
+     * Reads the fill value of a dataset in its file datatype,
+     * zero if no fill value has been defined.
+     */
+    static bool getFillValue(hid_t dataset, ChunkTransfer &transfer)
+    {
+        transfer.fillValue.assign(transfer.typeSize, 0);
+
+        hid_t dcpl = H5Dget_create_plist(dataset);
+        if (dcpl < 0)
+            return false;
+
+        H5D_fill_value_t status;
+        bool success = (H5Pfill_value_defined(dcpl, &status) >= 0);
+
+        if (success && status != H5D_FILL_VALUE_UNDEFINED)
+        {
+            hid_t datatype = H5Dget_type(dataset);
+            success = (datatype >= 0) &&
+                    (H5Pget_fill_value(dcpl, datatype, &(transfer.fillValue[0])) >= 0);
+            if (datatype >= 0)
+                H5Tclose(datatype);
+        }
+
+        H5Pclose(dcpl);
+        return success;
+    }
+
+#if (DC_DIRECT_CHUNK_IO==1)
+    /**
+     * Returns the stored size of a chunk, zero if it has not been allocated.
+     */
+    static bool getChunkStorageSize(hid_t dataset, const hsize_t *offset,
+            hsize_t &bytes)
+    {
+        bytes = 0;
+#if H5_VERSION_GE(1, 10, 5)
+        unsigned filter_mask = 0;
+        haddr_t address = HADDR_UNDEF;
+        if (H5Dget_chunk_info_by_coord(dataset, offset, &filter_mask,
+                &address, &bytes) < 0)
+            return false;
+
+        if (address == HADDR_UNDEF)
+            bytes = 0;
+        return true;
+#else
+        // fails for unallocated chunks
+        return (H5Dget_chunk_storage_size(dataset, offset, &bytes) >= 0);
+#endif
+    }
+#endif
+
+    /**
+     * Initializes a transfer for a chunk-aligned region of a dataset.
+     */
+    static bool initTransfer(hid_t dataset, uint32_t ndims,
+            const hsize_t *regionOffset, const hsize_t *regionSize,
+            ChunkTransfer &transfer)
+    {
+        if (ndims < 1 || ndims > DSP_DIM_MAX)
+            return false;
+
+        hsize_t chunk_dims[DSP_DIM_MAX];
+        if (!getFilterInfo(dataset, ndims, chunk_dims, &(transfer.deflateLevel)))
+            return false;
+
+        hsize_t dset_dims[DSP_DIM_MAX];
+        hid_t dataspace = H5Dget_space(dataset);
+        if (dataspace < 0)
+            return false;
+
+        bool valid = (H5Sget_simple_extent_dims(dataspace, dset_dims, NULL) == (int) ndims);
+        H5Sclose(dataspace);
+
+        hid_t datatype = H5Dget_type(dataset);
+        if (datatype < 0)
+            return false;
+
+        transfer.typeSize = H5Tget_size(datatype);
+        H5Tclose(datatype);
+
+        // the region must consist of whole chunks (or end at the dataset's end)
+        for (uint32_t i = 0; valid && (i < ndims); ++i)
+        {
+            valid = (regionSize[i] > 0) && (regionOffset[i] % chunk_dims[i] == 0) &&
+                    ((regionSize[i] % chunk_dims[i] == 0) ||
+                    (regionOffset[i] + regionSize[i] == dset_dims[i]));
+        }
+
+        if (!valid || transfer.typeSize == 0)
+            return false;
+
+        normalizeDims(ndims, chunk_dims, transfer.chunkDims, 1);
+        normalizeDims(ndims, regionOffset, transfer.regionOffset, 0);
+        normalizeDims(ndims, regionSize, transfer.regionSize, 1);
+
+        size_t num_chunks = 1;
+        for (uint32_t i = 0; i < DSP_DIM_MAX; ++i)
+        {
+            transfer.numChunks[i] = (transfer.regionSize[i] + transfer.chunkDims[i] - 1) /
+                    transfer.chunkDims[i];
+            num_chunks *= transfer.numChunks[i];
+        }
+
+        ChunkData empty = {NULL, 0, 0};
+        transfer.chunks.assign(num_chunks, empty);
+
+        return true;
+    }
+
+    static void freeChunks(ChunkTransfer &transfer)
+    {
+        for (std::vector<ChunkData>::iterator iter = transfer.chunks.begin();
+                iter != transfer.chunks.end(); ++iter)
+        {
+            delete[] iter->data;
+            iter->data = NULL;
+        }
+    }
+
+    std::string DCChunkIO::getExceptionString(std::string msg)
+    {
+        return (std::string("Exception for DCChunkIO: ") + msg);
+    }
+
+    bool DCChunkIO::runParallel(uint32_t numThreads, size_t numJobs,
+            bool (*func)(size_t job, void *userData), void *userData)
+    {
+        JobQueue queue;
+        queue.numJobs = numJobs;
+        queue.nextJob = 0;
+        queue.success = true;
+        queue.func = func;
+        queue.userData = userData;
+        pthread_mutex_init(&(queue.mutex), NULL);
+
+        if (numThreads > numJobs)
+            numThreads = numJobs;
+
+        // the calling thread is a worker, too
+        std::vector<pthread_t> threads;
+        for (uint32_t i = 1; i < numThreads; ++i)
+        {
+            pthread_t thread;
+            if (pthread_create(&thread, NULL, workerThread, &queue) == 0)
+                threads.push_back(thread);
+        }
+
+        workerThread(&queue);
+
+        for (size_t i = 0; i < threads.size(); ++i)
+            pthread_join(threads[i], NULL);
+
+        pthread_mutex_destroy(&(queue.mutex));
+
+        return queue.success;
+    }
+
+    bool DCChunkIO::writeChunks(hid_t dataset, hid_t dxpl, uint32_t ndims,
+            const hsize_t *dstOffset, const hsize_t *count,
+            const void *data, uint32_t numThreads)
+    throw (DCException)
+    {
+#if (DC_DIRECT_CHUNK_IO==1)
+        ChunkTransfer transfer;
+        if (!initTransfer(dataset, ndims, dstOffset, count, transfer))
+            return false;
+
+        // the dense source buffer matches the region
+        transfer.buffer = (uint8_t*) data;
+
+        log_msg(3, "DCChunkIO::writeChunks (%llu chunks, %u threads)",
+                (long long unsigned) transfer.chunks.size(), numThreads);
+
+        if (!runParallel(numThreads, transfer.chunks.size(), compressChunk, &transfer))
+        {
+            freeChunks(transfer);
+            throw DCException(getExceptionString("writeChunks: Failed to compress chunks"));
+        }
+
+        // HDF5 calls are serialized
+        for (size_t i = 0; i < transfer.chunks.size(); ++i)
+        {
+            hsize_t chunk_offset[DSP_DIM_MAX], chunk_extent[DSP_DIM_MAX];
+            getChunkPosition(&transfer, i, chunk_offset, chunk_extent);
+
+            for (uint32_t d = 0; d < DSP_DIM_MAX; ++d)
+                chunk_offset[d] += transfer.regionOffset[d];
+
+            const ChunkData &chunk = transfer.chunks[i];
+            if (H5Dwrite_chunk(dataset, dxpl, chunk.filterMask,
+                    chunk_offset + (DSP_DIM_MAX - ndims), chunk.size, chunk.data) < 0)
+            {
+                freeChunks(transfer);
+                throw DCException(getExceptionString("writeChunks: Failed to write chunk"));
+            }
+
+            // logical bytes like H5Dwrite, not the compressed size
+            IOStatistics::addTransfer(getScalarSize(chunk_extent) * transfer.typeSize);
+        }
+
+        freeChunks(transfer);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool DCChunkIO::readChunks(hid_t dataset, hid_t dxpl, uint32_t ndims,
+            const hsize_t *srcOffset, const hsize_t *srcSize,
+            const hsize_t *dstBuffer, const hsize_t *dstOffset,
+            void *dst, uint32_t numThreads)
+    throw (DCException)
+    {
+#if (DC_DIRECT_CHUNK_IO==1)
+        ChunkTransfer transfer;
+        if (!initTransfer(dataset, ndims, srcOffset, srcSize, transfer) ||
+                !getFillValue(dataset, transfer))
+            return false;
+
+        transfer.buffer = (uint8_t*) dst;
+        normalizeDims(ndims, dstBuffer, transfer.bufferSize, 1);
+        normalizeDims(ndims, dstOffset, transfer.bufferOffset, 0);
+
+        log_msg(3, "DCChunkIO::readChunks (%llu chunks, %u threads)",
+                (long long unsigned) transfer.chunks.size(), numThreads);
+
+        // HDF5 calls are serialized
+        for (size_t i = 0; i < transfer.chunks.size(); ++i)
+        {
+            hsize_t chunk_offset[DSP_DIM_MAX], chunk_extent[DSP_DIM_MAX];
+            getChunkPosition(&transfer, i, chunk_offset, chunk_extent);
+
+            for (uint32_t d = 0; d < DSP_DIM_MAX; ++d)
+                chunk_offset[d] += transfer.regionOffset[d];
+
+            hsize_t *offset = chunk_offset + (DSP_DIM_MAX - ndims);
+            hsize_t chunk_bytes = 0;
+            ChunkData &chunk = transfer.chunks[i];
+
+            // use the regular filter pipeline if the chunk cannot be queried
+            if (!getChunkStorageSize(dataset, offset, chunk_bytes))
+            {
+                freeChunks(transfer);
+                return false;
+            }
+
+            // unallocated chunks are filled with the fill value when decompressing
+            if (chunk_bytes == 0)
+            {
+                IOStatistics::addTransfer(getScalarSize(chunk_extent) * transfer.typeSize, 0);
+                continue;
+            }
+
+            chunk.data = new uint8_t[chunk_bytes];
+            chunk.size = chunk_bytes;
+
+            if (H5Dread_chunk(dataset, dxpl, offset, &(chunk.filterMask), chunk.data) < 0)
+            {
+                freeChunks(transfer);
+                throw DCException(getExceptionString("readChunks: Failed to read chunk"));
+            }
+
+            IOStatistics::addTransfer(getScalarSize(chunk_extent) * transfer.typeSize);
+        }
+
+        bool success = runParallel(numThreads, transfer.chunks.size(),
+                decompressChunk, &transfer);
+        freeChunks(transfer);
+
+        if (!success)
+            throw DCException(getExceptionString("readChunks: Failed to decompress chunks"));
+
+        return true;
+#else
+        return false;
+#endif
+    }
+
+}
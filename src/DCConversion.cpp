@@ -0,0 +1,577 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstring>
+
+#include "splash/core/DCConversion.hpp"
+
+// number of elements converted at once through temporary buffers
+#define DC_CONVERSION_BLOCK 1024
+
+namespace splash
+{
+
+    enum AtomicKind
+    {
+        AK_INT8, AK_UINT8, AK_INT16, AK_UINT16, AK_INT32, AK_UINT32,
+        AK_INT64, AK_UINT64, AK_FLOAT32, AK_FLOAT64
+    };
+
+    /**
+     * An atomic member of a datatype.
+     */
+    typedef struct
+    {
+        AtomicKind kind;
+        size_t size;
+        size_t offset;
+        bool swap;
+        std::string name;
+    } Member;
+
+    /**
+     * Atomic members of a datatype.
+     */
+    typedef struct
+    {
+        size_t size;
+        bool atomic;
+        std::vector<Member> members;
+    } Layout;
+
+    static bool getAtomic(hid_t type, Member &member)
+    {
+        const size_t size = H5Tget_size(type);
+        const H5T_order_t order = H5Tget_order(type);
+        if (order != H5T_ORDER_LE && order != H5T_ORDER_BE)
+            return false;
+
+        member.size = size;
+        member.offset = 0;
+        member.swap = (size > 1) && (order != H5Tget_order(H5T_NATIVE_INT));
+
+        switch (H5Tget_class(type))
+        {
+            case H5T_INTEGER:
+            {
+                if (H5Tget_precision(type) != size * 8 || H5Tget_offset(type) != 0)
+                    return false;
+
+                const bool is_signed = (H5Tget_sign(type) == H5T_SGN_2);
+                switch (size)
+                {
+                    case 1:
+                        member.kind = is_signed ? AK_INT8 : AK_UINT8;
+                        return true;
+                    case 2:
+                        member.kind = is_signed ? AK_INT16 : AK_UINT16;
+                        return true;
+                    case 4:
+                        member.kind = is_signed ? AK_INT32 : AK_UINT32;
+                        return true;
+                    case 8:
+                        member.kind = is_signed ? AK_INT64 : AK_UINT64;
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+            case H5T_FLOAT:
+                if (H5Tequal(type, H5T_IEEE_F32LE) > 0 || H5Tequal(type, H5T_IEEE_F32BE) > 0)
+                {
+                    member.kind = AK_FLOAT32;
+                    return true;
+                }
+                if (H5Tequal(type, H5T_IEEE_F64LE) > 0 || H5Tequal(type, H5T_IEEE_F64BE) > 0)
+                {
+                    member.kind = AK_FLOAT64;
+                    return true;
+                }
+                return false;
+            default:
+                return false;
+        }
+    }
+
+    static bool getLayout(hid_t type, Layout &layout)
+    {
+        layout.size = H5Tget_size(type);
+        layout.atomic = false;
+        layout.members.clear();
+
+        switch (H5Tget_class(type))
+        {
+            case H5T_COMPOUND:
+            {
+                const int num_members = H5Tget_nmembers(type);
+                if (num_members <= 0)
+                    return false;
+
+                for (int i = 0; i < num_members; ++i)
+                {
+                    Member member;
+                    hid_t member_type = H5Tget_member_type(type, i);
+                    const bool valid = getAtomic(member_type, member);
+                    H5Tclose(member_type);
+                    if (!valid)
+                        return false;
+
+                    member.offset = H5Tget_member_offset(type, i);
+                    char *name = H5Tget_member_name(type, i);
+                    member.name = name;
+                    H5free_memory(name);
+
+                    layout.members.push_back(member);
+                }
+                return true;
+            }
+            case H5T_ARRAY:
+            {
+                Member member;
+                hid_t base_type = H5Tget_super(type);
+                const bool valid = getAtomic(base_type, member);
+                H5Tclose(base_type);
+                if (!valid)
+                    return false;
+
+                for (size_t i = 0; i < layout.size / member.size; ++i)
+                {
+                    member.offset = i * member.size;
+                    layout.members.push_back(member);
+                }
+                return true;
+            }
+            default:
+            {
+                Member member;
+                if (!getAtomic(type, member))
+                    return false;
+
+                layout.atomic = true;
+                layout.members.push_back(member);
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Maps each destination plane or member to a source member.
+     */
+    static bool getMapping(const Layout &src, const Layout &dst,
+            std::vector<size_t> &mapping)
+    {
+        mapping.clear();
+
+        for (size_t i = 0; i < dst.members.size(); ++i)
+            if (dst.members[i].swap)
+                return false;
+
+        if (dst.atomic)
+        {
+            for (size_t i = 0; i < src.members.size(); ++i)
+                mapping.push_back(i);
+            return true;
+        }
+
+        if (src.atomic)
+            return false;
+
+        for (size_t i = 0; i < dst.members.size(); ++i)
+        {
+            const std::string &name = dst.members[i].name;
+            if (name.empty() || src.members[0].name.empty())
+            {
+                // array types are mapped by index
+                if (dst.members.size() != src.members.size())
+                    return false;
+                mapping.push_back(i);
+                continue;
+            }
+
+            size_t j = 0;
+            while (j < src.members.size() && src.members[j].name != name)
+                ++j;
+            if (j == src.members.size())
+                return false;
+            mapping.push_back(j);
+        }
+
+        return true;
+    }
+
+    static inline uint16_t swapBytes16(uint16_t value)
+    {
+        return (uint16_t) ((value >> 8) | (value << 8));
+    }
+
+    static inline uint32_t swapBytes32(uint32_t value)
+    {
+        return ((value >> 24) & 0xffu) | ((value >> 8) & 0xff00u) |
+                ((value << 8) & 0xff0000u) | (value << 24);
+    }
+
+    static inline uint64_t swapBytes64(uint64_t value)
+    {
+        return ((uint64_t) swapBytes32((uint32_t) value) << 32) |
+                swapBytes32((uint32_t) (value >> 32));
+    }
+
+    static void swapBytes(void *data, size_t size, size_t count)
+    {
+        switch (size)
+        {
+            case 2:
+            {
+                uint16_t *values = (uint16_t*) data;
+                for (size_t i = 0; i < count; ++i)
+                    values[i] = swapBytes16(values[i]);
+                break;
+            }
+            case 4:
+            {
+                uint32_t *values = (uint32_t*) data;
+                for (size_t i = 0; i < count; ++i)
+                    values[i] = swapBytes32(values[i]);
+                break;
+            }
+            case 8:
+            {
+                uint64_t *values = (uint64_t*) data;
+                for (size_t i = 0; i < count; ++i)
+                    values[i] = swapBytes64(values[i]);
+                break;
+            }
+        }
+    }
+
+    /**
+     * Casts a value, clamping it to the range of integer destinations.
+     * NaN is converted to 0.
+     */
+    template<typename S, typename D>
+    static inline D clampCast(S value)
+    {
+        if (!std::numeric_limits<D>::is_integer)
+            return (D) value;
+
+        const D min_value = std::numeric_limits<D>::min();
+        const D max_value = std::numeric_limits<D>::max();
+
+        if (!std::numeric_limits<S>::is_integer)
+        {
+            const double tmp = (double) value;
+            if (tmp != tmp)
+                return 0;
+            if (tmp >= (double) max_value)
+                return max_value;
+            if (tmp <= (double) min_value)
+                return min_value;
+            return (D) tmp;
+        }
+
+        if (std::numeric_limits<S>::is_signed)
+        {
+            const int64_t tmp = (int64_t) value;
+            if (std::numeric_limits<D>::is_signed)
+            {
+                if (tmp < (int64_t) min_value)
+                    return min_value;
+                if (tmp > (int64_t) max_value)
+                    return max_value;
+            } else
+            {
+                if (tmp < 0)
+                    return 0;
+                if ((uint64_t) tmp > (uint64_t) max_value)
+                    return max_value;
+            }
+        } else
+        {
+            if ((uint64_t) value > (uint64_t) max_value)
+                return max_value;
+        }
+
+        return (D) value;
+    }
+
+    template<typename S, typename D>
+    static void convertArray(const S *src, D *dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = clampCast<S, D>(src[i]);
+    }
+
+    template<typename S>
+    static void convertFrom(const S *src, AtomicKind dstKind, void *dst, size_t count)
+    {
+        switch (dstKind)
+        {
+            case AK_INT8: convertArray(src, (int8_t*) dst, count);
+                break;
+            case AK_UINT8: convertArray(src, (uint8_t*) dst, count);
+                break;
+            case AK_INT16: convertArray(src, (int16_t*) dst, count);
+                break;
+            case AK_UINT16: convertArray(src, (uint16_t*) dst, count);
+                break;
+            case AK_INT32: convertArray(src, (int32_t*) dst, count);
+                break;
+            case AK_UINT32: convertArray(src, (uint32_t*) dst, count);
+                break;
+            case AK_INT64: convertArray(src, (int64_t*) dst, count);
+                break;
+            case AK_UINT64: convertArray(src, (uint64_t*) dst, count);
+                break;
+            case AK_FLOAT32: convertArray(src, (float*) dst, count);
+                break;
+            case AK_FLOAT64: convertArray(src, (double*) dst, count);
+                break;
+        }
+    }
+
+    static void convertArray(AtomicKind srcKind, const void *src,
+            AtomicKind dstKind, void *dst, size_t count)
+    {
+        switch (srcKind)
+        {
+            case AK_INT8: convertFrom((const int8_t*) src, dstKind, dst, count);
+                break;
+            case AK_UINT8: convertFrom((const uint8_t*) src, dstKind, dst, count);
+                break;
+            case AK_INT16: convertFrom((const int16_t*) src, dstKind, dst, count);
+                break;
+            case AK_UINT16: convertFrom((const uint16_t*) src, dstKind, dst, count);
+                break;
+            case AK_INT32: convertFrom((const int32_t*) src, dstKind, dst, count);
+                break;
+            case AK_UINT32: convertFrom((const uint32_t*) src, dstKind, dst, count);
+                break;
+            case AK_INT64: convertFrom((const int64_t*) src, dstKind, dst, count);
+                break;
+            case AK_UINT64: convertFrom((const uint64_t*) src, dstKind, dst, count);
+                break;
+            case AK_FLOAT32: convertFrom((const float*) src, dstKind, dst, count);
+                break;
+            case AK_FLOAT64: convertFrom((const double*) src, dstKind, dst, count);
+                break;
+        }
+    }
+
+    template<size_t N>
+    static void copyStrided(const char *src, size_t srcStride,
+            char *dst, size_t dstStride, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            memcpy(dst + i * dstStride, src + i * srcStride, N);
+    }
+
+    /**
+     * Copies elements of the same native type between strided buffers.
+     */
+    static void copyStrided(const char *src, size_t srcStride,
+            char *dst, size_t dstStride, size_t size, size_t count)
+    {
+        switch (size)
+        {
+            case 1: copyStrided<1>(src, srcStride, dst, dstStride, count);
+                break;
+            case 2: copyStrided<2>(src, srcStride, dst, dstStride, count);
+                break;
+            case 4: copyStrided<4>(src, srcStride, dst, dstStride, count);
+                break;
+            case 8: copyStrided<8>(src, srcStride, dst, dstStride, count);
+                break;
+            default:
+                for (size_t i = 0; i < count; ++i)
+                    memcpy(dst + i * dstStride, src + i * srcStride, size);
+        }
+    }
+
+    /**
+     * Converts one member of all elements, strided members are
+     * gathered into dense blocks first.
+     */
+    static void convertMember(const char *src, size_t srcStride, const Member &srcMember,
+            char *dst, size_t dstStride, const Member &dstMember, size_t count)
+    {
+        uint64_t src_block[DC_CONVERSION_BLOCK];
+        uint64_t dst_block[DC_CONVERSION_BLOCK];
+
+        if ((srcMember.kind == dstMember.kind) && !srcMember.swap)
+        {
+            copyStrided(src + srcMember.offset, srcStride, dst + dstMember.offset,
+                    dstStride, dstMember.size, count);
+            return;
+        }
+
+        const bool dense_src = (srcStride == srcMember.size) && !srcMember.swap;
+        const bool dense_dst = (dstStride == dstMember.size);
+
+        for (size_t start = 0; start < count; start += DC_CONVERSION_BLOCK)
+        {
+            const size_t n = std::min((size_t) DC_CONVERSION_BLOCK, count - start);
+            const char *src_ptr = src + start * srcStride + srcMember.offset;
+            char *dst_ptr = dst + start * dstStride + dstMember.offset;
+
+            const void *block_src = src_ptr;
+            if (!dense_src)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    memcpy((char*) src_block + i * srcMember.size,
+                        src_ptr + i * srcStride, srcMember.size);
+
+                if (srcMember.swap)
+                    swapBytes(src_block, srcMember.size, n);
+                block_src = src_block;
+            }
+
+            void *block_dst = dense_dst ? (void*) dst_ptr : (void*) dst_block;
+            if (srcMember.kind == dstMember.kind)
+                memcpy(block_dst, block_src, n * dstMember.size);
+            else
+                convertArray(srcMember.kind, block_src, dstMember.kind, block_dst, n);
+
+            if (!dense_dst)
+            {
+                for (size_t i = 0; i < n; ++i)
+                    memcpy(dst_ptr + i * dstStride,
+                        (char*) dst_block + i * dstMember.size, dstMember.size);
+            }
+        }
+    }
+
+    bool DCConversion::isSupported(hid_t srcType, hid_t dstType, uint32_t &planes)
+    {
+        Layout src_layout, dst_layout;
+        std::vector<size_t> mapping;
+
+        if (!getLayout(srcType, src_layout) || !getLayout(dstType, dst_layout) ||
+                !getMapping(src_layout, dst_layout, mapping))
+            return false;
+
+        planes = dst_layout.atomic ? src_layout.members.size() : 1;
+        return true;
+    }
+
+    void DCConversion::convert(hid_t srcType, const void *src,
+            hid_t dstType, void *dst, size_t count)
+    {
+        Layout src_layout, dst_layout;
+        std::vector<size_t> mapping;
+
+        getLayout(srcType, src_layout);
+        getLayout(dstType, dst_layout);
+        getMapping(src_layout, dst_layout, mapping);
+
+        for (size_t i = 0; i < mapping.size(); ++i)
+        {
+            const Member &src_member = src_layout.members[mapping[i]];
+            if (dst_layout.atomic)
+            {
+                // one plane per source member
+                convertMember((const char*) src, src_layout.size, src_member,
+                        (char*) dst + i * count * dst_layout.size, dst_layout.size,
+                        dst_layout.members[0], count);
+            } else
+            {
+                convertMember((const char*) src, src_layout.size, src_member,
+                        (char*) dst, dst_layout.size, dst_layout.members[i], count);
+            }
+        }
+    }
+
+    bool DCConversion::getComponents(hid_t type, uint32_t &components)
+    {
+        Layout layout;
+        if (!getLayout(type, layout) || layout.atomic)
+            return false;
+
+        for (size_t i = 0; i < layout.members.size(); ++i)
+            if (layout.members[i].swap)
+                return false;
+
+        components = layout.members.size();
+        return true;
+    }
+
+    void DCConversion::interleave(hid_t type, const void* const* components,
+            uint32_t ndims, const hsize_t *size, const hsize_t *offset,
+            const hsize_t *stride, const hsize_t *count, void *dst)
+    {
+        Layout layout;
+        getLayout(type, layout);
+
+        // selected rows in the fastest dimension
+        const uint32_t last = ndims - 1;
+        size_t rows = 1;
+        for (uint32_t d = 0; d < last; ++d)
+            rows *= count[d];
+
+        if (rows * count[last] == 0)
+            return;
+
+        std::vector<size_t> pitch(ndims, 1);
+        for (uint32_t d = last; d > 0; --d)
+            pitch[d - 1] = pitch[d] * size[d];
+
+        std::vector<hsize_t> index(ndims, 0);
+        char *dst_ptr = (char*) dst;
+
+        for (size_t row = 0; row < rows; ++row)
+        {
+            size_t src_index = offset[last];
+            for (uint32_t d = 0; d < last; ++d)
+                src_index += (offset[d] + index[d] * stride[d]) * pitch[d];
+
+            // interleave blocks of all members to stay in cache
+            for (size_t start = 0; start < count[last]; start += DC_CONVERSION_BLOCK)
+            {
+                const size_t n = std::min((size_t) DC_CONVERSION_BLOCK,
+                        (size_t) count[last] - start);
+                const size_t first = src_index + start * stride[last];
+
+                for (size_t m = 0; m < layout.members.size(); ++m)
+                {
+                    const Member &member = layout.members[m];
+                    copyStrided((const char*) components[m] + first * member.size,
+                            stride[last] * member.size,
+                            dst_ptr + start * layout.size + member.offset,
+                            layout.size, member.size, n);
+                }
+            }
+
+            dst_ptr += count[last] * layout.size;
+
+            for (uint32_t d = last; d > 0; --d)
+            {
+                if (++index[d - 1] < count[d - 1])
+                    break;
+                index[d - 1] = 0;
+            }
+        }
+    }
+
+}
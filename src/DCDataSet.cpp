@@ -19,21 +19,35 @@
  * If not, see <http://www.gnu.org/licenses/>. 
  */
 
-
+#define SPLASH_LOG_CATEGORY splash::LOG_DATASET
 
 #include <string>
 #include <sstream>
+#include <vector>
+#include <cstring>
 #include <cassert>
+#include <algorithm>
 
 #include "splash/sdc_defines.hpp"
 
 #include "splash/core/DCDataSet.hpp"
 #include "splash/core/DCAttribute.hpp"
 #include "splash/core/DCHelper.hpp"
+#include "splash/core/DCChunkIO.hpp"
+#include "splash/core/DCConversion.hpp"
+#include "splash/core/DCVerifier.hpp"
 #include "splash/core/logging.hpp"
 #include "splash/DCException.hpp"
+#include "splash/IOStatistics.hpp"
+#include "splash/Tracing.hpp"
 #include "splash/basetypes/ColTypeDim.hpp"
 
+// maximum size in bytes of slabs interleaved by DCDataSet::writeComponents
+#define DC_COMPONENT_SLAB_SIZE (4 * 1024 * 1024)
+
+// maximum size in bytes of gathered data checksummed at once
+#define DC_CHECKSUM_BUFFER_SIZE (16 * 1024 * 1024)
+
 namespace splash
 {
 
@@ -75,15 +89,23 @@ namespace splash
     dataset(-1),
     datatype(-1),
     logicalSize(),
+    chunkDims(0, 0, 0),
     ndims(0),
     name(name),
     opened(false),
     isReference(false),
     checkExistence(true),
     compression(false),
+    contiguous(false),
+    directChunkThreads(0),
+    memType(-1),
+    checksums(false),
+    hasChecksum(false),
+    checksum(0),
     dimType()
     {
         dsetProperties = H5Pcreate(H5P_DATASET_CREATE);
+        dsetAccProperties = H5P_DATASET_ACCESS_DEFAULT;
         dsetWriteProperties = H5P_DEFAULT;
         dsetReadProperties = H5P_DEFAULT;
     }
@@ -116,7 +138,7 @@ namespace splash
         if (checkExistence && !H5Lexists(group, name.c_str(), H5P_LINK_ACCESS_DEFAULT))
             return false;
 
-        dataset = H5Dopen(group, name.c_str(), H5P_DATASET_ACCESS_DEFAULT);
+        dataset = H5Dopen(group, name.c_str(), dsetAccProperties);
 
         if (dataset < 0)
             throw DCException(getExceptionString("open: Failed to open dataset"));
@@ -128,6 +150,20 @@ namespace splash
             throw DCException(getExceptionString("open: Failed to get type of dataset"));
         }
 
+        try
+        {
+            storage.readAttribute(dataset);
+
+            // stored checksums are removed by partial writes, even if disabled
+            hasChecksum = (H5Aexists(dataset, SDC_ATTR_CHECKSUM) > 0);
+            if (hasChecksum && checksums)
+                DCAttribute::readAttribute(SDC_ATTR_CHECKSUM, dataset, &checksum);
+        } catch (DCException)
+        {
+            H5Dclose(dataset);
+            throw;
+        }
+
         dataspace = H5Dget_space(dataset);
         if (dataspace < 0)
         {
@@ -142,9 +178,16 @@ namespace splash
             throw DCException(getExceptionString("open: Failed to get dimensions"));
         }
 
+        if (dims_result > DSP_DIM_MAX)
+        {
+            close();
+            throw DCException(getExceptionString("open: Too many dimensions"));
+        }
+
         ndims = dims_result;
 
         getLogicalSize().set(1, 1, 1);
+        getLogicalSize().setRank(ndims, 1);
         if (H5Sget_simple_extent_dims(dataspace, getLogicalSize().getPointer(), NULL) < 0)
         {
             close();
@@ -165,8 +208,18 @@ namespace splash
         {
             // get chunking dimensions
             hsize_t chunk_dims[ndims];
-            DCHelper::getOptimalChunkDims(getPhysicalSize().getPointer(), ndims,
-                    typeSize, chunk_dims);
+            if (chunkDims.getScalarSize() != 0)
+            {
+                Dimensions physical_chunk_dims(chunkDims);
+                physical_chunk_dims.swapDims(ndims);
+
+                for (size_t i = 0; i < ndims; ++i)
+                    chunk_dims[i] = physical_chunk_dims[i];
+            } else
+            {
+                DCHelper::getOptimalChunkDims(getPhysicalSize().getPointer(), ndims,
+                        typeSize, chunk_dims);
+            }
 
             if (H5Pset_chunk(this->dsetProperties, ndims, chunk_dims) < 0)
             {
@@ -193,30 +246,174 @@ namespace splash
         }
     }
 
+    void DCDataSet::setChunkDims(const Dimensions chunkDims)
+    {
+        this->chunkDims.set(chunkDims);
+    }
+
+    void DCDataSet::setContiguous(bool contiguous)
+    {
+        this->contiguous = contiguous;
+    }
+
+    void DCDataSet::setDirectChunkIO(uint32_t numThreads)
+    {
+        this->directChunkThreads = numThreads;
+    }
+
+    void DCDataSet::setMemoryType(hid_t memType)
+    {
+        this->memType = memType;
+    }
+
+    void DCDataSet::setChecksums(bool checksums)
+    {
+        this->checksums = checksums;
+    }
+
+    /**
+     * Checksum of data gathered by H5Dgather.
+     */
+    typedef struct
+    {
+        uint32_t checksum;
+        uint32_t numThreads;
+    } GatherChecksum;
+
+    static herr_t gatherChecksum(const void *dstBuf, size_t dstBufBytesUsed, void *opData)
+    {
+        GatherChecksum *gather = (GatherChecksum*) opData;
+        gather->checksum = DCVerifier::updateChecksum(gather->checksum, dstBuf,
+                dstBufBytesUsed, gather->numThreads);
+        return 0;
+    }
+
+    uint32_t DCDataSet::getChecksum(hid_t space, const void* data, uint32_t initial)
+    throw (DCException)
+    {
+        GatherChecksum gather;
+        gather.checksum = initial;
+        gather.numThreads = std::max(directChunkThreads, (uint32_t) 1);
+
+        const size_t type_size = H5Tget_size(this->datatype);
+        const hssize_t num_selected = H5Sget_select_npoints(space);
+        if (num_selected <= 0)
+            return initial;
+
+        // dense buffers are checksummed in place
+        if (num_selected == H5Sget_simple_extent_npoints(space))
+            return DCVerifier::updateChecksum(initial, data, num_selected * type_size,
+                gather.numThreads);
+
+        std::vector<char> buffer(std::min((size_t) num_selected * type_size,
+                std::max((size_t) DC_CHECKSUM_BUFFER_SIZE, type_size)));
+        buffer.resize(buffer.size() - buffer.size() % type_size);
+        if (H5Dgather(space, data, this->datatype, buffer.size(), &(buffer[0]),
+                gatherChecksum, &gather) < 0)
+            throw DCException(getExceptionString("getChecksum: Failed to gather data"));
+
+        return gather.checksum;
+    }
+
+    bool DCDataSet::isComplete(const Dimensions size, const Dimensions offset)
+    {
+        const Dimensions physical_size(getPhysicalSize());
+        for (uint32_t i = 0; i < ndims; ++i)
+        {
+            if ((offset[i] != 0) || (size[i] != physical_size[i]))
+                return false;
+        }
+
+        return true;
+    }
+
+    void DCDataSet::setChecksumAttribute(bool valid, uint32_t value)
+    throw (DCException)
+    {
+        if (valid && checksums)
+        {
+            DCAttribute::writeAttribute(SDC_ATTR_CHECKSUM, H5T_NATIVE_UINT32,
+                    dataset, &value);
+            hasChecksum = true;
+            checksum = value;
+        } else if (hasChecksum)
+        {
+            if (H5Adelete(dataset, SDC_ATTR_CHECKSUM) < 0)
+                throw DCException(getExceptionString("write: Failed to remove checksum"));
+            hasChecksum = false;
+        }
+    }
+
+    void DCDataSet::verifyChecksum(const Dimensions srcSize, const Dimensions srcOffset,
+            const Dimensions dstBuffer, const Dimensions dstOffset, const void* data)
+    throw (DCException)
+    {
+        if (!checksums || !hasChecksum || !isComplete(srcSize, srcOffset))
+            return;
+
+        bool dense = true;
+        for (uint32_t i = 0; i < ndims; ++i)
+            dense = dense && (dstOffset[i] == 0) && (dstBuffer[i] == srcSize[i]);
+
+        uint32_t data_checksum = 0;
+        if (dense)
+            data_checksum = DCVerifier::updateChecksum(0, data,
+                srcSize.getScalarSize() * H5Tget_size(this->datatype),
+                std::max(directChunkThreads, (uint32_t) 1));
+        else
+        {
+            hid_t dst_dataspace = H5Screate_simple(ndims, dstBuffer.getPointer(), NULL);
+            if (dst_dataspace < 0 || H5Sselect_hyperslab(dst_dataspace, H5S_SELECT_SET,
+                    dstOffset.getPointer(), NULL, srcSize.getPointer(), NULL) < 0)
+                throw DCException(getExceptionString("read: Failed to create target dataspace"));
+
+            data_checksum = getChecksum(dst_dataspace, data, 0);
+            H5Sclose(dst_dataspace);
+        }
+
+        if (data_checksum != checksum)
+            throw DCException(getExceptionString("read: Checksum mismatch, data is corrupted"));
+    }
+
     void DCDataSet::create(const CollectionType& colType,
             hid_t group, const Dimensions size, uint32_t ndims,
             bool compression, bool extensible)
     throw (DCException)
     {
+        Tracing::Scope trace("dataset", "DCDataSet::create", name.c_str());
+
         log_msg(2, "DCDataSet::create (%s, size %s)", name.c_str(), size.toString().c_str());
 
         if (opened)
             throw DCException(getExceptionString("create: dataset is already open"));
 
         // if the dataset already exists, remove/unlink it
-        // note that this won't free the memory occupied by this
-        // dataset, however, there currently is no function to delete
-        // a dataset
+        // note that the space occupied by this dataset is only reused
+        // if the file tracks free space (FileCreationAttr::trackFreeSpace),
+        // otherwise it can only be reclaimed by repacking the file
         if (!checkExistence || (checkExistence && H5Lexists(group, name.c_str(), H5P_LINK_ACCESS_DEFAULT)))
             H5Ldelete(group, name.c_str(), H5P_LINK_ACCESS_DEFAULT);
 
         this->ndims = ndims;
         this->compression = compression;
-        this->datatype = colType.getDataType();
+        this->hasChecksum = false;
+
+        // data may be stored with a different datatype than in memory
+        const ColTypeStorage *storage_type = colType.getStorage();
+        if (storage_type)
+        {
+            storage.set(*storage_type);
+            this->datatype = storage_type->getStorageType();
+        } else
+        {
+            storage.reset();
+            this->datatype = colType.getDataType();
+        }
 
         getLogicalSize().set(size);
 
-        setChunking(colType.getSize());
+        if (!this->contiguous || compression || extensible)
+            setChunking(H5Tget_size(this->datatype));
         setCompression();
 
         if (getPhysicalSize().getScalarSize() != 0)
@@ -244,11 +441,14 @@ namespace splash
 
         // create the new dataset
         dataset = H5Dcreate(group, this->name.c_str(), this->datatype, dataspace,
-                H5P_DEFAULT, dsetProperties, H5P_DEFAULT);
+                H5P_DEFAULT, dsetProperties, dsetAccProperties);
 
         if (dataset < 0)
             throw DCException(getExceptionString("create: Failed to create dataset"));
 
+        if (!storage.isNative())
+            storage.writeAttribute(dataset);
+
         isReference = false;
         opened = true;
     }
@@ -285,6 +485,8 @@ namespace splash
                 dsetWriteProperties, &regionRef) < 0)
             throw DCException(getExceptionString("createReference: failed to write reference"));
 
+        IOStatistics::addTransfer(H5Tget_size(H5T_STD_REF_OBJ));
+
         isReference = true;
         opened = true;
     }
@@ -307,7 +509,7 @@ namespace splash
         this->ndims = srcDataSet.getNDims();
 
         count.swapDims(this->ndims);
-        offset.swapDims(this->ndims);
+        offset.swapDims(this->ndims, 0);
         stride.swapDims(this->ndims);
 
         // select region hyperslab in source dataset
@@ -336,6 +538,8 @@ namespace splash
                 dsetWriteProperties, &regionRef) < 0)
             throw DCException(getExceptionString("createReference: failed to write reference"));
 
+        IOStatistics::addTransfer(H5Tget_size(H5T_STD_REF_DSETREG));
+
         isReference = true;
         opened = true;
     }
@@ -364,11 +568,30 @@ namespace splash
         return dataspace;
     }
 
+    bool DCDataSet::isDataType(const CollectionType& colType) throw (DCException)
+    {
+        if (!opened)
+            throw DCException(getExceptionString("isDataType: dataset is not opened"));
+
+        const ColTypeStorage *storage_type = colType.getStorage();
+        if (storage_type)
+        {
+            return !storage.isNative() &&
+                    (storage_type->getMemoryType() == storage.getMemoryType()) &&
+                    (H5Tequal(storage_type->getStorageType(), datatype) > 0);
+        }
+
+        return storage.isNative() && (H5Tequal(colType.getDataType(), datatype) > 0);
+    }
+
     DCDataType DCDataSet::getDCDataType() throw (DCException)
     {
         if (!opened)
             throw DCException(getExceptionString("getDCDataType: dataset is not opened"));
 
+        if (!storage.isNative())
+            return storage.getMemoryType();
+
         DCDataType result = DCDT_UNKNOWN;
 
         H5T_class_t type_class = H5Tget_class(datatype);
@@ -410,6 +633,9 @@ namespace splash
         if (!opened)
             throw DCException(getExceptionString("getDataTypeSize: dataset is not opened"));
 
+        if (!storage.isNative())
+            return storage.getMemorySize();
+
         size_t size = H5Tget_size(this->datatype);
         if (size == 0)
             throw DCException(getExceptionString("getDataTypeSize: could not get size of datatype"));
@@ -417,6 +643,47 @@ namespace splash
         return size;
     }
 
+    uint64_t DCDataSet::getSelectedBytes()
+    {
+        const hssize_t points = H5Sget_select_npoints(dataspace);
+        if (points <= 0)
+            return 0;
+
+        return (uint64_t) points * H5Tget_size(this->datatype);
+    }
+
+    haddr_t DCDataSet::getRawDataOffset()
+    throw (DCException)
+    {
+        if (!opened)
+            throw DCException(getExceptionString("getRawDataOffset: dataset is not opened"));
+
+        if (!storage.isNative())
+            throw DCException(getExceptionString("getRawDataOffset: dataset uses a storage type"));
+
+        hid_t dcpl = H5Dget_create_plist(dataset);
+        if (dcpl < 0)
+            throw DCException(getExceptionString("getRawDataOffset: failed to get creation properties"));
+
+        const H5D_layout_t layout = H5Pget_layout(dcpl);
+        H5Pclose(dcpl);
+        if (layout != H5D_CONTIGUOUS)
+            throw DCException(getExceptionString("getRawDataOffset: dataset is not contiguous"));
+
+        hid_t native_type = H5Tget_native_type(datatype, H5T_DIR_ASCEND);
+        const bool is_native = (native_type >= 0) && (H5Tequal(native_type, datatype) > 0);
+        if (native_type >= 0)
+            H5Tclose(native_type);
+        if (!is_native)
+            throw DCException(getExceptionString("getRawDataOffset: datatype is not native"));
+
+        const haddr_t offset = H5Dget_offset(dataset);
+        if (offset == HADDR_UNDEF)
+            throw DCException(getExceptionString("getRawDataOffset: raw data is not allocated"));
+
+        return offset;
+    }
+
     std::string DCDataSet::getName()
     {
         return name;
@@ -442,6 +709,8 @@ namespace splash
             void* dst)
     throw (DCException)
     {
+        Tracing::Scope trace("dataset", "DCDataSet::read", name.c_str());
+
         log_msg(2, "DCDataSet::read (%s)", name.c_str());
 
         if (!opened)
@@ -472,9 +741,38 @@ namespace splash
                     srcOffset.toString().c_str());
 
             dstBuffer.swapDims(ndims);
-            dstOffset.swapDims(ndims);
+            dstOffset.swapDims(ndims, 0);
             srcSize.swapDims(ndims);
-            srcOffset.swapDims(ndims);
+            srcOffset.swapDims(ndims, 0);
+
+            // datatype passed to HDF5
+            hid_t mem_type = this->datatype;
+            if (!storage.isNative() ||
+                    ((memType >= 0) && (H5Tequal(memType, this->datatype) <= 0)))
+            {
+                if (readConverted(dstBuffer, dstOffset, srcSize, srcOffset, dst))
+                {
+                    srcSize.swapDims(ndims);
+                    sizeRead.set(srcSize);
+                    srcNDims = this->ndims;
+                    return;
+                }
+
+                // not supported by libSplash, HDF5 converts
+                mem_type = memType;
+            }
+
+            if ((mem_type == this->datatype) && (directChunkThreads > 0) &&
+                    DCChunkIO::readChunks(dataset, dsetReadProperties, ndims,
+                    srcOffset.getPointer(), srcSize.getPointer(), dstBuffer.getPointer(),
+                    dstOffset.getPointer(), dst, directChunkThreads))
+            {
+                verifyChecksum(srcSize, srcOffset, dstBuffer, dstOffset, dst);
+                srcSize.swapDims(ndims);
+                sizeRead.set(srcSize);
+                srcNDims = this->ndims;
+                return;
+            }
 
             hid_t dst_dataspace = H5Screate_simple(ndims, dstBuffer.getPointer(), NULL);
             if (dst_dataspace < 0)
@@ -493,11 +791,17 @@ namespace splash
             if (srcSize.getScalarSize() == 0)
                 H5Sselect_none(dataspace);
             
-            if (H5Dread(dataset, this->datatype, dst_dataspace, dataspace, dsetReadProperties, dst) < 0)
+            if (H5Dread(dataset, mem_type, dst_dataspace, dataspace, dsetReadProperties, dst) < 0)
                 throw DCException(getExceptionString("read: Failed to read dataset"));
 
+            IOStatistics::addTransfer(getSelectedBytes());
+
             H5Sclose(dst_dataspace);
 
+            // data converted by HDF5 cannot be verified
+            if (mem_type == this->datatype)
+                verifyChecksum(srcSize, srcOffset, dstBuffer, dstOffset, dst);
+
             srcSize.swapDims(ndims);
         }
 
@@ -509,12 +813,254 @@ namespace splash
         log_msg(3, " returns sizeRead = %s", sizeRead.toString().c_str());
     }
 
+    void DCDataSet::readComponents(Dimensions dstBuffer,
+            Dimensions dstOffset,
+            Dimensions srcSize,
+            Dimensions srcOffset,
+            Dimensions& sizeRead,
+            uint32_t& srcNDims,
+            void* const* components)
+    throw (DCException)
+    {
+        Tracing::Scope trace("dataset", "DCDataSet::readComponents", name.c_str());
+
+        log_msg(2, "DCDataSet::readComponents (%s)", name.c_str());
+
+        if (!opened)
+            throw DCException(getExceptionString("readComponents: Dataset has not been opened/created"));
+
+        const hid_t src_type = storage.isNative() ? this->datatype : storage.getMemoryH5Type();
+        uint32_t planes = 0;
+        if ((memType < 0) || (H5Tget_class(memType) == H5T_COMPOUND) ||
+                (H5Tget_class(memType) == H5T_ARRAY) ||
+                !DCConversion::isSupported(src_type, memType, planes))
+            throw DCException(getExceptionString("readComponents: Conversion to component datatype is not supported"));
+
+        if (dstBuffer.getScalarSize() == 0)
+            dstBuffer.set(srcSize);
+
+        if ((components != NULL) && (getNDims() > 0))
+        {
+            dstBuffer.swapDims(ndims);
+            dstOffset.swapDims(ndims, 0);
+            srcSize.swapDims(ndims);
+            srcOffset.swapDims(ndims, 0);
+
+            readConverted(dstBuffer, dstOffset, srcSize, srcOffset, NULL, components);
+
+            srcSize.swapDims(ndims);
+        }
+
+        sizeRead.set(srcSize);
+        srcNDims = this->ndims;
+    }
+
+    /**
+     * Source buffer for H5Dscatter.
+     */
+    typedef struct
+    {
+        const void *data;
+        size_t size;
+    } ScatterSource;
+
+    /**
+     * Provides the complete source buffer to H5Dscatter at once.
+     */
+    static herr_t scatterSource(const void **srcBuf, size_t *srcBufBytesUsed, void *opData)
+    {
+        ScatterSource *source = (ScatterSource*) opData;
+        *srcBuf = source->data;
+        *srcBufBytesUsed = source->size;
+        return 0;
+    }
+
+    bool DCDataSet::readConverted(const Dimensions dstBuffer,
+            const Dimensions dstOffset,
+            const Dimensions srcSize,
+            const Dimensions srcOffset,
+            void* dst,
+            void* const* dstPlanes)
+    throw (DCException)
+    {
+        // datatype of the read data after converting from the storage datatype
+        const hid_t src_type = storage.isNative() ? this->datatype : storage.getMemoryH5Type();
+        const hid_t dst_type = (memType >= 0) ? memType : src_type;
+        const bool convert = (H5Tequal(src_type, dst_type) <= 0);
+
+        uint32_t planes = 1;
+        if (convert && !DCConversion::isSupported(src_type, dst_type, planes))
+        {
+            if (storage.isNative())
+                return false;
+
+            throw DCException(getExceptionString("read: Conversion to memory datatype is not supported"));
+        }
+
+        const size_t count = srcSize.getScalarSize();
+        const size_t storage_size = H5Tget_size(this->datatype);
+        std::vector<char> stored(count * storage_size + 1);
+
+        // read the stored data densely
+        if ((count == 0) || (directChunkThreads == 0) ||
+                !DCChunkIO::readChunks(dataset, dsetReadProperties, ndims,
+                srcOffset.getPointer(), srcSize.getPointer(), srcSize.getPointer(),
+                Dimensions(0, 0, 0).getPointer(), &(stored[0]), directChunkThreads))
+        {
+            hid_t dsp_dst = H5Screate_simple(ndims, srcSize.getPointer(), NULL);
+            if (dsp_dst < 0)
+                throw DCException(getExceptionString("read: Failed to create target dataspace"));
+
+            if (H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, srcOffset.getPointer(), NULL,
+                    srcSize.getPointer(), NULL) < 0 ||
+                    H5Sselect_valid(dataspace) <= 0)
+                throw DCException(getExceptionString("read: Source dataspace hyperslab selection is not valid!"));
+
+            if (count == 0)
+            {
+                H5Sselect_none(dataspace);
+                H5Sselect_none(dsp_dst);
+            }
+
+            if (H5Dread(dataset, this->datatype, dsp_dst, dataspace, dsetReadProperties,
+                    &(stored[0])) < 0)
+                throw DCException(getExceptionString("read: Failed to read dataset"));
+
+            IOStatistics::addTransfer(getSelectedBytes());
+
+            H5Sclose(dsp_dst);
+        }
+
+        if (count == 0)
+            return true;
+
+        verifyChecksum(srcSize, srcOffset, srcSize, Dimensions(0, 0, 0), &(stored[0]));
+
+        std::vector<char> converted;
+        if (!storage.isNative())
+        {
+            converted.resize(count * storage.getMemorySize());
+            storage.fromStorage(&(stored[0]), &(converted[0]), count, this->datatype);
+            stored.swap(converted);
+        }
+
+        const size_t dst_type_size = H5Tget_size(dst_type);
+        if (convert)
+        {
+            converted.resize(count * dst_type_size * planes);
+            DCConversion::convert(src_type, &(stored[0]), dst_type, &(converted[0]), count);
+            stored.swap(converted);
+        }
+
+        // scatter the converted data into the selection of the target buffer,
+        // planes are stored one after another or in separate buffers
+        hid_t dst_dataspace = H5Screate_simple(ndims, dstBuffer.getPointer(), NULL);
+        if (dst_dataspace < 0)
+            throw DCException(getExceptionString("read: Failed to create target dataspace"));
+
+        if (H5Sselect_hyperslab(dst_dataspace, H5S_SELECT_SET, dstOffset.getPointer(), NULL,
+                srcSize.getPointer(), NULL) < 0 ||
+                H5Sselect_valid(dst_dataspace) <= 0)
+            throw DCException(getExceptionString("read: Target dataspace hyperslab selection is not valid!"));
+
+        const size_t plane_size = dstBuffer.getScalarSize() * dst_type_size;
+        for (uint32_t plane = 0; plane < planes; ++plane)
+        {
+            ScatterSource source;
+            source.data = &(stored[plane * count * dst_type_size]);
+            source.size = count * dst_type_size;
+
+            void *plane_dst = dstPlanes ? dstPlanes[plane] : (char*) dst + plane * plane_size;
+            if (H5Dscatter(scatterSource, &source, dst_type, dst_dataspace, plane_dst) < 0)
+                throw DCException(getExceptionString("read: Failed to scatter converted data"));
+        }
+
+        H5Sclose(dst_dataspace);
+        return true;
+    }
+
+    hid_t DCDataSet::createSourceSpace(const Selection &srcSelect)
+    throw (DCException)
+    {
+        hid_t dsp_src = H5Screate_simple(srcSelect.getSourceRank(ndims),
+                srcSelect.size.getPointer(), NULL);
+        if (dsp_src < 0)
+            throw DCException(getExceptionString("write: Failed to create source dataspace"));
+
+        if (srcSelect.pointRank > 0)
+        {
+            // point list, gathered in the given order
+            const size_t num_points = srcSelect.points.size() / srcSelect.pointRank;
+            if (num_points == 0)
+                H5Sselect_none(dsp_src);
+            else if (H5Sselect_elements(dsp_src, H5S_SELECT_SET, num_points,
+                    &(srcSelect.points[0])) < 0)
+                throw DCException(getExceptionString("write: Invalid source point selection"));
+        } else if (!srcSelect.hyperslabs.empty())
+        {
+            // union of hyperslabs
+            for (size_t i = 0; i < srcSelect.hyperslabs.size(); ++i)
+            {
+                const Selection::Hyperslab &hyperslab = srcSelect.hyperslabs[i];
+                if (H5Sselect_hyperslab(dsp_src, (i == 0) ? H5S_SELECT_SET : H5S_SELECT_OR,
+                        hyperslab.offset.getPointer(), hyperslab.stride.getPointer(),
+                        hyperslab.count.getPointer(), NULL) < 0)
+                    throw DCException(getExceptionString("write: Invalid source hyperslap selection"));
+            }
+        } else if ((srcSelect.offset.getScalarSize() != 0) || (srcSelect.count != srcSelect.size) ||
+                (srcSelect.stride.getScalarSize() != 1))
+        {
+            // select hyperslap only if necessary
+            if (H5Sselect_hyperslab(dsp_src, H5S_SELECT_SET, srcSelect.offset.getPointer(),
+                    srcSelect.stride.getPointer(), srcSelect.count.getPointer(), NULL) < 0)
+                throw DCException(getExceptionString("write: Invalid source hyperslap selection"));
+        }
+
+        if (H5Sselect_valid(dsp_src) <= 0)
+            throw DCException(getExceptionString("write: Invalid source hyperslap selection"));
+
+        if (srcSelect.isScattered() &&
+                ((hsize_t) H5Sget_select_npoints(dsp_src) != srcSelect.count.getScalarSize()))
+            throw DCException(getExceptionString("write: Number of selected source elements does not match count"));
+
+        return dsp_src;
+    }
+
+    void DCDataSet::convertForWrite(const Selection srcSelect, const void* data,
+            std::vector<char> &converted)
+    throw (DCException)
+    {
+        const size_t count = srcSelect.count.getScalarSize();
+        const void *src = data;
+
+        // gather selected elements unless the source is dense already
+        std::vector<char> gathered;
+        if (srcSelect.isScattered() || (srcSelect.offset.getScalarSize() != 0) ||
+                (srcSelect.count != srcSelect.size) || (srcSelect.stride.getScalarSize() != 1))
+        {
+            hid_t dsp_src = createSourceSpace(srcSelect);
+
+            gathered.resize(count * storage.getMemorySize());
+            if (H5Dgather(dsp_src, data, storage.getMemoryH5Type(), gathered.size(),
+                    &(gathered[0]), NULL, NULL) < 0)
+                throw DCException(getExceptionString("write: Failed to gather source data"));
+
+            H5Sclose(dsp_src);
+            src = &(gathered[0]);
+        }
+
+        converted.resize(count * H5Tget_size(this->datatype));
+        storage.toStorage(src, &(converted[0]), count, this->datatype);
+    }
+
     void DCDataSet::write(
             Selection srcSelect,
             Dimensions dstOffset,
             const void* data)
     throw (DCException)
     {
+        Tracing::Scope trace("dataset", "DCDataSet::write", name.c_str());
+
         log_msg(2, "DCDataSet::write (%s)", name.c_str());
 
         if (!opened)
@@ -534,27 +1080,49 @@ namespace splash
 
         // swap dimensions if necessary
         srcSelect.swapDims(ndims);
-        dstOffset.swapDims(ndims);
+        dstOffset.swapDims(ndims, 0);
 
         // dataspace to read from
         hid_t dsp_src;
 
         if (getLogicalSize().getScalarSize() != 0)
         {
-            dsp_src = H5Screate_simple(ndims, srcSelect.size.getPointer(), NULL);
-            if (dsp_src < 0)
-                throw DCException(getExceptionString("write: Failed to create source dataspace"));
+            // data with a different storage datatype is converted
+            // into a dense buffer which is written instead
+            std::vector<char> converted;
+            if (!storage.isNative() && data && (srcSelect.count.getScalarSize() != 0))
+            {
+                convertForWrite(srcSelect, data, converted);
+                srcSelect = Selection(srcSelect.count);
+                data = &(converted[0]);
+            }
 
-            // select hyperslap only if necessary
-            if ((srcSelect.offset.getScalarSize() != 0) || (srcSelect.count != srcSelect.size) || 
-                    (srcSelect.stride.getScalarSize() != 1))
+            // checksums cover data written to the complete dataset at once
+            const bool complete = data && (srcSelect.count.getScalarSize() != 0) &&
+                    isComplete(srcSelect.count, dstOffset);
+            uint32_t data_checksum = 0;
+            if (complete && checksums)
             {
-                if (H5Sselect_hyperslab(dsp_src, H5S_SELECT_SET, srcSelect.offset.getPointer(),
-                        srcSelect.stride.getPointer(), srcSelect.count.getPointer(), NULL) < 0 ||
-                        H5Sselect_valid(dsp_src) <= 0)
-                    throw DCException(getExceptionString("write: Invalid source hyperslap selection"));
+                dsp_src = createSourceSpace(srcSelect);
+                data_checksum = getChecksum(dsp_src, data, 0);
+                H5Sclose(dsp_src);
+            }
+
+            // dense source buffers can be compressed and written chunk-wise
+            if ((directChunkThreads > 0) && data && !srcSelect.isScattered() &&
+                    (srcSelect.offset == Dimensions(0, 0, 0)) &&
+                    (srcSelect.count == srcSelect.size) &&
+                    (srcSelect.stride.getScalarSize() == 1) &&
+                    DCChunkIO::writeChunks(dataset, dsetWriteProperties, ndims,
+                    dstOffset.getPointer(), srcSelect.count.getPointer(), data,
+                    directChunkThreads))
+            {
+                setChecksumAttribute(complete, data_checksum);
+                return;
             }
 
+            dsp_src = createSourceSpace(srcSelect);
+
             if (srcSelect.count.getScalarSize() == 0)
                 H5Sselect_none(dsp_src);
 
@@ -579,13 +1147,128 @@ namespace splash
             if (H5Dwrite(dataset, this->datatype, dsp_src, dataspace, dsetWriteProperties, data) < 0)
                 throw DCException(getExceptionString("write: Failed to write dataset"));
 
+            IOStatistics::addTransfer(getSelectedBytes());
+
             H5Sclose(dsp_src);
+
+            setChecksumAttribute(complete, data_checksum);
+        }
+    }
+
+    size_t DCDataSet::getComponentSlabs(const Dimensions count)
+    throw (DCException)
+    {
+        Dimensions physical_count(count);
+        physical_count.swapDims(ndims);
+        if (physical_count.getScalarSize() == 0)
+            return 0;
+
+        const size_t slab_rows = getComponentSlabRows(physical_count);
+        return (physical_count[0] + slab_rows - 1) / slab_rows;
+    }
+
+    size_t DCDataSet::getComponentSlabRows(const Dimensions physicalCount)
+    {
+        // slabs of whole rows in the slowest dimension
+        size_t row_size = H5Tget_size(this->datatype);
+        for (uint32_t i = 1; i < ndims; ++i)
+            row_size *= physicalCount[i];
+
+        size_t slab_rows = std::max((size_t) 1, (size_t) DC_COMPONENT_SLAB_SIZE / row_size);
+
+        // align slabs to chunks to keep direct chunk writes possible
+        hid_t dcpl = H5Dget_create_plist(dataset);
+        if ((dcpl >= 0) && (H5Pget_layout(dcpl) == H5D_CHUNKED))
+        {
+            hsize_t chunk_dims[DSP_DIM_MAX];
+            if (H5Pget_chunk(dcpl, ndims, chunk_dims) == (int) ndims)
+                slab_rows = ((slab_rows + chunk_dims[0] - 1) / chunk_dims[0]) * chunk_dims[0];
         }
+        if (dcpl >= 0)
+            H5Pclose(dcpl);
+
+        return slab_rows;
+    }
+
+    void DCDataSet::writeComponents(Selection srcSelect,
+            Dimensions dstOffset,
+            const void* const* components,
+            size_t numSlabs)
+    throw (DCException)
+    {
+        Tracing::Scope trace("dataset", "DCDataSet::writeComponents", name.c_str());
+
+        log_msg(2, "DCDataSet::writeComponents (%s)", name.c_str());
+
+        if (!opened)
+            throw DCException(getExceptionString("writeComponents: Dataset has not been opened/created"));
+
+        uint32_t num_components = 0;
+        if (!storage.isNative() || !DCConversion::getComponents(this->datatype, num_components))
+            throw DCException(getExceptionString("writeComponents: Datatype cannot be written from components"));
+
+        if (srcSelect.isScattered())
+            throw DCException(getExceptionString("writeComponents: Scattered selections are not supported"));
+
+        if (!components)
+            srcSelect.count[0] = 0;
+
+        const size_t slabs = getComponentSlabs(srcSelect.count);
+        if (numSlabs < slabs)
+            numSlabs = slabs;
+
+        // swap dimensions if necessary
+        srcSelect.swapDims(ndims);
+        dstOffset.swapDims(ndims, 0);
+
+        const size_t slab_rows = (slabs > 0) ? getComponentSlabRows(srcSelect.count) : 0;
+        Dimensions slab_count(srcSelect.count);
+        slab_count[0] = std::min((hsize_t) slab_rows, srcSelect.count[0]);
+        std::vector<char> buffer(slab_count.getScalarSize() * H5Tget_size(this->datatype) + 1);
+
+        // slabs are written in order, so their checksums are accumulated
+        const bool complete = checksums && (slabs > 0) && isComplete(srcSelect.count, dstOffset);
+        uint32_t data_checksum = 0;
+
+        for (size_t slab = 0; slab < numSlabs; ++slab)
+        {
+            Dimensions count(srcSelect.count);
+            Dimensions offset(srcSelect.offset);
+            Dimensions dst_offset(dstOffset);
+            const hsize_t first_row = std::min((hsize_t) (slab * slab_rows), srcSelect.count[0]);
+
+            count[0] = std::min((hsize_t) slab_rows, srcSelect.count[0] - first_row);
+            offset[0] += first_row * srcSelect.stride[0];
+            dst_offset[0] += first_row;
+
+            if (count.getScalarSize() != 0)
+            {
+                DCConversion::interleave(this->datatype, components, ndims,
+                        srcSelect.size.getPointer(), offset.getPointer(),
+                        srcSelect.stride.getPointer(), count.getPointer(), &(buffer[0]));
+
+                if (complete)
+                    data_checksum = DCVerifier::updateChecksum(data_checksum, &(buffer[0]),
+                        count.getScalarSize() * H5Tget_size(this->datatype),
+                        std::max(directChunkThreads, (uint32_t) 1));
+            }
+
+            // write the dense slab, in logical dimension order
+            count.swapDims(ndims);
+            dst_offset.swapDims(ndims, 0);
+            write(Selection(count), dst_offset,
+                    (count.getScalarSize() != 0) ? &(buffer[0]) : NULL);
+        }
+
+        if (complete)
+            setChecksumAttribute(true, data_checksum);
     }
 
     void DCDataSet::append(size_t count, size_t offset, size_t stride, const void* data)
     throw (DCException)
     {
+        Tracing::Scope trace("dataset", "DCDataSet::append", name.c_str());
+
         log_msg(2, "DCDataSet::append");
 
         if (!opened)
@@ -619,6 +1302,25 @@ namespace splash
                 H5Sselect_valid(dataspace) < 0)
             throw DCException(getExceptionString("append: Invalid target hyperslap selection"));
 
+        // data with a different storage datatype is gathered
+        // and converted into a dense buffer which is appended instead
+        std::vector<char> converted;
+        if (!storage.isNative() && data && (count != 0))
+        {
+            const size_t mem_size = storage.getMemorySize();
+            std::vector<char> gathered(count * mem_size);
+            for (size_t i = 0; i < count; ++i)
+                memcpy(&(gathered[i * mem_size]),
+                    (const char*) data + (offset + i * stride) * mem_size, mem_size);
+
+            converted.resize(count * H5Tget_size(this->datatype));
+            storage.toStorage(&(gathered[0]), &(converted[0]), count, this->datatype);
+
+            data = &(converted[0]);
+            offset = 0;
+            stride = 1;
+        }
+
         // append data to the dataset.
         // select the region in the source DataSpace to read from
         Dimensions dim_src(offset + count * stride, 1, 1);
@@ -640,7 +1342,37 @@ namespace splash
         if (H5Dwrite(dataset, this->datatype, dsp_src, dataspace, dsetWriteProperties, data) < 0)
             throw DCException(getExceptionString("append: Failed to append dataset"));
 
+        IOStatistics::addTransfer(getSelectedBytes());
+
+        // appended data extends the checksum of the preceding data
+        if (data)
+        {
+            const bool valid = hasChecksum || (target_offset[0] == 0);
+            setChecksumAttribute(valid, (valid && checksums) ?
+                    getChecksum(dsp_src, data, hasChecksum ? checksum : 0) : 0);
+        }
+
         H5Sclose(dsp_src);
     }
 
+    void DCDataSet::setExtent(const Dimensions size)
+    throw (DCException)
+    {
+        log_msg(2, "DCDataSet::setExtent (%s, size %s)", name.c_str(), size.toString().c_str());
+
+        if (!opened)
+            throw DCException(getExceptionString("setExtent: Dataset has not been opened/created."));
+
+        getLogicalSize().set(size);
+
+        if (H5Dset_extent(dataset, getPhysicalSize().getPointer()) < 0)
+            throw DCException(getExceptionString("setExtent: Failed to extend dataset"));
+
+        // refresh the dataspace for subsequent selections
+        H5Sclose(dataspace);
+        dataspace = H5Dget_space(dataset);
+        if (dataspace < 0)
+            throw DCException(getExceptionString("setExtent: Failed to open dataspace"));
+    }
+
 }
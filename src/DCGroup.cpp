@@ -19,7 +19,7 @@
  * If not, see <http://www.gnu.org/licenses/>. 
  */
 
-
+#define SPLASH_LOG_CATEGORY splash::LOG_FILE
 
 #include <string>
 #include <sstream>
@@ -27,6 +27,8 @@
 #include <string.h>
 
 #include "splash/core/DCGroup.hpp"
+#include "splash/core/logging.hpp"
+#include "splash/Tracing.hpp"
 
 #define H5_TRUE 1
 #define H5_FALSE 0
@@ -41,7 +43,8 @@ namespace splash
     }
 
     DCGroup::DCGroup() :
-    checkExistence(true)
+    checkExistence(true),
+    groupAccProperties(H5P_DEFAULT)
     {
     }
 
@@ -53,6 +56,10 @@ namespace splash
     H5Handle DCGroup::create(H5Handle base, std::string path)
     throw (DCException)
     {
+        Tracing::Scope trace("group", "DCGroup::create", path.c_str());
+
+        log_msg(3, "DCGroup::create (%s)", path.c_str());
+
         bool mustCreate = false;
         H5Handle currentHandle = base;
         char c_path[path.size() + 1];
@@ -61,10 +68,10 @@ namespace splash
         char *token = strtok(c_path, "/");
         while (token)
         {
-            if (mustCreate || !H5Lexists(currentHandle, token, H5P_DEFAULT))
+            if (mustCreate || !H5Lexists(currentHandle, token, groupAccProperties))
             {
                 H5Handle newHandle = H5Gcreate(currentHandle, token, H5P_LINK_CREATE_DEFAULT,
-                        H5P_GROUP_CREATE_DEFAULT, H5P_GROUP_ACCESS_DEFAULT);
+                        H5P_GROUP_CREATE_DEFAULT, groupAccProperties);
                 if (newHandle < 0)
                     throw DCException(getExceptionString("Failed to create group", path));
 
@@ -72,14 +79,14 @@ namespace splash
                 mustCreate = true;
             } else
             {
-                currentHandle = H5Gopen(currentHandle, token, H5P_DEFAULT);
+                currentHandle = H5Gopen(currentHandle, token, groupAccProperties);
                 if (currentHandle < 0)
                 {
                     if (checkExistence)
                         throw DCException(getExceptionString("Failed to create group", path));
                     
                     currentHandle = H5Gcreate(currentHandle, token, H5P_LINK_CREATE_DEFAULT,
-                        H5P_GROUP_CREATE_DEFAULT, H5P_GROUP_ACCESS_DEFAULT);
+                        H5P_GROUP_CREATE_DEFAULT, groupAccProperties);
                     if (currentHandle < 0)
                         throw DCException(getExceptionString("Failed to create group", path));
                     
@@ -97,12 +104,16 @@ namespace splash
     H5Handle DCGroup::open(H5Handle base, std::string path)
     throw (DCException)
     {
+        Tracing::Scope trace("group", "DCGroup::open", path.c_str());
+
+        log_msg(3, "DCGroup::open (%s)", path.c_str());
+
         H5Handle newHandle;
 
-        if (checkExistence && !H5Lexists(base, path.c_str(), H5P_DEFAULT))
+        if (checkExistence && !H5Lexists(base, path.c_str(), groupAccProperties))
             throw DCException(getExceptionString("Failed to open group", path));
 
-        newHandle = H5Gopen(base, path.c_str(), H5P_DEFAULT);
+        newHandle = H5Gopen(base, path.c_str(), groupAccProperties);
 
         if (newHandle < 0)
             throw DCException(getExceptionString("Failed to open group", path));
@@ -141,6 +152,8 @@ namespace splash
     void DCGroup::remove(H5Handle base, std::string path)
     throw (DCException)
     {
+        log_msg(2, "DCGroup::remove (%s)", path.c_str());
+
         if (H5Ldelete(base, path.c_str(), H5P_LINK_ACCESS_DEFAULT) < 0)
             throw DCException(getExceptionString("failed to remove group", path));
     }
@@ -190,8 +203,10 @@ namespace splash
 
             if (obj_info.type == H5O_TYPE_DATASET)
             {
+                // the name of the dataset relative to the iteration group
                 if (param->entries)
-                    param->entries[param->count].name = currentEntryName;
+                    param->entries[param->count].name =
+                        currentBaseName.substr(0, currentBaseName.size() - 1);
 
                 param->count++;
             }
@@ -0,0 +1,452 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "splash/core/DCRepack.hpp"
+#include "splash/core/DCAttribute.hpp"
+#include "splash/core/DCHelper.hpp"
+#include "splash/core/ScopedID.hpp"
+#include "splash/sdc_defines.hpp"
+
+namespace splash
+{
+
+    /** maximum number of bytes of a dataset copied at once */
+#define DCREPACK_BUFFER_SIZE (64 * 1024 * 1024)
+
+    static herr_t addLinkName(hid_t, const char *name, const H5L_info_t*, void *names)
+    {
+        ((std::vector<std::string>*)names)->push_back(name);
+        return 0;
+    }
+
+    static herr_t addAttributeName(hid_t, const char *name, const H5A_info_t*, void *names)
+    {
+        ((std::vector<std::string>*)names)->push_back(name);
+        return 0;
+    }
+
+    static bool hasVariableLength(hid_t type)
+    {
+        return (H5Tdetect_class(type, H5T_VLEN) > 0) ||
+                (H5Tget_class(type) == H5T_STRING && H5Tis_variable_str(type) > 0);
+    }
+
+    std::string DCRepack::getExceptionString(std::string msg, std::string name)
+    {
+        return (std::string("Exception for DCRepack [") + name + std::string("] ") +
+                msg);
+    }
+
+    void DCRepack::initParameters(Parameters &params)
+    {
+        params.compression = -1;
+        params.chunkSize.set(0, 0, 0);
+        params.firstID = 0;
+        params.lastID = -1;
+        params.trackFreeSpace = false;
+    }
+
+    void DCRepack::getLinkNames(hid_t group, std::vector<std::string> &names)
+    throw (DCException)
+    {
+        if (H5Literate(group, H5_INDEX_NAME, H5_ITER_INC, NULL, addLinkName, &names) < 0)
+            throw DCException(getExceptionString("Failed to iterate links", ""));
+    }
+
+    void DCRepack::copyAttributes(hid_t src, hid_t dst)
+    throw (DCException)
+    {
+        std::vector<std::string> names;
+        if (H5Aiterate2(src, H5_INDEX_NAME, H5_ITER_INC, NULL, addAttributeName, &names) < 0)
+            throw DCException(getExceptionString("Failed to iterate attributes", ""));
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            const char *name = names[i].c_str();
+            ScopedID attr(H5Aopen(src, name, H5P_DEFAULT));
+            ScopedID type(H5Aget_type(attr));
+            ScopedID dataspace(H5Aget_space(attr));
+            if (attr < 0 || type < 0 || dataspace < 0)
+                throw DCException(getExceptionString("Failed to open attribute", name));
+
+            // references to objects of the source file are meaningless
+            if (H5Tget_class(type) == H5T_REFERENCE)
+                continue;
+
+            const size_t size = H5Sget_simple_extent_npoints(dataspace) * H5Tget_size(type);
+            std::vector<char> buffer(size + 1);
+            if (H5Aread(attr, type, &(buffer[0])) < 0)
+                throw DCException(getExceptionString("Failed to read attribute", name));
+
+            ScopedID dst_attr(H5Acreate2(dst, name, type, dataspace, H5P_DEFAULT, H5P_DEFAULT));
+            herr_t status = (dst_attr < 0) ? -1 : H5Awrite(dst_attr, type, &(buffer[0]));
+
+            if (hasVariableLength(type))
+                H5Dvlen_reclaim(type, dataspace, H5P_DEFAULT, &(buffer[0]));
+
+            if (status < 0)
+                throw DCException(getExceptionString("Failed to write attribute", name));
+        }
+    }
+
+    void DCRepack::copyGroup(CopyState &state, hid_t src, hid_t dst,
+            const std::string &path)
+    throw (DCException)
+    {
+        copyAttributes(src, dst);
+
+        std::vector<std::string> names;
+        getLinkNames(src, names);
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            // skip iterations out of the requested range
+            if (path == SDC_GROUP_DATA)
+            {
+                const int32_t id = atoi(names[i].c_str());
+                if (id < state.params->firstID ||
+                        (state.params->lastID >= 0 && id > state.params->lastID))
+                    continue;
+            }
+
+            copyLink(state, src, dst, path, names[i]);
+        }
+    }
+
+    void DCRepack::copyLink(CopyState &state, hid_t src, hid_t dst,
+            const std::string &path, const std::string &name)
+    throw (DCException)
+    {
+        const std::string full_path = path + "/" + name;
+
+        H5L_info_t link_info;
+        if (H5Lget_info(src, name.c_str(), &link_info, H5P_DEFAULT) < 0)
+            throw DCException(getExceptionString("Failed to get link info", full_path));
+
+        if (link_info.type == H5L_TYPE_SOFT || link_info.type == H5L_TYPE_EXTERNAL)
+        {
+            std::vector<char> value(link_info.u.val_size + 1);
+            if (H5Lget_val(src, name.c_str(), &(value[0]), value.size(), H5P_DEFAULT) < 0)
+                throw DCException(getExceptionString("Failed to read link", full_path));
+
+            herr_t status = -1;
+            if (link_info.type == H5L_TYPE_SOFT)
+                status = H5Lcreate_soft(&(value[0]), dst, name.c_str(),
+                    H5P_DEFAULT, H5P_DEFAULT);
+            else
+            {
+                const char *filename = NULL, *obj_path = NULL;
+                unsigned flags = 0;
+                if (H5Lunpack_elink_val(&(value[0]), link_info.u.val_size, &flags,
+                        &filename, &obj_path) >= 0)
+                    status = H5Lcreate_external(filename, obj_path, dst, name.c_str(),
+                        H5P_DEFAULT, H5P_DEFAULT);
+            }
+
+            if (status < 0)
+                throw DCException(getExceptionString("Failed to create link", full_path));
+            return;
+        }
+
+        if (link_info.type != H5L_TYPE_HARD)
+            return;
+
+        ScopedID obj(H5Oopen(src, name.c_str(), H5P_DEFAULT));
+        if (obj < 0)
+            throw DCException(getExceptionString("Failed to open object", full_path));
+
+        switch (H5Iget_type(obj))
+        {
+            case H5I_GROUP:
+            {
+                ScopedID group(H5Gcreate2(dst, name.c_str(), H5P_DEFAULT,
+                        H5P_DEFAULT, H5P_DEFAULT));
+                if (group < 0)
+                    throw DCException(getExceptionString("Failed to create group", full_path));
+
+                copyGroup(state, obj, group, full_path);
+                break;
+            }
+            case H5I_DATASET:
+                copyDataSet(state, src, dst, full_path, name);
+                break;
+            default:
+                // named datatypes
+                if (H5Ocopy(src, name.c_str(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT) < 0)
+                    throw DCException(getExceptionString("Failed to copy object", full_path));
+        }
+    }
+
+    bool DCRepack::isChanged(const Parameters &params, hid_t dcpl)
+    {
+        // only chunked datasets are recompressed or rechunked
+        if (H5Pget_layout(dcpl) != H5D_CHUNKED)
+            return false;
+
+        return (params.compression >= 0) || (params.chunkSize.getScalarSize() > 0);
+    }
+
+    void DCRepack::setLayout(const Parameters &params, hid_t dataspace, hid_t dcpl)
+    {
+        const int ndims = H5Sget_simple_extent_ndims(dataspace);
+
+        if (params.chunkSize.getScalarSize() > 0 && ndims > 0)
+        {
+            hsize_t dims[H5S_MAX_RANK], max_dims[H5S_MAX_RANK], chunk_dims[H5S_MAX_RANK];
+            H5Sget_simple_extent_dims(dataspace, dims, max_dims);
+
+            for (int i = 0; i < ndims; ++i)
+            {
+                // chunk sizes are given in libSplash order
+                const uint32_t index = ndims - 1 - i;
+                chunk_dims[i] = (index < params.chunkSize.getRank()) ?
+                        params.chunkSize[index] : dims[i];
+
+                if (max_dims[i] != H5S_UNLIMITED && chunk_dims[i] > dims[i])
+                    chunk_dims[i] = dims[i];
+                if (chunk_dims[i] == 0)
+                    chunk_dims[i] = 1;
+            }
+
+            H5Pset_chunk(dcpl, ndims, chunk_dims);
+        }
+
+        if (params.compression >= 0)
+        {
+            H5Premove_filter(dcpl, H5Z_FILTER_ALL);
+            if (params.compression > 0)
+            {
+                H5Pset_shuffle(dcpl);
+                H5Pset_deflate(dcpl, params.compression);
+            }
+        }
+    }
+
+    void DCRepack::copyDataSet(CopyState &state, hid_t src, hid_t dst,
+            const std::string &path, const std::string &name)
+    throw (DCException)
+    {
+        ScopedID dataset(H5Dopen2(src, name.c_str(), H5P_DEFAULT));
+        ScopedID type(H5Dget_type(dataset));
+        ScopedID dcpl(H5Dget_create_plist(dataset));
+        if (dataset < 0 || type < 0 || dcpl < 0)
+            throw DCException(getExceptionString("Failed to open dataset", path));
+
+        // references are recreated after all other objects have been copied
+        if (H5Tget_class(type) == H5T_REFERENCE)
+        {
+            state.references.push_back(path);
+            return;
+        }
+
+        // unchanged datasets are copied without decompression
+        if (!isChanged(*(state.params), dcpl))
+        {
+            if (H5Ocopy(src, name.c_str(), dst, name.c_str(), H5P_DEFAULT, H5P_DEFAULT) < 0)
+                throw DCException(getExceptionString("Failed to copy dataset", path));
+            return;
+        }
+
+        ScopedID dataspace(H5Dget_space(dataset));
+        setLayout(*(state.params), dataspace, dcpl);
+
+        ScopedID dst_dataset(H5Dcreate2(dst, name.c_str(), type, dataspace,
+                H5P_DEFAULT, dcpl, H5P_DEFAULT));
+        if (dst_dataset < 0)
+            throw DCException(getExceptionString("Failed to create dataset", path));
+
+        // copy data in slabs of the slowest varying dimension
+        const int ndims = H5Sget_simple_extent_ndims(dataspace);
+        hsize_t dims[H5S_MAX_RANK];
+        H5Sget_simple_extent_dims(dataspace, dims, NULL);
+
+        size_t row_size = H5Tget_size(type);
+        for (int i = 1; i < ndims; ++i)
+            row_size *= dims[i];
+
+        const hsize_t num_rows = (ndims > 0) ? dims[0] : 1;
+        hsize_t slab_rows = DCREPACK_BUFFER_SIZE / (row_size > 0 ? row_size : 1);
+        if (slab_rows == 0)
+            slab_rows = 1;
+        if (slab_rows > num_rows)
+            slab_rows = num_rows;
+
+        if (H5Sget_simple_extent_npoints(dataspace) > 0)
+        {
+            std::vector<char> buffer(slab_rows * row_size);
+            const bool vlen = hasVariableLength(type);
+
+            for (hsize_t row = 0; row < num_rows; row += slab_rows)
+            {
+                hsize_t offset[H5S_MAX_RANK], count[H5S_MAX_RANK];
+                for (int i = 0; i < ndims; ++i)
+                {
+                    offset[i] = 0;
+                    count[i] = dims[i];
+                }
+
+                ScopedID mem_space((ndims > 0) ? H5Scopy(dataspace) : H5Screate(H5S_SCALAR));
+                if (ndims > 0)
+                {
+                    offset[0] = row;
+                    count[0] = (row + slab_rows > num_rows) ? num_rows - row : slab_rows;
+                    H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, offset, NULL, count, NULL);
+                    H5Sset_extent_simple(mem_space, ndims, count, NULL);
+                }
+
+                herr_t status = H5Dread(dataset, type, mem_space, dataspace, H5P_DEFAULT,
+                        &(buffer[0]));
+                if (status >= 0)
+                    status = H5Dwrite(dst_dataset, type, mem_space, dataspace, H5P_DEFAULT,
+                        &(buffer[0]));
+
+                if (vlen)
+                    H5Dvlen_reclaim(type, mem_space, H5P_DEFAULT, &(buffer[0]));
+
+                if (status < 0)
+                    throw DCException(getExceptionString("Failed to copy data", path));
+            }
+        }
+
+        copyAttributes(dataset, dst_dataset);
+    }
+
+    void DCRepack::copyReferences(CopyState &state, const std::string &path)
+    throw (DCException)
+    {
+        ScopedID dataset(H5Dopen2(state.srcFile, path.c_str(), H5P_DEFAULT));
+        ScopedID type(H5Dget_type(dataset));
+        ScopedID dataspace(H5Dget_space(dataset));
+        ScopedID dcpl(H5Dget_create_plist(dataset));
+        if (dataset < 0 || type < 0 || dataspace < 0 || dcpl < 0)
+            throw DCException(getExceptionString("Failed to open dataset", path));
+
+        const bool is_region = H5Tequal(type, H5T_STD_REF_DSETREG) > 0;
+        const H5R_type_t ref_type = is_region ? H5R_DATASET_REGION : H5R_OBJECT;
+        const hid_t mem_type = is_region ? H5T_STD_REF_DSETREG : H5T_STD_REF_OBJ;
+        const size_t ref_size = is_region ? sizeof (hdset_reg_ref_t) : sizeof (hobj_ref_t);
+        const size_t num_refs = H5Sget_simple_extent_npoints(dataspace);
+
+        std::vector<char> src_refs(num_refs * ref_size + 1);
+        std::vector<char> dst_refs(num_refs * ref_size + 1, 0);
+        if (num_refs > 0 && H5Dread(dataset, mem_type, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                &(src_refs[0])) < 0)
+            throw DCException(getExceptionString("Failed to read references", path));
+
+        for (size_t i = 0; i < num_refs; ++i)
+        {
+            void *src_ref = &(src_refs[i * ref_size]);
+            void *dst_ref = &(dst_refs[i * ref_size]);
+
+            // references to objects which have not been copied remain undefined
+            H5E_BEGIN_TRY
+            {
+                char target[1024];
+                if (H5Rget_name(state.srcFile, ref_type, src_ref, target, sizeof (target)) > 0)
+                {
+                    if (is_region)
+                    {
+                        ScopedID region(H5Rget_region(dataset, H5R_DATASET_REGION, src_ref));
+                        if (region >= 0)
+                            H5Rcreate(dst_ref, state.dstFile, target, H5R_DATASET_REGION, region);
+                    } else
+                        H5Rcreate(dst_ref, state.dstFile, target, H5R_OBJECT, -1);
+                }
+            }
+            H5E_END_TRY;
+        }
+
+        ScopedID dst_dataset(H5Dcreate2(state.dstFile, path.c_str(), type, dataspace,
+                H5P_DEFAULT, dcpl, H5P_DEFAULT));
+        if (dst_dataset < 0)
+            throw DCException(getExceptionString("Failed to create dataset", path));
+
+        if (num_refs > 0 && H5Dwrite(dst_dataset, mem_type, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                &(dst_refs[0])) < 0)
+            throw DCException(getExceptionString("Failed to write references", path));
+
+        copyAttributes(dataset, dst_dataset);
+    }
+
+    void DCRepack::updateMaxID(hid_t file)
+    throw (DCException)
+    {
+        if (H5Lexists(file, SDC_GROUP_HEADER, H5P_DEFAULT) <= 0 ||
+                H5Lexists(file, SDC_GROUP_DATA, H5P_DEFAULT) <= 0)
+            return;
+
+        ScopedID header(H5Gopen2(file, SDC_GROUP_HEADER, H5P_DEFAULT));
+        if (header < 0 || H5Aexists(header, SDC_ATTR_MAX_ID) <= 0)
+            return;
+
+        ScopedID data(H5Gopen2(file, SDC_GROUP_DATA, H5P_DEFAULT));
+        std::vector<std::string> names;
+        getLinkNames(data, names);
+
+        int32_t max_id = 0;
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            const int32_t id = atoi(names[i].c_str());
+            if (id > max_id)
+                max_id = id;
+        }
+
+        DCAttribute::writeAttribute(SDC_ATTR_MAX_ID, H5T_NATIVE_INT32, header, &max_id);
+    }
+
+    void DCRepack::copyFile(const std::string &srcFilename,
+            const std::string &dstFilename,
+            const Parameters &params)
+    throw (DCException)
+    {
+        ScopedID src_file(H5Fopen(srcFilename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT));
+        if (src_file < 0)
+            throw DCException(getExceptionString("Failed to open file", srcFilename));
+
+        ScopedID fcpl(params.trackFreeSpace ?
+                DCHelper::createFreeSpaceTrackingPList() : -1);
+        if (params.trackFreeSpace && fcpl < 0)
+            throw DCException(getExceptionString("Failed to set free space tracking",
+                dstFilename));
+
+        ScopedID dst_file(H5Fcreate(dstFilename.c_str(), H5F_ACC_TRUNC,
+                params.trackFreeSpace ? (hid_t) fcpl : H5P_DEFAULT, H5P_DEFAULT));
+        if (dst_file < 0)
+            throw DCException(getExceptionString("Failed to create file", dstFilename));
+
+        CopyState state;
+        state.srcFile = src_file;
+        state.dstFile = dst_file;
+        state.params = &params;
+
+        copyGroup(state, src_file, dst_file, "");
+
+        for (size_t i = 0; i < state.references.size(); ++i)
+            copyReferences(state, state.references[i]);
+
+        if (params.firstID > 0 || params.lastID >= 0)
+            updateMaxID(dst_file);
+    }
+
+}
@@ -0,0 +1,452 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+#include "splash/core/DCStorage.hpp"
+#include "splash/core/DCAttribute.hpp"
+#include "splash/sdc_defines.hpp"
+
+namespace splash
+{
+
+    /**
+     * Layout of the storage description attribute.
+     */
+    typedef struct
+    {
+        int32_t format;
+        int32_t memType;
+        double scale;
+    } StorageAttribute;
+
+    static inline uint32_t floatToBits(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof (bits));
+        return bits;
+    }
+
+    static inline float bitsToFloat(uint32_t bits)
+    {
+        float value;
+        memcpy(&value, &bits, sizeof (value));
+        return value;
+    }
+
+    /**
+     * Converts to half precision, rounding to nearest even.
+     * Values too large for half precision become infinity.
+     */
+    static inline uint16_t floatToHalf(float value)
+    {
+        const uint32_t f32_infinity = 255u << 23;
+        const uint32_t f16_max = (127u + 16u) << 23;
+        const uint32_t denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+        uint32_t bits = floatToBits(value);
+        const uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint16_t result;
+        if (bits >= f16_max)
+        {
+            // infinity or NaN (quiet)
+            result = (bits > f32_infinity) ? 0x7e00 : 0x7c00;
+        } else if (bits < (113u << 23))
+        {
+            // subnormal result, the addition rounds the mantissa
+            const float tmp = bitsToFloat(bits) + bitsToFloat(denorm_magic);
+            result = (uint16_t) (floatToBits(tmp) - denorm_magic);
+        } else
+        {
+            const uint32_t mant_odd = (bits >> 13) & 1;
+            bits -= (127u - 15u) << 23;
+            bits += 0xfffu + mant_odd;
+            result = (uint16_t) (bits >> 13);
+        }
+
+        return result | (uint16_t) (sign >> 16);
+    }
+
+    static inline float halfToFloat(uint16_t value)
+    {
+        const uint32_t shifted_exp = 0x7c00u << 13;
+
+        uint32_t bits = ((uint32_t) value & 0x7fffu) << 13;
+        const uint32_t exp = shifted_exp & bits;
+        bits += (127u - 15u) << 23;
+
+        if (exp == shifted_exp)
+        {
+            // infinity or NaN
+            bits += (128u - 16u) << 23;
+        } else if (exp == 0)
+        {
+            // subnormal, renormalize
+            bits += 1u << 23;
+            bits = floatToBits(bitsToFloat(bits) - bitsToFloat(113u << 23));
+        }
+
+        return bitsToFloat(bits | (((uint32_t) value & 0x8000u) << 16));
+    }
+
+    /**
+     * Converts to bfloat16, rounding to nearest even.
+     */
+    static inline uint16_t floatToBFloat16(float value)
+    {
+        uint32_t bits = floatToBits(value);
+        if ((bits & 0x7fffffffu) > 0x7f800000u)
+            return (uint16_t) ((bits >> 16) | 0x40u);
+
+        bits += 0x7fffu + ((bits >> 16) & 1u);
+        return (uint16_t) (bits >> 16);
+    }
+
+    static inline float bfloat16ToFloat(uint16_t value)
+    {
+        return bitsToFloat((uint32_t) value << 16);
+    }
+
+    /*
+     * The conversion loops are free of function calls and
+     * are vectorized by the compiler.
+     * Double precision data is rounded to single precision first.
+     */
+
+    template<typename T>
+    static void convertToHalf(const T *src, uint16_t *dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = floatToHalf((float) src[i]);
+    }
+
+    template<typename T>
+    static void convertFromHalf(const uint16_t *src, T *dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = (T) halfToFloat(src[i]);
+    }
+
+#if defined(__F16C__)
+    // hardware conversion of 8 values per instruction
+
+    template<>
+    void convertToHalf<float>(const float *src, uint16_t *dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm_storeu_si128((__m128i*) (dst + i),
+                _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+
+        for (; i < count; ++i)
+            dst[i] = floatToHalf(src[i]);
+    }
+
+    template<>
+    void convertFromHalf<float>(const uint16_t *src, float *dst, size_t count)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(dst + i,
+                _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) (src + i))));
+
+        for (; i < count; ++i)
+            dst[i] = halfToFloat(src[i]);
+    }
+#endif
+
+    template<typename T>
+    static void convertToBFloat16(const T *src, uint16_t *dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = floatToBFloat16((float) src[i]);
+    }
+
+    template<typename T>
+    static void convertFromBFloat16(const uint16_t *src, T *dst, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = (T) bfloat16ToFloat(src[i]);
+    }
+
+    template<typename S, typename T>
+    static void convertToFixedPoint(const T *src, S *dst, size_t count, double scale)
+    {
+        const double factor = 1.0 / scale;
+        const double min_value = (double) std::numeric_limits<S>::min();
+        const double max_value = (double) std::numeric_limits<S>::max();
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            double value = (double) src[i] * factor;
+            // NaN is stored as 0
+            value = (value == value) ? value : 0.0;
+            value = std::min(std::max(value, min_value), max_value);
+            dst[i] = (S) std::floor(value + 0.5);
+        }
+    }
+
+    template<typename S, typename T>
+    static void convertFromFixedPoint(const S *src, T *dst, size_t count, double scale)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = (T) ((double) src[i] * scale);
+    }
+
+    template<typename T>
+    static void convertToFixedPoint(const T *src, void *dst, size_t storageSize,
+            size_t count, double scale)
+    {
+        switch (storageSize)
+        {
+            case sizeof (int8_t):
+                convertToFixedPoint(src, (int8_t*) dst, count, scale);
+                break;
+            case sizeof (int16_t):
+                convertToFixedPoint(src, (int16_t*) dst, count, scale);
+                break;
+            default:
+                convertToFixedPoint(src, (int32_t*) dst, count, scale);
+        }
+    }
+
+    template<typename T>
+    static void convertFromFixedPoint(const void *src, T *dst, size_t storageSize,
+            size_t count, double scale)
+    {
+        switch (storageSize)
+        {
+            case sizeof (int8_t):
+                convertFromFixedPoint((const int8_t*) src, dst, count, scale);
+                break;
+            case sizeof (int16_t):
+                convertFromFixedPoint((const int16_t*) src, dst, count, scale);
+                break;
+            default:
+                convertFromFixedPoint((const int32_t*) src, dst, count, scale);
+        }
+    }
+
+    template<typename T>
+    static void convertToStorage(DCStorageFormat format, const T *src, void *dst,
+            size_t storageSize, size_t count, double scale)
+    {
+        switch (format)
+        {
+            case DCSF_FLOAT16:
+                convertToHalf(src, (uint16_t*) dst, count);
+                break;
+            case DCSF_BFLOAT16:
+                convertToBFloat16(src, (uint16_t*) dst, count);
+                break;
+            default:
+                convertToFixedPoint(src, dst, storageSize, count, scale);
+        }
+    }
+
+    template<typename T>
+    static void convertFromStorage(DCStorageFormat format, const void *src, T *dst,
+            size_t storageSize, size_t count, double scale)
+    {
+        switch (format)
+        {
+            case DCSF_FLOAT16:
+                convertFromHalf((const uint16_t*) src, dst, count);
+                break;
+            case DCSF_BFLOAT16:
+                convertFromBFloat16((const uint16_t*) src, dst, count);
+                break;
+            default:
+                convertFromFixedPoint(src, dst, storageSize, count, scale);
+        }
+    }
+
+    /**
+     * Converts with the (scalar) HDF5 conversion path.
+     */
+    static bool convertH5(hid_t srcType, const void *src, hid_t dstType, void *dst,
+            size_t count)
+    {
+        const size_t src_size = H5Tget_size(srcType);
+        const size_t dst_size = H5Tget_size(dstType);
+
+        std::vector<char> buffer(count * std::max(src_size, dst_size));
+        memcpy(&(buffer[0]), src, count * src_size);
+
+        if (H5Tconvert(srcType, dstType, count, &(buffer[0]), NULL, H5P_DEFAULT) < 0)
+            return false;
+
+        memcpy(dst, &(buffer[0]), count * dst_size);
+        return true;
+    }
+
+    DCStorage::DCStorage() :
+    format(DCSF_NATIVE),
+    memType(DCDT_UNKNOWN),
+    scale(1.0)
+    {
+    }
+
+    std::string DCStorage::getExceptionString(std::string msg)
+    {
+        return (std::string("Exception for DCStorage: ") + msg);
+    }
+
+    void DCStorage::set(const ColTypeStorage &colType)
+    {
+        format = colType.getFormat();
+        memType = colType.getMemoryType();
+        scale = colType.getScale();
+    }
+
+    void DCStorage::reset()
+    {
+        format = DCSF_NATIVE;
+        memType = DCDT_UNKNOWN;
+        scale = 1.0;
+    }
+
+    bool DCStorage::isNative() const
+    {
+        return format == DCSF_NATIVE;
+    }
+
+    DCDataType DCStorage::getMemoryType() const
+    {
+        return memType;
+    }
+
+    size_t DCStorage::getMemorySize() const
+    {
+        return (memType == DCDT_FLOAT64) ? sizeof (double) : sizeof (float);
+    }
+
+    hid_t DCStorage::getMemoryH5Type() const
+    {
+        return (memType == DCDT_FLOAT64) ? H5T_NATIVE_DOUBLE : H5T_NATIVE_FLOAT;
+    }
+
+    void DCStorage::toStorage(const void *src, void *dst, size_t count,
+            hid_t storageType) const
+    throw (DCException)
+    {
+        if (count == 0)
+            return;
+
+        if (format == DCSF_CUSTOM_FLOAT)
+        {
+            if (!convertH5(getMemoryH5Type(), src, storageType, dst, count))
+                throw DCException(getExceptionString("toStorage: Failed to convert data"));
+            return;
+        }
+
+        const size_t storage_size = H5Tget_size(storageType);
+        if (memType == DCDT_FLOAT64)
+            convertToStorage(format, (const double*) src, dst, storage_size, count, scale);
+        else
+            convertToStorage(format, (const float*) src, dst, storage_size, count, scale);
+    }
+
+    void DCStorage::fromStorage(const void *src, void *dst, size_t count,
+            hid_t storageType) const
+    throw (DCException)
+    {
+        if (count == 0)
+            return;
+
+        if (format == DCSF_CUSTOM_FLOAT)
+        {
+            if (!convertH5(storageType, src, getMemoryH5Type(), dst, count))
+                throw DCException(getExceptionString("fromStorage: Failed to convert data"));
+            return;
+        }
+
+        const size_t storage_size = H5Tget_size(storageType);
+        if (memType == DCDT_FLOAT64)
+            convertFromStorage(format, src, (double*) dst, storage_size, count, scale);
+        else
+            convertFromStorage(format, src, (float*) dst, storage_size, count, scale);
+    }
+
+    hid_t DCStorage::createAttributeType()
+    {
+        hid_t attr_type = H5Tcreate(H5T_COMPOUND, sizeof (StorageAttribute));
+        H5Tinsert(attr_type, "format", HOFFSET(StorageAttribute, format), H5T_NATIVE_INT32);
+        H5Tinsert(attr_type, "memType", HOFFSET(StorageAttribute, memType), H5T_NATIVE_INT32);
+        H5Tinsert(attr_type, "scale", HOFFSET(StorageAttribute, scale), H5T_NATIVE_DOUBLE);
+        return attr_type;
+    }
+
+    void DCStorage::writeAttribute(hid_t dataset) const
+    throw (DCException)
+    {
+        StorageAttribute attribute;
+        attribute.format = format;
+        attribute.memType = memType;
+        attribute.scale = scale;
+
+        hid_t attr_type = createAttributeType();
+        try
+        {
+            DCAttribute::writeAttribute(SDC_ATTR_STORAGE, attr_type, dataset, &attribute);
+        } catch (DCException)
+        {
+            H5Tclose(attr_type);
+            throw;
+        }
+        H5Tclose(attr_type);
+    }
+
+    void DCStorage::readAttribute(hid_t dataset)
+    throw (DCException)
+    {
+        reset();
+
+        htri_t exists = H5Aexists(dataset, SDC_ATTR_STORAGE);
+        if (exists < 0)
+            throw DCException(getExceptionString("readAttribute: Failed to check attribute"));
+        if (exists == 0)
+            return;
+
+        StorageAttribute attribute;
+        DCAttribute::readAttribute(SDC_ATTR_STORAGE, dataset, &attribute);
+
+        if (attribute.format <= DCSF_NATIVE || attribute.format > DCSF_CUSTOM_FLOAT ||
+                (attribute.memType != DCDT_FLOAT32 && attribute.memType != DCDT_FLOAT64))
+            throw DCException(getExceptionString("readAttribute: Invalid storage description"));
+
+        format = (DCStorageFormat) attribute.format;
+        memType = (DCDataType) attribute.memType;
+        scale = attribute.scale;
+    }
+
+}
@@ -0,0 +1,540 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <string.h>
+#include <zlib.h>
+
+#include "splash/core/DCVerifier.hpp"
+#include "splash/core/DCChunkIO.hpp"
+#include "splash/core/DCDomainDescriptor.hpp"
+#include "splash/core/ScopedID.hpp"
+#include "splash/basetypes/ColTypeDim.hpp"
+#include "splash/sdc_defines.hpp"
+
+namespace splash
+{
+
+    /** maximum number of bytes of a dataset read at once */
+#define DCVERIFIER_BUFFER_SIZE (64 * 1024 * 1024)
+
+    /** minimum and maximum number of bytes checksummed by a single thread */
+#define DCVERIFIER_MIN_BLOCK_SIZE (1024 * 1024)
+#define DCVERIFIER_MAX_BLOCK_SIZE (1024 * 1024 * 1024)
+
+    typedef struct
+    {
+        const uint8_t *data;
+        size_t size;
+        size_t blockSize;
+        std::vector<uLong> checksums;
+    } ChecksumJobs;
+
+    static bool checksumBlock(size_t job, void *userData)
+    {
+        ChecksumJobs *jobs = (ChecksumJobs*) userData;
+        const size_t offset = job * jobs->blockSize;
+        const size_t size = std::min(jobs->blockSize, jobs->size - offset);
+
+        jobs->checksums[job] = crc32(0L, jobs->data + offset, (uInt) size);
+        return true;
+    }
+
+    static herr_t addLinkName(hid_t, const char *name, const H5L_info_t*, void *names)
+    {
+        ((std::vector<std::string>*)names)->push_back(name);
+        return 0;
+    }
+
+    static bool hasVariableLength(hid_t type)
+    {
+        return (H5Tdetect_class(type, H5T_VLEN) > 0) ||
+                (H5Tget_class(type) == H5T_STRING && H5Tis_variable_str(type) > 0);
+    }
+
+    /**
+     * Reads an integer attribute with at most \p maxElements elements.
+     * Returns the number of elements read or -1 if the attribute is invalid.
+     */
+    static int readIntAttribute(hid_t obj, const char *name, hid_t memType,
+            void *dst, int maxElements)
+    {
+        ScopedID attr(H5Aopen(obj, name, H5P_DEFAULT));
+        ScopedID type((attr < 0) ? -1 : H5Aget_type(attr));
+        ScopedID dataspace((attr < 0) ? -1 : H5Aget_space(attr));
+        if (attr < 0 || type < 0 || dataspace < 0 || H5Tget_class(type) != H5T_INTEGER)
+            return -1;
+
+        const hssize_t elements = H5Sget_simple_extent_npoints(dataspace);
+        if (elements < 1 || elements > maxElements)
+            return -1;
+
+        if (H5Aread(attr, memType, dst) < 0)
+            return -1;
+
+        return (int) elements;
+    }
+
+    /**
+     * Reads a Dimensions attribute, either as ColTypeDim or as integer array.
+     * Returns the rank of the attribute or -1 if the attribute is invalid.
+     */
+    static int readDimsAttribute(hid_t obj, const char *name, Dimensions &dims)
+    {
+        ScopedID attr(H5Aopen(obj, name, H5P_DEFAULT));
+        ScopedID type((attr < 0) ? -1 : H5Aget_type(attr));
+        ScopedID dataspace((attr < 0) ? -1 : H5Aget_space(attr));
+        if (attr < 0 || type < 0 || dataspace < 0)
+            return -1;
+
+        if (H5Tget_class(type) != H5T_COMPOUND)
+            return readIntAttribute(obj, name, H5T_NATIVE_HSIZE, dims.getPointer(),
+                DSP_DIM_MAX);
+
+        ColTypeDim dim_t;
+        if (H5Sget_simple_extent_npoints(dataspace) != 1 ||
+                H5Aread(attr, dim_t.getDataType(), dims.getPointer()) < 0)
+            return -1;
+
+        return 3;
+    }
+
+    void DCVerifier::initParameters(Parameters &params)
+    {
+        params.numThreads = 1;
+        params.readData = true;
+    }
+
+    uint32_t DCVerifier::updateChecksum(uint32_t checksum, const void *data,
+            size_t size, uint32_t numThreads)
+    {
+        if (size == 0)
+            return checksum;
+
+        // split data into blocks which are combined afterwards
+        size_t num_blocks = std::min((size_t) numThreads, size / DCVERIFIER_MIN_BLOCK_SIZE);
+        num_blocks = std::max(num_blocks, (size + DCVERIFIER_MAX_BLOCK_SIZE - 1) /
+                DCVERIFIER_MAX_BLOCK_SIZE);
+
+        ChecksumJobs jobs;
+        jobs.data = (const uint8_t*) data;
+        jobs.size = size;
+        jobs.blockSize = (size + num_blocks - 1) / num_blocks;
+        jobs.checksums.resize(num_blocks);
+
+        DCChunkIO::runParallel(numThreads, num_blocks, checksumBlock, &jobs);
+
+        uLong result = checksum;
+        for (size_t i = 0; i < num_blocks; ++i)
+        {
+            const size_t offset = i * jobs.blockSize;
+            result = crc32_combine(result, jobs.checksums[i],
+                    (z_off_t) std::min(jobs.blockSize, size - offset));
+        }
+
+        return (uint32_t) result;
+    }
+
+    void DCVerifier::addProblem(VerifyState &state, const std::string &path,
+            const std::string &message)
+    {
+        Problem problem;
+        problem.path = path;
+        problem.message = message;
+        state.problems->push_back(problem);
+    }
+
+    bool DCVerifier::verifyFile(const std::string &filename,
+            const Parameters &params, std::vector<Problem> &problems)
+    {
+        const size_t num_problems = problems.size();
+
+        VerifyState state;
+        state.params = &params;
+        state.problems = &problems;
+
+        // damaged objects are reported as problems, not on the HDF5 error stack
+        H5E_auto2_t error_func = NULL;
+        void *error_data = NULL;
+        H5Eget_auto2(H5E_DEFAULT, &error_func, &error_data);
+        H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+        {
+            ScopedID file(H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT));
+            if (file < 0)
+                addProblem(state, "/", "Failed to open file");
+            else
+            {
+                verifyHeader(state, file);
+                verifyIterations(state, file);
+            }
+        }
+
+        H5Eset_auto2(H5E_DEFAULT, error_func, error_data);
+
+        return problems.size() == num_problems;
+    }
+
+    void DCVerifier::verifyHeader(VerifyState &state, hid_t file)
+    {
+        ScopedID header((H5Lexists(file, SDC_GROUP_HEADER, H5P_DEFAULT) > 0) ?
+                H5Gopen2(file, SDC_GROUP_HEADER, H5P_DEFAULT) : -1);
+        if (header < 0)
+        {
+            addProblem(state, SDC_GROUP_HEADER, "Missing header group");
+            return;
+        }
+
+        const std::string max_id_path = std::string(SDC_GROUP_HEADER "/") + SDC_ATTR_MAX_ID;
+        if (H5Aexists(header, SDC_ATTR_MAX_ID) <= 0)
+            addProblem(state, max_id_path, "Missing header attribute");
+        else
+        {
+            int32_t max_id = 0;
+            if (readIntAttribute(header, SDC_ATTR_MAX_ID, H5T_NATIVE_INT32,
+                    &max_id, 1) != 1)
+                addProblem(state, max_id_path, "Invalid header attribute");
+        }
+
+        const std::string mpi_size_path = std::string(SDC_GROUP_HEADER "/") + SDC_ATTR_MPI_SIZE;
+        if (H5Aexists(header, SDC_ATTR_MPI_SIZE) <= 0)
+        {
+            addProblem(state, mpi_size_path, "Missing header attribute");
+            return;
+        }
+
+        ColTypeDim dim_t;
+        Dimensions mpi_size(0, 0, 0);
+        ScopedID attr(H5Aopen(header, SDC_ATTR_MPI_SIZE, H5P_DEFAULT));
+        ScopedID dataspace((attr < 0) ? -1 : H5Aget_space(attr));
+        if (attr < 0 || dataspace < 0 || H5Sget_simple_extent_npoints(dataspace) != 1 ||
+                H5Aread(attr, dim_t.getDataType(), mpi_size.getPointer()) < 0 ||
+                mpi_size.getScalarSize() == 0)
+            addProblem(state, mpi_size_path, "Invalid header attribute");
+    }
+
+    void DCVerifier::verifyIterations(VerifyState &state, hid_t file)
+    {
+        // files without any iteration have no data group
+        if (H5Lexists(file, SDC_GROUP_DATA, H5P_DEFAULT) <= 0)
+            return;
+
+        ScopedID data(H5Gopen2(file, SDC_GROUP_DATA, H5P_DEFAULT));
+        std::vector<std::string> names;
+        if (data < 0 || H5Literate(data, H5_INDEX_NAME, H5_ITER_INC, NULL,
+                addLinkName, &names) < 0)
+        {
+            addProblem(state, SDC_GROUP_DATA, "Failed to open group");
+            return;
+        }
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            const std::string path = std::string(SDC_GROUP_DATA "/") + names[i];
+
+            if (names[i].find_first_not_of("0123456789") != std::string::npos)
+            {
+                addProblem(state, path, "Invalid iteration name");
+                continue;
+            }
+
+            ScopedID group(H5Oopen(data, names[i].c_str(), H5P_DEFAULT));
+            if (group < 0 || H5Iget_type(group) != H5I_GROUP)
+            {
+                addProblem(state, path, "Iteration is not a group");
+                continue;
+            }
+
+            verifyGroup(state, group, path);
+        }
+    }
+
+    void DCVerifier::verifyGroup(VerifyState &state, hid_t group,
+            const std::string &path)
+    {
+        std::vector<std::string> names;
+        if (H5Literate(group, H5_INDEX_NAME, H5_ITER_INC, NULL, addLinkName, &names) < 0)
+        {
+            addProblem(state, path, "Failed to iterate group");
+            return;
+        }
+
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            const std::string full_path = path + "/" + names[i];
+
+            // links are verified at their target
+            H5L_info_t link_info;
+            if (H5Lget_info(group, names[i].c_str(), &link_info, H5P_DEFAULT) < 0)
+            {
+                addProblem(state, full_path, "Failed to get link info");
+                continue;
+            }
+
+            if (link_info.type != H5L_TYPE_HARD)
+                continue;
+
+            ScopedID obj(H5Oopen(group, names[i].c_str(), H5P_DEFAULT));
+            if (obj < 0)
+            {
+                addProblem(state, full_path, "Failed to open object");
+                continue;
+            }
+
+            switch (H5Iget_type(obj))
+            {
+                case H5I_GROUP:
+                    verifyGroup(state, obj, full_path);
+                    break;
+                case H5I_DATASET:
+                    verifyDataSet(state, obj, full_path);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    void DCVerifier::verifyDataSet(VerifyState &state, hid_t dataset,
+            const std::string &path)
+    {
+        ScopedID type(H5Dget_type(dataset));
+        ScopedID dataspace(H5Dget_space(dataset));
+        if (type < 0 || dataspace < 0 || H5Sget_simple_extent_ndims(dataspace) < 0 ||
+                H5Sget_simple_extent_ndims(dataspace) > DSP_DIM_MAX)
+        {
+            addProblem(state, path, "Invalid datatype or dataspace");
+            return;
+        }
+
+        verifyDomain(state, dataset, path);
+
+        if (state.params->readData)
+            verifyData(state, dataset, path);
+    }
+
+    void DCVerifier::verifyDomain(VerifyState &state, hid_t dataset,
+            const std::string &path)
+    {
+        int32_t data_class = IDomainCollector::UndefinedType;
+        Dimensions local_size, local_offset, global_size;
+        uint32_t rank = 0;
+
+        if (H5Aexists(dataset, DOMCOL_ATTR_DOMAIN) > 0)
+        {
+            DCDomainDescriptor descriptor;
+            try
+            {
+                descriptor.readAttribute(dataset);
+            } catch (DCException)
+            {
+                addProblem(state, path, "Invalid domain attribute");
+                return;
+            }
+
+            data_class = descriptor.getDataClass();
+            local_size = descriptor.getLocalDomain().getSize();
+            local_offset = descriptor.getLocalDomain().getOffset();
+            global_size = descriptor.getGlobalDomain().getSize();
+            rank = std::max(local_size.getRank(), global_size.getRank());
+        } else if (H5Aexists(dataset, DOMCOL_ATTR_CLASS) > 0)
+        {
+            // files written by older versions use separate attributes
+            const int size_rank = readDimsAttribute(dataset, DOMCOL_ATTR_SIZE,
+                    local_size);
+            if (readIntAttribute(dataset, DOMCOL_ATTR_CLASS, H5T_NATIVE_INT32,
+                    &data_class, 1) != 1 || size_rank < 0 ||
+                    readDimsAttribute(dataset, DOMCOL_ATTR_OFFSET,
+                    local_offset) != size_rank ||
+                    readDimsAttribute(dataset, DOMCOL_ATTR_GLOBAL_SIZE,
+                    global_size) != size_rank)
+            {
+                addProblem(state, path, "Invalid domain attributes");
+                return;
+            }
+
+            rank = size_rank;
+        } else
+            return;
+
+        if (data_class != IDomainCollector::GridType &&
+                data_class != IDomainCollector::PolyType)
+        {
+            addProblem(state, path, "Invalid domain class");
+            return;
+        }
+
+        if (rank == 0 || rank > DSP_DIM_MAX)
+        {
+            addProblem(state, path, "Invalid domain rank");
+            return;
+        }
+
+        // empty domains have no position
+        bool empty = false;
+        for (uint32_t i = 0; i < rank; ++i)
+            empty = empty || (local_size[i] == 0);
+
+        if (!empty)
+        {
+            for (uint32_t i = 0; i < rank; ++i)
+            {
+                if (local_offset[i] + local_size[i] > global_size[i])
+                {
+                    addProblem(state, path, "Local domain exceeds global domain");
+                    return;
+                }
+            }
+        }
+
+        // only grid data has the extent of its domain
+        if (data_class != IDomainCollector::GridType)
+            return;
+
+        ScopedID dataspace(H5Dget_space(dataset));
+        hsize_t dims[DSP_DIM_MAX];
+        const int ndims = (H5Sget_simple_extent_type(dataspace) == H5S_NULL) ? 0 :
+                H5Sget_simple_extent_dims(dataspace, dims, NULL);
+
+        if (ndims == 0)
+        {
+            if (!empty)
+                addProblem(state, path, "Empty dataset for non-empty grid domain");
+            return;
+        }
+
+        // compare in libSplash order, missing dimensions have size 1
+        for (uint32_t i = 0; i < std::max(rank, (uint32_t) ndims); ++i)
+        {
+            const hsize_t data_size = (i < (uint32_t) ndims) ? dims[ndims - 1 - i] : 1;
+            const hsize_t domain_size = (i < rank) ? local_size[i] : 1;
+
+            if (data_size != domain_size)
+            {
+                addProblem(state, path, std::string("Dataset extent does not match "
+                        "local domain ") + local_size.toString());
+                return;
+            }
+        }
+    }
+
+    void DCVerifier::verifyData(VerifyState &state, hid_t dataset,
+            const std::string &path)
+    {
+        ScopedID type(H5Dget_type(dataset));
+        ScopedID dataspace(H5Dget_space(dataset));
+        ScopedID dcpl(H5Dget_create_plist(dataset));
+
+        // variable length data is not stored in the dataset itself
+        if (hasVariableLength(type))
+            return;
+
+        const bool has_checksum = (H5Aexists(dataset, SDC_ATTR_CHECKSUM) > 0);
+        uint32_t stored_checksum = 0;
+        if (has_checksum && readIntAttribute(dataset, SDC_ATTR_CHECKSUM,
+                H5T_NATIVE_UINT32, &stored_checksum, 1) != 1)
+        {
+            addProblem(state, path, "Invalid checksum attribute");
+            return;
+        }
+
+        uint32_t checksum = 0;
+        const int ndims = (H5Sget_simple_extent_type(dataspace) == H5S_NULL) ? -1 :
+                H5Sget_simple_extent_ndims(dataspace);
+
+        if (ndims >= 0 && H5Sget_simple_extent_npoints(dataspace) > 0)
+        {
+            // read data in slabs of the slowest varying dimension,
+            // aligned to chunks for direct chunk reads
+            hsize_t dims[DSP_DIM_MAX], chunk_dims[DSP_DIM_MAX];
+            H5Sget_simple_extent_dims(dataspace, dims, NULL);
+
+            size_t row_size = H5Tget_size(type);
+            for (int i = 1; i < ndims; ++i)
+                row_size *= dims[i];
+
+            hsize_t chunk_rows = 1;
+            if (ndims > 0 && H5Pget_layout(dcpl) == H5D_CHUNKED &&
+                    H5Pget_chunk(dcpl, ndims, chunk_dims) == ndims)
+                chunk_rows = chunk_dims[0];
+
+            const hsize_t num_rows = (ndims > 0) ? dims[0] : 1;
+            hsize_t slab_rows = DCVERIFIER_BUFFER_SIZE / (row_size > 0 ? row_size : 1);
+            slab_rows = std::max(slab_rows - slab_rows % chunk_rows, chunk_rows);
+            if (slab_rows > num_rows)
+                slab_rows = num_rows;
+
+            std::vector<char> buffer(slab_rows * row_size);
+
+            for (hsize_t row = 0; row < num_rows; row += slab_rows)
+            {
+                hsize_t offset[DSP_DIM_MAX], count[DSP_DIM_MAX], zero[DSP_DIM_MAX];
+                for (int i = 0; i < ndims; ++i)
+                {
+                    offset[i] = 0;
+                    count[i] = dims[i];
+                    zero[i] = 0;
+                }
+
+                ScopedID mem_space((ndims > 0) ? H5Scopy(dataspace) : H5Screate(H5S_SCALAR));
+                if (ndims > 0)
+                {
+                    offset[0] = row;
+                    count[0] = std::min(slab_rows, num_rows - row);
+                    H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, offset, NULL, count, NULL);
+                    H5Sset_extent_simple(mem_space, ndims, count, NULL);
+                }
+
+                const size_t slab_size = ((ndims > 0) ? count[0] : 1) * row_size;
+
+                // unallocated chunks read as zeros, like the default fill value
+                memset(&(buffer[0]), 0, slab_size);
+
+                try
+                {
+                    if (ndims == 0 || !DCChunkIO::readChunks(dataset, H5P_DEFAULT, ndims,
+                            offset, count, count, zero, &(buffer[0]),
+                            state.params->numThreads))
+                    {
+                        if (H5Dread(dataset, type, mem_space, dataspace, H5P_DEFAULT,
+                                &(buffer[0])) < 0)
+                        {
+                            addProblem(state, path, "Failed to read data");
+                            return;
+                        }
+                    }
+                } catch (DCException e)
+                {
+                    addProblem(state, path, "Failed to decompress data");
+                    return;
+                }
+
+                if (has_checksum)
+                    checksum = updateChecksum(checksum, &(buffer[0]), slab_size,
+                        state.params->numThreads);
+            }
+        }
+
+        if (has_checksum && checksum != stored_checksum)
+            addProblem(state, path, "Checksum mismatch");
+    }
+
+}
@@ -19,6 +19,7 @@
  * If not, see <http://www.gnu.org/licenses/>. 
  */
 
+#define SPLASH_LOG_CATEGORY splash::LOG_COLLECTOR
 
 #include <algorithm>
 #include <cassert>
@@ -29,6 +30,7 @@
 #include "splash/core/DCDataSet.hpp"
 #include "splash/core/DCGroup.hpp"
 #include "splash/core/DCAttribute.hpp"
+#include "splash/core/DCDomainDescriptor.hpp"
 #include "splash/core/logging.hpp"
 
 namespace splash
@@ -60,6 +62,10 @@ namespace splash
         // we can just open the last MPI position to get the total size.
         Dimensions mpi_position(mpi_size[0] - 1, mpi_size[1] - 1, mpi_size[2] - 1);
 
+        DCDomainDescriptor descriptor;
+        if (readDomainDescriptor(id, name, mpi_position, descriptor))
+            return descriptor.getGlobalDomain();
+
         Dimensions global_domain_size;
         Dimensions global_domain_offset;
 
@@ -78,6 +84,10 @@ namespace splash
         // this accesses the local information, for both normal and merged read
         Dimensions mpi_position(0, 0, 0);
 
+        DCDomainDescriptor descriptor;
+        if (readDomainDescriptor(id, name, mpi_position, descriptor))
+            return descriptor.getLocalDomain();
+
         Dimensions domain_size;
         Dimensions domain_offset;
 
@@ -87,6 +97,70 @@ namespace splash
         return Domain(domain_offset, domain_size);
     }
 
+    bool DomainCollector::readDomainInfo(int32_t id,
+            const char* name,
+            DomainInfo &info)
+    throw (DCException)
+    {
+        if ((fileStatus != FST_MERGING) && (fileStatus != FST_READING))
+            throw DCException("DomainCollector::readDomainInfo: this access is not permitted");
+
+        Dimensions mpi_position(0, 0, 0);
+
+        DCDomainDescriptor descriptor;
+        if (readDomainDescriptor(id, name, mpi_position, descriptor))
+        {
+            info.dataClass = descriptor.getDataClass();
+            info.localDomain = descriptor.getLocalDomain();
+            info.globalDomain = descriptor.getGlobalDomain();
+        } else
+        {
+            hid_t dset_handle = openDatasetHandle(id, name, &mpi_position);
+
+            // datasets without any domain annotation are skipped
+            if (H5Aexists(dset_handle, DOMCOL_ATTR_CLASS) <= 0)
+            {
+                closeDatasetHandle(dset_handle);
+                return false;
+            }
+
+            try
+            {
+                DCAttribute::readAttribute(DOMCOL_ATTR_CLASS, dset_handle,
+                        &(info.dataClass));
+                DCAttribute::readAttribute(DOMCOL_ATTR_OFFSET, dset_handle,
+                        info.localDomain.getOffset().getPointer());
+                DCAttribute::readAttribute(DOMCOL_ATTR_SIZE, dset_handle,
+                        info.localDomain.getSize().getPointer());
+                DCAttribute::readAttribute(DOMCOL_ATTR_GLOBAL_OFFSET, dset_handle,
+                        info.globalDomain.getOffset().getPointer());
+                DCAttribute::readAttribute(DOMCOL_ATTR_GLOBAL_SIZE, dset_handle,
+                        info.globalDomain.getSize().getPointer());
+            } catch (DCException e)
+            {
+                closeDatasetHandle(dset_handle);
+                throw e;
+            }
+
+            closeDatasetHandle(dset_handle);
+        }
+
+        std::string group_path, dset_name;
+        DCDataSet::getFullDataPath(name, SDC_GROUP_DATA, id, group_path, dset_name);
+
+        DCGroup group;
+        group.open(handles.get(mpi_position), group_path);
+
+        DCDataSet dataset(dset_name);
+        dataset.open(group.getHandle());
+        info.ndims = dataset.getNDims();
+        info.dataSize = dataset.getSize();
+        info.dataType = dataset.getDCDataType();
+        dataset.close();
+
+        return true;
+    }
+
     void DomainCollector::writeDomainAttributes(
             int32_t id,
             const char *name,
@@ -95,25 +169,41 @@ namespace splash
             const Domain globalDomain)
     throw (DCException)
     {
-        ColTypeInt32 int_t;
-        ColTypeDim dim_t;
-        
+        DCDomainDescriptor descriptor;
+        descriptor.set(dataClass, localDomain, globalDomain);
+
         hid_t dset_handle = openDatasetHandle(id, name, NULL);
         
-        DCAttribute::writeAttribute(DOMCOL_ATTR_CLASS, int_t.getDataType(),
-                dset_handle, &dataClass);
-        DCAttribute::writeAttribute(DOMCOL_ATTR_SIZE, dim_t.getDataType(),
-                dset_handle, localDomain.getSize().getPointer());
-        DCAttribute::writeAttribute(DOMCOL_ATTR_OFFSET, dim_t.getDataType(),
-                dset_handle, localDomain.getOffset().getPointer());
-        DCAttribute::writeAttribute(DOMCOL_ATTR_GLOBAL_SIZE, dim_t.getDataType(),
-                dset_handle, globalDomain.getSize().getPointer());
-        DCAttribute::writeAttribute(DOMCOL_ATTR_GLOBAL_OFFSET, dim_t.getDataType(),
-                dset_handle, globalDomain.getOffset().getPointer());
+        DCAttribute::writeAttribute(DOMCOL_ATTR_DOMAIN, descriptor.getDataType(),
+                dset_handle, descriptor.getBuffer());
         
         closeDatasetHandle(dset_handle);
     }
 
+    bool DomainCollector::readDomainDescriptor(
+            int32_t id,
+            const char *name,
+            Dimensions mpiPosition,
+            DCDomainDescriptor &descriptor)
+    throw (DCException)
+    {
+        hid_t dset_handle = openDatasetHandle(id, name, &mpiPosition);
+
+        // files written by older versions use separate attributes
+        bool found = false;
+        try
+        {
+            found = descriptor.readAttribute(dset_handle);
+        } catch (DCException e)
+        {
+            closeDatasetHandle(dset_handle);
+            throw e;
+        }
+
+        closeDatasetHandle(dset_handle);
+        return found;
+    }
+
     bool DomainCollector::readDomainInfoForRank(
             Dimensions mpiPosition,
             int32_t id,
@@ -122,6 +212,12 @@ namespace splash
             Domain &fileDomain)
     throw (DCException)
     {
+        DCDomainDescriptor descriptor;
+        if (readDomainDescriptor(id, name, mpiPosition, descriptor))
+        {
+            fileDomain = descriptor.getLocalDomain();
+            fileDomain.getOffset() += descriptor.getGlobalDomain().getOffset();
+        } else
         {
             hid_t dset_handle = openDatasetHandle(id, name, &mpiPosition);
             Dimensions global_domain_offset;
@@ -209,6 +305,10 @@ namespace splash
         const Dimensions &request_offset = requestDomain.getOffset();
         const Dimensions &request_size = requestDomain.getSize();
 
+        dst_offset.setRank(ndims, 0);
+        src_size.setRank(ndims, 1);
+        src_offset.setRank(ndims, 0);
+
         for (uint32_t i = 0; i < ndims; ++i)
         {
             dst_offset[i] = std::max((int64_t) clientDomain.getOffset()[i] - (int64_t) request_offset[i], (int64_t) 0);
@@ -364,6 +464,13 @@ namespace splash
         Dimensions data_size;
         DomDataClass tmp_data_class = UndefinedType;
 
+        DCDomainDescriptor descriptor;
+        if (readDomainDescriptor(id, name, mpiPosition, descriptor))
+        {
+            local_client_domain = descriptor.getLocalDomain();
+            global_client_domain = descriptor.getGlobalDomain();
+            tmp_data_class = descriptor.getDataClass();
+        } else
         {
             hid_t dset_handle = openDatasetHandle(id, name, &mpiPosition);
 
@@ -455,6 +562,8 @@ namespace splash
             bool lazyLoad)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, id, name);
+
         if ((fileStatus != FST_MERGING) && (fileStatus != FST_READING))
             throw DCException("DomainCollector::readDomain: this access is not permitted");
 
@@ -548,6 +657,7 @@ namespace splash
 
         Dimensions current_mpi_pos(min_dims);
         Dimensions point_dim(1, 1, 1);
+        point_dim.setRank(request_offset.getRank(), 1);
 
         // try to find top-left corner of requested domain
         // stop if no new file can be tested for the requested domain
@@ -691,6 +801,9 @@ namespace splash
             throw DCException("DomainCollector::readDomainLazy: This DomainData does not allow lazy loading");
         }
 
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, loadingRef->id,
+                loadingRef->name.c_str());
+
         if (loadingRef->dataClass == UndefinedType)
         {
             throw DCException("DomainCollector::readDomainLazy: DomainData has invalid data class");
@@ -19,13 +19,15 @@
  * If not, see <http://www.gnu.org/licenses/>. 
  */
 
-
+#define SPLASH_LOG_CATEGORY splash::LOG_FILE
 
 #include <limits>
 #include <iostream>
 #include <hdf5.h>
 
 #include "splash/core/HandleMgr.hpp"
+#include "splash/core/logging.hpp"
+#include "splash/Tracing.hpp"
 
 namespace splash
 {
@@ -35,6 +37,7 @@ namespace splash
     numHandles(0),
     mpiSize(1, 1, 1),
     fileNameScheme(fileNameScheme),
+    fileCreateProperties(H5P_FILE_CREATE_DEFAULT),
     fileFlags(0),
     singleFile(true),
     fileCreateCallback(NULL),
@@ -69,23 +72,25 @@ namespace splash
     }
 
     void HandleMgr::open(Dimensions mpiSize, const std::string baseFilename,
-            hid_t fileAccProperties, unsigned flags)
+            hid_t fileAccProperties, unsigned flags, hid_t fileCreateProperties)
     {
         this->numHandles = mpiSize.getScalarSize();
         this->mpiSize.set(mpiSize);
         this->filename = baseFilename;
         this->fileAccProperties = fileAccProperties;
+        this->fileCreateProperties = fileCreateProperties;
         this->fileFlags = flags;
         this->singleFile = false;
     }
 
     void HandleMgr::open(const std::string fullFilename,
-            hid_t fileAccProperties, unsigned flags)
+            hid_t fileAccProperties, unsigned flags, hid_t fileCreateProperties)
     {
         this->numHandles = 1;
         this->mpiSize.set(1, 1, 1);
         this->filename = fullFilename;
         this->fileAccProperties = fileAccProperties;
+        this->fileCreateProperties = fileCreateProperties;
         this->fileFlags = flags;
         this->singleFile = true;
     }
@@ -133,6 +138,10 @@ namespace splash
             if (handles.size() + 1 > maxHandles)
             {
                 HandleMap::iterator rmHandle = handles.find(leastAccIndex.index);
+                Tracing::Scope trace("file", "H5Fclose");
+                log_msg(2, "closing least accessed file %s to open file %s",
+                        posFromIndex(leastAccIndex.index).toString().c_str(),
+                        mpiPos.toString().c_str());
                 if (fileCloseCallback)
                 {
                     fileCloseCallback(rmHandle->second.handle,
@@ -162,15 +171,18 @@ namespace splash
             }
 
             H5Handle newHandle = 0;
+            const std::string fullFilename = filenameStream.str();
+            Tracing::Scope trace("file", "HandleMgr::get", fullFilename.c_str());
 
             // serve requests to create files once as create and as read/write afterwards
             if ((fileFlags & H5F_ACC_TRUNC) && (createdFiles.find(index) == createdFiles.end()))
             {
-                newHandle = H5Fcreate(filenameStream.str().c_str(), fileFlags,
-                        H5P_FILE_CREATE_DEFAULT, fileAccProperties);
+                log_msg(1, "creating file %s", fullFilename.c_str());
+                newHandle = H5Fcreate(fullFilename.c_str(), fileFlags,
+                        fileCreateProperties, fileAccProperties);
                 if (newHandle < 0)
                     throw DCException(getExceptionString("get", "Failed to create file",
-                        filenameStream.str().c_str()));
+                        fullFilename.c_str()));
 
                 createdFiles.insert(index);
 
@@ -183,10 +195,11 @@ namespace splash
                 if (fileFlags & H5F_ACC_TRUNC)
                     tmp_flags = H5F_ACC_RDWR;
 
-                newHandle = H5Fopen(filenameStream.str().c_str(), tmp_flags, fileAccProperties);
+                log_msg(1, "opening file %s", fullFilename.c_str());
+                newHandle = H5Fopen(fullFilename.c_str(), tmp_flags, fileAccProperties);
                 if (newHandle < 0)
                     throw DCException(getExceptionString("get", "Failed to open file",
-                        filenameStream.str().c_str()));
+                        fullFilename.c_str()));
 
                 if (fileOpenCallback)
                     fileOpenCallback(newHandle, index, fileOpenUserData);
@@ -215,10 +228,13 @@ namespace splash
 
     void HandleMgr::close()
     {
+        log_msg(1, "closing %llu files", (long long unsigned) handles.size());
+
         // clean internal state
         createdFiles.clear();
         filename = "";
         fileAccProperties = 0;
+        fileCreateProperties = H5P_FILE_CREATE_DEFAULT;
         fileFlags = 0;
         leastAccIndex.ctr = 0;
         leastAccIndex.index = 0;
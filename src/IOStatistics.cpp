@@ -0,0 +1,234 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <time.h>
+#include <fstream>
+#include <iomanip>
+
+#include "splash/IOStatistics.hpp"
+
+namespace splash
+{
+
+    uint64_t IOStatistics::transferCalls = 0;
+    uint64_t IOStatistics::transferBytes = 0;
+
+    static const char *operationNames[IOStatistics::OP_COUNT] = {
+        "write", "read", "append", "attribute", "group"
+    };
+
+    static double getWallTime()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (double) now.tv_sec + (double) now.tv_nsec * 1.0e-9;
+    }
+
+    static size_t getHistogramBin(uint64_t value)
+    {
+        size_t bin = 0;
+        while (value > 0 && bin < IOSTAT_HISTOGRAM_BINS - 1)
+        {
+            value >>= 1;
+            bin++;
+        }
+
+        return bin;
+    }
+
+    static void writeJSONString(std::ostream &out, const std::string &str)
+    {
+        out << "\"";
+        for (size_t i = 0; i < str.size(); ++i)
+        {
+            const unsigned char c = str[i];
+            if (c == '"' || c == '\\')
+                out << "\\" << c;
+            else if (c < 0x20)
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') <<
+                    (unsigned) c << std::dec << std::setfill(' ');
+            else
+                out << c;
+        }
+        out << "\"";
+    }
+
+    IOStatistics::_Counters::_Counters() :
+    calls(0),
+    bytes(0),
+    h5Calls(0),
+    time(0.0),
+    maxTime(0.0)
+    {
+        for (size_t i = 0; i < IOSTAT_HISTOGRAM_BINS; ++i)
+        {
+            timeHistogram[i] = 0;
+            sizeHistogram[i] = 0;
+        }
+    }
+
+    IOStatistics::Timer::Timer(IOStatistics &statistics, Operation op,
+            int32_t id, const char *name) :
+    statistics(statistics),
+    op(op),
+    id(id),
+    name(name),
+    outermost(statistics.activeTimers == 0),
+    startTime(0.0),
+    startCalls(IOStatistics::transferCalls),
+    startBytes(IOStatistics::transferBytes),
+    trace("collector", operationNames[op], name)
+    {
+        statistics.activeTimers++;
+        if (outermost)
+            startTime = getWallTime();
+    }
+
+    IOStatistics::Timer::~Timer()
+    {
+        statistics.activeTimers--;
+        if (outermost)
+        {
+            statistics.record(op, id, name, getWallTime() - startTime,
+                    IOStatistics::transferBytes - startBytes,
+                    IOStatistics::transferCalls - startCalls);
+        }
+    }
+
+    IOStatistics::IOStatistics() :
+    activeTimers(0)
+    {
+    }
+
+    void IOStatistics::reset()
+    {
+        for (size_t i = 0; i < OP_COUNT; ++i)
+            total[i] = Counters();
+
+        entries.clear();
+    }
+
+    void IOStatistics::addCounters(Counters &counters, double time,
+            uint64_t bytes, uint64_t h5Calls)
+    {
+        counters.calls++;
+        counters.bytes += bytes;
+        counters.h5Calls += h5Calls;
+        counters.time += time;
+        if (time > counters.maxTime)
+            counters.maxTime = time;
+
+        counters.timeHistogram[getHistogramBin((uint64_t) (time * 1.0e6))]++;
+        counters.sizeHistogram[getHistogramBin(bytes)]++;
+    }
+
+    void IOStatistics::record(Operation op, int32_t id, const char *name,
+            double time, uint64_t bytes, uint64_t h5Calls)
+    {
+        addCounters(total[op], time, bytes, h5Calls);
+
+        Key key(id, name != NULL ? name : "");
+        addCounters(entries[key].operations[op], time, bytes, h5Calls);
+    }
+
+    const IOStatistics::Counters& IOStatistics::getTotal(Operation op) const
+    {
+        return total[op];
+    }
+
+    const IOStatistics::EntryMap& IOStatistics::getEntries() const
+    {
+        return entries;
+    }
+
+    const char* IOStatistics::getOperationName(Operation op)
+    {
+        return operationNames[op];
+    }
+
+    void IOStatistics::addTransfer(uint64_t bytes, uint64_t calls)
+    {
+        transferCalls += calls;
+        transferBytes += bytes;
+    }
+
+    void IOStatistics::writeCounters(std::ostream &out, const Counters &counters)
+    {
+        out << "{\"calls\": " << counters.calls <<
+                ", \"bytes\": " << counters.bytes <<
+                ", \"h5_calls\": " << counters.h5Calls <<
+                ", \"time\": " << counters.time <<
+                ", \"max_time\": " << counters.maxTime;
+
+        out << ", \"time_histogram\": [";
+        for (size_t i = 0; i < IOSTAT_HISTOGRAM_BINS; ++i)
+            out << (i > 0 ? ", " : "") << counters.timeHistogram[i];
+
+        out << "], \"size_histogram\": [";
+        for (size_t i = 0; i < IOSTAT_HISTOGRAM_BINS; ++i)
+            out << (i > 0 ? ", " : "") << counters.sizeHistogram[i];
+
+        out << "]}";
+    }
+
+    void IOStatistics::writeJSON(std::ostream &out) const
+    {
+        out << "{\n  \"total\": {";
+        for (size_t op = 0; op < OP_COUNT; ++op)
+        {
+            out << (op > 0 ? "," : "") << "\n    \"" << operationNames[op] << "\": ";
+            writeCounters(out, total[op]);
+        }
+        out << "\n  },\n  \"entries\": [";
+
+        // only operations which have been called
+        for (EntryMap::const_iterator iter = entries.begin(); iter != entries.end(); ++iter)
+        {
+            out << (iter != entries.begin() ? "," : "") << "\n    {\"id\": " <<
+                    iter->first.first << ", \"name\": ";
+            writeJSONString(out, iter->first.second);
+
+            for (size_t op = 0; op < OP_COUNT; ++op)
+            {
+                if (iter->second.operations[op].calls == 0)
+                    continue;
+
+                out << ",\n     \"" << operationNames[op] << "\": ";
+                writeCounters(out, iter->second.operations[op]);
+            }
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    void IOStatistics::writeJSON(const std::string &filename) const
+    throw (DCException)
+    {
+        std::ofstream file(filename.c_str());
+        if (!file)
+            throw DCException(std::string("IOStatistics::writeJSON: failed to open ") + filename);
+
+        writeJSON(file);
+        if (!file)
+            throw DCException(std::string("IOStatistics::writeJSON: failed to write ") + filename);
+    }
+
+}
@@ -19,21 +19,55 @@
  * If not, see <http://www.gnu.org/licenses/>. 
  */
 
+#define SPLASH_LOG_CATEGORY splash::LOG_COLLECTOR
+
+#include <algorithm>
 #include <cassert>
 #include <set>
 #include <dirent.h>
+#include <sys/stat.h>
 #include <stdlib.h>
 #include <cstring>
 
 #include "splash/ParallelDataCollector.hpp"
+#include "splash/basetypes/basetypes_storage.hpp"
 #include "splash/core/DCParallelDataSet.hpp"
 #include "splash/core/DCAttribute.hpp"
+#include "splash/core/DCConversion.hpp"
 #include "splash/core/DCParallelGroup.hpp"
+#include "splash/core/DCHelper.hpp"
 #include "splash/core/logging.hpp"
 
 namespace splash
 {
 
+    /**
+     * CollectionType for the datatype of a declared dataset.
+     */
+    class DeclaredCollectionType : public CollectionType
+    {
+    public:
+
+        DeclaredCollectionType(hid_t datatype, const ColTypeStorage *storage) :
+        storage(storage)
+        {
+            this->type = datatype;
+        }
+
+        size_t getSize() const
+        {
+            return H5Tget_size(this->type);
+        }
+
+        const ColTypeStorage* getStorage() const
+        {
+            return storage;
+        }
+
+    private:
+        const ColTypeStorage *storage;
+    };
+
     /*******************************************************************************
      * PRIVATE FUNCTIONS
      *******************************************************************************/
@@ -61,6 +95,11 @@ namespace splash
         H5Pset_cache(fileAccProperties, metaCacheElements, rawCacheElements, rawCacheSize, policy);
 
         log_msg(3, "Raw Data Cache (File) = %llu KiB", (long long unsigned) (rawCacheSize / 1024));
+
+#if (PDC_COLL_METADATA==1)
+        // metadata modifications are collective anyway, flush them with collective I/O
+        H5Pset_coll_metadata_write(fileAccProperties, true);
+#endif
     }
 
     std::string ParallelDataCollector::getFullFilename(uint32_t id, std::string baseFilename)
@@ -91,27 +130,30 @@ namespace splash
         mpiPos[0] = index % mpiSize[0];
     }
 
-    void ParallelDataCollector::listFilesInDir(const std::string baseFilename, std::set<int32_t> &ids)
-    throw (DCException)
+    void ParallelDataCollector::splitBaseFilename(const std::string baseFilename,
+            std::string &dirPath, std::string &prefix)
     {
-        log_msg(2, "listing files for %s", baseFilename.c_str());
-
-        /* Split baseFilename into path and name prefix.
-         * Always append '_' since PDC filenames are 'prefix_timestep.h5'.
-         * e.g. '/path/to/filename' -> dir_path='/path/to/' name='filename_'
-         */
-        std::string dir_path, name;
+        /* Always append '_' since PDC filenames are 'prefix_timestep.h5'. */
         std::string::size_type pos = baseFilename.find_last_of('/');
         if (pos == std::string::npos)
         {
-            dir_path.assign(".");
-            name.assign(baseFilename);
+            dirPath.assign(".");
+            prefix.assign(baseFilename);
         } else
         {
-            dir_path.assign(baseFilename.c_str(), baseFilename.c_str() + pos);
-            name.assign(baseFilename.c_str() + pos + 1);
+            dirPath.assign(baseFilename.c_str(), baseFilename.c_str() + pos);
+            prefix.assign(baseFilename.c_str() + pos + 1);
         }
-        name.append("_");
+        prefix.append("_");
+    }
+
+    void ParallelDataCollector::listFilesInDir(const std::string baseFilename, std::set<int32_t> &ids)
+    throw (DCException)
+    {
+        log_msg(2, "listing files for %s", baseFilename.c_str());
+
+        std::string dir_path, name;
+        splitBaseFilename(baseFilename, dir_path, name);
 
         dirent *dp = NULL;
         DIR *dirp = NULL;
@@ -151,6 +193,100 @@ namespace splash
         (void) closedir(dirp);
     }
 
+    bool ParallelDataCollector::getCatalogMTime(const FileCatalog &catalog,
+            int64_t &mtimeSec, int64_t &mtimeNsec)
+    {
+        std::string dir_path, name;
+        splitBaseFilename(catalog.baseFilename, dir_path, name);
+
+        struct stat dir_stat;
+        if (stat(dir_path.c_str(), &dir_stat) != 0)
+            return false;
+
+        mtimeSec = dir_stat.st_mtim.tv_sec;
+        mtimeNsec = dir_stat.st_mtim.tv_nsec;
+        return true;
+    }
+
+    void ParallelDataCollector::updateCatalog(bool collective)
+    throw (DCException)
+    {
+        FileCatalog &catalog = options.catalog;
+
+        /* status: 0 = unchanged, 1 = rescanned, -1 = scan failed */
+        int status = 0;
+        std::string error_msg;
+
+        if (!collective || options.mpiRank == 0)
+        {
+            int64_t mtime_sec = 0, mtime_nsec = 0;
+            bool has_mtime = getCatalogMTime(catalog, mtime_sec, mtime_nsec);
+
+            if (!catalog.valid || !has_mtime || mtime_sec != catalog.mtimeSec ||
+                    mtime_nsec != catalog.mtimeNsec)
+            {
+                status = 1;
+                catalog.ids.clear();
+                catalog.valid = false;
+
+                try
+                {
+                    listFilesInDir(catalog.baseFilename, catalog.ids);
+                } catch (DCException e)
+                {
+                    status = -1;
+                    error_msg = e.what();
+                }
+
+                // take the directory time from before the scan,
+                // a concurrent change triggers another scan later
+                if (status == 1 && has_mtime)
+                {
+                    catalog.mtimeSec = mtime_sec;
+                    catalog.mtimeNsec = mtime_nsec;
+                    catalog.valid = true;
+                }
+            } else
+                log_msg(3, "using cached file list for %s", catalog.baseFilename.c_str());
+        }
+
+        if (collective && options.mpiSize > 1)
+        {
+            // distribute the scan result of the root process
+            MPI_Bcast(&status, 1, MPI_INT, 0, options.mpiComm);
+
+            if (status == 1)
+            {
+                int64_t header[3] = {catalog.mtimeSec, catalog.mtimeNsec,
+                    (int64_t) catalog.ids.size()};
+                MPI_Bcast(header, 3, MPI_INT64_T, 0, options.mpiComm);
+
+                std::vector<int32_t> ids(catalog.ids.begin(), catalog.ids.end());
+                ids.resize(header[2]);
+                if (header[2] > 0)
+                    MPI_Bcast(&(ids[0]), header[2], MPI_INT32_T, 0, options.mpiComm);
+
+                if (options.mpiRank != 0)
+                {
+                    catalog.ids.clear();
+                    catalog.ids.insert(ids.begin(), ids.end());
+                    catalog.mtimeSec = header[0];
+                    catalog.mtimeNsec = header[1];
+                    catalog.valid = true;
+                }
+            }
+        }
+
+        if (status < 0)
+        {
+            if (!collective || options.mpiRank == 0)
+                throw DCException(error_msg);
+            else
+                throw DCException(getExceptionString("updateCatalog",
+                    "Failed to list files on root process"));
+        }
+    }
+
     /*******************************************************************************
      * PUBLIC FUNCTIONS
      *******************************************************************************/
@@ -158,6 +294,7 @@ namespace splash
     ParallelDataCollector::ParallelDataCollector(MPI_Comm comm, MPI_Info info,
             const Dimensions topology, uint32_t maxFileHandles) :
     handles(maxFileHandles, HandleMgr::FNS_ITERATIONS),
+    fileCreateProperties(-1),
     fileStatus(FST_CLOSED)
     {
         parseEnvVars();
@@ -172,8 +309,12 @@ namespace splash
         options.mpiSize = topology.getScalarSize();
         options.mpiTopology.set(topology);
         options.maxID = -1;
+        options.catalog.valid = false;
+        options.catalog.mtimeSec = 0;
+        options.catalog.mtimeNsec = 0;
         
         setLogMpiRank(options.mpiRank);
+        Tracing::setProcessID(options.mpiRank);
 
         if (H5open() < 0)
             throw DCException(getExceptionString("ParallelDataCollector",
@@ -197,6 +338,7 @@ namespace splash
 
     ParallelDataCollector::~ParallelDataCollector()
     {
+        clearDeclared();
         H5Pclose(fileAccProperties);
     }
     
@@ -223,6 +365,15 @@ namespace splash
             throw DCException(getExceptionString("open", "this access is not permitted"));
 
         this->baseFilename.assign(filename);
+        this->statisticsFile = attr.statisticsFile;
+
+        // keep cached file IDs only for the same file set
+        if (options.catalog.baseFilename != this->baseFilename)
+        {
+            options.catalog.baseFilename = this->baseFilename;
+            options.catalog.ids.clear();
+            options.catalog.valid = false;
+        }
 
         switch (attr.fileAccType)
         {
@@ -236,6 +387,9 @@ namespace splash
             case FAT_CREATE:
                 openCreate(filename, attr);
                 break;
+            case FAT_CREATE_INMEMORY:
+                throw DCException(getExceptionString("open",
+                        "FAT_CREATE_INMEMORY is not supported"));
         }
     }
 
@@ -244,20 +398,67 @@ namespace splash
         log_msg(1, "closing parallel data collector");
 
         // close opened hdf5 file handles
-        handles.close();
+        {
+            Tracing::Scope trace("file", "HandleMgr::close");
+            handles.close();
+        }
+
+        if (fileCreateProperties >= 0)
+        {
+            H5Pclose(fileCreateProperties);
+            fileCreateProperties = -1;
+        }
+
+        clearDeclared();
+
+        if (!statisticsFile.empty())
+        {
+            std::stringstream statistics_filename;
+            statistics_filename << statisticsFile << "_" << options.mpiRank;
+            try
+            {
+                statistics.writeJSON(statistics_filename.str());
+            } catch (DCException e)
+            {
+                log_msg(0, "Exception: %s", e.what());
+            }
+            statisticsFile.clear();
+        }
+
+        // append the events of this file to the trace
+        try
+        {
+            Tracing::flush();
+        } catch (DCException e)
+        {
+            log_msg(0, "Exception: %s", e.what());
+        }
 
         options.maxID = -1;
 
         fileStatus = FST_CLOSED;
     }
 
+    const IOStatistics& ParallelDataCollector::getStatistics() const
+    {
+        return statistics;
+    }
+
+    void ParallelDataCollector::resetStatistics()
+    {
+        statistics.reset();
+    }
+
     int32_t ParallelDataCollector::getMaxID()
     {
-        std::set<int32_t> ids;
-        listFilesInDir(this->baseFilename, ids);
+        updateCatalog(false);
 
+        // -1 if no files exist, as in SerialDataCollector
+        const std::set<int32_t> &ids = options.catalog.ids;
         if (ids.size() > 0)
             options.maxID = *(ids.rbegin());
+        else
+            options.maxID = -1;
 
         return options.maxID;
     }
@@ -270,8 +471,11 @@ namespace splash
     void ParallelDataCollector::getEntryIDs(int32_t *ids, size_t *count)
     throw (DCException)
     {
-        std::set<int32_t> file_ids;
-        listFilesInDir(this->baseFilename, file_ids);
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, -1, NULL);
+
+        updateCatalog(false);
+
+        const std::set<int32_t> &file_ids = options.catalog.ids;
 
         if (count != NULL)
             *count = file_ids.size();
@@ -292,6 +496,8 @@ namespace splash
             size_t *count)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, id, NULL);
+
         std::stringstream group_id_name;
         group_id_name << SDC_GROUP_DATA << "/" << id;
 
@@ -314,6 +520,8 @@ namespace splash
             void *data)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_ATTRIBUTE, id, NULL);
+
         if (name == NULL || data == NULL)
             throw DCException(getExceptionString("readGlobalAttribute", "a parameter was null"));
 
@@ -339,6 +547,8 @@ namespace splash
             const void* data)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_ATTRIBUTE, id, NULL);
+
         if (name == NULL || data == NULL)
             throw DCException(getExceptionString("writeGlobalAttribute", "a parameter was null"));
 
@@ -365,6 +575,8 @@ namespace splash
             Dimensions* /*mpiPosition*/)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_ATTRIBUTE, id, dataName);
+
         // mpiPosition is ignored
         if (attrName == NULL || data == NULL)
             throw DCException(getExceptionString("readAttribute", "a parameter was null"));
@@ -421,6 +633,8 @@ namespace splash
             const void* data)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_ATTRIBUTE, id, dataName);
+
         if (attrName == NULL || data == NULL)
             throw DCException(getExceptionString("writeAttribute", "a parameter was null"));
 
@@ -486,6 +700,8 @@ namespace splash
             void* buf)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, id, name);
+
         if (fileStatus != FST_READING && fileStatus != FST_WRITING)
             throw DCException(getExceptionString("read", "this access is not permitted"));
 
@@ -494,6 +710,65 @@ namespace splash
                 Dimensions(0, 0, 0), sizeRead, ndims, buf);
     }
 
+    void ParallelDataCollector::read(int32_t id,
+            const CollectionType& type,
+            const char* name,
+            const Dimensions dstBuffer,
+            const Dimensions dstOffset,
+            Dimensions &sizeRead,
+            void* buf)
+    throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, id, name);
+
+        if (fileStatus != FST_READING && fileStatus != FST_WRITING)
+            throw DCException(getExceptionString("read", "this access is not permitted"));
+
+        uint32_t ndims = 0;
+        readCompleteDataSet(handles.get(id), id, name, dstBuffer, dstOffset,
+                Dimensions(0, 0, 0), sizeRead, ndims, buf, &type);
+    }
+
+    void ParallelDataCollector::readComponents(int32_t id,
+            const CollectionType& type,
+            const char* name,
+            const Dimensions dstBuffer,
+            const Dimensions dstOffset,
+            Dimensions &sizeRead,
+            void* const* components)
+    throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, id, name);
+
+        if (name == NULL)
+            throw DCException(getExceptionString("readComponents", "parameter name is NULL"));
+
+        if (fileStatus != FST_READING && fileStatus != FST_WRITING)
+            throw DCException(getExceptionString("readComponents", "this access is not permitted"));
+
+        std::string group_path, dset_name;
+        DCDataSet::getFullDataPath(name, SDC_GROUP_DATA, id, group_path, dset_name);
+
+        DCParallelGroup group;
+        group.open(handles.get(id), group_path);
+
+        DCParallelDataSet dataset(dset_name.c_str());
+        dataset.setMemoryType(type.getDataType());
+        dataset.open(group.getHandle());
+
+        uint32_t ndims = 0;
+        try
+        {
+            dataset.readComponents(dstBuffer, dstOffset, dataset.getSize(), Dimensions(0, 0, 0),
+                    sizeRead, ndims, components);
+        } catch (DCException)
+        {
+            dataset.close();
+            throw;
+        }
+        dataset.close();
+    }
+
     void ParallelDataCollector::read(int32_t id,
             const Dimensions localSize,
             const Dimensions globalOffset,
@@ -514,6 +789,8 @@ namespace splash
             Dimensions &sizeRead,
             void* buf) throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, id, name);
+
         if (fileStatus != FST_READING && fileStatus != FST_WRITING)
             throw DCException(getExceptionString("read", "this access is not permitted"));
 
@@ -526,6 +803,8 @@ namespace splash
             const Selection select, const char* name, const void* buf)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_WRITE, id, name);
+
         Dimensions globalSize, globalOffset;
         gatherMPIWrites(ndims, select.count, globalSize, globalOffset);
 
@@ -537,6 +816,78 @@ namespace splash
             const Dimensions globalOffset,
             const CollectionType& type, uint32_t ndims, 
             const Selection select, const char* name, const void* buf)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_WRITE, id, name);
+
+        writeData(id, globalSize, globalOffset, type, ndims, select, name,
+                buf, NULL, false);
+    }
+
+    void ParallelDataCollector::writeComponents(int32_t id, const CollectionType& type,
+            uint32_t ndims, const Selection select, const char* name,
+            const void* const* components)
+    throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_WRITE, id, name);
+
+        Dimensions globalSize, globalOffset;
+        gatherMPIWrites(ndims, select.count, globalSize, globalOffset);
+
+        writeComponents(id, globalSize, globalOffset,
+                type, ndims, select, name, components);
+    }
+
+    void ParallelDataCollector::writeComponents(int32_t id, const Dimensions globalSize,
+            const Dimensions globalOffset,
+            const CollectionType& type, uint32_t ndims,
+            const Selection select, const char* name, const void* const* components)
+    throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_WRITE, id, name);
+
+        uint32_t num_components = 0;
+        if (!DCConversion::getComponents(type.getDataType(), num_components))
+            throw DCException(getExceptionString("writeComponents",
+                "datatype cannot be written from components"));
+
+        writeData(id, globalSize, globalOffset, type, ndims, select, name,
+                NULL, components, true);
+    }
+
+    /**
+     * Writes data or separate buffers per member (componentWise)
+     * to an open dataset.
+     * Slab writes of all processes are matched for collective I/O.
+     */
+    static void writeToDataSet(DCParallelDataSet &dataset, MPI_Comm comm,
+            const Selection srcSelect, const Dimensions globalOffset,
+            const void* data, const void* const* components, bool componentWise)
+    throw (DCException)
+    {
+        if (!componentWise)
+        {
+            dataset.write(srcSelect, globalOffset, data);
+            return;
+        }
+
+        uint64_t local_slabs = components ? dataset.getComponentSlabs(srcSelect.count) : 0;
+        uint64_t num_slabs = 0;
+        {
+            Tracing::Scope trace("mpi", "MPI_Allreduce", "writeComponents");
+            if (MPI_Allreduce(&local_slabs, &num_slabs, 1, MPI_UINT64_T,
+                    MPI_MAX, comm) != MPI_SUCCESS)
+                throw DCException("Exception for ParallelDataCollector::writeComponents: MPI_Allreduce failed");
+        }
+
+        dataset.writeComponents(srcSelect, globalOffset, components, num_slabs);
+    }
+
+    void ParallelDataCollector::writeData(int32_t id, const Dimensions globalSize,
+            const Dimensions globalOffset,
+            const CollectionType& type, uint32_t ndims,
+            const Selection select, const char* name, const void* buf,
+            const void* const* components, bool componentWise)
+    throw (DCException)
     {
         if (name == NULL)
             throw DCException(getExceptionString("write", "parameter name is NULL"));
@@ -544,19 +895,54 @@ namespace splash
         if (fileStatus == FST_CLOSED || fileStatus == FST_READING)
             throw DCException(getExceptionString("write", "this access is not permitted"));
 
-        if (ndims < 1 || ndims > 3)
+        if (ndims < 1 || ndims > DSP_DIM_MAX)
             throw DCException(getExceptionString("write", "maximum dimension is invalid"));
 
         // create group for this id/iteration
         std::string group_path, dset_name;
         DCDataSet::getFullDataPath(name, SDC_GROUP_DATA, id, group_path, dset_name);
 
+        if (createdDataSets.find(group_path + "/" + dset_name) != createdDataSets.end())
+        {
+            // dataset has been created by createDeclared, only write raw data
+            DCParallelGroup group;
+            group.setCollectiveMetadata();
+            group.open(handles.get(id), group_path);
+
+            DCParallelDataSet dataset(dset_name.c_str());
+            dataset.setCollectiveMetadata();
+            dataset.open(group.getHandle());
+
+            if (dataset.getNDims() != ndims)
+            {
+                dataset.close();
+                throw DCException(getExceptionString("write",
+                        "rank differs from declared dataset", name));
+            }
+
+            const Dimensions declared_size(dataset.getSize());
+            for (uint32_t i = 0; i < ndims; ++i)
+            {
+                if (declared_size[i] != globalSize[i])
+                {
+                    dataset.close();
+                    throw DCException(getExceptionString("write",
+                            "globalSize differs from declared dataset", name));
+                }
+            }
+
+            writeToDataSet(dataset, options.mpiComm, select, globalOffset,
+                    buf, components, componentWise);
+            dataset.close();
+            return;
+        }
+
         DCParallelGroup group;
         group.openCreate(handles.get(id), group_path);
 
         // write data to the group
         writeDataSet(group.getHandle(), globalSize, globalOffset, type, ndims,
-                select, dset_name.c_str(), buf);
+                select, dset_name.c_str(), buf, components, componentWise);
     }
 
     void ParallelDataCollector::reserve(int32_t id,
@@ -565,13 +951,15 @@ namespace splash
             const CollectionType& type,
             const char* name) throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_WRITE, id, name);
+
         if (name == NULL)
             throw DCException(getExceptionString("reserve", "a parameter was NULL"));
 
         if (fileStatus == FST_CLOSED || fileStatus == FST_READING)
             throw DCException(getExceptionString("write", "this access is not permitted"));
 
-        if (ndims < 1 || ndims > 3)
+        if (ndims < 1 || ndims > DSP_DIM_MAX)
             throw DCException(getExceptionString("write", "maximum dimension is invalid"));
 
         reserveInternal(id, globalSize, ndims, type, name);
@@ -585,13 +973,15 @@ namespace splash
             const CollectionType& type,
             const char* name) throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_WRITE, id, name);
+
         if (name == NULL)
             throw DCException(getExceptionString("reserve", "a parameter was NULL"));
 
         if (fileStatus == FST_CLOSED || fileStatus == FST_READING)
             throw DCException(getExceptionString("write", "this access is not permitted"));
 
-        if (ndims < 1 || ndims > 3)
+        if (ndims < 1 || ndims > DSP_DIM_MAX)
             throw DCException(getExceptionString("write", "maximum dimension is invalid"));
 
         Dimensions global_size, global_offset;
@@ -606,6 +996,102 @@ namespace splash
             globalOffset->set(global_offset);
     }
 
+    void ParallelDataCollector::declare(int32_t id,
+            const Dimensions globalSize,
+            uint32_t ndims,
+            const CollectionType& type,
+            const char* name) throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_WRITE, id, name);
+
+        if (name == NULL)
+            throw DCException(getExceptionString("declare", "a parameter was NULL"));
+
+        if (fileStatus == FST_CLOSED || fileStatus == FST_READING)
+            throw DCException(getExceptionString("declare", "this access is not permitted"));
+
+        if (ndims < 1 || ndims > DSP_DIM_MAX)
+            throw DCException(getExceptionString("declare", "maximum dimension is invalid"));
+
+        DeclaredDataSet declared;
+        declared.id = id;
+        declared.name.assign(name);
+        declared.globalSize.set(globalSize);
+        declared.ndims = ndims;
+        declared.datatype = H5Tcopy(type.getDataType());
+
+        if (declared.datatype < 0)
+            throw DCException(getExceptionString("declare", "failed to copy datatype", name));
+
+        // keep the storage description to create the dataset with its storage datatype
+        declared.storage = NULL;
+        if (type.getStorage())
+            declared.storage = new ColTypeStorage(*(type.getStorage()));
+
+        declaredDataSets.push_back(declared);
+    }
+
+    void ParallelDataCollector::createDeclared(int32_t id) throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_WRITE, id, NULL);
+
+        log_msg(1, "creating declared datasets for group %d", id);
+
+        if (fileStatus == FST_CLOSED || fileStatus == FST_READING)
+            throw DCException(getExceptionString("createDeclared", "this access is not permitted"));
+
+        H5Handle h5File = handles.get(id);
+
+        std::vector<DeclaredDataSet>::iterator iter = declaredDataSets.begin();
+        while (iter != declaredDataSets.end())
+        {
+            if (iter->id != id)
+            {
+                ++iter;
+                continue;
+            }
+
+            std::string group_path, dset_name;
+            DCDataSet::getFullDataPath(iter->name, SDC_GROUP_DATA, id, group_path, dset_name);
+
+            DCParallelGroup group;
+            group.setCollectiveMetadata();
+            group.openCreate(h5File, group_path);
+
+            DeclaredCollectionType type(iter->datatype, iter->storage);
+            DCParallelDataSet dataset(dset_name.c_str());
+            dataset.setCollectiveMetadata();
+
+            if (this->options.enableCompression)
+            {
+                // local blocks are not known yet, align chunks to an even
+                // split of the global size over the MPI topology instead
+                Dimensions local_size(iter->globalSize);
+                for (uint32_t i = 0; i < iter->ndims && i < 3; ++i)
+                {
+                    const hsize_t procs = options.mpiTopology[i];
+                    local_size[i] = (procs > 0 && local_size[i] % procs == 0) ?
+                            local_size[i] / procs : 0;
+                }
+
+                Dimensions chunk_dims;
+                if (getAlignedChunkDims(iter->ndims, local_size, type.getSize(), chunk_dims))
+                    dataset.setChunkDims(chunk_dims);
+            }
+
+            // not extensible
+            dataset.create(type, group.getHandle(), iter->globalSize, iter->ndims,
+                    this->options.enableCompression, false);
+            dataset.close();
+
+            createdDataSets.insert(group_path + "/" + dset_name);
+
+            H5Tclose(iter->datatype);
+            delete iter->storage;
+            iter = declaredDataSets.erase(iter);
+        }
+    }
+
     void ParallelDataCollector::append(int32_t id,
             const Dimensions size,
             uint32_t ndims,
@@ -613,13 +1099,15 @@ namespace splash
             const char *name,
             const void *buf)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_APPEND, id, name);
+
         if (name == NULL)
             throw DCException(getExceptionString("append", "parameter name is NULL"));
 
         if (fileStatus == FST_CLOSED || fileStatus == FST_READING)
             throw DCException(getExceptionString("append", "this access is not permitted"));
 
-        if (ndims < 1 || ndims > 3)
+        if (ndims < 1 || ndims > DSP_DIM_MAX)
             throw DCException(getExceptionString("append", "maximum dimension is invalid"));
 
         // create group for this id/iteration
@@ -643,9 +1131,121 @@ namespace splash
         dataset.close();
     }
 
+    void ParallelDataCollector::reserveAndAppend(int32_t id,
+            const CollectionType& type,
+            size_t count,
+            const char *name,
+            const void *buf,
+            Dimensions *globalOffset)
+    throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_APPEND, id, name);
+
+        if (name == NULL)
+            throw DCException(getExceptionString("reserveAndAppend", "parameter name is NULL"));
+
+        if (fileStatus == FST_CLOSED || fileStatus == FST_READING)
+            throw DCException(getExceptionString("reserveAndAppend", "this access is not permitted"));
+
+        // local offset and global number of elements and writing processes
+        uint64_t local_info[2] = {count, (count > 0) ? 1 : 0};
+        uint64_t global_info[2] = {0, 0};
+        uint64_t local_offset = 0;
+
+        {
+            Tracing::Scope trace("mpi", "MPI_Exscan", "reserveAndAppend");
+            if (MPI_Exscan(local_info, &local_offset, 1, MPI_UNSIGNED_LONG_LONG,
+                    MPI_SUM, options.mpiComm) != MPI_SUCCESS)
+                throw DCException(getExceptionString("reserveAndAppend", "MPI_Exscan failed"));
+        }
+
+        // result of MPI_Exscan is undefined on the first process
+        if (options.mpiRank == 0)
+            local_offset = 0;
+
+        {
+            Tracing::Scope trace("mpi", "MPI_Allreduce", "reserveAndAppend");
+            if (MPI_Allreduce(local_info, global_info, 2, MPI_UNSIGNED_LONG_LONG,
+                    MPI_SUM, options.mpiComm) != MPI_SUCCESS)
+                throw DCException(getExceptionString("reserveAndAppend", "MPI_Allreduce failed"));
+        }
+
+        std::string group_path, dset_name;
+        DCDataSet::getFullDataPath(name, SDC_GROUP_DATA, id, group_path, dset_name);
+
+        DCParallelGroup group;
+        group.openCreate(handles.get(id), group_path);
+
+        DCParallelDataSet dataset(dset_name.c_str());
+        uint64_t previous_size = 0;
+        bool create = true;
+
+        if (H5Lexists(group.getHandle(), dset_name.c_str(), H5P_LINK_ACCESS_DEFAULT) > 0)
+        {
+            dataset.open(group.getHandle());
+
+            // empty datasets have no extent and are created again
+            if (dataset.getNDims() != 0)
+            {
+                if (dataset.getNDims() != 1)
+                {
+                    dataset.close();
+                    throw DCException(getExceptionString("reserveAndAppend",
+                            "dataset is not 1-dimensional", dset_name.c_str()));
+                }
+
+                if (!dataset.isDataType(type))
+                {
+                    dataset.close();
+                    throw DCException(getExceptionString("reserveAndAppend",
+                            "datatype differs from existing dataset", dset_name.c_str()));
+                }
+
+                previous_size = dataset.getSize()[0];
+                create = false;
+            } else
+                dataset.close();
+        }
+
+        // extensible and without filters as some processes might write independently,
+        // the chunk size does not depend on the size of the first append
+        if (create)
+        {
+            const size_t type_size = type.getStorage() ?
+                    type.getStorage()->getStorageSize() : type.getSize();
+            dataset.setChunkDims(Dimensions(
+                    std::max((size_t) 1, PDC_APPEND_CHUNK_SIZE / type_size), 1, 1));
+            dataset.create(type, group.getHandle(), Dimensions(global_info[0], 1, 1),
+                1, false, true);
+        }
+        else if (global_info[0] > 0)
+            dataset.setExtent(Dimensions(previous_size + global_info[0], 1, 1));
+
+        Dimensions dst_offset(previous_size + local_offset, 0, 0);
+
+        if (global_info[1] == (uint64_t) options.mpiSize)
+        {
+            // all processes contribute data, write collectively
+            dataset.write(Selection(Dimensions(count, 1, 1)), dst_offset, buf);
+        } else
+        {
+            // file regions of writing processes do not overlap
+            dataset.setWriteIndependent();
+            if (count > 0)
+                dataset.write(Selection(Dimensions(count, 1, 1)), dst_offset, buf);
+        }
+
+        dataset.close();
+
+        if (globalOffset)
+            globalOffset->set(dst_offset);
+    }
+
     void ParallelDataCollector::remove(int32_t id)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, id, NULL);
+
         log_msg(1, "removing group %d", id);
 
         if (fileStatus == FST_CLOSED || fileStatus == FST_READING)
@@ -656,6 +1256,17 @@ namespace splash
 
         DCParallelGroup::remove(handles.get(id), group_id_name.str());
 
+        // forget datasets created for this iteration
+        const std::string group_prefix = group_id_name.str() + "/";
+        std::set<std::string>::iterator iter = createdDataSets.begin();
+        while (iter != createdDataSets.end())
+        {
+            if (iter->compare(0, group_prefix.size(), group_prefix) == 0)
+                createdDataSets.erase(iter++);
+            else
+                ++iter;
+        }
+
         // update maxID
         getMaxID();
     }
@@ -663,6 +1274,8 @@ namespace splash
     void ParallelDataCollector::remove(int32_t id, const char* name)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, id, name);
+
         log_msg(1, "removing dataset %s from group %d", name, id);
 
         if (fileStatus == FST_CLOSED || fileStatus == FST_READING)
@@ -681,6 +1294,8 @@ namespace splash
         {
             throw DCException(getExceptionString("remove", "failed to remove dataset", name));
         }
+
+        createdDataSets.erase(group_path + "/" + dset_name);
     }
 
     void ParallelDataCollector::createReference(int32_t srcID,
@@ -689,6 +1304,8 @@ namespace splash
             const char *dstName)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, dstID, dstName);
+
         if (srcName == NULL || dstName == NULL)
             throw DCException(getExceptionString("createReference", "a parameter was NULL"));
 
@@ -733,6 +1350,8 @@ namespace splash
             Dimensions /*stride*/)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, dstID, dstName);
+
         if (srcName == NULL || dstName == NULL)
             throw DCException(getExceptionString("createReference", "a parameter was NULL"));
 
@@ -755,6 +1374,19 @@ namespace splash
      * PROTECTED FUNCTIONS
      *******************************************************************************/
 
+    void ParallelDataCollector::clearDeclared()
+    {
+        for (std::vector<DeclaredDataSet>::const_iterator iter = declaredDataSets.begin();
+                iter != declaredDataSets.end(); ++iter)
+        {
+            H5Tclose(iter->datatype);
+            delete iter->storage;
+        }
+
+        declaredDataSets.clear();
+        createdDataSets.clear();
+    }
+
     void ParallelDataCollector::fileCreateCallback(H5Handle handle, uint32_t index, void *userData)
     throw (DCException)
     {
@@ -770,6 +1402,14 @@ namespace splash
         group.close();
 
         writeHeader(handle, index, options->enableCompression, options->mpiTopology);
+
+        // register the new file without scanning the directory again
+        FileCatalog &catalog = options->catalog;
+        if (catalog.valid)
+        {
+            catalog.ids.insert(index);
+            catalog.valid = getCatalogMTime(catalog, catalog.mtimeSec, catalog.mtimeNsec);
+        }
     }
 
     void ParallelDataCollector::fileOpenCallback(H5Handle /*handle*/, uint32_t index, void *userData)
@@ -805,20 +1445,32 @@ namespace splash
     }
 
     void ParallelDataCollector::openCreate(const char *filename,
-            FileCreationAttr& /*attr*/)
+            FileCreationAttr& attr)
     throw (DCException)
     {
         this->fileStatus = FST_CREATING;
 
-        // filters are currently not supported by parallel HDF5
-        //this->options.enableCompression = attr.enableCompression;
-
-        log_msg(1, "compression = 0");
+        setCompression(attr.enableCompression);
 
         options.maxID = -1;
 
+        hid_t create_properties = H5P_FILE_CREATE_DEFAULT;
+        if (attr.trackFreeSpace)
+        {
+            fileCreateProperties = DCHelper::createFreeSpaceTrackingPList();
+            if (fileCreateProperties < 0)
+            {
+                this->fileStatus = FST_CLOSED;
+                throw DCException(getExceptionString("openCreate",
+                        "Failed to set free space tracking", filename));
+            }
+
+            create_properties = fileCreateProperties;
+        }
+
         // open file
-        handles.open(Dimensions(1, 1, 1), filename, fileAccProperties, H5F_ACC_TRUNC);
+        handles.open(Dimensions(1, 1, 1), filename, fileAccProperties, H5F_ACC_TRUNC,
+                create_properties);
     }
 
     void ParallelDataCollector::openRead(const char* filename, FileCreationAttr& /*attr*/)
@@ -826,24 +1478,83 @@ namespace splash
     {
         this->fileStatus = FST_READING;
 
+        updateCatalog(true);
         getMaxID();
 
         handles.open(Dimensions(1, 1, 1), filename, fileAccProperties, H5F_ACC_RDONLY);
     }
 
-    void ParallelDataCollector::openWrite(const char* filename, FileCreationAttr& /*attr*/)
+    void ParallelDataCollector::openWrite(const char* filename, FileCreationAttr& attr)
     throw (DCException)
     {
         this->fileStatus = FST_WRITING;
 
+        updateCatalog(true);
         getMaxID();
 
-        // filters are currently not supported by parallel HDF5
-        //this->options.enableCompression = attr.enableCompression;
+        setCompression(attr.enableCompression);
 
         handles.open(Dimensions(1, 1, 1), filename, fileAccProperties, H5F_ACC_RDWR);
     }
 
+    void ParallelDataCollector::setCompression(bool enableCompression)
+    {
+#if (PDC_PARALLEL_FILTERS==1)
+        this->options.enableCompression = enableCompression;
+#else
+        // filters are not supported by this version of parallel HDF5
+        if (enableCompression)
+            log_msg(1, "compression requires parallel HDF5 >= 1.10.2, disabled");
+
+        this->options.enableCompression = false;
+#endif
+
+        log_msg(1, "compression = %d", this->options.enableCompression);
+    }
+
+    bool ParallelDataCollector::getAlignedChunkDims(uint32_t ndims,
+            const Dimensions localSize, size_t typeSize, Dimensions &chunkDims)
+    throw (DCException)
+    {
+        const uint32_t rank = std::max(ndims, (uint32_t) 3);
+        uint64_t local_size[DSP_DIM_MAX];
+        uint64_t min_size[DSP_DIM_MAX], max_size[DSP_DIM_MAX];
+
+        for (uint32_t i = 0; i < rank; ++i)
+            local_size[i] = (i < ndims) ? localSize[i] : 1;
+
+        Tracing::Scope trace("mpi", "MPI_Allreduce", "getAlignedChunkDims");
+        if (MPI_Allreduce(local_size, min_size, rank, MPI_UNSIGNED_LONG_LONG,
+                MPI_MIN, options.mpiComm) != MPI_SUCCESS ||
+                MPI_Allreduce(local_size, max_size, rank, MPI_UNSIGNED_LONG_LONG,
+                MPI_MAX, options.mpiComm) != MPI_SUCCESS)
+            throw DCException(getExceptionString("getAlignedChunkDims",
+                "MPI_Allreduce failed", NULL));
+
+        chunkDims.set(0, 0, 0);
+
+        // chunks can only match all local blocks if these are equally sized
+        uint64_t chunk_size = typeSize;
+        for (uint32_t i = 0; i < rank; ++i)
+        {
+            if (min_size[i] != max_size[i] || min_size[i] == 0)
+                return false;
+
+            chunk_size *= min_size[i];
+        }
+
+        // HDF5 limits chunks to 4 GiB
+        if (chunk_size >= PDC_MAX_CHUNK_SIZE)
+            return false;
+
+        hsize_t chunk_dims[DSP_DIM_MAX];
+        for (uint32_t i = 0; i < rank; ++i)
+            chunk_dims[i] = min_size[i];
+
+        chunkDims = Dimensions(rank, chunk_dims);
+        return true;
+    }
+
     void ParallelDataCollector::readCompleteDataSet(H5Handle h5File,
             int32_t id,
             const char* name,
@@ -852,7 +1563,8 @@ namespace splash
             const Dimensions srcOffset,
             Dimensions &sizeRead,
             uint32_t& srcRank,
-            void* dst)
+            void* dst,
+            const CollectionType* memType)
     throw (DCException)
     {
         log_msg(2, "readCompleteDataSet");
@@ -867,10 +1579,20 @@ namespace splash
         group.open(h5File, group_path);
 
         DCParallelDataSet dataset(dset_name.c_str());
+        if (memType != NULL)
+            dataset.setMemoryType(memType->getDataType());
         dataset.open(group.getHandle());
         const Dimensions src_size(dataset.getSize() - srcOffset);
 
-        dataset.read(dstBuffer, dstOffset, src_size, srcOffset, sizeRead, srcRank, dst);
+        try
+        {
+            dataset.read(dstBuffer, dstOffset, src_size, srcOffset, sizeRead, srcRank, dst);
+        } catch (DCException)
+        {
+            // e.g. unsupported memory datatype
+            dataset.close();
+            throw;
+        }
         dataset.close();
     }
 
@@ -911,16 +1633,37 @@ namespace splash
             uint32_t ndims,
             const Selection srcSelect,
             const char* name,
-            const void* data) throw (DCException)
+            const void* data,
+            const void* const* components,
+            bool componentWise) throw (DCException)
     {
         log_msg(2, "writeDataSet");
 
         DCParallelDataSet dataset(name);
+
+        if (this->options.enableCompression)
+        {
+            // align chunks to the local blocks so that every chunk
+            // is compressed and written by a single process only
+            Dimensions chunk_dims;
+            if (getAlignedChunkDims(ndims, srcSelect.count, datatype.getSize(), chunk_dims))
+                dataset.setChunkDims(chunk_dims);
+        }
+
         // always create dataset but write data only if all dimensions > 0
         // not extensible
         dataset.create(datatype, group, globalSize, ndims,
                 this->options.enableCompression, false);
-        dataset.write(srcSelect, globalOffset, data);
+        try
+        {
+            writeToDataSet(dataset, options.mpiComm, srcSelect, globalOffset,
+                    data, components, componentWise);
+        } catch (DCException)
+        {
+            // e.g. invalid source selection
+            dataset.close();
+            throw;
+        }
         dataset.close();
     }
 
@@ -933,11 +1676,16 @@ namespace splash
 
         globalSize.set(1, 1, 1);
         globalOffset.set(0, 0, 0);
+        globalSize.setRank(ndims, 1);
+        globalOffset.setRank(ndims, 0);
 
-        if (MPI_Allgather(local_write_size, 3, MPI_UNSIGNED_LONG_LONG,
-                write_sizes, 3, MPI_UNSIGNED_LONG_LONG, options.mpiComm) != MPI_SUCCESS)
-            throw DCException(getExceptionString("gatherMPIWrites",
-                "MPI_Allgather failed", NULL));
+        {
+            Tracing::Scope trace("mpi", "MPI_Allgather", "gatherMPIWrites");
+            if (MPI_Allgather(local_write_size, 3, MPI_UNSIGNED_LONG_LONG,
+                    write_sizes, 3, MPI_UNSIGNED_LONG_LONG, options.mpiComm) != MPI_SUCCESS)
+                throw DCException(getExceptionString("gatherMPIWrites",
+                    "MPI_Allgather failed", NULL));
+        }
 
         Dimensions tmp_mpi_topology(options.mpiTopology);
         Dimensions tmp_mpi_pos(options.mpiPos);
@@ -953,7 +1701,11 @@ namespace splash
                     "cannot auto-detect global size/offset for 2D data when writing with 3D topology", NULL));
         }
 
-        for (int i = 0; i < ndims; ++i)
+        // the MPI topology is 3-dimensional, higher dimensions are not distributed
+        for (int i = 3; i < ndims; ++i)
+            globalSize[i] = localSize[i];
+
+        for (int i = 0; i < std::min(ndims, 3); ++i)
         {
             globalSize[i] = 0;
             size_t index;
@@ -1020,8 +1772,8 @@ namespace splash
 
         DCParallelDataSet dataset(dset_name.c_str());
         // create the empty extensible dataset
-        dataset.create(type, group.getHandle(), globalSize, ndims,
-                this->options.enableCompression, true);
+        // filtered datasets require collective writes but append writes independently
+        dataset.create(type, group.getHandle(), globalSize, ndims, false, true);
         dataset.close();
     }
 
@@ -19,10 +19,19 @@
  * If not, see <http://www.gnu.org/licenses/>. 
  */
 
+#define SPLASH_LOG_CATEGORY splash::LOG_COLLECTOR
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <vector>
+
 #include "splash/basetypes/basetypes.hpp"
 
 #include "splash/ParallelDomainCollector.hpp"
 #include "splash/core/DCParallelDataSet.hpp"
+#include "splash/core/DCParallelGroup.hpp"
+#include "splash/core/DCDomainDescriptor.hpp"
 #include "splash/core/logging.hpp"
 
 namespace splash
@@ -48,13 +57,45 @@ namespace splash
             const Domain localDomain,
             const Domain globalDomain)
     {
-        ColTypeInt32 int_t;
-        ColTypeDim dim_t;
-        writeAttribute(id, int_t, name, DOMCOL_ATTR_CLASS, &dataClass);
-        writeAttribute(id, dim_t, name, DOMCOL_ATTR_SIZE, localDomain.getSize().getPointer());
-        writeAttribute(id, dim_t, name, DOMCOL_ATTR_OFFSET, localDomain.getOffset().getPointer());
-        writeAttribute(id, dim_t, name, DOMCOL_ATTR_GLOBAL_SIZE, globalDomain.getSize().getPointer());
-        writeAttribute(id, dim_t, name, DOMCOL_ATTR_GLOBAL_OFFSET, globalDomain.getOffset().getPointer());
+        DCDomainDescriptor descriptor;
+        descriptor.set(dataClass, localDomain, globalDomain);
+        writeAttribute(id, descriptor, name, DOMCOL_ATTR_DOMAIN, descriptor.getBuffer());
+    }
+
+    bool ParallelDomainCollector::readDomainDescriptor(
+            int32_t id,
+            const char *name,
+            DCDomainDescriptor &descriptor)
+    throw (DCException)
+    {
+        if (fileStatus == FST_CLOSED)
+            throw DCException(getExceptionString("readDomainDescriptor",
+                "this access is not permitted", NULL));
+
+        std::string group_path, obj_name;
+        DCDataSet::getFullDataPath(name, SDC_GROUP_DATA, id, group_path, obj_name);
+
+        DCParallelGroup group;
+        group.open(handles.get(id), group_path);
+
+        hid_t dset_handle = H5Oopen(group.getHandle(), obj_name.c_str(), H5P_DEFAULT);
+        if (dset_handle < 0)
+            throw DCException(getExceptionString("readDomainDescriptor",
+                "dataset not found", obj_name.c_str()));
+
+        // files written by older versions use separate attributes
+        bool found = false;
+        try
+        {
+            found = descriptor.readAttribute(dset_handle);
+        } catch (DCException e)
+        {
+            H5Oclose(dset_handle);
+            throw e;
+        }
+
+        H5Oclose(dset_handle);
+        return found;
     }
 
     ParallelDomainCollector::ParallelDomainCollector(MPI_Comm comm, MPI_Info info,
@@ -75,6 +116,10 @@ namespace splash
             throw DCException(getExceptionString("getGlobalDomain",
                 "this access is not permitted", NULL));
 
+        DCDomainDescriptor descriptor;
+        if (readDomainDescriptor(id, name, descriptor))
+            return descriptor.getGlobalDomain();
+
         Domain domain;
 
         readAttribute(id, name, DOMCOL_ATTR_GLOBAL_SIZE, domain.getSize().getPointer());
@@ -91,6 +136,10 @@ namespace splash
             throw DCException(getExceptionString("getLocalDomain",
                 "this access is not permitted", NULL));
 
+        DCDomainDescriptor descriptor;
+        if (readDomainDescriptor(id, name, descriptor))
+            return descriptor.getLocalDomain();
+
         Domain domain;
 
         readAttribute(id, name, DOMCOL_ATTR_SIZE, domain.getSize().getPointer());
@@ -99,6 +148,69 @@ namespace splash
         return domain;
     }
 
+    void ParallelDomainCollector::readClientDomain(
+            int32_t id,
+            const char *name,
+            Domain &clientDomain,
+            DomDataClass &dataClass)
+    throw (DCException)
+    {
+        Domain local_client_domain, global_client_domain;
+
+        DCDomainDescriptor descriptor;
+        if (readDomainDescriptor(id, name, descriptor))
+        {
+            local_client_domain = descriptor.getLocalDomain();
+            global_client_domain = descriptor.getGlobalDomain();
+            dataClass = descriptor.getDataClass();
+        } else
+        {
+            readAttribute(id, name, DOMCOL_ATTR_OFFSET, local_client_domain.getOffset().getPointer());
+            readAttribute(id, name, DOMCOL_ATTR_SIZE, local_client_domain.getSize().getPointer());
+            readAttribute(id, name, DOMCOL_ATTR_GLOBAL_OFFSET, global_client_domain.getOffset().getPointer());
+            readAttribute(id, name, DOMCOL_ATTR_GLOBAL_SIZE, global_client_domain.getSize().getPointer());
+            readAttribute(id, name, DOMCOL_ATTR_CLASS, &dataClass);
+        }
+
+        clientDomain = Domain(
+                local_client_domain.getOffset() + global_client_domain.getOffset(),
+                local_client_domain.getSize());
+    }
+
+    void ParallelDomainCollector::readDataTypeInfo(
+            int32_t id,
+            const char *name,
+            size_t &typeSize,
+            DCDataType &dcDataType)
+    throw (DCException)
+    {
+        std::stringstream group_id_name;
+        group_id_name << SDC_GROUP_DATA << "/" << id;
+        std::string group_id_string = group_id_name.str();
+
+        hid_t group_id = H5Gopen(handles.get(id), group_id_string.c_str(), H5P_DEFAULT);
+        if (group_id < 0)
+            throw DCException(getExceptionString("readDataTypeInfo",
+                "group not found", group_id_string.c_str()));
+
+        try
+        {
+            DCParallelDataSet tmp_dataset(name);
+            tmp_dataset.open(group_id);
+
+            typeSize = tmp_dataset.getDataTypeSize();
+            dcDataType = tmp_dataset.getDCDataType();
+
+            tmp_dataset.close();
+        } catch (DCException e)
+        {
+            H5Gclose(group_id);
+            throw e;
+        }
+
+        H5Gclose(group_id);
+    }
+
     bool ParallelDomainCollector::readDomainDataForRank(
             DataContainer *dataContainer,
             DomDataClass *dataClass,
@@ -108,23 +220,13 @@ namespace splash
             bool lazyLoad)
     throw (DCException)
     {
-        Domain local_client_domain, global_client_domain;
-        
-        readAttribute(id, name, DOMCOL_ATTR_OFFSET, local_client_domain.getOffset().getPointer());
-        readAttribute(id, name, DOMCOL_ATTR_SIZE, local_client_domain.getSize().getPointer());
-        readAttribute(id, name, DOMCOL_ATTR_GLOBAL_OFFSET, global_client_domain.getOffset().getPointer());
-        readAttribute(id, name, DOMCOL_ATTR_GLOBAL_SIZE, global_client_domain.getSize().getPointer());
-        
-        Domain client_domain(
-                local_client_domain.getOffset() + global_client_domain.getOffset(),
-                local_client_domain.getSize());
+        Domain client_domain;
+        DomDataClass tmp_data_class = UndefinedType;
+        readClientDomain(id, name, client_domain, tmp_data_class);
 
         Dimensions data_elements;
         read(id, name, data_elements, NULL);
 
-        DomDataClass tmp_data_class = UndefinedType;
-        readAttribute(id, name, DOMCOL_ATTR_CLASS, &tmp_data_class);
-
         if (tmp_data_class == GridType && data_elements != client_domain.getSize())
             throw DCException(getExceptionString("readDomainDataForRank",
                 "Number of data elements must match domain size for Grid data.", NULL));
@@ -153,34 +255,9 @@ namespace splash
             log_msg(3, "dataclass = Poly");
             if (data_elements.getScalarSize() > 0)
             {
-                std::stringstream group_id_name;
-                group_id_name << SDC_GROUP_DATA << "/" << id;
-                std::string group_id_string = group_id_name.str();
-
-                hid_t group_id = H5Gopen(handles.get(id), group_id_string.c_str(), H5P_DEFAULT);
-                if (group_id < 0)
-                    throw DCException(getExceptionString("readDomainDataForRank",
-                        "group not found", group_id_string.c_str()));
-
                 size_t datatype_size = 0;
                 DCDataType dc_datatype = DCDT_UNKNOWN;
-
-                try
-                {
-                    DCParallelDataSet tmp_dataset(name);
-                    tmp_dataset.open(group_id);
-
-                    datatype_size = tmp_dataset.getDataTypeSize();
-                    dc_datatype = tmp_dataset.getDCDataType();
-
-                    tmp_dataset.close();
-                } catch (DCException e)
-                {
-                    H5Gclose(group_id);
-                    throw e;
-                }
-
-                H5Gclose(group_id);
+                readDataTypeInfo(id, name, datatype_size, dc_datatype);
 
                 DomainData *client_data = new DomainData(client_domain,
                         data_elements, datatype_size, dc_datatype);
@@ -226,34 +303,9 @@ namespace splash
             // buffer is allocated and added to the container.
             if (dataContainer->getNumSubdomains() == 0)
             {
-                std::stringstream group_id_name;
-                group_id_name << SDC_GROUP_DATA << "/" << id;
-                std::string group_id_string = group_id_name.str();
-
-                hid_t group_id = H5Gopen(handles.get(id), group_id_string.c_str(), H5P_DEFAULT);
-                if (group_id < 0)
-                    throw DCException(getExceptionString("readDomainDataForRank",
-                        "group not found", group_id_string.c_str()));
-
                 size_t datatype_size = 0;
                 DCDataType dc_datatype = DCDT_UNKNOWN;
-
-                try
-                {
-                    DCParallelDataSet tmp_dataset(name);
-                    tmp_dataset.open(group_id);
-
-                    datatype_size = tmp_dataset.getDataTypeSize();
-                    dc_datatype = tmp_dataset.getDCDataType();
-
-                    tmp_dataset.close();
-                } catch (DCException e)
-                {
-                    H5Gclose(group_id);
-                    throw e;
-                }
-
-                H5Gclose(group_id);
+                readDataTypeInfo(id, name, datatype_size, dc_datatype);
 
                 DomainData *target_data = new DomainData(
                         requestDomain, requestDomain.getSize(),
@@ -275,6 +327,10 @@ namespace splash
 
             const Dimensions request_offset = requestDomain.getOffset();
             const Dimensions request_size = requestDomain.getSize();
+
+            dst_offset.setRank(ndims, 0);
+            src_size.setRank(ndims, 1);
+            src_offset.setRank(ndims, 0);
             for (uint32_t i = 0; i < ndims; ++i)
             {
                 dst_offset[i] = std::max((int64_t) client_domain.getOffset()[i] -
@@ -356,6 +412,8 @@ namespace splash
             bool lazyLoad)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, id, name);
+
         if (fileStatus == FST_CLOSED)
             throw DCException(getExceptionString("readDomain",
                 "this access is not permitted", NULL));
@@ -379,6 +437,307 @@ namespace splash
         return data_container;
     }
 
+    DataContainer *ParallelDomainCollector::readDomainDistributed(int32_t id,
+            const char* name,
+            const Domain requestDomain,
+            DomDataClass* dataClass)
+    throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, id, name);
+
+        if (fileStatus == FST_CLOSED)
+            throw DCException(getExceptionString("readDomainDistributed",
+                "this access is not permitted", NULL));
+
+        log_msg(3, "requestDomain = %s", requestDomain.toString().c_str());
+
+        const int mpi_size = options.mpiSize;
+        const int mpi_rank = options.mpiRank;
+
+        Domain client_domain;
+        DomDataClass data_class = UndefinedType;
+        readClientDomain(id, name, client_domain, data_class);
+
+        if (data_class != GridType && data_class != PolyType)
+            throw DCException(getExceptionString("readDomainDistributed",
+                "Unknown data class", name));
+
+        Dimensions data_elements;
+        read(id, name, data_elements, NULL);
+
+        if (data_class == GridType && data_elements != client_domain.getSize())
+            throw DCException(getExceptionString("readDomainDistributed",
+                "Number of data elements must match domain size for Grid data.", NULL));
+
+        const uint32_t ndims = getNDims(handles.get(id), id, name);
+
+        size_t datatype_size = 0;
+        DCDataType dc_datatype = DCDT_UNKNOWN;
+        readDataTypeInfo(id, name, datatype_size, dc_datatype);
+
+        // gather the requests of all processes,
+        // the last entry flags requests with unsupported dimensions
+        std::vector<uint64_t> requests(mpi_size * 7);
+        uint64_t local_request[7];
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            local_request[i] = requestDomain.getOffset()[i];
+            local_request[3 + i] = requestDomain.getSize()[i];
+        }
+        local_request[6] = (ndims > 3 || requestDomain.getSize().getRank() > 3) ? 1 : 0;
+
+        {
+            Tracing::Scope trace("mpi", "MPI_Allgather", "readDomainDistributed");
+            if (MPI_Allgather(local_request, 7, MPI_UNSIGNED_LONG_LONG,
+                    &(requests[0]), 7, MPI_UNSIGNED_LONG_LONG, options.mpiComm) != MPI_SUCCESS)
+                throw DCException(getExceptionString("readDomainDistributed",
+                    "MPI_Allgather failed", NULL));
+        }
+
+        // all processes fail if any request is not supported
+        for (int r = 0; r < mpi_size; ++r)
+        {
+            if (requests[r * 7 + 6] != 0)
+                throw DCException(getExceptionString("readDomainDistributed",
+                    "Only 1-3-dimensional domains are supported", name));
+        }
+
+        // every process reads a contiguous slab along the slowest dimension,
+        // Poly data is split by elements rather than by domain
+        Domain data_domain(client_domain);
+        if (data_class == PolyType)
+            data_domain = Domain(Dimensions(0, 0, 0), data_elements);
+
+        // Grid data is sent to the requests, Poly data is split evenly by
+        // elements among all processes with an intersecting or empty request
+        std::vector<Domain> targets(mpi_size);
+        std::vector<int> poly_targets;
+        for (int r = 0; r < mpi_size; ++r)
+        {
+            Domain request_r(
+                    Dimensions(requests[r * 7], requests[r * 7 + 1], requests[r * 7 + 2]),
+                    Dimensions(requests[r * 7 + 3], requests[r * 7 + 4], requests[r * 7 + 5]));
+
+            if (data_class == GridType)
+                targets[r] = request_r;
+            else
+            {
+                targets[r] = Domain(Dimensions(0, 0, 0), Dimensions(0, 0, 0));
+                if ((request_r.getSize().getScalarSize() == 0) ||
+                        Domain::testIntersection(request_r, client_domain))
+                    poly_targets.push_back(r);
+            }
+        }
+
+        for (size_t i = 0; i < poly_targets.size(); ++i)
+            targets[poly_targets[i]] = getDistributedSlab(data_domain, ndims,
+                i, poly_targets.size());
+
+        Domain slab = getDistributedSlab(data_domain, ndims, mpi_rank, mpi_size);
+        Dimensions slab_offset = slab.getOffset() - data_domain.getOffset();
+        size_t slab_bytes = slab.getSize().getScalarSize() * datatype_size;
+        char *slab_data = new char[slab_bytes + 1];
+
+        // errors are collected and thrown by all processes after
+        // a reduction to not leave other processes in the exchange
+        std::string error;
+        int local_error = 0;
+        try
+        {
+            Dimensions elements_read;
+            uint32_t src_rank = 0;
+            readDataSet(handles.get(id), id, name, slab.getSize(), Dimensions(0, 0, 0),
+                    slab.getSize(), slab_offset, elements_read, src_rank, slab_data);
+        } catch (DCException e)
+        {
+            error = e.what();
+            local_error = 1;
+        }
+
+        // plan the exchange, both sides compute the same intersections
+        std::vector<int> send_counts(mpi_size), send_displs(mpi_size);
+        std::vector<int> recv_counts(mpi_size), recv_displs(mpi_size);
+        std::vector<Domain> send_domains(mpi_size), recv_domains(mpi_size);
+        uint64_t send_total = 0, recv_total = 0;
+
+        for (int r = 0; r < mpi_size && local_error == 0; ++r)
+        {
+            send_domains[r] = getDistributedPart(slab, targets[r]);
+            recv_domains[r] = getDistributedPart(
+                    getDistributedSlab(data_domain, ndims, r, mpi_size), targets[mpi_rank]);
+
+            uint64_t send_bytes = send_domains[r].getSize().getScalarSize() * datatype_size;
+            uint64_t recv_bytes = recv_domains[r].getSize().getScalarSize() * datatype_size;
+
+            if (send_total + send_bytes > INT_MAX || recv_total + recv_bytes > INT_MAX)
+            {
+                error = getExceptionString("readDomainDistributed",
+                        "Redistributed data exceeds 2 GiB per process", name);
+                local_error = 1;
+                break;
+            }
+
+            send_counts[r] = send_bytes;
+            send_displs[r] = send_total;
+            send_total += send_bytes;
+
+            recv_counts[r] = recv_bytes;
+            recv_displs[r] = recv_total;
+            recv_total += recv_bytes;
+        }
+
+        int global_error = 0;
+        {
+            Tracing::Scope trace("mpi", "MPI_Allreduce", "readDomainDistributed");
+            if (MPI_Allreduce(&local_error, &global_error, 1, MPI_INT, MPI_MAX,
+                    options.mpiComm) != MPI_SUCCESS)
+            {
+                delete[] slab_data;
+                throw DCException(getExceptionString("readDomainDistributed",
+                        "MPI_Allreduce failed", NULL));
+            }
+        }
+
+        if (global_error != 0)
+        {
+            delete[] slab_data;
+            if (local_error != 0)
+                throw DCException(error);
+
+            throw DCException(getExceptionString("readDomainDistributed",
+                    "Failed to read or redistribute on another process", name));
+        }
+
+        // pack the parts of the slab for all processes
+        char *send_data = new char[send_total + 1];
+        for (int r = 0; r < mpi_size; ++r)
+        {
+            if (send_counts[r] > 0)
+                copyDomainData(slab_data, slab, send_data + send_displs[r],
+                    send_domains[r], send_domains[r], datatype_size);
+        }
+        delete[] slab_data;
+
+        char *recv_data = new char[recv_total + 1];
+        int mpi_status = MPI_SUCCESS;
+        {
+            Tracing::Scope trace("mpi", "MPI_Alltoallv", "readDomainDistributed");
+            mpi_status = MPI_Alltoallv(send_data, &(send_counts[0]), &(send_displs[0]), MPI_BYTE,
+                    recv_data, &(recv_counts[0]), &(recv_displs[0]), MPI_BYTE,
+                    options.mpiComm);
+        }
+
+        if (mpi_status != MPI_SUCCESS)
+        {
+            delete[] send_data;
+            delete[] recv_data;
+            throw DCException(getExceptionString("readDomainDistributed",
+                    "MPI_Alltoallv failed", NULL));
+        }
+        delete[] send_data;
+
+        // unpack received parts into the result
+        DataContainer *data_container = new DataContainer();
+
+        if (data_class == GridType)
+        {
+            if ((requestDomain.getSize().getScalarSize() > 0) &&
+                    Domain::testIntersection(requestDomain, client_domain))
+            {
+                // the received parts cover the intersection of
+                // the request with the dataset domain completely
+                const Domain target_domain = getDistributedPart(client_domain, requestDomain);
+                DomainData *target_data = new DomainData(target_domain,
+                        target_domain.getSize(), datatype_size, dc_datatype);
+
+                for (int r = 0; r < mpi_size; ++r)
+                {
+                    if (recv_counts[r] > 0)
+                        copyDomainData(recv_data + recv_displs[r], recv_domains[r],
+                            (char*) target_data->getData(), target_domain,
+                            recv_domains[r], datatype_size);
+                }
+
+                data_container->add(target_data);
+            }
+        } else
+        {
+            // slabs are received in order and form the elements of this process
+            if (recv_total > 0)
+            {
+                DomainData *client_data = new DomainData(client_domain,
+                        targets[mpi_rank].getSize(), datatype_size, dc_datatype);
+                memcpy(client_data->getData(), recv_data, recv_total);
+                data_container->add(client_data);
+            }
+        }
+
+        delete[] recv_data;
+
+        if (dataClass != NULL)
+            *dataClass = data_class;
+
+        return data_container;
+    }
+
+    Domain ParallelDomainCollector::getDistributedSlab(const Domain dataDomain,
+            uint32_t ndims, int index, int numSlabs)
+    {
+        const uint32_t dim = ndims - 1;
+        const uint64_t extent = dataDomain.getSize()[dim];
+        const uint64_t start = extent * index / numSlabs;
+        const uint64_t end = extent * (index + 1) / numSlabs;
+
+        Domain slab(dataDomain);
+        slab.getOffset()[dim] += start;
+        slab.getSize()[dim] = end - start;
+
+        return slab;
+    }
+
+    Domain ParallelDomainCollector::getDistributedPart(const Domain slab,
+            const Domain target)
+    {
+        Domain part(slab.getOffset(), Dimensions(0, 0, 0));
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            uint64_t start = std::max(slab.getOffset()[i], target.getOffset()[i]);
+            uint64_t end = std::min(slab.getOffset()[i] + slab.getSize()[i],
+                    target.getOffset()[i] + target.getSize()[i]);
+
+            if (end <= start)
+                return Domain(slab.getOffset(), Dimensions(0, 0, 0));
+
+            part.getOffset()[i] = start;
+            part.getSize()[i] = end - start;
+        }
+
+        return part;
+    }
+
+    void ParallelDomainCollector::copyDomainData(const char *src, const Domain srcDomain,
+            char *dst, const Domain dstDomain, const Domain part, size_t typeSize)
+    {
+        const Dimensions src_size = srcDomain.getSize();
+        const Dimensions dst_size = dstDomain.getSize();
+        const Dimensions src_offset = part.getOffset() - srcDomain.getOffset();
+        const Dimensions dst_offset = part.getOffset() - dstDomain.getOffset();
+        const size_t line_bytes = part.getSize()[0] * typeSize;
+
+        // copy contiguous lines along the fastest dimension
+        for (size_t z = 0; z < part.getSize()[2]; ++z)
+            for (size_t y = 0; y < part.getSize()[1]; ++y)
+            {
+                size_t src_index = ((src_offset[2] + z) * src_size[1] +
+                        src_offset[1] + y) * src_size[0] + src_offset[0];
+                size_t dst_index = ((dst_offset[2] + z) * dst_size[1] +
+                        dst_offset[1] + y) * dst_size[0] + dst_offset[0];
+
+                memcpy(dst + dst_index * typeSize, src + src_index * typeSize, line_bytes);
+            }
+    }
+
     void ParallelDomainCollector::readDomainLazy(DomainData *domainData)
     throw (DCException)
     {
@@ -395,6 +754,9 @@ namespace splash
                     "This DomainData does not allow lazy loading", NULL));
         }
 
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, loadingRef->id,
+                loadingRef->name.c_str());
+
         if (loadingRef->dataClass == UndefinedType)
         {
             throw DCException(getExceptionString("readDomainLazy",
@@ -0,0 +1,407 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <time.h>
+#include <exception>
+
+#include "splash/RecordingCollector.hpp"
+
+namespace splash
+{
+
+    static double getWallTime()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (double) now.tv_sec + (double) now.tv_nsec * 1.0e-9;
+    }
+
+    RecordingCollector::Record::Record(RecordingCollector &recorder,
+            const char *method) :
+    recorder(recorder),
+    startTime(getWallTime())
+    {
+        fields << method;
+    }
+
+    RecordingCollector::Record::~Record()
+    {
+        const double endTime = getWallTime();
+
+        recorder.trace << (startTime - recorder.traceStart) << "\t" <<
+                (endTime - startTime) << "\t" <<
+                (std::uncaught_exception() ? "error" : "ok") << "\t" <<
+                fields.str() << std::endl;
+    }
+
+    RecordingCollector::Record& RecordingCollector::Record::operator<<(int64_t value)
+    {
+        fields << "\t" << value;
+        return *this;
+    }
+
+    RecordingCollector::Record& RecordingCollector::Record::operator<<(const char *value)
+    {
+        fields << "\t";
+        if (value != NULL)
+            fields << value;
+        return *this;
+    }
+
+    RecordingCollector::Record& RecordingCollector::Record::operator<<(const Dimensions &value)
+    {
+        fields << "\t" << value[0];
+        for (uint32_t i = 1; i < value.getRank(); ++i)
+            fields << "," << value[i];
+        return *this;
+    }
+
+    RecordingCollector::Record& RecordingCollector::Record::operator<<(const Selection &value)
+    {
+        // size, count, offset and stride as separate fields,
+        // followed by the number of hyperslabs or points of scattered selections
+        *this << value.size << value.count << value.offset << value.stride;
+
+        if (value.pointRank > 0)
+            fields << "\tp" << (value.points.size() / value.pointRank);
+        else
+            fields << "\th" << value.hyperslabs.size();
+
+        return *this;
+    }
+
+    RecordingCollector::Record& RecordingCollector::Record::operator<<(const CollectionType &value)
+    {
+        fields << "\t" << getTypeCode(value);
+        return *this;
+    }
+
+    RecordingCollector::RecordingCollector(DataCollector *collector,
+            const std::string &traceFilename) throw (DCException) :
+    collector(collector),
+    traceStart(getWallTime())
+    {
+        if (collector == NULL)
+            throw DCException("RecordingCollector::RecordingCollector: collector must not be NULL");
+
+        trace.open(traceFilename.c_str(), std::ios::out | std::ios::trunc);
+        if (!trace.is_open())
+            throw DCException(std::string("RecordingCollector::RecordingCollector: ") +
+                "failed to open trace file " + traceFilename);
+
+        trace << "# libSplash workload trace 1" << std::endl;
+    }
+
+    RecordingCollector::~RecordingCollector()
+    {
+        trace.close();
+    }
+
+    std::string RecordingCollector::getTypeCode(const CollectionType& type)
+    {
+        const hid_t datatype = type.getDataType();
+        const size_t size = type.getSize();
+        std::stringstream code;
+
+        switch (H5Tget_class(datatype))
+        {
+            case H5T_FLOAT:
+                code << "f";
+                break;
+            case H5T_INTEGER:
+                code << ((H5Tget_sign(datatype) == H5T_SGN_NONE) ? "u" : "i");
+                break;
+            default:
+                code << "o";
+        }
+
+        code << size;
+        return code.str();
+    }
+
+    void RecordingCollector::open(const char *filename,
+            FileCreationAttr& attr)
+    {
+        Record record(*this, "open");
+        record << (int64_t) attr.fileAccType << attr.mpiPosition << attr.mpiSize <<
+                (int64_t) attr.enableCompression << (int64_t) attr.contiguousLayout <<
+                filename;
+
+        collector->open(filename, attr);
+    }
+
+    void RecordingCollector::close()
+    {
+        Record record(*this, "close");
+        collector->close();
+    }
+
+    int32_t RecordingCollector::getMaxID()
+    {
+        Record record(*this, "getMaxID");
+        const int32_t maxID = collector->getMaxID();
+        record << (int64_t) maxID;
+        return maxID;
+    }
+
+    void RecordingCollector::getMPISize(Dimensions& mpiSize)
+    {
+        Record record(*this, "getMPISize");
+        collector->getMPISize(mpiSize);
+        record << mpiSize;
+    }
+
+    void RecordingCollector::getEntryIDs(int32_t *ids, size_t *count)
+    {
+        Record record(*this, "getEntryIDs");
+        record << (int64_t) (ids != NULL);
+        collector->getEntryIDs(ids, count);
+        if (count != NULL)
+            record << (int64_t) *count;
+    }
+
+    void RecordingCollector::getEntriesForID(int32_t id, DCEntry *entries, size_t *count)
+    {
+        Record record(*this, "getEntriesForID");
+        record << (int64_t) id << (int64_t) (entries != NULL);
+        collector->getEntriesForID(id, entries, count);
+        if (count != NULL)
+            record << (int64_t) *count;
+    }
+
+    void RecordingCollector::write(int32_t id,
+            const CollectionType& type,
+            uint32_t ndims,
+            const Selection select,
+            const char* name,
+            const void* buf)
+    {
+        Record record(*this, "write");
+        record << (int64_t) id << name << type << (int64_t) ndims << select;
+
+        collector->write(id, type, ndims, select, name, buf);
+    }
+
+    void RecordingCollector::writeComponents(int32_t id,
+            const CollectionType& type,
+            uint32_t ndims,
+            const Selection select,
+            const char* name,
+            const void* const* components)
+    {
+        Record record(*this, "writeComponents");
+        record << (int64_t) id << name << type << (int64_t) ndims << select;
+
+        collector->writeComponents(id, type, ndims, select, name, components);
+    }
+
+    void RecordingCollector::append(int32_t id,
+            const CollectionType& type,
+            size_t count,
+            const char *name,
+            const void *buf)
+    {
+        Record record(*this, "append");
+        record << (int64_t) id << name << type << (int64_t) count <<
+                (int64_t) 0 << (int64_t) 1;
+
+        collector->append(id, type, count, name, buf);
+    }
+
+    void RecordingCollector::append(int32_t id,
+            const CollectionType& type,
+            size_t count,
+            size_t offset,
+            size_t stride,
+            const char *name,
+            const void *buf)
+    {
+        Record record(*this, "append");
+        record << (int64_t) id << name << type << (int64_t) count <<
+                (int64_t) offset << (int64_t) stride;
+
+        collector->append(id, type, count, offset, stride, name, buf);
+    }
+
+    void RecordingCollector::remove(int32_t id)
+    {
+        Record record(*this, "remove");
+        record << (int64_t) id;
+
+        collector->remove(id);
+    }
+
+    void RecordingCollector::remove(int32_t id,
+            const char *name)
+    {
+        Record record(*this, "remove");
+        record << (int64_t) id << name;
+
+        collector->remove(id, name);
+    }
+
+    void RecordingCollector::createReference(int32_t srcID,
+            const char *srcName,
+            int32_t dstID,
+            const char *dstName)
+    {
+        Record record(*this, "createReference");
+        record << (int64_t) srcID << srcName << (int64_t) dstID << dstName;
+
+        collector->createReference(srcID, srcName, dstID, dstName);
+    }
+
+    void RecordingCollector::createReference(int32_t srcID,
+            const char *srcName,
+            int32_t dstID,
+            const char *dstName,
+            Dimensions count,
+            Dimensions offset,
+            Dimensions stride)
+    {
+        Record record(*this, "createReference");
+        record << (int64_t) srcID << srcName << (int64_t) dstID << dstName <<
+                count << offset << stride;
+
+        collector->createReference(srcID, srcName, dstID, dstName,
+                count, offset, stride);
+    }
+
+    void RecordingCollector::readGlobalAttribute(
+            const char *name,
+            void* buf,
+            Dimensions *mpiPosition)
+    {
+        Record record(*this, "readGlobalAttribute");
+        record << name;
+        if (mpiPosition != NULL)
+            record << *mpiPosition;
+
+        collector->readGlobalAttribute(name, buf, mpiPosition);
+    }
+
+    void RecordingCollector::writeGlobalAttribute(const CollectionType& type,
+            const char *name,
+            const void* buf)
+    {
+        Record record(*this, "writeGlobalAttribute");
+        record << name << type;
+
+        collector->writeGlobalAttribute(type, name, buf);
+    }
+
+    void RecordingCollector::readAttribute(int32_t id,
+            const char *dataName,
+            const char *attrName,
+            void *buf,
+            Dimensions *mpiPosition)
+    {
+        Record record(*this, "readAttribute");
+        record << (int64_t) id << dataName << attrName;
+        if (mpiPosition != NULL)
+            record << *mpiPosition;
+
+        collector->readAttribute(id, dataName, attrName, buf, mpiPosition);
+    }
+
+    void RecordingCollector::writeAttribute(int32_t id,
+            const CollectionType& type,
+            const char *dataName,
+            const char *attrName,
+            const void *buf)
+    {
+        Record record(*this, "writeAttribute");
+        record << (int64_t) id << dataName << attrName << type;
+
+        collector->writeAttribute(id, type, dataName, attrName, buf);
+    }
+
+    void RecordingCollector::read(int32_t id,
+            const char* name,
+            Dimensions &sizeRead,
+            void* buf)
+    {
+        Record record(*this, "read");
+        record << (int64_t) id << name << (int64_t) (buf != NULL);
+
+        collector->read(id, name, sizeRead, buf);
+        record << sizeRead;
+    }
+
+    void RecordingCollector::read(int32_t id,
+            const char* name,
+            const Dimensions dstBuffer,
+            const Dimensions dstOffset,
+            Dimensions &sizeRead,
+            void* buf)
+    {
+        Record record(*this, "read");
+        record << (int64_t) id << name << (int64_t) (buf != NULL) <<
+                dstBuffer << dstOffset;
+
+        collector->read(id, name, dstBuffer, dstOffset, sizeRead, buf);
+        record << sizeRead;
+    }
+
+    void RecordingCollector::read(int32_t id,
+            const CollectionType& type,
+            const char* name,
+            const Dimensions dstBuffer,
+            const Dimensions dstOffset,
+            Dimensions &sizeRead,
+            void* buf)
+    {
+        Record record(*this, "readType");
+        record << (int64_t) id << name << (int64_t) (buf != NULL) <<
+                dstBuffer << dstOffset << type;
+
+        collector->read(id, type, name, dstBuffer, dstOffset, sizeRead, buf);
+        record << sizeRead;
+    }
+
+    void RecordingCollector::readComponents(int32_t id,
+            const CollectionType& type,
+            const char* name,
+            const Dimensions dstBuffer,
+            const Dimensions dstOffset,
+            Dimensions &sizeRead,
+            void* const* components)
+    {
+        Record record(*this, "readComponents");
+        record << (int64_t) id << name << (int64_t) (components != NULL) <<
+                dstBuffer << dstOffset << type;
+
+        collector->readComponents(id, type, name, dstBuffer, dstOffset,
+                sizeRead, components);
+        record << sizeRead;
+    }
+
+    const IOStatistics& RecordingCollector::getStatistics() const
+    {
+        return collector->getStatistics();
+    }
+
+    void RecordingCollector::resetStatistics()
+    {
+        collector->resetStatistics();
+    }
+
+}
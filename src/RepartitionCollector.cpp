@@ -0,0 +1,461 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define SPLASH_LOG_CATEGORY splash::LOG_COLLECTOR
+
+#include <cstring>
+#include <string>
+
+#include "splash/RepartitionCollector.hpp"
+#include "splash/core/DCDomainDescriptor.hpp"
+#include "splash/core/logging.hpp"
+
+/* number of values per file in the domain table */
+#define REPARTITION_TABLE_ENTRIES 16
+
+namespace splash
+{
+
+    static void indexToPosition(size_t index, const Dimensions topology,
+            Dimensions &position)
+    {
+        position[0] = index % topology[0];
+        position[1] = (index / topology[0]) % topology[1];
+        position[2] = index / (topology[0] * topology[1]);
+    }
+
+    static bool isEmpty(const Domain &domain)
+    {
+        return domain.getSize().getScalarSize() == 0;
+    }
+
+    RepartitionCollector::RepartitionCollector(MPI_Comm comm,
+            const Dimensions topology, uint32_t maxFileHandles) :
+    DomainCollector(maxFileHandles),
+    mpiComm(MPI_COMM_NULL),
+    mpiRank(0),
+    newTopology(topology)
+    {
+        if (MPI_Comm_dup(comm, &mpiComm) != MPI_SUCCESS)
+            throw DCException("RepartitionCollector: failed to duplicate MPI communicator");
+
+        int mpi_size = 0;
+        MPI_Comm_rank(mpiComm, &mpiRank);
+        MPI_Comm_size(mpiComm, &mpi_size);
+
+        if ((size_t) mpi_size != newTopology.getScalarSize())
+            throw DCException("RepartitionCollector: topology does not match size of communicator");
+
+        indexToPosition(mpiRank, newTopology, newPosition);
+    }
+
+    RepartitionCollector::~RepartitionCollector()
+    {
+    }
+
+    void RepartitionCollector::finalize()
+    {
+        if (mpiComm != MPI_COMM_NULL)
+        {
+            MPI_Comm_free(&mpiComm);
+            mpiComm = MPI_COMM_NULL;
+        }
+    }
+
+    void RepartitionCollector::open(const char *filename, FileCreationAttr& attr)
+    throw (DCException)
+    {
+        if (attr.fileAccType != FAT_READ_MERGED)
+            throw DCException("RepartitionCollector::open: only FAT_READ_MERGED is supported");
+
+        DomainCollector::open(filename, attr);
+    }
+
+    Dimensions RepartitionCollector::getTopology() const
+    {
+        return newTopology;
+    }
+
+    Dimensions RepartitionCollector::getPosition() const
+    {
+        return newPosition;
+    }
+
+    Domain RepartitionCollector::getRepartitionedDomain(int32_t id,
+            const char* name) throw (DCException)
+    {
+        if (fileStatus != FST_MERGING)
+            throw DCException("RepartitionCollector::getRepartitionedDomain: this access is not permitted");
+
+        return getBox(getGlobalDomain(id, name), newPosition);
+    }
+
+    Domain RepartitionCollector::getBox(const Domain globalDomain,
+            const Dimensions position) const
+    {
+        Domain box;
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            const hsize_t extent = globalDomain.getSize()[i];
+            const hsize_t start = extent * position[i] / newTopology[i];
+            const hsize_t end = extent * (position[i] + 1) / newTopology[i];
+
+            box.getOffset()[i] = globalDomain.getOffset()[i] + start;
+            box.getSize()[i] = end - start;
+        }
+
+        return box;
+    }
+
+    void RepartitionCollector::readFileDomains(int32_t id, const char* name,
+            std::vector<FileDomain> &fileDomains) throw (DCException)
+    {
+        const size_t num_files = mpiTopology.getScalarSize();
+        const int mpi_size = newTopology.getScalarSize();
+
+        // the last entry counts files which could not be read
+        const size_t table_size = num_files * REPARTITION_TABLE_ENTRIES + 1;
+        std::vector<uint64_t> local_table(table_size, 0);
+        std::vector<uint64_t> table(table_size, 0);
+
+        // errors are only thrown after the collective reduction,
+        // which every process has to take part in
+        std::string error;
+
+        // every file is read by exactly one process
+        for (size_t f = mpiRank; f < num_files; f += mpi_size)
+        {
+            Dimensions file_position;
+            indexToPosition(f, mpiTopology, file_position);
+
+            Domain local_client_domain, global_client_domain;
+            Dimensions data_size;
+            DomDataClass data_class = UndefinedType;
+
+            try
+            {
+                DCDomainDescriptor descriptor;
+                if (readDomainDescriptor(id, name, file_position, descriptor))
+                {
+                    local_client_domain = descriptor.getLocalDomain();
+                    global_client_domain = descriptor.getGlobalDomain();
+                    data_class = descriptor.getDataClass();
+                } else
+                {
+                    readAttribute(id, name, DOMCOL_ATTR_OFFSET,
+                            local_client_domain.getOffset().getPointer(), &file_position);
+                    readAttribute(id, name, DOMCOL_ATTR_SIZE,
+                            local_client_domain.getSize().getPointer(), &file_position);
+                    readAttribute(id, name, DOMCOL_ATTR_GLOBAL_OFFSET,
+                            global_client_domain.getOffset().getPointer(), &file_position);
+                    readAttribute(id, name, DOMCOL_ATTR_GLOBAL_SIZE,
+                            global_client_domain.getSize().getPointer(), &file_position);
+                    readAttribute(id, name, DOMCOL_ATTR_CLASS, &data_class, &file_position);
+                }
+
+                readSizeInternal(handles.get(file_position), id, name, data_size);
+
+                if (global_client_domain.getSize().getRank() > 3 || data_size.getRank() > 3)
+                    throw DCException("RepartitionCollector::readFileDomains: Only 1-3-dimensional domains are supported");
+            } catch (DCException e)
+            {
+                error = e.what();
+                local_table[table_size - 1] = 1;
+                break;
+            }
+
+            uint64_t *entry = &(local_table[f * REPARTITION_TABLE_ENTRIES]);
+            entry[0] = data_class;
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                entry[1 + i] = local_client_domain.getOffset()[i] +
+                        global_client_domain.getOffset()[i];
+                entry[4 + i] = local_client_domain.getSize()[i];
+                entry[7 + i] = global_client_domain.getOffset()[i];
+                entry[10 + i] = global_client_domain.getSize()[i];
+                entry[13 + i] = data_size[i];
+            }
+        }
+
+        // unread entries are zero, summing combines the table
+        if (MPI_Allreduce(&(local_table[0]), &(table[0]), table.size(),
+                MPI_UNSIGNED_LONG_LONG, MPI_SUM, mpiComm) != MPI_SUCCESS)
+            throw DCException("RepartitionCollector::readFileDomains: MPI_Allreduce failed");
+
+        if (!error.empty())
+            throw DCException(error);
+
+        if (table[table_size - 1] != 0)
+            throw DCException("RepartitionCollector::readFileDomains: Failed to read domains of another process");
+
+        fileDomains.resize(num_files);
+        for (size_t f = 0; f < num_files; ++f)
+        {
+            const uint64_t *entry = &(table[f * REPARTITION_TABLE_ENTRIES]);
+            FileDomain &file_domain = fileDomains[f];
+
+            file_domain.dataClass = (DomDataClass) entry[0];
+            file_domain.clientDomain = Domain(
+                    Dimensions(entry[1], entry[2], entry[3]),
+                    Dimensions(entry[4], entry[5], entry[6]));
+            file_domain.globalDomain = Domain(
+                    Dimensions(entry[7], entry[8], entry[9]),
+                    Dimensions(entry[10], entry[11], entry[12]));
+            file_domain.elements.set(entry[13], entry[14], entry[15]);
+
+            if (file_domain.dataClass != fileDomains[0].dataClass)
+                throw DCException("RepartitionCollector::readFileDomains: Data classes in files are inconsistent!");
+        }
+    }
+
+    DataContainer *RepartitionCollector::readRepartitioned(int32_t id,
+            const char* name,
+            DomDataClass* dataClass,
+            const char* const* positionNames,
+            const char* const* positionOffsetNames) throw (DCException)
+    {
+        if (fileStatus != FST_MERGING)
+            throw DCException("RepartitionCollector::readRepartitioned: this access is not permitted");
+
+        std::vector<FileDomain> file_domains;
+        readFileDomains(id, name, file_domains);
+
+        const DomDataClass data_class = file_domains[0].dataClass;
+        const Domain box = getBox(file_domains[0].globalDomain, newPosition);
+
+        log_msg(3, "repartitioned box = %s", box.toString().c_str());
+
+        DataContainer *data_container = new DataContainer();
+
+        try
+        {
+            switch (data_class)
+            {
+                case GridType:
+                    if (!isEmpty(box))
+                    {
+                        DomDataClass tmp_data_class = GridType;
+                        for (size_t f = 0; f < file_domains.size(); ++f)
+                        {
+                            if (isEmpty(file_domains[f].clientDomain) ||
+                                    !Domain::testIntersection(box, file_domains[f].clientDomain))
+                                continue;
+
+                            Dimensions file_position;
+                            indexToPosition(f, mpiTopology, file_position);
+                            readDomainDataForRank(data_container, &tmp_data_class,
+                                    file_position, id, name, box, false);
+                        }
+                    }
+                    break;
+                case PolyType:
+                    readPolyRepartitioned(data_container, id, name, file_domains,
+                            file_domains[0].globalDomain, box, positionNames,
+                            positionOffsetNames);
+                    break;
+                default:
+                    throw DCException("RepartitionCollector::readRepartitioned: Unknown data class");
+            }
+        } catch (DCException e)
+        {
+            delete data_container;
+            throw e;
+        }
+
+        if (dataClass != NULL)
+            *dataClass = data_class;
+
+        return data_container;
+    }
+
+    void RepartitionCollector::readPolyRepartitioned(DataContainer *dataContainer,
+            int32_t id,
+            const char* name,
+            const std::vector<FileDomain> &fileDomains,
+            const Domain globalDomain,
+            const Domain box,
+            const char* const* positionNames,
+            const char* const* positionOffsetNames) throw (DCException)
+    {
+        if (isEmpty(box))
+            return;
+
+        // select files to read
+        std::vector<size_t> files;
+        size_t max_elements = 0;
+        for (size_t f = 0; f < fileDomains.size(); ++f)
+        {
+            const Domain &client_domain = fileDomains[f].clientDomain;
+            bool read_file = false;
+
+            if (positionNames != NULL)
+            {
+                read_file = !isEmpty(client_domain) &&
+                        Domain::testIntersection(box, client_domain);
+            } else
+            {
+                // without positions, files are assigned by their offset
+                read_file = true;
+                for (uint32_t i = 0; i < 3; ++i)
+                {
+                    if (client_domain.getOffset()[i] < box.getOffset()[i] ||
+                            client_domain.getOffset()[i] >= box.getOffset()[i] + box.getSize()[i])
+                        read_file = false;
+                }
+            }
+
+            if (read_file && fileDomains[f].elements.getScalarSize() > 0)
+            {
+                files.push_back(f);
+                max_elements += fileDomains[f].elements.getScalarSize();
+            }
+        }
+
+        if (files.size() == 0)
+            return;
+
+        DomainData *target_data = NULL;
+        size_t num_elements = 0;
+
+        for (size_t k = 0; k < files.size(); ++k)
+        {
+            const FileDomain &file_domain = fileDomains[files[k]];
+            Dimensions file_position;
+            indexToPosition(files[k], mpiTopology, file_position);
+
+            DataContainer file_data;
+            readPolyInternal(&file_data, file_position, id, name,
+                    file_domain.elements, file_domain.clientDomain, false);
+            DomainData *data = file_data.getIndex(0);
+            const size_t type_size = data->getTypeSize();
+            const size_t file_elements = file_domain.elements.getScalarSize();
+
+            if (target_data == NULL)
+                target_data = new DomainData(box, Dimensions(max_elements, 1, 1),
+                    type_size, data->getDataType());
+
+            uint8_t *dst = (uint8_t*) target_data->getData();
+            const uint8_t *src = (const uint8_t*) data->getData();
+
+            if (positionNames == NULL)
+            {
+                memcpy(dst + num_elements * type_size, src, file_elements * type_size);
+                num_elements += file_elements;
+                continue;
+            }
+
+            // read positions and test all elements against the box,
+            // the last box along a dimension includes the upper global boundary
+            std::vector<bool> inside(file_elements, true);
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                if (positionNames[i] == NULL)
+                    continue;
+
+                std::vector<double> positions(file_elements, 0.0);
+                readPositionValues(file_position, id, positionNames[i], file_domain, positions);
+                if (positionOffsetNames != NULL && positionOffsetNames[i] != NULL)
+                    readPositionValues(file_position, id, positionOffsetNames[i],
+                        file_domain, positions);
+
+                const double box_start = box.getOffset()[i];
+                const double box_end = box.getOffset()[i] + box.getSize()[i];
+                const bool upper_closed = (box.getOffset()[i] + box.getSize()[i] ==
+                        globalDomain.getOffset()[i] + globalDomain.getSize()[i]);
+
+                for (size_t e = 0; e < file_elements; ++e)
+                {
+                    const double pos = positions[e];
+                    if (pos < box_start || pos > box_end || (pos == box_end && !upper_closed))
+                        inside[e] = false;
+                }
+            }
+
+            for (size_t e = 0; e < file_elements; ++e)
+            {
+                if (inside[e])
+                {
+                    memcpy(dst + num_elements * type_size, src + e * type_size, type_size);
+                    num_elements++;
+                }
+            }
+        }
+
+        if (num_elements == 0)
+        {
+            delete target_data;
+            return;
+        }
+
+        // shrink to the number of elements of this process
+        DomainData *result = new DomainData(box, Dimensions(num_elements, 1, 1),
+                target_data->getTypeSize(), target_data->getDataType());
+        memcpy(result->getData(), target_data->getData(),
+                num_elements * target_data->getTypeSize());
+        delete target_data;
+
+        dataContainer->add(result);
+    }
+
+    void RepartitionCollector::readPositionValues(const Dimensions filePosition,
+            int32_t id,
+            const char* name,
+            const FileDomain &fileDomain,
+            std::vector<double> &values) throw (DCException)
+    {
+        Dimensions position_size;
+        readSizeInternal(handles.get(filePosition), id, name, position_size);
+        if (position_size != fileDomain.elements)
+            throw DCException("RepartitionCollector::readRepartitioned: Number of positions must match number of elements.");
+
+        DataContainer position_data;
+        readPolyInternal(&position_data, filePosition, id, name,
+                position_size, fileDomain.clientDomain, false);
+        DomainData *positions = position_data.getIndex(0);
+
+        for (size_t e = 0; e < values.size(); ++e)
+            values[e] += getPositionValue(positions->getData(), positions->getDataType(), e);
+    }
+
+    double RepartitionCollector::getPositionValue(const void *data,
+            DCDataType type, size_t index) throw (DCException)
+    {
+        switch (type)
+        {
+            case DCDT_FLOAT32:
+                return ((const float*) data)[index];
+            case DCDT_FLOAT64:
+                return ((const double*) data)[index];
+            case DCDT_INT32:
+                return ((const int32_t*) data)[index];
+            case DCDT_INT64:
+                return ((const int64_t*) data)[index];
+            case DCDT_UINT32:
+                return ((const uint32_t*) data)[index];
+            case DCDT_UINT64:
+                return ((const uint64_t*) data)[index];
+            default:
+                throw DCException("RepartitionCollector::getPositionValue: Unsupported type for positions");
+        }
+    }
+
+}
@@ -19,17 +19,22 @@
  * If not, see <http://www.gnu.org/licenses/>. 
  */
 
-
+#define SPLASH_LOG_CATEGORY splash::LOG_COLLECTOR
 
 #include <cstring>
 #include <time.h>
 #include <stdlib.h>
 #include <cassert>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
 
 #include "splash/SerialDataCollector.hpp"
 
 #include "splash/core/DCAttribute.hpp"
+#include "splash/core/DCConversion.hpp"
 #include "splash/core/DCDataSet.hpp"
 #include "splash/core/DCGroup.hpp"
 #include "splash/core/DCHelper.hpp"
@@ -60,6 +65,16 @@ namespace splash
         log_msg(3, "Raw Data Cache (File) = %llu KiB", (long long unsigned) (rawCacheSize / 1024));
     }
 
+    void SerialDataCollector::writeMaxID()
+    throw (DCException)
+    {
+        DCGroup group;
+        group.open(handles.get(0), SDC_GROUP_HEADER);
+
+        DCAttribute::writeAttribute(SDC_ATTR_MAX_ID, H5T_NATIVE_INT32,
+                group.getHandle(), &maxID);
+    }
+
     bool SerialDataCollector::fileExists(std::string filename)
     {
         struct stat fileInfo;
@@ -94,9 +109,15 @@ namespace splash
 
     SerialDataCollector::SerialDataCollector(uint32_t maxFileHandles) :
     handles(maxFileHandles, HandleMgr::FNS_MPI),
+    coreAccProperties(-1),
+    fileCreateProperties(-1),
     fileStatus(FST_CLOSED),
     maxID(-1),
-    mpiTopology(1, 1, 1)
+    mpiTopology(1, 1, 1),
+    enableCompression(false),
+    compressionThreads(0),
+    contiguousLayout(false),
+    checksums(false)
     {
 #ifdef COL_TYPE_CPP
         throw DCException("Check your defines !");
@@ -134,6 +155,13 @@ namespace splash
         if (fileStatus != FST_CLOSED)
             throw DCException(getExceptionString("open", "this access is not permitted"));
 
+        this->statisticsFile = attr.statisticsFile;
+        this->checksums = attr.checksums;
+
+        // one trace per MPI position
+        Tracing::setProcessID(attr.mpiPosition[0] + attr.mpiSize[0] *
+                (attr.mpiPosition[1] + attr.mpiSize[1] * attr.mpiPosition[2]));
+
         switch (attr.fileAccType)
         {
             case FAT_READ:
@@ -148,6 +176,9 @@ namespace splash
             case FAT_READ_MERGED:
                 openMerge(filename);
                 break;
+            case FAT_CREATE_INMEMORY:
+                openCreate(filename, attr);
+                break;
         }
     }
 
@@ -157,14 +188,10 @@ namespace splash
 
         if (fileStatus == FST_CREATING || fileStatus == FST_WRITING)
         {
-            DCGroup group;
-            group.open(handles.get(0), SDC_GROUP_HEADER);
-
             // write number of iterations
             try
             {
-                DCAttribute::writeAttribute(SDC_ATTR_MAX_ID, H5T_NATIVE_INT32,
-                        group.getHandle(), &maxID);
+                writeMaxID();
             } catch (DCException e)
             {
                 log_msg(0, "Exception: %s", e.what());
@@ -176,7 +203,43 @@ namespace splash
         mpiTopology.set(1, 1, 1);
 
         // close opened hdf5 file handles
-        handles.close();
+        {
+            Tracing::Scope trace("file", "HandleMgr::close");
+            handles.close();
+        }
+
+        if (!statisticsFile.empty())
+        {
+            try
+            {
+                statistics.writeJSON(statisticsFile);
+            } catch (DCException e)
+            {
+                log_msg(0, "Exception: %s", e.what());
+            }
+            statisticsFile.clear();
+        }
+
+        // append the events of this file to the trace
+        try
+        {
+            Tracing::flush();
+        } catch (DCException e)
+        {
+            log_msg(0, "Exception: %s", e.what());
+        }
+
+        if (coreAccProperties >= 0)
+        {
+            H5Pclose(coreAccProperties);
+            coreAccProperties = -1;
+        }
+
+        if (fileCreateProperties >= 0)
+        {
+            H5Pclose(fileCreateProperties);
+            fileCreateProperties = -1;
+        }
 
         fileStatus = FST_CLOSED;
     }
@@ -187,6 +250,8 @@ namespace splash
             Dimensions *mpiPosition)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_ATTRIBUTE, -1, NULL);
+
         // mpiPosition is allowed to be NULL here
         if (name == NULL || data == NULL)
             throw DCException(getExceptionString("readGlobalAttribute", "a parameter was null"));
@@ -230,6 +295,8 @@ namespace splash
             const void* data)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_ATTRIBUTE, -1, NULL);
+
         if (name == NULL || data == NULL)
             throw DCException(getExceptionString("writeGlobalAttribute", "a parameter was null"));
 
@@ -256,6 +323,8 @@ namespace splash
             Dimensions *mpiPosition)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_ATTRIBUTE, id, dataName);
+
         // mpiPosition is allowed to be NULL here
         if (attrName == NULL || data == NULL)
             throw DCException(getExceptionString("readAttribute", "a parameter was null"));
@@ -320,6 +389,8 @@ namespace splash
             const void* data)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_ATTRIBUTE, id, dataName);
+
         if (attrName == NULL || data == NULL)
             throw DCException(getExceptionString("writeAttribute", "a parameter was null"));
 
@@ -386,6 +457,8 @@ namespace splash
             void* data)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, id, name);
+
         if (fileStatus != FST_READING && fileStatus != FST_WRITING && fileStatus != FST_MERGING)
             throw DCException(getExceptionString("read", "this access is not permitted"));
 
@@ -394,17 +467,236 @@ namespace splash
                 Dimensions(0, 0, 0), sizeRead, ndims, data);
     }
 
+    void SerialDataCollector::read(int32_t id,
+            const CollectionType& type,
+            const char* name,
+            const Dimensions dstBuffer,
+            const Dimensions dstOffset,
+            Dimensions &sizeRead,
+            void* data)
+    throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, id, name);
+
+        if (fileStatus != FST_READING && fileStatus != FST_WRITING && fileStatus != FST_MERGING)
+            throw DCException(getExceptionString("read", "this access is not permitted"));
+
+        uint32_t ndims = 0;
+        readCompleteDataSet(handles.get(0), id, name, dstBuffer, dstOffset,
+                Dimensions(0, 0, 0), sizeRead, ndims, data, &type);
+    }
+
+    void SerialDataCollector::readComponents(int32_t id,
+            const CollectionType& type,
+            const char* name,
+            const Dimensions dstBuffer,
+            const Dimensions dstOffset,
+            Dimensions &sizeRead,
+            void* const* components)
+    throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_READ, id, name);
+
+        if (name == NULL)
+            throw DCException(getExceptionString("readComponents", "parameter name is NULL"));
+
+        if (fileStatus != FST_READING && fileStatus != FST_WRITING && fileStatus != FST_MERGING)
+            throw DCException(getExceptionString("readComponents", "this access is not permitted"));
+
+        std::string group_path, dset_name;
+        DCDataSet::getFullDataPath(name, SDC_GROUP_DATA, id, group_path, dset_name);
+
+        DCGroup group;
+        group.open(handles.get(0), group_path);
+
+        DCDataSet dataset(dset_name.c_str());
+        dataset.setDirectChunkIO(this->compressionThreads);
+        dataset.setChecksums(this->checksums);
+        dataset.setMemoryType(type.getDataType());
+        dataset.open(group.getHandle());
+
+        uint32_t ndims = 0;
+        try
+        {
+            dataset.readComponents(dstBuffer, dstOffset, dataset.getSize(), Dimensions(0, 0, 0),
+                    sizeRead, ndims, components);
+        } catch (DCException)
+        {
+            dataset.close();
+            throw;
+        }
+        dataset.close();
+    }
+
+    const IOStatistics& SerialDataCollector::getStatistics() const
+    {
+        return statistics;
+    }
+
+    void SerialDataCollector::resetStatistics()
+    {
+        statistics.reset();
+    }
+
+    MappedData* SerialDataCollector::mapDataset(int32_t id, const char* name)
+    throw (DCException)
+    {
+        if (name == NULL)
+            throw DCException(getExceptionString("mapDataset", "parameter name is NULL"));
+
+        if (fileStatus == FST_CLOSED || fileStatus == FST_MERGING)
+            throw DCException(getExceptionString("mapDataset", "this access is not permitted"));
+
+        if (coreAccProperties >= 0)
+            throw DCException(getExceptionString("mapDataset", "not supported for in-memory files"));
+
+        std::string group_path, dset_name;
+        DCDataSet::getFullDataPath(name, SDC_GROUP_DATA, id, group_path, dset_name);
+
+        H5Handle h5File = handles.get(0);
+
+        DCGroup group;
+        group.open(h5File, group_path);
+
+        DCDataSet dataset(dset_name.c_str());
+        dataset.open(group.getHandle());
+
+        Dimensions size(dataset.getSize());
+        const uint32_t ndims = dataset.getNDims();
+        if (H5Sget_simple_extent_type(dataset.getDataSpace()) == H5S_NULL)
+            size.set(0, 0, 0);
+        size_t type_size = 0;
+        DCDataType type = DCDT_UNKNOWN;
+        haddr_t offset = HADDR_UNDEF;
+        try
+        {
+            type_size = dataset.getDataTypeSize();
+            type = dataset.getDCDataType();
+            if (size.getScalarSize() != 0)
+                offset = dataset.getRawDataOffset();
+        } catch (DCException)
+        {
+            dataset.close();
+            throw;
+        }
+        dataset.close();
+
+        if (offset == HADDR_UNDEF)
+            return new MappedData(NULL, 0, 0, size, ndims, type_size, type);
+
+        // raw data may still be cached by HDF5
+        if (fileStatus != FST_READING && H5Fflush(h5File, H5F_SCOPE_LOCAL) < 0)
+            throw DCException(getExceptionString("mapDataset", "failed to flush file", name));
+
+        const ssize_t name_length = H5Fget_name(h5File, NULL, 0);
+        if (name_length <= 0)
+            throw DCException(getExceptionString("mapDataset", "failed to get filename", name));
+
+        std::vector<char> filename(name_length + 1);
+        H5Fget_name(h5File, &(filename[0]), filename.size());
+
+        const size_t data_size = size.getScalarSize() * type_size;
+
+        // mappings must start at a page boundary
+        const size_t page_size = sysconf(_SC_PAGESIZE);
+        const size_t data_offset = offset % page_size;
+        const size_t mapping_size = data_size + data_offset;
+
+        int fd = ::open(&(filename[0]), O_RDONLY);
+        if (fd < 0)
+            throw DCException(getExceptionString("mapDataset", "failed to open file",
+                &(filename[0])));
+
+        // accessing pages beyond the end of the file would raise SIGBUS
+        struct stat file_info;
+        if (fstat(fd, &file_info) != 0 || (size_t) file_info.st_size < offset + data_size)
+        {
+            ::close(fd);
+            throw DCException(getExceptionString("mapDataset", "raw data exceeds file size", name));
+        }
+
+        void *mapping = mmap(NULL, mapping_size, PROT_READ, MAP_SHARED,
+                fd, (off_t) (offset - data_offset));
+        ::close(fd);
+
+        if (mapping == MAP_FAILED)
+            throw DCException(getExceptionString("mapDataset", "failed to map dataset", name));
+
+        return new MappedData(mapping, mapping_size, data_offset, size, ndims, type_size, type);
+    }
+
+    void SerialDataCollector::openImage(const void* image, size_t size)
+    throw (DCException)
+    {
+        log_msg(1, "opening serial data collector from file image");
+
+        if (image == NULL || size == 0)
+            throw DCException(getExceptionString("openImage", "file image must not be empty"));
+
+        if (fileStatus != FST_CLOSED)
+            throw DCException(getExceptionString("openImage", "this access is not permitted"));
+
+        // the image is copied into the property list
+        coreAccProperties = H5Pcreate(H5P_FILE_ACCESS);
+        if (coreAccProperties < 0 ||
+                H5Pset_fapl_core(coreAccProperties, SDC_CORE_INCREMENT, false) < 0 ||
+                H5Pset_file_image(coreAccProperties, (void*) image, size) < 0)
+        {
+            close();
+            throw DCException(getExceptionString("openImage", "Failed to set file image"));
+        }
+
+        this->fileStatus = FST_READING;
+        this->compressionThreads = 0;
+        this->checksums = false;
+
+        // the filename is not used for file images
+        handles.open("image.h5", coreAccProperties, H5F_ACC_RDONLY);
+
+        try
+        {
+            SDCHelper::getReferenceData(handles.get(0), &(this->maxID), &(this->mpiTopology));
+        } catch (DCException)
+        {
+            close();
+            throw;
+        }
+    }
+
+    size_t SerialDataCollector::getFileImage(void* buffer, size_t size)
+    throw (DCException)
+    {
+        if (fileStatus == FST_CLOSED || fileStatus == FST_MERGING)
+            throw DCException(getExceptionString("getFileImage", "this access is not permitted"));
+
+        if (fileStatus == FST_CREATING || fileStatus == FST_WRITING)
+            writeMaxID();
+
+        H5Handle h5File = handles.get(0);
+        if (H5Fflush(h5File, H5F_SCOPE_LOCAL) < 0)
+            throw DCException(getExceptionString("getFileImage", "Failed to flush file"));
+
+        const ssize_t image_size = H5Fget_file_image(h5File, buffer, size);
+        if (image_size < 0)
+            throw DCException(getExceptionString("getFileImage",
+                    "Failed to get file image, buffer may be too small"));
+
+        return image_size;
+    }
+
     void SerialDataCollector::write(int32_t id, const CollectionType& type, uint32_t ndims,
             const Selection select, const char* name, const void* data)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_WRITE, id, name);
+
         if (name == NULL)
             throw DCException(getExceptionString("write", "parameter name is NULL"));
 
         if (fileStatus == FST_CLOSED || fileStatus == FST_READING || fileStatus == FST_MERGING)
             throw DCException(getExceptionString("write", "this access is not permitted"));
 
-        if (ndims < 1 || ndims > 3)
+        if (ndims < 1 || ndims > DSP_DIM_MAX)
             throw DCException(getExceptionString("write", "maximum dimension is invalid"));
 
         if (id > this->maxID)
@@ -426,6 +718,40 @@ namespace splash
         }
     }
 
+    void SerialDataCollector::writeComponents(int32_t id, const CollectionType& type,
+            uint32_t ndims, const Selection select, const char* name,
+            const void* const* components)
+    throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_WRITE, id, name);
+
+        if (name == NULL)
+            throw DCException(getExceptionString("writeComponents", "parameter name is NULL"));
+
+        if (fileStatus == FST_CLOSED || fileStatus == FST_READING || fileStatus == FST_MERGING)
+            throw DCException(getExceptionString("writeComponents", "this access is not permitted"));
+
+        if (ndims < 1 || ndims > DSP_DIM_MAX)
+            throw DCException(getExceptionString("writeComponents", "maximum dimension is invalid"));
+
+        uint32_t num_components = 0;
+        if (!DCConversion::getComponents(type.getDataType(), num_components))
+            throw DCException(getExceptionString("writeComponents",
+                "datatype cannot be written from components"));
+
+        if (id > this->maxID)
+            this->maxID = id;
+
+        std::string group_path, dset_name;
+        DCDataSet::getFullDataPath(name, SDC_GROUP_DATA, id, group_path, dset_name);
+
+        DCGroup group;
+        group.openCreate(handles.get(0), group_path);
+
+        writeDataSet(group.getHandle(), type, ndims, select, dset_name.c_str(),
+                NULL, components);
+    }
+
     void SerialDataCollector::append(int32_t id, const CollectionType& type,
             size_t count, const char* name, const void* data)
     throw (DCException)
@@ -437,6 +763,8 @@ namespace splash
             size_t count, size_t offset, size_t stride, const char* name, const void* data)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_APPEND, id, name);
+
         if (name == NULL)
             throw DCException(getExceptionString("append", "parameter name is NULL"));
 
@@ -466,6 +794,8 @@ namespace splash
     void SerialDataCollector::remove(int32_t id)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, id, NULL);
+
         log_msg(1, "removing group %d", id);
 
         if (fileStatus == FST_CLOSED || fileStatus == FST_READING || fileStatus == FST_MERGING)
@@ -476,6 +806,36 @@ namespace splash
 
         DCGroup::remove(handles.get(0), group_id_name.str());
 
+        updateMaxID();
+    }
+
+    void SerialDataCollector::removeIDs(const int32_t *ids, size_t count)
+    throw (DCException)
+    {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, -1, NULL);
+
+        log_msg(1, "removing %llu groups", (long long unsigned) count);
+
+        if (fileStatus == FST_CLOSED || fileStatus == FST_READING || fileStatus == FST_MERGING)
+            throw DCException(getExceptionString("removeIDs", "this access is not permitted"));
+
+        if (count > 0 && ids == NULL)
+            throw DCException(getExceptionString("removeIDs", "parameter ids is NULL"));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::stringstream group_id_name;
+            group_id_name << SDC_GROUP_DATA << "/" << ids[i];
+
+            DCGroup::remove(handles.get(0), group_id_name.str());
+        }
+
+        updateMaxID();
+    }
+
+    void SerialDataCollector::updateMaxID()
+    throw (DCException)
+    {
         // update maxID to new highest group
         maxID = 0;
         size_t num_groups = 0;
@@ -495,6 +855,8 @@ namespace splash
     void SerialDataCollector::remove(int32_t id, const char* name)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, id, name);
+
         log_msg(1, "removing dataset %s from group %d", name, id);
 
         if (fileStatus == FST_CLOSED || fileStatus == FST_READING || fileStatus == FST_MERGING)
@@ -522,6 +884,8 @@ namespace splash
             const char *dstName)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, dstID, dstName);
+
         if (srcName == NULL || dstName == NULL)
             throw DCException(getExceptionString("createReference", "a parameter was NULL"));
 
@@ -575,6 +939,8 @@ namespace splash
             Dimensions stride)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, dstID, dstName);
+
         if (srcName == NULL || dstName == NULL)
             throw DCException(getExceptionString("createReference", "a parameter was NULL"));
 
@@ -632,6 +998,8 @@ namespace splash
     void SerialDataCollector::getEntryIDs(int32_t* ids, size_t* count)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, -1, NULL);
+
         DCGroup group;
         group.open(handles.get(0), SDC_GROUP_DATA);
 
@@ -668,6 +1036,8 @@ namespace splash
     void SerialDataCollector::getEntriesForID(int32_t id, DCEntry *entries, size_t *count)
     throw (DCException)
     {
+        IOStatistics::Timer timer(statistics, IOStatistics::OP_GROUP, id, NULL);
+
         std::stringstream group_id_name;
         group_id_name << SDC_GROUP_DATA << "/" << id;
 
@@ -700,11 +1070,44 @@ namespace splash
         DCHelper::testFilename(full_filename);
 
         this->enableCompression = attr.enableCompression;
+        this->compressionThreads = attr.compressionThreads;
+        this->contiguousLayout = attr.contiguousLayout;
 
         log_msg(1, "compression = %d", attr.enableCompression);
 
+        hid_t access_properties = fileAccProperties;
+        if (attr.fileAccType == FAT_CREATE_INMEMORY)
+        {
+            // the core driver keeps the complete file in memory
+            coreAccProperties = H5Pcreate(H5P_FILE_ACCESS);
+            if (coreAccProperties < 0 ||
+                    H5Pset_fapl_core(coreAccProperties, SDC_CORE_INCREMENT, attr.backingStore) < 0)
+            {
+                this->fileStatus = FST_CLOSED;
+                throw DCException(getExceptionString("openCreate",
+                        "Failed to set in-memory file access", full_filename.c_str()));
+            }
+
+            access_properties = coreAccProperties;
+        }
+
+        hid_t create_properties = H5P_FILE_CREATE_DEFAULT;
+        if (attr.trackFreeSpace)
+        {
+            fileCreateProperties = DCHelper::createFreeSpaceTrackingPList();
+            if (fileCreateProperties < 0)
+            {
+                this->fileStatus = FST_CLOSED;
+                throw DCException(getExceptionString("openCreate",
+                        "Failed to set free space tracking", full_filename.c_str()));
+            }
+
+            create_properties = fileCreateProperties;
+        }
+
         // open file
-        handles.open(full_filename, fileAccProperties, H5F_ACC_TRUNC);
+        handles.open(full_filename, access_properties, H5F_ACC_TRUNC,
+                create_properties);
 
         this->maxID = 0;
         this->mpiTopology.set(attr.mpiSize);
@@ -735,6 +1138,8 @@ namespace splash
         DCHelper::testFilename(full_filename);
 
         this->enableCompression = attr.enableCompression;
+        this->compressionThreads = attr.compressionThreads;
+        this->contiguousLayout = attr.contiguousLayout;
 
         if (fileExists(full_filename))
         {
@@ -769,6 +1174,7 @@ namespace splash
 
         // no compression for in-memory datasets
         this->enableCompression = false;
+        this->compressionThreads = 0;
 
         handles.open(mpiTopology, filename, fileAccProperties, H5F_ACC_RDONLY);
     }
@@ -793,6 +1199,8 @@ namespace splash
         // read reference data from target file
         SDCHelper::getReferenceData(full_filename.c_str(), &(this->maxID), &(this->mpiTopology));
 
+        this->compressionThreads = attr.compressionThreads;
+
         handles.open(full_filename, fileAccProperties, H5F_ACC_RDONLY);
     }
 
@@ -801,17 +1209,31 @@ namespace splash
             uint32_t ndims,
             const Selection select,
             const char* name,
-            const void* data) throw (DCException)
+            const void* data,
+            const void* const* components) throw (DCException)
     {
         log_msg(2, "writeDataSet");
 
         DCDataSet dataset(name);
+        dataset.setDirectChunkIO(this->compressionThreads);
+        dataset.setChecksums(this->checksums);
+        dataset.setContiguous(this->contiguousLayout);
         // always create dataset but write data only if all dimensions > 0 and data available
         // not extensible
         dataset.create(datatype, group, select.count, ndims,
                 this->enableCompression, false);
-        if (data && (select.count.getScalarSize() > 0))
-            dataset.write(select, Dimensions(0, 0, 0), data);
+        try
+        {
+            if (data && (select.count.getScalarSize() > 0))
+                dataset.write(select, Dimensions(0, 0, 0), data);
+            if (components && (select.count.getScalarSize() > 0))
+                dataset.writeComponents(select, Dimensions(0, 0, 0), components);
+        } catch (DCException)
+        {
+            // e.g. invalid source selection
+            dataset.close();
+            throw;
+        }
         dataset.close();
     }
 
@@ -822,6 +1244,7 @@ namespace splash
         log_msg(2, "appendDataSet");
 
         DCDataSet dataset(name);
+        dataset.setChecksums(this->checksums);
 
         if (!dataset.open(group))
         {
@@ -830,8 +1253,8 @@ namespace splash
             dataset.create(datatype, group, data_size, 1, this->enableCompression, true);
 
             if (count > 0)
-                dataset.write(Selection(data_size,
-                    Dimensions(offset + count * stride, 1, 1),
+                dataset.write(Selection(Dimensions(offset + count * stride, 1, 1),
+                    data_size,
                     Dimensions(offset, 0, 0),
                     Dimensions(stride, 1, 1)),
                     Dimensions(0, 0, 0),
@@ -882,7 +1305,8 @@ namespace splash
             const Dimensions srcOffset,
             Dimensions &sizeRead,
             uint32_t& srcDims,
-            void* dst)
+            void* dst,
+            const CollectionType* memType)
     throw (DCException)
     {
         log_msg(2, "readCompleteDataSet");
@@ -894,9 +1318,21 @@ namespace splash
         group.open(h5File, group_path);
 
         DCDataSet dataset(dset_name.c_str());
+        dataset.setDirectChunkIO(this->compressionThreads);
+        dataset.setChecksums(this->checksums);
+        if (memType != NULL)
+            dataset.setMemoryType(memType->getDataType());
         dataset.open(group.getHandle());
         Dimensions src_size(dataset.getSize() - srcOffset);
-        dataset.read(dstBuffer, dstOffset, src_size, srcOffset, sizeRead, srcDims, dst);
+        try
+        {
+            dataset.read(dstBuffer, dstOffset, src_size, srcOffset, sizeRead, srcDims, dst);
+        } catch (DCException)
+        {
+            // e.g. unsupported memory datatype
+            dataset.close();
+            throw;
+        }
         dataset.close();
     }
 
@@ -921,6 +1357,8 @@ namespace splash
         group.open(h5File, group_path);
 
         DCDataSet dataset(dset_name.c_str());
+        dataset.setDirectChunkIO(this->compressionThreads);
+        dataset.setChecksums(this->checksums);
         dataset.open(group.getHandle());
         dataset.read(dstBuffer, dstOffset, srcSize, srcOffset, sizeRead, srcDims, dst);
         dataset.close();
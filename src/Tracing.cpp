@@ -0,0 +1,236 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <time.h>
+#include <pthread.h>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#include "splash/Tracing.hpp"
+
+namespace splash
+{
+
+    /**
+     * a buffered trace event
+     */
+    typedef struct
+    {
+        const char *category;
+        const char *name;
+        std::string detail;
+        double startTime;
+        double endTime;
+        uint64_t tid;
+    } TraceEvent;
+
+    static bool tracing_enabled = false;
+    static bool trace_file_created = false;
+    static int trace_pid = 0;
+    static std::string trace_filename;
+    static std::vector<TraceEvent> trace_events;
+    static pthread_mutex_t trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+    /**
+     * Returns the time since the epoch in microseconds, which allows
+     * to merge the traces of several nodes and of the application.
+     */
+    static double getTraceTime()
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        return (double) now.tv_sec * 1.0e6 + (double) now.tv_nsec * 1.0e-3;
+    }
+
+    static void writeJSONString(std::ostream &out, const std::string &str)
+    {
+        out << "\"";
+        for (size_t i = 0; i < str.size(); ++i)
+        {
+            const unsigned char c = str[i];
+            if (c == '"' || c == '\\')
+                out << "\\" << c;
+            else if (c < 0x20)
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') <<
+                    (unsigned) c << std::dec << std::setfill(' ');
+            else
+                out << c;
+        }
+        out << "\"";
+    }
+
+    static void writeEvent(std::ostream &out, const TraceEvent &event, int pid)
+    {
+        out << "{\"name\": \"" << event.name << "\", \"cat\": \"" << event.category <<
+                "\", \"ph\": \"X\", \"ts\": " << event.startTime <<
+                ", \"dur\": " << event.endTime - event.startTime <<
+                ", \"pid\": " << pid << ", \"tid\": " << event.tid;
+
+        if (!event.detail.empty())
+        {
+            out << ", \"args\": {\"detail\": ";
+            writeJSONString(out, event.detail);
+            out << "}";
+        }
+        out << "}";
+    }
+
+    /**
+     * Writes the buffered events as elements of a JSON array.
+     *
+     * @param out stream to write to
+     * @param continued true if the array already contains events
+     */
+    static void writeEvents(std::ostream &out, bool continued)
+    {
+        out << std::fixed << std::setprecision(3);
+        for (size_t i = 0; i < trace_events.size(); ++i)
+        {
+            out << ((i > 0 || continued) ? ",\n" : "\n");
+            writeEvent(out, trace_events[i], trace_pid);
+        }
+    }
+
+    Tracing::Scope::Scope(const char *category, const char *name, const char *detail) :
+    category(category),
+    name(name),
+    detail(detail),
+    startTime(0.0)
+    {
+        if (tracing_enabled)
+            startTime = getTraceTime();
+    }
+
+    Tracing::Scope::~Scope()
+    {
+        // events are only recorded if tracing was enabled at construction
+        if (tracing_enabled && startTime > 0.0)
+            Tracing::record(category, name, detail, startTime, getTraceTime());
+    }
+
+    void Tracing::enable(const std::string &filename)
+    {
+        pthread_mutex_lock(&trace_mutex);
+        trace_filename = filename;
+        trace_file_created = false;
+        tracing_enabled = true;
+        pthread_mutex_unlock(&trace_mutex);
+    }
+
+    void Tracing::disable()
+    {
+        pthread_mutex_lock(&trace_mutex);
+        tracing_enabled = false;
+        trace_events.clear();
+        pthread_mutex_unlock(&trace_mutex);
+    }
+
+    bool Tracing::isEnabled()
+    {
+        return tracing_enabled;
+    }
+
+    void Tracing::setProcessID(int pid)
+    {
+        trace_pid = pid;
+    }
+
+    size_t Tracing::getNumEvents()
+    {
+        pthread_mutex_lock(&trace_mutex);
+        size_t num_events = trace_events.size();
+        pthread_mutex_unlock(&trace_mutex);
+
+        return num_events;
+    }
+
+    void Tracing::record(const char *category, const char *name,
+            const char *detail, double startTime, double endTime)
+    {
+        TraceEvent event;
+        event.category = category;
+        event.name = name;
+        if (detail != NULL)
+            event.detail = detail;
+        event.startTime = startTime;
+        event.endTime = endTime;
+        event.tid = (uint64_t) pthread_self();
+
+        pthread_mutex_lock(&trace_mutex);
+        trace_events.push_back(event);
+        pthread_mutex_unlock(&trace_mutex);
+    }
+
+    void Tracing::writeChromeTrace(std::ostream &out)
+    {
+        pthread_mutex_lock(&trace_mutex);
+
+        out << "[";
+        writeEvents(out, false);
+        out << "\n]\n";
+
+        pthread_mutex_unlock(&trace_mutex);
+    }
+
+    void Tracing::flush()
+    throw (DCException)
+    {
+        pthread_mutex_lock(&trace_mutex);
+
+        if (!tracing_enabled || trace_events.empty())
+        {
+            pthread_mutex_unlock(&trace_mutex);
+            return;
+        }
+
+        std::stringstream filename;
+        filename << trace_filename << "_" << trace_pid << ".json";
+
+        std::fstream file(filename.str().c_str(), trace_file_created ?
+                (std::ios::in | std::ios::out) : (std::ios::out | std::ios::trunc));
+        if (!file)
+        {
+            pthread_mutex_unlock(&trace_mutex);
+            throw DCException(std::string("Tracing::flush: failed to open ") + filename.str());
+        }
+
+        // the array is terminated after every flush, further events
+        // overwrite the terminating "\n]\n"
+        if (trace_file_created)
+            file.seekp(-3, std::ios::end);
+        else
+            file << "[";
+
+        writeEvents(file, trace_file_created);
+        file << "\n]\n";
+        trace_file_created = true;
+
+        trace_events.clear();
+
+        pthread_mutex_unlock(&trace_mutex);
+
+        if (!file)
+            throw DCException(std::string("Tracing::flush: failed to write ") + filename.str());
+    }
+
+}
@@ -24,6 +24,7 @@
 #ifndef COLLECTIONTYPE_H
 #define	COLLECTIONTYPE_H
 
+#include <cstddef>
 #include <hdf5.h>
 
 #define H5DataType hid_t
@@ -31,6 +32,8 @@
 namespace splash
 {
 
+    class ColTypeStorage;
+
     /**
      * Describes the datatype to be used for writing/reading HDF5 data to/from disk.
      */
@@ -55,6 +58,17 @@ namespace splash
          */
         virtual size_t getSize() const = 0;
 
+        /**
+         * Returns the description of the storage datatype if data
+         * is stored with a different datatype than in memory.
+         *
+         * @return storage description or NULL if data is stored with its memory datatype
+         */
+        virtual const ColTypeStorage* getStorage() const
+        {
+            return NULL;
+        }
+
         /**
          * Destructor
          */
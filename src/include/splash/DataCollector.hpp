@@ -48,9 +48,12 @@
 #define	_DATACOLLECTOR_H
 
 #include <stdint.h>
+#include <string>
 
 #include "splash/CollectionType.hpp"
+#include "splash/DCException.hpp"
 #include "splash/Dimensions.hpp"
+#include "splash/IOStatistics.hpp"
 #include "splash/Selection.hpp"
 
 namespace splash
@@ -62,10 +65,12 @@ namespace splash
 
         /**
          * flags for opening files
+         * (FAT_CREATE_INMEMORY creates a file in memory, only supported by
+         * serial DataCollectors)
          */
         enum FileAccType
         {
-            FAT_CREATE, FAT_READ, FAT_READ_MERGED, FAT_WRITE
+            FAT_CREATE, FAT_READ, FAT_READ_MERGED, FAT_WRITE, FAT_CREATE_INMEMORY
         };
 
         /**
@@ -78,7 +83,13 @@ namespace splash
             fileAccType(FAT_CREATE),
             mpiSize(1, 1, 1),
             mpiPosition(0, 0, 0),
-            enableCompression(false)
+            enableCompression(false),
+            compressionThreads(0),
+            contiguousLayout(false),
+            backingStore(false),
+            trackFreeSpace(false),
+            checksums(false),
+            statisticsFile()
             {
 
             }
@@ -102,6 +113,50 @@ namespace splash
              * Enable compression, if supported.
              */
             bool enableCompression;
+
+            /**
+             * Number of threads for (de)compressing chunks directly,
+             * bypassing the HDF5 filter pipeline, if supported.
+             * 0 uses the HDF5 filter pipeline.
+             */
+            uint32_t compressionThreads;
+
+            /**
+             * Store uncompressed datasets with contiguous instead of
+             * chunked layout, e.g. to map them with
+             * \ref SerialDataCollector::mapDataset.
+             * Only used by serial DataCollectors.
+             */
+            bool contiguousLayout;
+
+            /**
+             * Write a file created with FAT_CREATE_INMEMORY
+             * to disk when it is closed.
+             */
+            bool backingStore;
+
+            /**
+             * Persistently track free space in created files, so that
+             * the space of deleted or overwritten datasets is reused
+             * by later writes, even after the file has been reopened.
+             * Requires HDF5 1.10.1 or newer and is only set when a file is created.
+             */
+            bool trackFreeSpace;
+
+            /**
+             * Store a CRC-32 checksum with each dataset written or appended
+             * at once and verify it when a complete dataset is read,
+             * see \ref SDC_ATTR_CHECKSUM.
+             * Only used by serial DataCollectors.
+             */
+            bool checksums;
+
+            /**
+             * Write the I/O statistics as JSON to this file when the
+             * file is closed, empty to disable.
+             * Parallel DataCollectors append the MPI rank to the filename.
+             */
+            std::string statisticsFile;
         } FileCreationAttr;
 
         /**
@@ -117,13 +172,22 @@ namespace splash
 
         /**
          * Initializes FileCreationAttr with default values.
-         * (compression = false, access type = FAT_CREATE, position = (0, 0, 0), size = (1, 1, 1))
+         * (compression = false, compression threads = 0, contiguous layout = false,
+         * backing store = false, free space tracking = false,
+         * checksums = false, no statistics file, access type = FAT_CREATE,
+         * position = (0, 0, 0), size = (1, 1, 1))
          * 
          * @param attr file attributes to initialize
          */
         static void initFileCreationAttr(FileCreationAttr& attr)
         {
             attr.enableCompression = false;
+            attr.compressionThreads = 0;
+            attr.contiguousLayout = false;
+            attr.backingStore = false;
+            attr.trackFreeSpace = false;
+            attr.checksums = false;
+            attr.statisticsFile.clear();
             attr.fileAccType = FAT_CREATE;
             attr.mpiPosition.set(0, 0, 0);
             attr.mpiSize.set(1, 1, 1);
@@ -202,6 +266,30 @@ namespace splash
                 const char* name,
                 const void* buf) = 0;
 
+        /**
+         * Writes data of a compound or array type from separate buffers
+         * per member (structure of arrays) to HDF5 file.
+         * Members are interleaved on the fly in slabs, so no interleaved
+         * copy of all data is required.
+         * The default implementation throws a DCException.
+         *
+         * @param id ID for iteration.
+         * @param type Compound or array type of the dataset.
+         * @param ndims Number of dimensions (1-3).
+         * @param select Selection in each buffer of \p components.
+         * @param name Name for the dataset.
+         * @param components One buffer per member of \p type, holding the member's datatype.
+         */
+        virtual void writeComponents(int32_t /*id*/,
+                const CollectionType& /*type*/,
+                uint32_t /*ndims*/,
+                const Selection /*select*/,
+                const char* /*name*/,
+                const void* const* /*components*/)
+        {
+            throw DCException("DataCollector::writeComponents: not supported");
+        }
+
         /**
          * Appends 1-dimensional data in a HDF5 file.
          *
@@ -386,6 +474,85 @@ namespace splash
                 const Dimensions dstOffset,
                 Dimensions &sizeRead,
                 void* buf) = 0;
+
+        /**
+         * Reads data from HDF5 file, converting it to a memory datatype.
+         * If data is to be read (instead of only its size in the file),
+         * the destination buffer (\p buf) must be allocated already.
+         *
+         * Conversions between integer and floating point types, byte orders
+         * and compound types with matching member names are done by libSplash.
+         * Reading a compound dataset with an atomic \p type returns its
+         * members as consecutive planes of \p dstBuffer elements each
+         * (structure of arrays).
+         * All other conversions are done by HDF5.
+         * The default implementation throws a DCException.
+         *
+         * @param id ID for iteration.
+         * @param type Type information for data in \p buf.
+         * @param name Name for the dataset.
+         * @param dstBuffer Size of the buffer \p buf to read to.
+         * @param dstOffset Offset in destination buffer to read to.
+         * @param sizeRead Returns the size of the data in the file.
+         * @param buf Buffer to read from file, can be NULL.
+         */
+        virtual void read(int32_t /*id*/,
+                const CollectionType& /*type*/,
+                const char* /*name*/,
+                const Dimensions /*dstBuffer*/,
+                const Dimensions /*dstOffset*/,
+                Dimensions& /*sizeRead*/,
+                void* /*buf*/)
+        {
+            throw DCException("DataCollector::read: typed reads not supported");
+        }
+
+        /**
+         * Reads data of a compound or array type from HDF5 file into
+         * separate buffers per member (structure of arrays).
+         * If data is to be read (instead of only its size in the file),
+         * the destination buffers must be allocated already.
+         * The default implementation throws a DCException.
+         *
+         * @param id ID for iteration.
+         * @param type Atomic type information for each buffer of \p components.
+         * @param name Name for the dataset.
+         * @param dstBuffer Size of each buffer of \p components.
+         * @param dstOffset Offset in destination buffers to read to.
+         * @param sizeRead Returns the size of the data in the file.
+         * @param components One buffer per member of the dataset's type, can be NULL.
+         */
+        virtual void readComponents(int32_t /*id*/,
+                const CollectionType& /*type*/,
+                const char* /*name*/,
+                const Dimensions /*dstBuffer*/,
+                const Dimensions /*dstOffset*/,
+                Dimensions& /*sizeRead*/,
+                void* const* /*components*/)
+        {
+            throw DCException("DataCollector::readComponents: not supported");
+        }
+
+        /**
+         * Returns statistics on all I/O operations of this DataCollector
+         * since its construction or the last call to \ref resetStatistics.
+         * The default implementation throws a DCException.
+         *
+         * @return I/O statistics
+         */
+        virtual const IOStatistics& getStatistics() const
+        {
+            throw DCException("DataCollector::getStatistics: not supported");
+        }
+
+        /**
+         * Resets the I/O statistics.
+         * The default implementation throws a DCException.
+         */
+        virtual void resetStatistics()
+        {
+            throw DCException("DataCollector::resetStatistics: not supported");
+        }
     };
 
 }
@@ -25,19 +25,27 @@
 #define	_DIMENSIONS_H
 
 #include <sstream>
+#include <stdint.h>
 #include <hdf5.h>
 
+#include "splash/sdc_defines.hpp"
+
 namespace splash
 {
 
     /**
-     * Manages 1-3D size information.
+     * Manages 1-N-dimensional size information, N is at most \ref DSP_DIM_MAX.
      * Can be used for MPI-positions/-dimensions or data-dimensions.
+     *
+     * Dimensions always have at least 3 elements.
+     * Elements beyond the rank of Dimensions are zero, element-wise
+     * operations on Dimensions of different rank use the larger rank.
      */
     class Dimensions
     {
     private:
-        hsize_t s[3];
+        hsize_t s[DSP_DIM_MAX];
+        uint32_t rank;
     public:
 
         /**
@@ -60,10 +68,23 @@ namespace splash
             set(x, y, z);
         }
 
+        /**
+         * Constructor for more than 3 dimensions
+         * @param ndims number of dimensions (1-\ref DSP_DIM_MAX)
+         * @param values array with \p ndims elements
+         */
+        Dimensions(uint32_t ndims, const hsize_t *values)
+        {
+            set(1, 1, 1);
+            setRank(ndims, 1);
+            for (uint32_t i = 0; i < ndims && i < DSP_DIM_MAX; ++i)
+                s[i] = values[i];
+        }
+
         /**
          * Returns element \p t
          * 
-         * @param t element index (1-3)
+         * @param t element index (0-\ref DSP_DIM_MAX - 1)
          * @return element
          */
         hsize_t & operator[](const hsize_t t)
@@ -74,7 +95,7 @@ namespace splash
         /**
          * Returns element \p t
          * 
-         * @param t element index (1-3)
+         * @param t element index (0-\ref DSP_DIM_MAX - 1)
          * @return element
          */
         const hsize_t & operator[](const hsize_t t) const
@@ -90,7 +111,11 @@ namespace splash
          */
         Dimensions operator+(Dimensions const& other) const
         {
-            return Dimensions(s[0] + other[0], s[1] + other[1], s[2] + other[2]);
+            Dimensions result(*this);
+            result.setRank(other.getRank(), 0);
+            for (uint32_t i = 0; i < result.getRank(); ++i)
+                result[i] += other[i];
+            return result;
         }
 
         /**
@@ -101,7 +126,11 @@ namespace splash
          */
         Dimensions operator-(Dimensions const& other) const
         {
-            return Dimensions(s[0] - other[0], s[1] - other[1], s[2] - other[2]);
+            Dimensions result(*this);
+            result.setRank(other.getRank(), 0);
+            for (uint32_t i = 0; i < result.getRank(); ++i)
+                result[i] -= other[i];
+            return result;
         }
 
         /**
@@ -112,7 +141,11 @@ namespace splash
          */
         Dimensions operator*(Dimensions const& other) const
         {
-            return Dimensions(s[0] * other[0], s[1] * other[1], s[2] * other[2]);
+            Dimensions result(*this);
+            result.setRank(other.getRank(), 0);
+            for (uint32_t i = 0; i < result.getRank(); ++i)
+                result[i] *= other[i];
+            return result;
         }
 
         /**
@@ -123,7 +156,11 @@ namespace splash
          */
         Dimensions operator/(Dimensions const& other) const
         {
-            return Dimensions(s[0] / other[0], s[1] / other[1], s[2] / other[2]);
+            Dimensions result(*this);
+            result.setRank(other.getRank(), 0);
+            for (uint32_t i = 0; i < result.getRank(); ++i)
+                result[i] /= other[i];
+            return result;
         }
 
         /**
@@ -158,7 +195,12 @@ namespace splash
          */
         bool operator==(Dimensions const& other) const
         {
-            return s[0] == other[0] && s[1] == other[1] && s[2] == other[2];
+            const uint32_t max_rank = (rank > other.getRank()) ? rank : other.getRank();
+            for (uint32_t i = 0; i < max_rank; ++i)
+                if (s[i] != other[i])
+                    return false;
+
+            return true;
         }
 
         /**
@@ -180,7 +222,10 @@ namespace splash
         std::string toString() const
         {
             std::stringstream stream;
-            stream << "(" << s[0] << "," << s[1] << "," << s[2] << ")";
+            stream << "(" << s[0];
+            for (uint32_t i = 1; i < rank; ++i)
+                stream << "," << s[i];
+            stream << ")";
             return stream.str();
         }
 
@@ -203,7 +248,8 @@ namespace splash
         }
 
         /**
-         * Get the size in bytes of the data array.
+         * Get the size in bytes of the data array of 3 dimensions,
+         * e.g. for attributes.
          * @return Size in bytes of data array.
          */
         inline static size_t getSize()
@@ -217,11 +263,15 @@ namespace splash
          */
         inline size_t getScalarSize() const
         {
-            return s[0] * s[1] * s[2];
+            size_t scalar_size = s[0];
+            for (uint32_t i = 1; i < rank; ++i)
+                scalar_size *= s[i];
+            return scalar_size;
         }
 
         /**
          * Set dimensions.
+         * Resets the rank to 3.
          * @param x First dimension.
          * @param y Second dimension.
          * @param z Third dimension.
@@ -231,6 +281,9 @@ namespace splash
             s[0] = x;
             s[1] = y;
             s[2] = z;
+            for (uint32_t i = 3; i < DSP_DIM_MAX; ++i)
+                s[i] = 0;
+            rank = 3;
         }
 
         /**
@@ -239,9 +292,37 @@ namespace splash
          */
         inline void set(const Dimensions d)
         {
-            s[0] = d[0];
-            s[1] = d[1];
-            s[2] = d[2];
+            for (uint32_t i = 0; i < DSP_DIM_MAX; ++i)
+                s[i] = d[i];
+            rank = d.getRank();
+        }
+
+        /**
+         * Get the number of elements, at least 3.
+         * @return Rank of this object.
+         */
+        inline uint32_t getRank(void) const
+        {
+            return rank;
+        }
+
+        /**
+         * Extends the number of elements to \p ndims.
+         * New elements are set to \p value.
+         * Dimensions are never reduced below their current rank.
+         * @param ndims Number of elements (up to \ref DSP_DIM_MAX).
+         * @param value Value for new elements, e.g. 0 for offsets or 1 for sizes.
+         */
+        inline void setRank(uint32_t ndims, hsize_t value)
+        {
+            if (ndims > DSP_DIM_MAX)
+                ndims = DSP_DIM_MAX;
+
+            for (uint32_t i = rank; i < ndims; ++i)
+                s[i] = value;
+
+            if (ndims > rank)
+                rank = ndims;
         }
         
         /**
@@ -250,38 +331,32 @@ namespace splash
          */
         inline uint32_t getDims(void) const
         {
-            uint32_t dims = 3;
-            if (s[2] == 1)
-            {
-                dims = 2;
-                if (s[1] == 1)
-                    dims = 1;
-            }
+            uint32_t dims = rank;
+            while (dims > 1 && s[dims - 1] == 1)
+                dims--;
             
             return dims;
         }
 
         /**
-         * Swaps the dimensions depending on \p dims.
+         * Swaps the dimensions depending on \p dims,
+         * i.e. reverses the order of the first \p dims elements.
+         * Dimensions of lower rank are extended to \p dims elements first.
          * @param dims Number of dimensions for swapping.
+         * @param value Value for new elements, 1 for sizes or 0 for offsets.
          */
-        void swapDims(uint32_t dims)
+        void swapDims(uint32_t dims, hsize_t value = 1)
         {
-            hsize_t tmp1 = s[0];
-            hsize_t tmp2[3] = {s[2], s[1], s[0]};
+            if (dims > DSP_DIM_MAX)
+                return;
+
+            setRank(dims, value);
 
-            switch (dims)
+            for (uint32_t i = 0; i < dims / 2; ++i)
             {
-                case 2:
-                    s[0] = s[1];
-                    s[1] = tmp1;
-                    break;
-                case 3:
-                    for (uint32_t i = 0; i < 3; i++)
-                        s[i] = tmp2[i];
-                    break;
-                default:
-                    return;
+                hsize_t tmp = s[i];
+                s[i] = s[dims - 1 - i];
+                s[dims - 1 - i] = tmp;
             }
         }
 
@@ -290,4 +365,3 @@ namespace splash
 }
 
 #endif	/* _DIMENSIONS_H */
-
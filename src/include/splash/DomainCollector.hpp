@@ -29,6 +29,7 @@
 #include "splash/Dimensions.hpp"
 #include "splash/Selection.hpp"
 #include "splash/DCException.hpp"
+#include "splash/core/DCDomainDescriptor.hpp"
 
 namespace splash
 {
@@ -52,6 +53,26 @@ namespace splash
     class DomainCollector : public IDomainCollector, public SerialDataCollector
     {
     public:
+
+        /**
+         * Domain annotation and layout of a dataset.
+         */
+        typedef struct
+        {
+            /** class of the data */
+            DomDataClass dataClass;
+            /** local domain, relative to the offset of the global domain */
+            Domain localDomain;
+            /** global domain */
+            Domain globalDomain;
+            /** number of dimensions of the dataset */
+            uint32_t ndims;
+            /** size of the dataset */
+            Dimensions dataSize;
+            /** type of the data, DCDT_UNKNOWN for other than basic types */
+            DCDataType dataType;
+        } DomainInfo;
+
         /**
          * Constructor
          * @param maxFileHandles Maximum number of concurrently opened file handles (0=unlimited).
@@ -77,6 +98,20 @@ namespace splash
 
         void readDomainLazy(DomainData *domainData) throw (DCException);
 
+        /**
+         * Reads the domain annotation and layout of a dataset
+         * in the local file without reading its data,
+         * e.g. to create meta data descriptions of a file.
+         *
+         * @param id ID of the iteration.
+         * @param name Name of the dataset.
+         * @param info Returns the annotation of the dataset.
+         * @return false if the dataset has no domain annotation
+         */
+        bool readDomainInfo(int32_t id,
+                const char* name,
+                DomainInfo &info) throw (DCException);
+
         void writeDomain(int32_t id,
                 const CollectionType& type,
                 uint32_t ndims,
@@ -113,6 +148,22 @@ namespace splash
                 const Domain localDomain,
                 const Domain globalDomain) throw (DCException);
         
+        /**
+         * Reads the compound domain attribute of a dataset.
+         *
+         * @param id ID of the iteration.
+         * @param name Name of the dataset.
+         * @param mpiPosition MPI position of the file to read from.
+         * @param descriptor Returns the domain annotation.
+         * @return true if the dataset has a compound domain attribute,
+         * false if it only has the separate legacy attributes
+         */
+        bool readDomainDescriptor(
+                int32_t id,
+                const char *name,
+                Dimensions mpiPosition,
+                DCDomainDescriptor &descriptor) throw (DCException);
+
         bool readDomainInfoForRank(
                 Dimensions mpiPosition,
                 int32_t id,
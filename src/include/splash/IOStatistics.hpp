@@ -0,0 +1,215 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IOSTATISTICS_HPP
+#define	IOSTATISTICS_HPP
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <ostream>
+
+#include "splash/DCException.hpp"
+#include "splash/Tracing.hpp"
+
+/** number of bins of the time and size histograms of \ref IOStatistics */
+#define IOSTAT_HISTOGRAM_BINS 32
+
+namespace splash
+{
+
+    /**
+     * Statistics on the I/O operations of a DataCollector.
+     *
+     * For each type of operation, the number of calls, the transferred bytes,
+     * the number of HDF5 data transfer calls and the wall time are recorded,
+     * in total and per iteration and dataset name.
+     * Histograms count the calls by duration (in microseconds) and by
+     * transferred bytes. Bin 0 counts zero values, bin i values
+     * in [2^(i-1), 2^i) and the last bin all larger values.
+     */
+    class IOStatistics
+    {
+    public:
+
+        /**
+         * types of recorded operations
+         */
+        enum Operation
+        {
+            OP_WRITE, OP_READ, OP_APPEND, OP_ATTRIBUTE, OP_GROUP, OP_COUNT
+        };
+
+        /**
+         * Counters of a single type of operation.
+         */
+        typedef struct _Counters
+        {
+            _Counters();
+
+            /** number of calls */
+            uint64_t calls;
+            /** bytes transferred by HDF5, in the uncompressed file datatype */
+            uint64_t bytes;
+            /** number of HDF5 data transfer calls */
+            uint64_t h5Calls;
+            /** total wall time in seconds */
+            double time;
+            /** maximum wall time of a single call in seconds */
+            double maxTime;
+            /** calls by wall time in microseconds */
+            uint64_t timeHistogram[IOSTAT_HISTOGRAM_BINS];
+            /** calls by transferred bytes */
+            uint64_t sizeHistogram[IOSTAT_HISTOGRAM_BINS];
+        } Counters;
+
+        /**
+         * Counters of all types of operations for a dataset.
+         */
+        typedef struct
+        {
+            Counters operations[OP_COUNT];
+        } Entry;
+
+        /**
+         * Identifies a dataset by iteration and name.
+         * The iteration is -1 for global attributes and file-wide operations,
+         * the name is empty for operations on a complete iteration.
+         */
+        typedef std::pair<int32_t, std::string> Key;
+
+        typedef std::map<Key, Entry> EntryMap;
+
+        /**
+         * Measures the wall time and transfers of an operation
+         * from construction to destruction and records them.
+         * Operations started while another operation is measured,
+         * e.g. calls to other methods of the DataCollector, are not recorded.
+         * All operations are recorded as trace events, see \ref Tracing.
+         */
+        class Timer
+        {
+        public:
+            Timer(IOStatistics &statistics, Operation op, int32_t id, const char *name);
+            ~Timer();
+        private:
+            Timer(const Timer &other);
+            Timer& operator=(const Timer &other);
+
+            IOStatistics &statistics;
+            Operation op;
+            int32_t id;
+            const char *name;
+            bool outermost;
+            double startTime;
+            uint64_t startCalls;
+            uint64_t startBytes;
+            Tracing::Scope trace;
+        };
+
+        /**
+         * Constructor
+         */
+        IOStatistics();
+
+        /**
+         * Resets all counters.
+         */
+        void reset();
+
+        /**
+         * Records a single operation.
+         *
+         * @param op type of operation
+         * @param id iteration
+         * @param name name of the dataset, can be NULL
+         * @param time wall time in seconds
+         * @param bytes transferred bytes
+         * @param h5Calls number of HDF5 data transfer calls
+         */
+        void record(Operation op, int32_t id, const char *name,
+                double time, uint64_t bytes, uint64_t h5Calls);
+
+        /**
+         * Returns the counters of all operations of a type.
+         *
+         * @param op type of operation
+         * @return counters
+         */
+        const Counters& getTotal(Operation op) const;
+
+        /**
+         * Returns the counters per iteration and dataset.
+         *
+         * @return map of counters
+         */
+        const EntryMap& getEntries() const;
+
+        /**
+         * Writes all counters as JSON.
+         *
+         * @param out stream to write to
+         */
+        void writeJSON(std::ostream &out) const;
+
+        /**
+         * Writes all counters as JSON to a file.
+         *
+         * @param filename file to write to, is overwritten
+         */
+        void writeJSON(const std::string &filename) const throw (DCException);
+
+        /**
+         * Returns the name of a type of operation, e.g. "write".
+         *
+         * @param op type of operation
+         * @return name
+         */
+        static const char* getOperationName(Operation op);
+
+        /**
+         * Counts an HDF5 data transfer call.
+         * Called by the library internally.
+         * Bytes are always counted uncompressed, also for
+         * compressed chunks which are transferred directly.
+         *
+         * @param bytes transferred bytes
+         * @param calls number of HDF5 calls, 0 for data which is
+         * not transferred from the file, e.g. unallocated chunks
+         */
+        static void addTransfer(uint64_t bytes, uint64_t calls = 1);
+
+    private:
+        static void addCounters(Counters &counters, double time,
+                uint64_t bytes, uint64_t h5Calls);
+        static void writeCounters(std::ostream &out, const Counters &counters);
+
+        Counters total[OP_COUNT];
+        EntryMap entries;
+        uint32_t activeTimers;
+
+        static uint64_t transferCalls;
+        static uint64_t transferBytes;
+    };
+
+}
+
+#endif	/* IOSTATISTICS_HPP */
@@ -67,6 +67,40 @@ namespace splash
                 const Selection select,
                 const char* name,
                 const void* buf) = 0;
+
+        /**
+         * Implements \ref DataCollector::writeComponents
+         * The global size and the write offset for the calling process are
+         * determined automatically via MPI among all participating processes.
+         */
+        virtual void writeComponents(int32_t id,
+                const CollectionType& type,
+                uint32_t rank,
+                const Selection select,
+                const char* name,
+                const void* const* components) = 0;
+
+        /**
+         * Writes data of a compound or array type from separate buffers
+         * per member (structure of arrays) to HDF5 file.
+         *
+         * @param id ID for iteration
+         * @param globalSize Size of global collective write buffer.
+         * @param globalOffset Offset in \p globalSize buffer where this process writes to.
+         * @param type Compound or array type of the dataset.
+         * @param rank Number of dimensions (1-3).
+         * @param select Selection in each buffer of \p components.
+         * @param name Name for the dataset.
+         * @param components One buffer per member of \p type, holding the member's datatype.
+         */
+        virtual void writeComponents(int32_t id,
+                const Dimensions globalSize,
+                const Dimensions globalOffset,
+                const CollectionType& type,
+                uint32_t rank,
+                const Selection select,
+                const char* name,
+                const void* const* components) = 0;
         
         /**
          * Reserves a dataset for parallel access. 
@@ -102,6 +136,37 @@ namespace splash
                 const CollectionType& type,
                 const char* name) = 0;
 
+        /**
+         * Declares a dataset for deferred creation by \ref IParallelDataCollector::createDeclared.
+         * Declaring is a local operation but all processes must declare
+         * the same datasets in the same order.
+         *
+         * @param id ID for iteration.
+         * @param globalSize Size of global data.
+         * @param rank Number of dimensions (1-3).
+         * @param type Type information for data.
+         * @param name Name for the dataset.
+         */
+        virtual void declare(int32_t id,
+                const Dimensions globalSize,
+                uint32_t rank,
+                const CollectionType& type,
+                const char* name) = 0;
+
+        /**
+         * Creates all groups and datasets declared for an iteration in a
+         * single collective pass.
+         * Datasets are created with the same settings as by
+         * \ref IParallelDataCollector::write, chunks of compressed datasets are
+         * aligned to an even split of the global size over the MPI topology.
+         * Subsequent calls to \ref IParallelDataCollector::write for these
+         * datasets only write raw data and must pass the declared global size,
+         * a DCException is thrown otherwise.
+         *
+         * @param id ID for iteration.
+         */
+        virtual void createDeclared(int32_t id) = 0;
+
         /**
          * Reads global attribute from HDF5 file.
          *
@@ -158,6 +223,29 @@ namespace splash
                 const char *name,
                 const void *buf) = 0;
 
+        /**
+         * Appends 1-dimensional data of all processes to a dataset,
+         * creating the dataset if it does not exist.
+         * Global size and offsets are computed internally, i.e. no prior
+         * \ref IParallelDataCollector::reserve is required.
+         * Can be called multiple times per iteration, each call extends the
+         * dataset by the data of all processes, ordered by MPI rank.
+         * Must be called collectively, processes may pass count = 0.
+         *
+         * @param id ID for iteration.
+         * @param type Type information for data.
+         * @param count Number of local elements to append.
+         * @param name Name for the dataset to append to.
+         * @param buf Buffer to append.
+         * @param globalOffset Returns the offset of the local data in the dataset, can be NULL.
+         */
+        virtual void reserveAndAppend(int32_t id,
+                const CollectionType& type,
+                size_t count,
+                const char *name,
+                const void *buf,
+                Dimensions *globalOffset) = 0;
+
         virtual void append(int32_t id,
                 const CollectionType& type,
                 size_t count,
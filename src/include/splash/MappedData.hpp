@@ -0,0 +1,180 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPPEDDATA_HPP
+#define	MAPPEDDATA_HPP
+
+#include <stdint.h>
+#include <sys/mman.h>
+
+#include "splash/Dimensions.hpp"
+#include "splash/DCException.hpp"
+#include "splash/core/DCDataType.hpp"
+
+namespace splash
+{
+
+    /**
+     * Read-only view of the raw data of a dataset which is
+     * mapped into memory, see \ref SerialDataCollector::mapDataset.
+     *
+     * Elements are stored in logical order, i.e. the first dimension
+     * is the fastest.
+     * The mapping is removed when the MappedData is deleted.
+     */
+    class MappedData
+    {
+    public:
+
+        /**
+         * Constructor.
+         * Takes ownership of the mapping.
+         *
+         * @param mapping start of the mapped memory, can be NULL for empty datasets.
+         * @param mappingSize size of the mapped memory in bytes.
+         * @param dataOffset offset of the raw data in the mapped memory in bytes.
+         * @param size Number of data elements in every dimension.
+         * @param ndims Number of dimensions of the dataset.
+         * @param datatypeSize Size of each element in bytes.
+         * @param datatype Internal representation of HDF5 datatype.
+         */
+        MappedData(void *mapping, size_t mappingSize, size_t dataOffset,
+                const Dimensions size, uint32_t ndims,
+                size_t datatypeSize, DCDataType datatype) :
+        mapping(mapping),
+        mappingSize(mappingSize),
+        data(NULL),
+        size(size),
+        ndims(ndims),
+        datatypeSize(datatypeSize),
+        datatype(datatype)
+        {
+            if (mapping != NULL)
+                data = (const uint8_t*) mapping + dataOffset;
+        }
+
+        /**
+         * Destructor.
+         * Unmaps the data.
+         */
+        virtual ~MappedData()
+        {
+            if (mapping != NULL)
+            {
+                munmap(mapping, mappingSize);
+                mapping = NULL;
+            }
+        }
+
+        /**
+         * Returns a pointer to the mapped data.
+         * The pointer has to be casted to the actual data type.
+         *
+         * @return pointer to mapped data, NULL for empty datasets
+         */
+        const void* getData() const
+        {
+            return data;
+        }
+
+        /**
+         * Returns a pointer to a single element.
+         * A DCException is thrown if the index is out of bounds.
+         *
+         * @param index index of the element in every dimension
+         * @return pointer to the element
+         */
+        const void* getElement(const Dimensions index) const throw (DCException)
+        {
+            if (data == NULL)
+                throw DCException("MappedData::getElement: dataset is empty");
+
+            size_t element = 0;
+            size_t pitch = 1;
+            for (uint32_t i = 0; i < ndims; ++i)
+            {
+                if (index[i] >= size[i])
+                    throw DCException("MappedData::getElement: index out of bounds");
+
+                element += index[i] * pitch;
+                pitch *= size[i];
+            }
+
+            return data + element * datatypeSize;
+        }
+
+        /**
+         * Returns the number of data elements in every dimension.
+         *
+         * @return number of data elements
+         */
+        Dimensions getSize() const
+        {
+            return size;
+        }
+
+        /**
+         * Returns the number of dimensions of the dataset.
+         *
+         * @return number of dimensions
+         */
+        uint32_t getNDims() const
+        {
+            return ndims;
+        }
+
+        /**
+         * Returns the size in bytes of the data type.
+         *
+         * @return size of data type in bytes
+         */
+        size_t getTypeSize() const
+        {
+            return datatypeSize;
+        }
+
+        /**
+         * Returns the DCDataType of the mapped data.
+         *
+         * @return the datatype
+         */
+        DCDataType getDataType() const
+        {
+            return datatype;
+        }
+
+    private:
+        // not copyable
+        MappedData(const MappedData &other);
+        MappedData& operator=(const MappedData &other);
+
+        void *mapping;
+        size_t mappingSize;
+        const uint8_t *data;
+        Dimensions size;
+        uint32_t ndims;
+        size_t datatypeSize;
+        DCDataType datatype;
+    };
+
+}
+
+#endif	/* MAPPEDDATA_HPP */
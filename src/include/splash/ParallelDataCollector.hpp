@@ -27,12 +27,14 @@
 #include <string>
 #include <iostream>
 #include <set>
+#include <vector>
 #include <hdf5.h>
 
 #include "splash/IParallelDataCollector.hpp"
 
 #include "splash/DCException.hpp"
 #include "splash/sdc_defines.hpp"
+#include "splash/pdc_defines.hpp"
 #include "splash/core/HandleMgr.hpp"
 
 namespace splash
@@ -75,10 +77,39 @@ namespace splash
 
         static void indexToPos(int index, Dimensions mpiSize, Dimensions &mpiPos);
 
+        /**
+         * Splits a base filename into directory path and filename prefix,
+         * e.g. '/path/to/filename' -> dirPath='/path/to' prefix='filename_'
+         *
+         * @param baseFilename Base filename.
+         * @param dirPath Returns the directory path.
+         * @param prefix Returns the filename prefix including '_'.
+         */
+        static void splitBaseFilename(const std::string baseFilename,
+                std::string &dirPath, std::string &prefix);
+
         static void listFilesInDir(const std::string baseFilename, std::set<int32_t> &ids)
         throw (DCException);
     protected:
 
+        /**
+         * Cached iteration IDs of all files in the output directory.
+         * The cache is invalidated when the modification time of the
+         * directory changes.
+         */
+        typedef struct
+        {
+            // base filename the cache belongs to
+            std::string baseFilename;
+            // iteration IDs of existing files
+            std::set<int32_t> ids;
+            // directory modification time at the last synchronization
+            int64_t mtimeSec;
+            int64_t mtimeNsec;
+            // true if ids are valid for baseFilename
+            bool valid;
+        } FileCatalog;
+
         typedef struct
         {
             // internal MPI structures
@@ -92,8 +123,23 @@ namespace splash
             bool enableCompression;
             // id for maximum accessed iteration
             int32_t maxID;
+            // iteration IDs of files in the output directory
+            FileCatalog catalog;
         } Options;
 
+        /**
+         * Dataset declared for deferred creation.
+         */
+        typedef struct
+        {
+            int32_t id;
+            std::string name;
+            Dimensions globalSize;
+            uint32_t ndims;
+            hid_t datatype;
+            ColTypeStorage *storage;
+        } DeclaredDataSet;
+
         /**
          * internal type to save file access mode
          */
@@ -110,12 +156,29 @@ namespace splash
         // property list for hdf5 file access
         hid_t fileAccProperties;
 
+        // property list for creating files with free space tracking, -1 if not used
+        hid_t fileCreateProperties;
+
         // current file access type
         FileStatusType fileStatus;
 
         // filename passed to PDC
         std::string baseFilename;
 
+        // datasets waiting for creation by createDeclared
+        std::vector<DeclaredDataSet> declaredDataSets;
+
+        // full paths of datasets created by createDeclared
+        std::set<std::string> createdDataSets;
+
+        // statistics on all I/O operations
+        IOStatistics statistics;
+
+        // file to write statistics to on close, empty if disabled
+        std::string statisticsFile;
+
+        void clearDeclared();
+
         static void writeHeader(hid_t fHandle, uint32_t id,
                 bool enableCompression, Dimensions mpiTopology) throw (DCException);
 
@@ -125,6 +188,49 @@ namespace splash
         static void fileOpenCallback(H5Handle handle, uint32_t index,
                 void *userData) throw (DCException);
 
+        /**
+         * Reads the modification time of the catalog directory.
+         *
+         * @param catalog File catalog.
+         * @param mtimeSec Returns seconds of the modification time.
+         * @param mtimeNsec Returns nanoseconds of the modification time.
+         * @return true on success, false if the directory does not exist
+         */
+        static bool getCatalogMTime(const FileCatalog &catalog,
+                int64_t &mtimeSec, int64_t &mtimeNsec);
+
+        /**
+         * Updates the file catalog for the current base filename.
+         * The directory is only scanned if its modification time changed
+         * since the last update.
+         * If collective, only the root process accesses the directory and
+         * broadcasts the result.
+         *
+         * @param collective true if called collectively by all processes
+         */
+        void updateCatalog(bool collective) throw (DCException);
+
+        /**
+         * Enables compression if supported by parallel HDF5.
+         *
+         * @param enableCompression requested compression
+         */
+        void setCompression(bool enableCompression);
+
+        /**
+         * Returns chunk dimensions which are aligned to the local blocks of
+         * all processes, i.e. if all processes write blocks of identical size.
+         * Must be called collectively.
+         *
+         * @param ndims Number of dimensions (1-3).
+         * @param localSize Size of the local block of this process.
+         * @param typeSize Size of the datatype in bytes.
+         * @param chunkDims Returns the aligned chunk dimensions.
+         * @return true if aligned chunk dimensions could be determined
+         */
+        bool getAlignedChunkDims(uint32_t ndims, const Dimensions localSize,
+                size_t typeSize, Dimensions &chunkDims) throw (DCException);
+
         void openCreate(const char *filename,
                 FileCreationAttr &attr) throw (DCException);
 
@@ -142,7 +248,8 @@ namespace splash
                 const Dimensions srcOffset,
                 Dimensions &sizeRead,
                 uint32_t& srcRank,
-                void* dst) throw (DCException);
+                void* dst,
+                const CollectionType* memType = NULL) throw (DCException);
 
         void readDataSet(H5Handle h5File,
                 int32_t id,
@@ -163,7 +270,20 @@ namespace splash
                 uint32_t rank,
                 const Selection srcSelect,
                 const char* name,
-                const void* data) throw (DCException);
+                const void* data,
+                const void* const* components,
+                bool componentWise) throw (DCException);
+
+        void writeData(int32_t id,
+                const Dimensions globalSize,
+                const Dimensions globalOffset,
+                const CollectionType& type,
+                uint32_t rank,
+                const Selection select,
+                const char* name,
+                const void* data,
+                const void* const* components,
+                bool componentWise) throw (DCException);
 
         void gatherMPIWrites(int rank, const Dimensions localSize,
                 Dimensions &globalSize, Dimensions &globalOffset) throw (DCException);
@@ -232,6 +352,22 @@ namespace splash
                 const char* name,
                 const void* buf);
 
+        void writeComponents(int32_t id,
+                const CollectionType& type,
+                uint32_t rank,
+                const Selection select,
+                const char* name,
+                const void* const* components) throw (DCException);
+
+        void writeComponents(int32_t id,
+                const Dimensions globalSize,
+                const Dimensions globalOffset,
+                const CollectionType& type,
+                uint32_t rank,
+                const Selection select,
+                const char* name,
+                const void* const* components) throw (DCException);
+
         void reserve(int32_t id,
                 const Dimensions globalSize,
                 uint32_t rank,
@@ -246,6 +382,14 @@ namespace splash
                 const CollectionType& type,
                 const char* name) throw (DCException);
 
+        void declare(int32_t id,
+                const Dimensions globalSize,
+                uint32_t rank,
+                const CollectionType& type,
+                const char* name) throw (DCException);
+
+        void createDeclared(int32_t id) throw (DCException);
+
         void append(int32_t id,
                 const Dimensions size,
                 uint32_t rank,
@@ -253,6 +397,13 @@ namespace splash
                 const char *name,
                 const void *buf);
 
+        void reserveAndAppend(int32_t id,
+                const CollectionType& type,
+                size_t count,
+                const char *name,
+                const void *buf,
+                Dimensions *globalOffset) throw (DCException);
+
         void remove(int32_t id) throw (DCException);
 
         void remove(int32_t id,
@@ -296,6 +447,22 @@ namespace splash
                 Dimensions &sizeRead,
                 void* buf) throw (DCException);
 
+        void read(int32_t id,
+                const CollectionType& type,
+                const char* name,
+                const Dimensions dstBuffer,
+                const Dimensions dstOffset,
+                Dimensions &sizeRead,
+                void* buf) throw (DCException);
+
+        void readComponents(int32_t id,
+                const CollectionType& type,
+                const char* name,
+                const Dimensions dstBuffer,
+                const Dimensions dstOffset,
+                Dimensions &sizeRead,
+                void* const* components) throw (DCException);
+
         /**
          * Reads data from HDF5 file.
          * If data is to be read (instead of only its size in the file),
@@ -340,6 +507,10 @@ namespace splash
         
         void finalize(void);
 
+        const IOStatistics& getStatistics() const;
+
+        void resetStatistics();
+
     private:
 
         void readGlobalAttribute(const char*,
@@ -24,6 +24,7 @@
 
 #include "splash/domains/IParallelDomainCollector.hpp"
 #include "splash/ParallelDataCollector.hpp"
+#include "splash/core/DCDomainDescriptor.hpp"
 
 namespace splash
 {
@@ -45,6 +46,44 @@ namespace splash
         static std::string getExceptionString(std::string func, std::string msg,
                 const char *info);
 
+        /**
+         * Returns the part of a domain which is read by a process
+         * in \ref ParallelDomainCollector::readDomainDistributed,
+         * a contiguous slab along the slowest dimension.
+         *
+         * @param dataDomain domain of the complete dataset,
+         * for Poly data the domain of its elements
+         * @param ndims number of dimensions of the dataset
+         * @param index index of the slab (process)
+         * @param numSlabs total number of slabs (processes)
+         * @return domain of the slab
+         */
+        static Domain getDistributedSlab(const Domain dataDomain,
+                uint32_t ndims, int index, int numSlabs);
+
+        /**
+         * Returns the part of a slab which must be sent to a process.
+         *
+         * @param slab domain of the slab
+         * @param target domain received by the process, the requested domain
+         * for Grid data or the range of received elements for Poly data
+         * @return part of the slab, size is zero if nothing is sent
+         */
+        static Domain getDistributedPart(const Domain slab, const Domain target);
+
+        /**
+         * Copies a part of a 3D buffer to another 3D buffer.
+         *
+         * @param src source buffer
+         * @param srcDomain domain of the source buffer
+         * @param dst destination buffer
+         * @param dstDomain domain of the destination buffer
+         * @param part domain to copy, contained in source and destination
+         * @param typeSize size of an element in bytes
+         */
+        static void copyDomainData(const char *src, const Domain srcDomain,
+                char *dst, const Domain dstDomain, const Domain part, size_t typeSize);
+
         void writeDomainAttributes(
                 int32_t id,
                 const char *name,
@@ -98,6 +137,11 @@ namespace splash
 
         void readDomainLazy(DomainData *domainData) throw (DCException);
 
+        DataContainer *readDomainDistributed(int32_t id,
+                const char* name,
+                const Domain requestDomain,
+                DomDataClass* dataClass) throw (DCException);
+
         void writeDomain(int32_t id,
                 const CollectionType& type,
                 uint32_t ndims,
@@ -139,6 +183,48 @@ namespace splash
 
     protected:
 
+        /**
+         * Reads the compound domain attribute of a dataset.
+         *
+         * @param id ID of the iteration.
+         * @param name Name of the dataset.
+         * @param descriptor Returns the domain annotation.
+         * @return true if the dataset has a compound domain attribute,
+         * false if it only has the separate legacy attributes
+         */
+        bool readDomainDescriptor(
+                int32_t id,
+                const char *name,
+                DCDomainDescriptor &descriptor) throw (DCException);
+
+        /**
+         * Reads the domain and class annotation of a dataset.
+         *
+         * @param id ID of the iteration.
+         * @param name Name of the dataset.
+         * @param clientDomain Returns the domain of the dataset.
+         * @param dataClass Returns the class of the domain data.
+         */
+        void readClientDomain(
+                int32_t id,
+                const char *name,
+                Domain &clientDomain,
+                DomDataClass &dataClass) throw (DCException);
+
+        /**
+         * Reads datatype information of a dataset.
+         *
+         * @param id ID of the iteration.
+         * @param name Name of the dataset.
+         * @param typeSize Returns the size of the datatype in bytes.
+         * @param dcDataType Returns the datatype.
+         */
+        void readDataTypeInfo(
+                int32_t id,
+                const char *name,
+                size_t &typeSize,
+                DCDataType &dcDataType) throw (DCException);
+
         bool readDomainDataForRank(
                 DataContainer *dataContainer,
                 DomDataClass *dataClass,
@@ -0,0 +1,217 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RECORDINGCOLLECTOR_HPP
+#define	RECORDINGCOLLECTOR_HPP
+
+#include <string>
+#include <fstream>
+#include <sstream>
+
+#include "splash/DataCollector.hpp"
+#include "splash/DCException.hpp"
+
+namespace splash
+{
+
+    /**
+     * Records all calls to a DataCollector to a workload trace,
+     * which can be replayed with synthetic data by splash-replay.
+     *
+     * All calls are forwarded to the wrapped DataCollector.
+     * Each call is written as a line of tab-separated fields:
+     * start time and duration in seconds, "ok" or "error" if the call
+     * threw an exception, the name of the method and its arguments
+     * without data, e.g. sizes, selections and datatypes.
+     * Datatypes are recorded by their class and size, e.g. "f4" or "u8",
+     * other datatypes as "o(size)".
+     *
+     * See \ref DataCollector interface for function documentation.
+     */
+    class RecordingCollector : public DataCollector
+    {
+    public:
+        /**
+         * Constructor
+         *
+         * @param collector DataCollector to record, is not deleted by this object
+         * @param traceFilename file to write the trace to, is overwritten
+         */
+        RecordingCollector(DataCollector *collector,
+                const std::string &traceFilename) throw (DCException);
+
+        /**
+         * Destructor
+         */
+        virtual ~RecordingCollector();
+
+        void open(const char *filename,
+                FileCreationAttr& attr);
+
+        void close();
+
+        int32_t getMaxID();
+
+        void getMPISize(Dimensions& mpiSize);
+
+        void getEntryIDs(int32_t *ids, size_t *count);
+
+        void getEntriesForID(int32_t id, DCEntry *entries, size_t *count);
+
+        void write(int32_t id,
+                const CollectionType& type,
+                uint32_t ndims,
+                const Selection select,
+                const char* name,
+                const void* buf);
+
+        void writeComponents(int32_t id,
+                const CollectionType& type,
+                uint32_t ndims,
+                const Selection select,
+                const char* name,
+                const void* const* components);
+
+        void append(int32_t id,
+                const CollectionType& type,
+                size_t count,
+                const char *name,
+                const void *buf);
+
+        void append(int32_t id,
+                const CollectionType& type,
+                size_t count,
+                size_t offset,
+                size_t stride,
+                const char *name,
+                const void *buf);
+
+        void remove(int32_t id);
+
+        void remove(int32_t id,
+                const char *name);
+
+        void createReference(int32_t srcID,
+                const char *srcName,
+                int32_t dstID,
+                const char *dstName);
+
+        void createReference(int32_t srcID,
+                const char *srcName,
+                int32_t dstID,
+                const char *dstName,
+                Dimensions count,
+                Dimensions offset,
+                Dimensions stride);
+
+        void readGlobalAttribute(
+                const char *name,
+                void* buf,
+                Dimensions *mpiPosition = NULL);
+
+        void writeGlobalAttribute(const CollectionType& type,
+                const char *name,
+                const void* buf);
+
+        void readAttribute(int32_t id,
+                const char *dataName,
+                const char *attrName,
+                void *buf,
+                Dimensions *mpiPosition = NULL);
+
+        void writeAttribute(int32_t id,
+                const CollectionType& type,
+                const char *dataName,
+                const char *attrName,
+                const void *buf);
+
+        void read(int32_t id,
+                const char* name,
+                Dimensions &sizeRead,
+                void* buf);
+
+        void read(int32_t id,
+                const char* name,
+                const Dimensions dstBuffer,
+                const Dimensions dstOffset,
+                Dimensions &sizeRead,
+                void* buf);
+
+        void read(int32_t id,
+                const CollectionType& type,
+                const char* name,
+                const Dimensions dstBuffer,
+                const Dimensions dstOffset,
+                Dimensions &sizeRead,
+                void* buf);
+
+        void readComponents(int32_t id,
+                const CollectionType& type,
+                const char* name,
+                const Dimensions dstBuffer,
+                const Dimensions dstOffset,
+                Dimensions &sizeRead,
+                void* const* components);
+
+        const IOStatistics& getStatistics() const;
+
+        void resetStatistics();
+
+        /**
+         * Returns the code of a datatype in workload traces.
+         *
+         * @param type datatype
+         * @return code, e.g. "f4", "i8" or "o16"
+         */
+        static std::string getTypeCode(const CollectionType& type);
+
+    private:
+        RecordingCollector(const RecordingCollector &other);
+        RecordingCollector& operator=(const RecordingCollector &other);
+
+        /**
+         * A single line of the trace, written on destruction.
+         */
+        class Record
+        {
+        public:
+            Record(RecordingCollector &recorder, const char *method);
+            ~Record();
+
+            Record& operator<<(int64_t value);
+            Record& operator<<(const char *value);
+            Record& operator<<(const Dimensions &value);
+            Record& operator<<(const Selection &value);
+            Record& operator<<(const CollectionType &value);
+        private:
+            RecordingCollector &recorder;
+            double startTime;
+            std::stringstream fields;
+        };
+
+        DataCollector *collector;
+        std::ofstream trace;
+        double traceStart;
+    };
+
+}
+
+#endif	/* RECORDINGCOLLECTOR_HPP */
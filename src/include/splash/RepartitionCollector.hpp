@@ -0,0 +1,217 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPARTITIONCOLLECTOR_HPP
+#define	REPARTITIONCOLLECTOR_HPP
+
+#include <mpi.h>
+#include <vector>
+
+#include "splash/DomainCollector.hpp"
+
+namespace splash
+{
+
+    /**
+     * RepartitionCollector reads files written by a DomainCollector
+     * with an arbitrary MPI topology for a new MPI topology,
+     * e.g. to restart a simulation with a different number of processes.
+     *
+     * The global domain of a dataset is split into one regular box per
+     * process of the new topology. Each process only opens the files
+     * which intersect its box.
+     * Grid data is read for the box, Poly data is re-bucketed by
+     * the positions of its elements.
+     *
+     * Files must be opened with FAT_READ_MERGED and all read methods
+     * must be called by all processes of the communicator.
+     */
+    class RepartitionCollector : public DomainCollector
+    {
+    public:
+        /**
+         * Constructor
+         * @param comm The communicator of the new topology.
+         * @param topology Number of MPI processes in each dimension,
+         * must match the size of \p comm.
+         * @param maxFileHandles Maximum number of concurrently opened file handles (0=unlimited).
+         */
+        RepartitionCollector(MPI_Comm comm, const Dimensions topology,
+                uint32_t maxFileHandles);
+
+        /**
+         * Destructor
+         */
+        virtual ~RepartitionCollector();
+
+        /**
+         * Frees the MPI communicator.
+         * Must be called before MPI_Finalize.
+         */
+        void finalize();
+
+        /**
+         * Opens the files written with any MPI topology.
+         * The topology of the files is read from the file header.
+         *
+         * @param filename Name of the files to open (the common part without index identifiers).
+         * @param attr File access type must be FAT_READ_MERGED.
+         */
+        void open(const char *filename,
+                FileCreationAttr& attr) throw (DCException);
+
+        /**
+         * Returns the MPI topology of the reading processes.
+         *
+         * @return new MPI topology
+         */
+        Dimensions getTopology() const;
+
+        /**
+         * Returns the MPI position of this process in the new topology.
+         *
+         * @return MPI position
+         */
+        Dimensions getPosition() const;
+
+        /**
+         * Returns the part of the global domain of a dataset
+         * which is assigned to this process.
+         *
+         * @param id ID of the iteration.
+         * @param name Name of the dataset.
+         * @return box of this process in global domain coordinates
+         */
+        Domain getRepartitionedDomain(int32_t id,
+                const char* name) throw (DCException);
+
+        /**
+         * Reads the part of a dataset which is assigned to this process.
+         *
+         * For Grid data, the returned container holds one subdomain
+         * with the box of this process, as returned by
+         * \ref RepartitionCollector::getRepartitionedDomain.
+         * The container is empty if the box is empty.
+         *
+         * For Poly data, the returned container holds at most one
+         * subdomain with all elements of this process.
+         * If \p positionNames is set, elements are assigned by their
+         * position, read from one Poly dataset per dimension.
+         * The global position of an element is the sum of its value in
+         * \p positionNames and, if set, in \p positionOffsetNames,
+         * e.g. a cell-relative position and the global cell index,
+         * and must be given in global domain coordinates.
+         * Entries may be NULL for dimensions without positions or offsets.
+         * Boxes are half-open, except for the last box along each dimension
+         * which includes the upper boundary of the global domain.
+         * Only the files whose domain intersects the box of this process
+         * are read, i.e. elements outside of the domain of their file
+         * are not redistributed.
+         * Without \p positionNames, all elements of a file are assigned to the process
+         * whose box contains the offset of the file's domain.
+         * Reading several Poly datasets with the same \p positionNames
+         * returns their elements in the same order.
+         *
+         * @param id ID of the iteration.
+         * @param name Name of the dataset.
+         * @param dataClass Returns the class of the data, can be NULL.
+         * @param positionNames Array with 3 names of position datasets, can be NULL.
+         * @param positionOffsetNames Array with 3 names of datasets added to
+         * the positions, can be NULL.
+         * @return DataContainer with the data of this process, must be deleted by the user.
+         */
+        DataContainer *readRepartitioned(int32_t id,
+                const char* name,
+                DomDataClass* dataClass,
+                const char* const* positionNames = NULL,
+                const char* const* positionOffsetNames = NULL) throw (DCException);
+
+    protected:
+
+        /**
+         * Domain annotation of a single file.
+         */
+        typedef struct
+        {
+            DomDataClass dataClass;
+            Domain clientDomain;
+            Domain globalDomain;
+            Dimensions elements;
+        } FileDomain;
+
+        /**
+         * Reads the domain annotations of all files.
+         * The files are distributed among all processes.
+         *
+         * @param id ID of the iteration.
+         * @param name Name of the dataset.
+         * @param fileDomains Returns one entry per file, indexed by MPI rank of the file.
+         */
+        void readFileDomains(int32_t id,
+                const char* name,
+                std::vector<FileDomain> &fileDomains) throw (DCException);
+
+        /**
+         * Returns the box of a process in the new topology.
+         *
+         * @param globalDomain global domain of the dataset
+         * @param position MPI position of the process
+         * @return box in global domain coordinates
+         */
+        Domain getBox(const Domain globalDomain, const Dimensions position) const;
+
+        void readPolyRepartitioned(DataContainer *dataContainer,
+                int32_t id,
+                const char* name,
+                const std::vector<FileDomain> &fileDomains,
+                const Domain globalDomain,
+                const Domain box,
+                const char* const* positionNames,
+                const char* const* positionOffsetNames) throw (DCException);
+
+        /**
+         * Reads a Poly dataset of a file and adds its values to \p values.
+         *
+         * @param filePosition MPI position of the file
+         * @param id ID of the iteration.
+         * @param name Name of the dataset.
+         * @param fileDomain domain annotation of the file
+         * @param values values to add to, one per element
+         */
+        void readPositionValues(const Dimensions filePosition,
+                int32_t id,
+                const char* name,
+                const FileDomain &fileDomain,
+                std::vector<double> &values) throw (DCException);
+
+        static double getPositionValue(const void *data, DCDataType type,
+                size_t index) throw (DCException);
+
+    private:
+        MPI_Comm mpiComm;
+        int mpiRank;
+        Dimensions newTopology;
+        Dimensions newPosition;
+    };
+
+}
+
+#endif	/* REPARTITIONCOLLECTOR_HPP */
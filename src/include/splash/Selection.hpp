@@ -24,6 +24,8 @@
 
 #include <string>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 #include "Dimensions.hpp"
 
@@ -31,7 +33,12 @@ namespace splash
 {
 
     /**
-     * 1-3D dataset selection, similar to an HDF5 hyperslap.
+     * 1-N-dimensional dataset selection, similar to an HDF5 hyperslap.
+     *
+     * Besides a single regular hyperslab, a selection can consist of a
+     * union of hyperslabs or a list of points in the source buffer.
+     * Such scattered selections are passed to HDF5, which gathers
+     * the selected elements directly from the source buffer.
      */
     class Selection
     {
@@ -46,9 +53,11 @@ namespace splash
         size(size),
         count(size),
         offset(0, 0, 0),
-        stride(1, 1, 1)
+        stride(1, 1, 1),
+        pointRank(0)
         {
-
+            offset.setRank(size.getRank(), 0);
+            stride.setRank(size.getRank(), 1);
         }
 
         /**
@@ -62,9 +71,10 @@ namespace splash
         size(size),
         count(count),
         offset(offset),
-        stride(1, 1, 1)
+        stride(1, 1, 1),
+        pointRank(0)
         {
-
+            stride.setRank(size.getRank(), 1);
         }
 
         /**
@@ -79,9 +89,142 @@ namespace splash
         size(size),
         count(count),
         offset(offset),
-        stride(stride)
+        stride(stride),
+        pointRank(0)
+        {
+
+        }
+
+        /**
+         * A single hyperslab of a scattered selection.
+         */
+        typedef struct
+        {
+            Dimensions count;
+            Dimensions offset;
+            Dimensions stride;
+        } Hyperslab;
+
+        /**
+         * Adds a hyperslab of the source buffer to this selection.
+         * The selection becomes the union of all added hyperslabs,
+         * replacing the regular hyperslab given by \ref offset,
+         * \ref count and \ref stride. Hyperslabs must not overlap.
+         *
+         * Selected elements are written in row-major order of the source buffer.
+         * \ref count is set to the number of selected elements, it can be changed
+         * to any size with the same number of elements.
+         *
+         * @param blockCount size of the hyperslab
+         * @param blockOffset offset of the hyperslab
+         * @param blockStride stride of the hyperslab
+         */
+        void addHyperslab(Dimensions blockCount, Dimensions blockOffset,
+                Dimensions blockStride = Dimensions(1, 1, 1))
         {
+            if (hyperslabs.empty())
+                count.set(0, 1, 1);
+
+            Hyperslab hyperslab;
+            hyperslab.count = blockCount;
+            hyperslab.offset = blockOffset;
+            hyperslab.stride = blockStride;
+            hyperslabs.push_back(hyperslab);
 
+            points.clear();
+            pointRank = 0;
+            count.set(count[0] + blockCount.getScalarSize(), 1, 1);
+        }
+
+        /**
+         * Selects single elements of the source buffer, replacing
+         * any other selection.
+         * Elements are written in the order of \p coords.
+         * \ref count is set to the number of points, it can be changed
+         * to any size with the same number of elements.
+         *
+         * @param coords coordinates of all points, \p rank values per point
+         * @param numPoints number of points
+         * @param rank number of coordinates per point, i.e. the number of
+         * dimensions of the source buffer, e.g. 1 for indices into Poly data
+         */
+        void setPoints(const hsize_t *coords, size_t numPoints, uint32_t rank)
+        {
+            hyperslabs.clear();
+            points.assign(coords, coords + numPoints * rank);
+            pointRank = rank;
+            count.set(numPoints, 1, 1);
+        }
+
+        /**
+         * Selects all elements of the source buffer for which \p mask is set,
+         * replacing any other selection.
+         * The elements are selected as a single list of points in row-major
+         * order of the source buffer, see \ref setPoints. Applying one point
+         * list is much faster than a union of many small hyperslabs.
+         *
+         * @param mask array with one entry per element of \ref size
+         */
+        void setMask(const bool *mask)
+        {
+            hyperslabs.clear();
+            points.clear();
+
+            const uint32_t rank = size.getRank();
+            const size_t elements = size.getScalarSize();
+
+            size_t num_points = 0;
+            for (size_t i = 0; i < elements; ++i)
+                if (mask[i])
+                    ++num_points;
+
+            points.resize(num_points * rank);
+
+            size_t p = 0;
+            for (size_t i = 0; i < elements; ++i)
+            {
+                if (!mask[i])
+                    continue;
+
+                size_t index = i;
+                for (uint32_t d = 0; d < rank; ++d)
+                {
+                    points[p + d] = index % size[d];
+                    index /= size[d];
+                }
+                p += rank;
+            }
+
+            pointRank = rank;
+            count.set(num_points, 1, 1);
+        }
+
+        /**
+         * Returns the number of dimensions of the source buffer.
+         * Scattered selections may select from a source buffer with more
+         * dimensions than the written data, e.g. a mask over a 3D buffer
+         * written as 1D data.
+         *
+         * @param ndims number of dimensions of the written data
+         * @return number of dimensions of the source buffer
+         */
+        uint32_t getSourceRank(uint32_t ndims) const
+        {
+            if (pointRank > 0)
+                return pointRank;
+            if (!hyperslabs.empty())
+                return size.getRank();
+            return ndims;
+        }
+
+        /**
+         * Returns if this selection consists of several hyperslabs or points.
+         *
+         * @return true for scattered selections
+         */
+        bool isScattered() const
+        {
+            return !hyperslabs.empty() || (pointRank > 0);
         }
         
         /**
@@ -91,10 +234,24 @@ namespace splash
          */
         void swapDims(uint32_t ndims)
         {
-            size.swapDims(ndims);
+            // the source buffer of scattered selections may have another rank
+            const uint32_t src_ndims = getSourceRank(ndims);
+
+            size.swapDims(src_ndims);
             count.swapDims(ndims);
-            offset.swapDims(ndims);
+            offset.swapDims(ndims, 0);
             stride.swapDims(ndims);
+
+            for (size_t i = 0; i < hyperslabs.size(); ++i)
+            {
+                hyperslabs[i].count.swapDims(src_ndims);
+                hyperslabs[i].offset.swapDims(src_ndims, 0);
+                hyperslabs[i].stride.swapDims(src_ndims);
+            }
+
+            for (size_t i = 0; i < points.size(); i += pointRank)
+                for (uint32_t d = 0; d < pointRank / 2; ++d)
+                    std::swap(points[i + d], points[i + pointRank - 1 - d]);
         }
         
         /**
@@ -109,7 +266,12 @@ namespace splash
                     "{size=" << size.toString() << 
                     ", count=" << count.toString() <<
                     ", offset=" << offset.toString() <<
-                    ", stride=" << stride.toString() << "}";
+                    ", stride=" << stride.toString();
+            if (!hyperslabs.empty())
+                stream << ", hyperslabs=" << hyperslabs.size();
+            if (pointRank > 0)
+                stream << ", points=" << (points.size() / pointRank);
+            stream << "}";
             return stream.str(); 
         }
 
@@ -117,6 +279,13 @@ namespace splash
         Dimensions count;
         Dimensions offset;
         Dimensions stride;
+
+        /** hyperslabs of a scattered selection, empty for a regular selection */
+        std::vector<Hyperslab> hyperslabs;
+        /** point coordinates of a scattered selection, \ref pointRank values per point */
+        std::vector<hsize_t> points;
+        /** number of coordinates per point, 0 if no points are selected */
+        uint32_t pointRank;
     };
 
 }
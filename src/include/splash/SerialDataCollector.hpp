@@ -30,6 +30,7 @@
 
 #include "splash/DataCollector.hpp"
 #include "splash/DCException.hpp"
+#include "splash/MappedData.hpp"
 #include "splash/core/HandleMgr.hpp"
 #include "splash/sdc_defines.hpp"
 
@@ -79,6 +80,16 @@ namespace splash
          */
         std::string getExceptionString(std::string func, std::string msg, const char *info = NULL);
 
+        /**
+         * Writes the last written iteration to the file header.
+         */
+        void writeMaxID() throw (DCException);
+
+        /**
+         * Sets maxID to the highest iteration in the file.
+         */
+        void updateMaxID() throw (DCException);
+
         static herr_t visitObjCallback(hid_t o_id, const char *name,
                 const H5O_info_t *object_info, void *op_data);
 
@@ -98,6 +109,12 @@ namespace splash
         // property list for HDF5 file access
         hid_t fileAccProperties;
 
+        // property list for in-memory files, -1 if not used
+        hid_t coreAccProperties;
+
+        // property list for creating files with free space tracking, -1 if not used
+        hid_t fileCreateProperties;
+
         // current file access type
         FileStatusType fileStatus;
 
@@ -110,6 +127,21 @@ namespace splash
         // enable data compression
         bool enableCompression;
 
+        // number of threads for direct chunk (de)compression
+        uint32_t compressionThreads;
+
+        // store uncompressed datasets contiguously
+        bool contiguousLayout;
+
+        // store and verify dataset checksums
+        bool checksums;
+
+        // statistics on all I/O operations
+        IOStatistics statistics;
+
+        // file to write statistics to on close, empty if disabled
+        std::string statisticsFile;
+
         void openCreate(const char *filename,
                 FileCreationAttr &attr) throw (DCException);
 
@@ -158,7 +190,8 @@ namespace splash
                 const Dimensions srcOffset,
                 Dimensions &sizeRead,
                 uint32_t& srcDims,
-                void* dst)
+                void* dst,
+                const CollectionType* memType = NULL)
         throw (DCException);
 
         /**
@@ -189,7 +222,8 @@ namespace splash
                 uint32_t ndims,
                 const Selection select,
                 const char* name,
-                const void* data) throw (DCException);
+                const void* data,
+                const void* const* components = NULL) throw (DCException);
 
         /**
          * Basic method for appending data to a 1-dimensional DataSet.
@@ -243,6 +277,13 @@ namespace splash
                 const char* name,
                 const void* data) throw (DCException);
 
+        void writeComponents(int32_t id,
+                const CollectionType& type,
+                uint32_t ndims,
+                const Selection select,
+                const char* name,
+                const void* const* components) throw (DCException);
+
         void append(int32_t id,
                 const CollectionType& type,
                 size_t count,
@@ -262,6 +303,16 @@ namespace splash
         void remove(int32_t id,
                 const char *name) throw (DCException);
 
+        /**
+         * Removes several iterations.
+         * Unlike calling \ref remove for each iteration, the highest
+         * remaining iteration is determined only once.
+         *
+         * @param ids IDs of the iterations to remove.
+         * @param count Number of entries in \p ids.
+         */
+        void removeIDs(const int32_t *ids, size_t count) throw (DCException);
+
         void createReference(int32_t srcID,
                 const char *srcName,
                 int32_t dstID,
@@ -307,6 +358,68 @@ namespace splash
                 const Dimensions dstOffset,
                 Dimensions &sizeRead,
                 void* data) throw (DCException);
+
+        void read(int32_t id,
+                const CollectionType& type,
+                const char* name,
+                const Dimensions dstBuffer,
+                const Dimensions dstOffset,
+                Dimensions &sizeRead,
+                void* data) throw (DCException);
+
+        void readComponents(int32_t id,
+                const CollectionType& type,
+                const char* name,
+                const Dimensions dstBuffer,
+                const Dimensions dstOffset,
+                Dimensions &sizeRead,
+                void* const* components) throw (DCException);
+
+        const IOStatistics& getStatistics() const;
+
+        void resetStatistics();
+
+        /**
+         * Maps the raw data of a dataset read-only into memory,
+         * without reading or copying it.
+         * Pages are loaded on access and cached by the operating system.
+         *
+         * The dataset must be stored uncompressed with contiguous layout
+         * (see \ref DataCollector::FileCreationAttr::contiguousLayout)
+         * and with the native datatype, i.e. without a storage type.
+         * Empty datasets are mapped to a NULL pointer.
+         * The mapping stays valid after the file has been closed,
+         * but must not be used after the dataset has been changed or removed.
+         *
+         * @param id ID for iteration.
+         * @param name Name of the dataset.
+         * @return mapped dataset, must be deleted by the user
+         */
+        MappedData* mapDataset(int32_t id,
+                const char* name) throw (DCException);
+
+        /**
+         * Opens a file image for reading, e.g. as returned by
+         * \ref SerialDataCollector::getFileImage in another process.
+         * The image is copied and can be freed after this call.
+         *
+         * @param image buffer holding the file image.
+         * @param size size of the file image in bytes.
+         */
+        void openImage(const void* image,
+                size_t size) throw (DCException);
+
+        /**
+         * Returns the image of the opened file, i.e. a copy of the complete file
+         * in memory. This is mostly useful for files created with FAT_CREATE_INMEMORY.
+         * The header of a written file is updated before.
+         *
+         * @param buffer buffer for the file image, can be NULL to only return the size.
+         * @param size size of \p buffer in bytes, must be at least the size of the image.
+         * @return size of the file image in bytes
+         */
+        size_t getFileImage(void* buffer,
+                size_t size) throw (DCException);
     };
 
 } // namespace DataCollector
@@ -0,0 +1,133 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACING_HPP
+#define	TRACING_HPP
+
+#include <stdint.h>
+#include <string>
+#include <ostream>
+
+#include "splash/DCException.hpp"
+
+namespace splash
+{
+
+    /**
+     * Records a timeline of the internal operations of libSplash,
+     * e.g. file opens, group and dataset creation, HDF5 transfers and
+     * MPI collectives.
+     *
+     * Tracing is disabled by default and can be enabled with \ref Tracing::enable
+     * or the environment variable SPLASH_TRACE=(filename).
+     * Events are buffered per process and appended to (filename)_(rank).json
+     * in the Chrome trace event format by \ref Tracing::flush, which is
+     * called by DataCollector::close.
+     * The files can be viewed with chrome://tracing or Perfetto and
+     * merged with the traces of an application.
+     */
+    class Tracing
+    {
+    public:
+
+        /**
+         * Records an event from construction to destruction
+         * if tracing is enabled.
+         */
+        class Scope
+        {
+        public:
+            /**
+             * Constructor
+             *
+             * @param category category of the event, must be a string literal
+             * @param name name of the event, must be a string literal
+             * @param detail further information, e.g. a dataset name, can be NULL
+             */
+            Scope(const char *category, const char *name, const char *detail = NULL);
+            ~Scope();
+        private:
+            Scope(const Scope &other);
+            Scope& operator=(const Scope &other);
+
+            const char *category;
+            const char *name;
+            const char *detail;
+            double startTime;
+        };
+
+        /**
+         * Enables tracing.
+         *
+         * @param filename common part of the trace filenames
+         */
+        static void enable(const std::string &filename);
+
+        /**
+         * Disables tracing and discards buffered events.
+         */
+        static void disable();
+
+        /**
+         * Returns if tracing is enabled.
+         *
+         * @return true if enabled
+         */
+        static bool isEnabled();
+
+        /**
+         * Sets the process ID of the events, usually the MPI rank.
+         *
+         * @param pid process ID
+         */
+        static void setProcessID(int pid);
+
+        /**
+         * Returns the number of buffered events.
+         *
+         * @return number of events
+         */
+        static size_t getNumEvents();
+
+        /**
+         * Writes the buffered events as JSON array in the Chrome trace event format.
+         *
+         * @param out stream to write to
+         */
+        static void writeChromeTrace(std::ostream &out);
+
+        /**
+         * Appends the buffered events to the trace file of this process
+         * and clears the buffer.
+         * The trace file is created by the first call after \ref Tracing::enable
+         * and contains the same JSON array as written by \ref Tracing::writeChromeTrace,
+         * which is terminated after every call.
+         */
+        static void flush() throw (DCException);
+
+    private:
+        static void record(const char *category, const char *name,
+                const char *detail, double startTime, double endTime);
+    };
+
+}
+
+#endif	/* TRACING_HPP */
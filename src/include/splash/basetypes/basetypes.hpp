@@ -25,6 +25,7 @@
 #include "splash/basetypes/basetypes_array.hpp"
 #include "splash/basetypes/basetypes_atomic.hpp"
 #include "splash/basetypes/basetypes_compound.hpp"
+#include "splash/basetypes/basetypes_storage.hpp"
 
 #include "splash/basetypes/ColTypeBool.hpp"
 #include "splash/basetypes/ColTypeDim.hpp"
@@ -0,0 +1,296 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef BASETYPES_STORAGE_HPP
+#define	BASETYPES_STORAGE_HPP
+
+#include <stdint.h>
+#include <hdf5.h>
+
+#include "splash/CollectionType.hpp"
+#include "splash/DCException.hpp"
+#include "splash/core/DCDataType.hpp"
+
+namespace splash
+{
+
+    /**
+     * Formats for storing floating point data with a different
+     * datatype than in memory.
+     */
+    enum DCStorageFormat
+    {
+        DCSF_NATIVE = 0, /* stored with its memory datatype */
+        DCSF_FLOAT16, /* IEEE 754 half precision */
+        DCSF_BFLOAT16, /* bfloat16 (truncated single precision) */
+        DCSF_FIXED_POINT, /* signed integer scaled by a constant factor */
+        DCSF_CUSTOM_FLOAT /* floating point with custom exponent and mantissa size */
+    };
+
+    /**
+     * Base class for datatypes which store floating point data
+     * (float or double in memory) with a different datatype in the file.
+     *
+     * Data is converted to the storage datatype when writing datasets
+     * and converted back to the memory datatype when reading them.
+     * getDataType() and getSize() describe the memory datatype,
+     * attributes are always written with the memory datatype.
+     */
+    class ColTypeStorage : public CollectionType
+    {
+    public:
+
+        /**
+         * Copy constructor, copies the storage datatype.
+         *
+         * @param other storage type to copy
+         */
+        ColTypeStorage(const ColTypeStorage &other) :
+        CollectionType(other),
+        format(other.format),
+        memType(other.memType),
+        storageType(H5Tcopy(other.storageType)),
+        scale(other.scale)
+        {
+        }
+
+        /**
+         * Assignment operator, copies the storage datatype.
+         *
+         * @param other storage type to copy
+         * @return this storage type
+         */
+        ColTypeStorage& operator=(const ColTypeStorage &other)
+        {
+            if (this != &other)
+            {
+                H5Tclose(storageType);
+                type = other.type;
+                format = other.format;
+                memType = other.memType;
+                storageType = H5Tcopy(other.storageType);
+                scale = other.scale;
+            }
+            return *this;
+        }
+
+        virtual ~ColTypeStorage()
+        {
+            H5Tclose(storageType);
+        }
+
+        size_t getSize() const
+        {
+            return (memType == DCDT_FLOAT64) ? sizeof (double) : sizeof (float);
+        }
+
+        const ColTypeStorage* getStorage() const
+        {
+            return this;
+        }
+
+        /**
+         * Returns the datatype used in the file.
+         *
+         * @return storage datatype
+         */
+        const H5DataType& getStorageType() const
+        {
+            return storageType;
+        }
+
+        /**
+         * Returns the size in bytes of the storage datatype.
+         *
+         * @return size of storage datatype in bytes
+         */
+        size_t getStorageSize() const
+        {
+            return H5Tget_size(storageType);
+        }
+
+        /**
+         * Returns the storage format.
+         *
+         * @return storage format
+         */
+        DCStorageFormat getFormat() const
+        {
+            return format;
+        }
+
+        /**
+         * Returns the memory datatype, DCDT_FLOAT32 or DCDT_FLOAT64.
+         *
+         * @return memory datatype
+         */
+        DCDataType getMemoryType() const
+        {
+            return memType;
+        }
+
+        /**
+         * Returns the factor to multiply stored values with,
+         * only used for DCSF_FIXED_POINT.
+         *
+         * @return scaling factor
+         */
+        double getScale() const
+        {
+            return scale;
+        }
+
+        /**
+         * Creates a floating point datatype with custom precision.
+         *
+         * @param exponentBits number of bits of the exponent (2-11)
+         * @param mantissaBits number of bits of the mantissa (1-52)
+         * @return new datatype, must be closed by the caller
+         */
+        static H5DataType createFloatType(uint32_t exponentBits, uint32_t mantissaBits)
+        throw (DCException)
+        {
+            if (exponentBits < 2 || exponentBits > 11 || mantissaBits < 1 || mantissaBits > 52)
+                throw DCException("ColTypeStorage::createFloatType: Invalid number of bits");
+
+            const size_t precision = 1 + exponentBits + mantissaBits;
+
+            hid_t float_type = H5Tcopy(H5T_IEEE_F64LE);
+            if (float_type < 0 ||
+                    H5Tset_fields(float_type, precision - 1, mantissaBits, exponentBits,
+                    0, mantissaBits) < 0 ||
+                    H5Tset_precision(float_type, precision) < 0 ||
+                    H5Tset_size(float_type, (precision + 7) / 8) < 0 ||
+                    H5Tset_ebias(float_type, (1 << (exponentBits - 1)) - 1) < 0)
+                throw DCException("ColTypeStorage::createFloatType: Failed to create datatype");
+
+            return float_type;
+        }
+
+    protected:
+
+        ColTypeStorage(DCStorageFormat format, DCDataType memType,
+                H5DataType storageType, double scale = 1.0) throw (DCException) :
+        format(format),
+        memType(memType),
+        storageType(storageType),
+        scale(scale)
+        {
+            if (memType == DCDT_FLOAT32)
+                type = H5T_NATIVE_FLOAT;
+            else if (memType == DCDT_FLOAT64)
+                type = H5T_NATIVE_DOUBLE;
+            else
+            {
+                H5Tclose(storageType);
+                throw DCException("ColTypeStorage: Memory type must be DCDT_FLOAT32 or DCDT_FLOAT64");
+            }
+        }
+
+        DCStorageFormat format;
+        DCDataType memType;
+        H5DataType storageType;
+        double scale;
+    };
+
+    /**
+     * Stores float or double data as IEEE 754 half precision (16 bit).
+     */
+    class ColTypeFloat16 : public ColTypeStorage
+    {
+    public:
+
+        ColTypeFloat16(DCDataType memType = DCDT_FLOAT32) :
+        ColTypeStorage(DCSF_FLOAT16, memType, createFloatType(5, 10))
+        {
+        }
+    };
+
+    /**
+     * Stores float or double data as bfloat16, i.e. with the exponent
+     * of single precision and a 7 bit mantissa.
+     */
+    class ColTypeBFloat16 : public ColTypeStorage
+    {
+    public:
+
+        ColTypeBFloat16(DCDataType memType = DCDT_FLOAT32) :
+        ColTypeStorage(DCSF_BFLOAT16, memType, createFloatType(8, 7))
+        {
+        }
+    };
+
+    /**
+     * Stores float or double data as signed integers with 8, 16 or 32 bit.
+     * A value x is stored as round(x / scale), clamped to the
+     * range of the integer type. NaN is stored as 0.
+     */
+    class ColTypeFixedPoint : public ColTypeStorage
+    {
+    public:
+
+        ColTypeFixedPoint(double scale, uint32_t bits = 16,
+                DCDataType memType = DCDT_FLOAT32) :
+        ColTypeStorage(DCSF_FIXED_POINT, memType, createIntType(bits), scale)
+        {
+            if (scale <= 0.0)
+                throw DCException("ColTypeFixedPoint: Scale must be positive");
+        }
+
+    private:
+
+        static H5DataType createIntType(uint32_t bits) throw (DCException)
+        {
+            switch (bits)
+            {
+                case 8:
+                    return H5Tcopy(H5T_STD_I8LE);
+                case 16:
+                    return H5Tcopy(H5T_STD_I16LE);
+                case 32:
+                    return H5Tcopy(H5T_STD_I32LE);
+                default:
+                    throw DCException("ColTypeFixedPoint: Number of bits must be 8, 16 or 32");
+            }
+        }
+    };
+
+    /**
+     * Stores float or double data as floating point with a custom
+     * number of exponent and mantissa bits, e.g. 24 bit floats.
+     * Conversion is done by HDF5.
+     */
+    class ColTypeCustomFloat : public ColTypeStorage
+    {
+    public:
+
+        ColTypeCustomFloat(uint32_t exponentBits, uint32_t mantissaBits,
+                DCDataType memType = DCDT_FLOAT32) :
+        ColTypeStorage(DCSF_CUSTOM_FLOAT, memType,
+                createFloatType(exponentBits, mantissaBits))
+        {
+        }
+    };
+
+}
+
+#endif	/* BASETYPES_STORAGE_HPP */
@@ -0,0 +1,120 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash. 
+ * 
+ * libSplash is free software: you can redistribute it and/or modify 
+ * it under the terms of of either the GNU General Public License or 
+ * the GNU Lesser General Public License as published by 
+ * the Free Software Foundation, either version 3 of the License, or 
+ * (at your option) any later version. 
+ * libSplash is distributed in the hope that it will be useful, 
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU General Public License and the GNU Lesser General Public License 
+ * for more details. 
+ * 
+ * You should have received a copy of the GNU General Public License 
+ * and the GNU Lesser General Public License along with libSplash. 
+ * If not, see <http://www.gnu.org/licenses/>. 
+ */
+
+#ifndef DCCHUNKIO_HPP
+#define	DCCHUNKIO_HPP
+
+#include <stdint.h>
+#include <string>
+#include <hdf5.h>
+
+#include "splash/DCException.hpp"
+
+// H5Dwrite_chunk and H5Dread_chunk are available since HDF5 1.10.3
+#if H5_VERSION_GE(1, 10, 3)
+#define DC_DIRECT_CHUNK_IO 1
+#else
+#define DC_DIRECT_CHUNK_IO 0
+#endif
+
+namespace splash
+{
+
+    /**
+     * Reads and writes compressed chunks directly, bypassing the
+     * HDF5 filter pipeline.
+     * Chunks are (de)compressed by multiple threads, the resulting
+     * chunks are identical to those of the HDF5 shuffle and deflate filters.
+     *
+     * All sizes and offsets are physical, i.e. in HDF5 dimension order.
+     * \cond HIDDEN_SYMBOLS
+     */
+    class DCChunkIO
+    {
+    public:
+
+        /**
+         * Writes a dense buffer as compressed chunks.
+         * The dataset must use exactly the shuffle and deflate filters and
+         * the written region must consist of whole chunks, except at the
+         * end of the dataset.
+         *
+         * @param dataset the dataset to write to
+         * @param dxpl data transfer property list
+         * @param ndims number of dimensions
+         * @param dstOffset offset in the dataset to write to
+         * @param count size of the dense source buffer
+         * @param data source buffer
+         * @param numThreads number of compression threads
+         * @return true if data has been written, false if the direct
+         * path cannot be used for this dataset or region
+         */
+        static bool writeChunks(hid_t dataset, hid_t dxpl, uint32_t ndims,
+                const hsize_t *dstOffset, const hsize_t *count,
+                const void *data, uint32_t numThreads) throw (DCException);
+
+        /**
+         * Reads compressed chunks into a buffer.
+         * The dataset must use exactly the shuffle and deflate filters and
+         * the read region must consist of whole chunks, except at the
+         * end of the dataset.
+         * Chunks which have not been allocated yet are read as the
+         * fill value of the dataset, as with H5Dread.
+         *
+         * @param dataset the dataset to read from
+         * @param dxpl data transfer property list
+         * @param ndims number of dimensions
+         * @param srcOffset offset in the dataset to read from
+         * @param srcSize size of the region to read
+         * @param dstBuffer size of the destination buffer
+         * @param dstOffset offset in the destination buffer
+         * @param dst destination buffer
+         * @param numThreads number of decompression threads
+         * @return true if data has been read, false if the direct
+         * path cannot be used for this dataset or region
+         */
+        static bool readChunks(hid_t dataset, hid_t dxpl, uint32_t ndims,
+                const hsize_t *srcOffset, const hsize_t *srcSize,
+                const hsize_t *dstBuffer, const hsize_t *dstOffset,
+                void *dst, uint32_t numThreads) throw (DCException);
+
+        /**
+         * Runs a function for all jobs in [0, numJobs) using a pool of threads.
+         *
+         * @param numThreads number of threads
+         * @param numJobs number of jobs
+         * @param func function to run for each job, returns false on error
+         * @param userData user data passed to func
+         * @return true if func succeeded for all jobs
+         */
+        static bool runParallel(uint32_t numThreads, size_t numJobs,
+                bool (*func)(size_t job, void *userData), void *userData);
+
+    private:
+        static std::string getExceptionString(std::string msg);
+    };
+    /**
+     * \endcond
+     */
+
+}
+
+#endif	/* DCCHUNKIO_HPP */
@@ -0,0 +1,109 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DCCONVERSION_HPP
+#define	DCCONVERSION_HPP
+
+#include <stdint.h>
+#include <hdf5.h>
+
+namespace splash
+{
+
+    /**
+     * Converts dense buffers between datatypes without the HDF5
+     * conversion path.
+     *
+     * Supported are integer and IEEE floating point types of any
+     * byte order (converted to native byte order) as well as compound
+     * and array types of those. Integer overflows are clamped
+     * as done by HDF5.
+     * Compound and array types can be converted member-wise to another
+     * compound (members are matched by name) or array type with the same
+     * number of elements, or to an atomic type. In the latter case,
+     * each member is written to a separate plane (structure of arrays).
+     * \cond HIDDEN_SYMBOLS
+     */
+    class DCConversion
+    {
+    public:
+        /**
+         * Tests if a conversion is supported.
+         *
+         * @param srcType source datatype
+         * @param dstType destination datatype, must have native byte order
+         * @param planes returns the number of destination planes,
+         * i.e. the number of source members if dstType is atomic, 1 otherwise
+         * @return true if the conversion is supported
+         */
+        static bool isSupported(hid_t srcType, hid_t dstType, uint32_t &planes);
+
+        /**
+         * Converts a dense buffer.
+         * The conversion must be supported, see \ref isSupported.
+         *
+         * @param srcType source datatype
+         * @param src source buffer
+         * @param dstType destination datatype
+         * @param dst destination buffer, holds count elements per plane,
+         * planes are stored one after another
+         * @param count number of elements
+         */
+        static void convert(hid_t srcType, const void *src,
+                hid_t dstType, void *dst, size_t count);
+
+        /**
+         * Returns the number of members of a compound or array type
+         * which can be interleaved from separate buffers.
+         *
+         * @param type compound or array datatype
+         * @param components returns the number of members
+         * @return true if \ref interleave supports the type
+         */
+        static bool getComponents(hid_t type, uint32_t &components);
+
+        /**
+         * Interleaves a selection of separate buffers per member into a
+         * dense buffer of a compound or array type (structure of arrays
+         * to array of structures).
+         * All sizes and offsets are physical.
+         *
+         * @param type compound or array datatype, see \ref getComponents
+         * @param components one buffer per member, holding the member's datatype
+         * @param ndims number of dimensions
+         * @param size size of each component buffer
+         * @param offset offset of the selection in each component buffer
+         * @param stride stride of the selection
+         * @param count size of the selection
+         * @param dst dense destination buffer
+         */
+        static void interleave(hid_t type, const void* const* components,
+                uint32_t ndims, const hsize_t *size, const hsize_t *offset,
+                const hsize_t *stride, const hsize_t *count, void *dst);
+    };
+    /**
+     * \endcond
+     */
+
+}
+
+#endif	/* DCCONVERSION_HPP */
@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <vector>
 #include <hdf5.h>
 
 #include "splash/DCException.hpp"
@@ -33,23 +34,11 @@
 #include "splash/Selection.hpp"
 #include "splash/CollectionType.hpp"
 #include "splash/basetypes/ColTypeDim.hpp"
+#include "splash/core/DCDataType.hpp"
+#include "splash/core/DCStorage.hpp"
 
 namespace splash
 {
-    /**
-     * Possible data types.
-     */
-    enum DCDataType
-    {
-        DCDT_UNKNOWN,
-        DCDT_FLOAT32,
-        DCDT_FLOAT64,
-        DCDT_INT32,
-        DCDT_INT64,
-        DCDT_UINT32,
-        DCDT_UINT64
-    };
-
     /**
      * \cond HIDDEN_SYMBOLS
      */
@@ -94,6 +83,50 @@ namespace splash
         void create(const CollectionType& colType, hid_t group, const Dimensions size,
                 uint32_t ndims, bool compression, bool extensible) throw (DCException);
 
+        /**
+         * Sets the chunk size to be used by subsequent calls to create.
+         * A chunk size of zero lets the chunk size be selected automatically.
+         *
+         * @param chunkDims logical chunk size
+         */
+        void setChunkDims(const Dimensions chunkDims);
+
+        /**
+         * Enables (de)compressing chunks directly using multiple threads
+         * instead of the HDF5 filter pipeline, where possible.
+         *
+         * @param numThreads number of threads, 0 disables direct chunk access
+         */
+        void setDirectChunkIO(uint32_t numThreads);
+
+        /**
+         * Stores subsequently created datasets with contiguous layout
+         * if they are neither compressed nor extensible.
+         *
+         * @param contiguous enable contiguous layout
+         */
+        void setContiguous(bool contiguous);
+
+        /**
+         * Sets the datatype of the memory buffer for reading.
+         * Data is converted from the dataset's datatype by libSplash
+         * where possible, otherwise by HDF5.
+         *
+         * @param memType HDF5 memory datatype, -1 to read with the dataset's datatype
+         */
+        void setMemoryType(hid_t memType);
+
+        /**
+         * Stores a checksum (\ref SDC_ATTR_CHECKSUM) with data written
+         * to the complete dataset at once or appended to it, and verifies
+         * the checksum when the complete dataset is read.
+         * Checksums are computed with the threads of \ref setDirectChunkIO.
+         * Partial writes remove the checksum of a dataset in any case.
+         *
+         * @param checksums enable checksums
+         */
+        void setChecksums(bool checksums);
+
         /**
          * Create an object reference
          * @param refGroup handle to group for reference
@@ -126,6 +159,30 @@ namespace splash
          */
         void write(Selection srcSelect, Dimensions dstOffset, const void* data) throw (DCException);
 
+        /**
+         * Writes data from separate buffers per member of the compound or
+         * array datatype of this dataset (structure of arrays).
+         * Members are interleaved and written in slabs of the slowest
+         * dimension, so no interleaved copy of all data is required.
+         *
+         * @param srcSelect selection in each component buffer
+         * @param dstOffset offset in dataset for writing
+         * @param components one buffer per member, holding the member's datatype
+         * @param numSlabs number of slab writes, 0 for as many as required,
+         * see \ref getComponentSlabs. Additional writes are empty,
+         * e.g. to take part in collective writes.
+         */
+        void writeComponents(Selection srcSelect, Dimensions dstOffset,
+                const void* const* components, size_t numSlabs = 0) throw (DCException);
+
+        /**
+         * Returns the number of slab writes of \ref writeComponents.
+         *
+         * @param count size of the written data
+         * @return number of slabs
+         */
+        size_t getComponentSlabs(const Dimensions count) throw (DCException);
+
         /**
          * Reads data from an open dataset.
          *
@@ -160,6 +217,27 @@ namespace splash
                 uint32_t& srcNDims,
                 void* dst) throw (DCException);
 
+        /**
+         * Reads data from an open dataset into separate buffers per member
+         * (structure of arrays). The memory datatype must be set to an
+         * atomic type, see \ref setMemoryType.
+         *
+         * @param dstBuffer size of each component buffer
+         * @param dstOffset offset in component buffers to read to
+         * @param srcSize the size of the requested buffer
+         * @param srcOffset offset in source buffer to read from
+         * @param sizeRead returns the size of the read dataset
+         * @param srcNDims returns the dimensions of the read dataset
+         * @param components one buffer per member of the dataset's datatype, can be NULL
+         */
+        void readComponents(Dimensions dstBuffer,
+                Dimensions dstOffset,
+                Dimensions srcSize,
+                Dimensions srcOffset,
+                Dimensions& sizeRead,
+                uint32_t& srcNDims,
+                void* const* components) throw (DCException);
+
         /**
          * Appends data to an open 1-dimensional dataset.
          *
@@ -175,6 +253,13 @@ namespace splash
                 size_t stride,
                 const void* data) throw (DCException);
 
+        /**
+         * Changes the size of an open extensible dataset.
+         *
+         * @param size new logical size of the dataset
+         */
+        void setExtent(const Dimensions size) throw (DCException);
+
         /**
          * Returns the number of dimensions of the dataset.
          *
@@ -208,12 +293,33 @@ namespace splash
         DCDataType getDCDataType() throw (DCException);
 
 
+        /**
+         * Returns if data of a CollectionType is stored with the datatype
+         * of this dataset, i.e. its memory or storage datatype equals
+         * the file datatype.
+         * A DCException is thrown if the dataset has not been opened/created.
+         *
+         * @param colType type information of the data
+         * @return true if the datatypes are equal
+         */
+        bool isDataType(const CollectionType& colType) throw (DCException);
+
         /**
          * Returns the size of the underlying HDF5 datatype
          * @return size of HDF5 datatype
          */
         size_t getDataTypeSize() throw (DCException);
 
+        /**
+         * Returns the offset of the raw data in the file.
+         * A DCException is thrown if the dataset is not stored contiguous,
+         * has no allocated storage or its file datatype differs from the
+         * native datatype, i.e. if its raw data cannot be accessed in place.
+         *
+         * @return offset in bytes from the beginning of the file
+         */
+        haddr_t getRawDataOffset() throw (DCException);
+
         /**
          * Returns the name of the dataset.
          * 
@@ -233,11 +339,83 @@ namespace splash
         Dimensions& getLogicalSize();
         Dimensions getPhysicalSize();
 
+        /**
+         * Returns the number of bytes selected in the file dataspace.
+         */
+        uint64_t getSelectedBytes();
+
+        /**
+         * Reads data stored with a different datatype or into a different
+         * memory datatype and converts it. All sizes and offsets are physical.
+         *
+         * Planes of the converted data are read to consecutive planes
+         * of \p dst or to separate buffers \p dstPlanes.
+         *
+         * @return false if the conversion is not supported by libSplash
+         * and data is stored with its memory datatype
+         */
+        bool readConverted(const Dimensions dstBuffer,
+                const Dimensions dstOffset,
+                const Dimensions srcSize,
+                const Dimensions srcOffset,
+                void* dst,
+                void* const* dstPlanes = NULL) throw (DCException);
+
+        /**
+         * Returns the number of rows in the slowest dimension of
+         * each slab of \ref writeComponents.
+         */
+        size_t getComponentSlabRows(const Dimensions physicalCount);
+
+        /**
+         * Creates the dataspace of a source buffer with the selection
+         * applied. The selection is physical.
+         */
+        hid_t createSourceSpace(const Selection &srcSelect) throw (DCException);
+
+        /**
+         * Gathers the selected source data and converts it to the
+         * storage datatype. The selection is physical.
+         */
+        void convertForWrite(const Selection srcSelect, const void* data,
+                std::vector<char> &converted) throw (DCException);
+
+        /**
+         * Returns the checksum of the selected elements of a buffer
+         * with the dataset's datatype, continuing from checksum \p initial,
+         * see \ref DCVerifier::updateChecksum.
+         */
+        uint32_t getChecksum(hid_t space, const void* data, uint32_t initial)
+        throw (DCException);
+
+        /**
+         * Returns true if the region \p size at \p offset (physical)
+         * is the complete dataset.
+         */
+        bool isComplete(const Dimensions size, const Dimensions offset);
+
+        /**
+         * Stores \p value as checksum of the dataset if checksums are enabled
+         * and \p valid is set, otherwise removes a stored checksum.
+         */
+        void setChecksumAttribute(bool valid, uint32_t value) throw (DCException);
+
+        /**
+         * Compares the stored checksum to the checksum of data read from the
+         * region \p srcSize at \p srcOffset into a buffer of size \p dstBuffer
+         * at \p dstOffset, if the region is the complete dataset.
+         * All sizes and offsets are physical.
+         */
+        void verifyChecksum(const Dimensions srcSize, const Dimensions srcOffset,
+                const Dimensions dstBuffer, const Dimensions dstOffset,
+                const void* data) throw (DCException);
+
         hid_t dataset;
         hid_t datatype;
         hid_t dataspace;
         hdset_reg_ref_t regionRef;
         Dimensions logicalSize;
+        Dimensions chunkDims;
         size_t ndims;
         std::string name;
         bool opened;
@@ -246,10 +424,18 @@ namespace splash
 
         // property lists
         hid_t dsetProperties;
+        hid_t dsetAccProperties;
         hid_t dsetWriteProperties;
         hid_t dsetReadProperties;
 
         bool compression;
+        bool contiguous;
+        uint32_t directChunkThreads;
+        DCStorage storage;
+        hid_t memType;
+        bool checksums;
+        bool hasChecksum;
+        uint32_t checksum;
     private:
         std::string getExceptionString(std::string msg);
 
@@ -0,0 +1,43 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DCDATATYPE_HPP
+#define	DCDATATYPE_HPP
+
+namespace splash
+{
+    /**
+     * Possible data types.
+     */
+    enum DCDataType
+    {
+        DCDT_UNKNOWN,
+        DCDT_FLOAT32,
+        DCDT_FLOAT64,
+        DCDT_INT32,
+        DCDT_INT64,
+        DCDT_UINT32,
+        DCDT_UINT64
+    };
+}
+
+#endif	/* DCDATATYPE_HPP */
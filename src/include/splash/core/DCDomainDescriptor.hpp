@@ -0,0 +1,204 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash. 
+ * 
+ * libSplash is free software: you can redistribute it and/or modify 
+ * it under the terms of of either the GNU General Public License or 
+ * the GNU Lesser General Public License as published by 
+ * the Free Software Foundation, either version 3 of the License, or 
+ * (at your option) any later version. 
+ * libSplash is distributed in the hope that it will be useful, 
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ * GNU General Public License and the GNU Lesser General Public License 
+ * for more details. 
+ * 
+ * You should have received a copy of the GNU General Public License 
+ * and the GNU Lesser General Public License along with libSplash. 
+ * If not, see <http://www.gnu.org/licenses/>. 
+ */
+
+#ifndef DCDOMAINDESCRIPTOR_HPP
+#define	DCDOMAINDESCRIPTOR_HPP
+
+#include <algorithm>
+#include <stdint.h>
+#include <hdf5.h>
+
+#include "splash/CollectionType.hpp"
+#include "splash/DCException.hpp"
+#include "splash/domains/IDomainCollector.hpp"
+#include "splash/domains/Domain.hpp"
+#include "splash/core/ScopedID.hpp"
+
+namespace splash
+{
+
+    /**
+     * Domain annotation of a dataset (class, local and global domain)
+     * which is stored as a single compound attribute \ref DOMCOL_ATTR_DOMAIN.
+     * Domains are stored with \ref DSP_DIM_MAX elements and their rank.
+     * Files of format version 2.2 store 3 elements without a rank.
+     * The descriptor is its own CollectionType.
+     * \cond HIDDEN_SYMBOLS
+     */
+    class DCDomainDescriptor : public CollectionType
+    {
+    public:
+
+        DCDomainDescriptor()
+        {
+            const hsize_t dim[] = {DSP_DIM_MAX};
+            hid_t dim_t = H5Tarray_create(H5T_NATIVE_HSIZE, 1, dim);
+
+            this->type = H5Tcreate(H5T_COMPOUND, sizeof (Descriptor));
+            H5Tinsert(this->type, "class", HOFFSET(Descriptor, dataClass), H5T_NATIVE_INT32);
+            H5Tinsert(this->type, "rank", HOFFSET(Descriptor, rank), H5T_NATIVE_UINT32);
+            H5Tinsert(this->type, "size", HOFFSET(Descriptor, size), dim_t);
+            H5Tinsert(this->type, "start", HOFFSET(Descriptor, offset), dim_t);
+            H5Tinsert(this->type, "global_size", HOFFSET(Descriptor, globalSize), dim_t);
+            H5Tinsert(this->type, "global_start", HOFFSET(Descriptor, globalOffset), dim_t);
+
+            H5Tclose(dim_t);
+
+            set(IDomainCollector::UndefinedType, Domain(), Domain());
+        }
+
+        ~DCDomainDescriptor()
+        {
+            H5Tclose(this->type);
+        }
+
+        size_t getSize() const
+        {
+            return sizeof (Descriptor);
+        }
+
+        /**
+         * Sets the annotation.
+         *
+         * @param dataClass class of the domain data
+         * @param localDomain local domain of the dataset
+         * @param globalDomain global domain of the dataset
+         */
+        void set(IDomainCollector::DomDataClass dataClass,
+                const Domain localDomain, const Domain globalDomain)
+        {
+            descriptor.dataClass = dataClass;
+            descriptor.rank = std::max(localDomain.getSize().getRank(),
+                    globalDomain.getSize().getRank());
+            for (uint32_t i = 0; i < DSP_DIM_MAX; ++i)
+            {
+                descriptor.size[i] = localDomain.getSize()[i];
+                descriptor.offset[i] = localDomain.getOffset()[i];
+                descriptor.globalSize[i] = globalDomain.getSize()[i];
+                descriptor.globalOffset[i] = globalDomain.getOffset()[i];
+            }
+        }
+
+        IDomainCollector::DomDataClass getDataClass() const
+        {
+            return (IDomainCollector::DomDataClass) descriptor.dataClass;
+        }
+
+        Domain getLocalDomain() const
+        {
+            return Domain(Dimensions(descriptor.rank, descriptor.offset),
+                    Dimensions(descriptor.rank, descriptor.size));
+        }
+
+        Domain getGlobalDomain() const
+        {
+            return Domain(Dimensions(descriptor.rank, descriptor.globalOffset),
+                    Dimensions(descriptor.rank, descriptor.globalSize));
+        }
+
+        /**
+         * Returns the buffer for writing the attribute.
+         *
+         * @return pointer to the descriptor data
+         */
+        void *getBuffer()
+        {
+            return &descriptor;
+        }
+
+        /**
+         * Reads the annotation from the \ref DOMCOL_ATTR_DOMAIN attribute
+         * of a dataset, in the current or the 3-dimensional layout.
+         *
+         * @param dataset dataset to read from
+         * @return false if the dataset has no such attribute
+         */
+        bool readAttribute(hid_t dataset) throw (DCException)
+        {
+            if (H5Aexists(dataset, DOMCOL_ATTR_DOMAIN) <= 0)
+                return false;
+
+            ScopedID attr(H5Aopen(dataset, DOMCOL_ATTR_DOMAIN, H5P_DEFAULT));
+            ScopedID file_type((attr < 0) ? -1 : H5Aget_type(attr));
+            if (attr < 0 || file_type < 0 || H5Tget_class(file_type) != H5T_COMPOUND)
+                throw DCException("DCDomainDescriptor: Invalid domain attribute");
+
+            if (H5Tget_member_index(file_type, "rank") >= 0)
+            {
+                if (H5Aread(attr, this->type, &descriptor) < 0)
+                    throw DCException("DCDomainDescriptor: Failed to read domain attribute");
+
+                return true;
+            }
+
+            // format version 2.2 without rank
+            const hsize_t dim[] = {3};
+            ScopedID dim_t(H5Tarray_create(H5T_NATIVE_HSIZE, 1, dim));
+            ScopedID legacy_type(H5Tcreate(H5T_COMPOUND, sizeof (LegacyDescriptor)));
+            H5Tinsert(legacy_type, "class", HOFFSET(LegacyDescriptor, dataClass), H5T_NATIVE_INT32);
+            H5Tinsert(legacy_type, "size", HOFFSET(LegacyDescriptor, size), dim_t);
+            H5Tinsert(legacy_type, "start", HOFFSET(LegacyDescriptor, offset), dim_t);
+            H5Tinsert(legacy_type, "global_size", HOFFSET(LegacyDescriptor, globalSize), dim_t);
+            H5Tinsert(legacy_type, "global_start", HOFFSET(LegacyDescriptor, globalOffset), dim_t);
+
+            LegacyDescriptor legacy;
+            if (H5Aread(attr, legacy_type, &legacy) < 0)
+                throw DCException("DCDomainDescriptor: Failed to read domain attribute");
+
+            set((IDomainCollector::DomDataClass) legacy.dataClass,
+                    Domain(Dimensions(legacy.offset[0], legacy.offset[1], legacy.offset[2]),
+                    Dimensions(legacy.size[0], legacy.size[1], legacy.size[2])),
+                    Domain(Dimensions(legacy.globalOffset[0], legacy.globalOffset[1],
+                    legacy.globalOffset[2]),
+                    Dimensions(legacy.globalSize[0], legacy.globalSize[1],
+                    legacy.globalSize[2])));
+            return true;
+        }
+
+    private:
+
+        typedef struct
+        {
+            int32_t dataClass;
+            hsize_t size[3];
+            hsize_t offset[3];
+            hsize_t globalSize[3];
+            hsize_t globalOffset[3];
+        } LegacyDescriptor;
+
+        typedef struct
+        {
+            int32_t dataClass;
+            uint32_t rank;
+            hsize_t size[DSP_DIM_MAX];
+            hsize_t offset[DSP_DIM_MAX];
+            hsize_t globalSize[DSP_DIM_MAX];
+            hsize_t globalOffset[DSP_DIM_MAX];
+        } Descriptor;
+
+        Descriptor descriptor;
+    };
+    /**
+     * \endcond
+     */
+}
+
+#endif	/* DCDOMAINDESCRIPTOR_HPP */
@@ -71,6 +71,9 @@ namespace splash
     protected:
         bool checkExistence;
 
+        // property list for group and link access
+        hid_t groupAccProperties;
+
     private:
         HandlesList handles;
 
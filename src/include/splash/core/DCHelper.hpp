@@ -63,26 +63,11 @@ namespace splash
             if (hs == NULL)
                 return;
 
-            hsize_t tmp1;
-            hsize_t tmp3[3];
-
-            switch (rank)
+            for (uint32_t i = 0; i < rank / 2; i++)
             {
-                case 2:
-                    tmp1 = hs[0];
-                    hs[0] = hs[1];
-                    hs[1] = tmp1;
-                    break;
-                case 3:
-                    tmp3[0] = hs[2];
-                    tmp3[1] = hs[1];
-                    tmp3[2] = hs[0];
-
-                    for (uint32_t i = 0; i < 3; i++)
-                        hs[i] = tmp3[i];
-                    break;
-                default:
-                    return;
+                hsize_t tmp = hs[i];
+                hs[i] = hs[rank - 1 - i];
+                hs[rank - 1 - i] = tmp;
             }
         }
 
@@ -199,6 +184,33 @@ namespace splash
             return true;
         }
 
+        /**
+         * Creates a file creation property list which persistently tracks
+         * free space in the file, i.e. the space of deleted datasets
+         * is reused by later writes, even after the file has been reopened.
+         * Requires HDF5 1.10.1 or newer.
+         *
+         * @return property list, must be closed with H5Pclose, negative on error
+         */
+        static hid_t createFreeSpaceTrackingPList()
+        {
+#if H5_VERSION_GE(1, 10, 1)
+            hid_t fcpl = H5Pcreate(H5P_FILE_CREATE);
+            if (fcpl < 0)
+                return -1;
+
+            if (H5Pset_file_space_strategy(fcpl, H5F_FSPACE_STRATEGY_FSM_AGGR, 1, 1) < 0)
+            {
+                H5Pclose(fcpl);
+                return -1;
+            }
+
+            return fcpl;
+#else
+            return -1;
+#endif
+        }
+
     };
     /**
      * \endcond
@@ -23,6 +23,7 @@
 #define	DCPARALLELDATASET_HPP
 
 #include "splash/core/DCDataSet.hpp"
+#include "splash/pdc_defines.hpp"
 
 
 namespace splash
@@ -51,12 +52,32 @@ namespace splash
         {
             H5Pclose(dsetWriteProperties);
             H5Pclose(dsetReadProperties);
+
+            if (dsetAccProperties != H5P_DATASET_ACCESS_DEFAULT)
+                H5Pclose(dsetAccProperties);
         }
         
         void setWriteIndependent()
         {
             H5Pset_dxpl_mpio(dsetWriteProperties, H5FD_MPIO_INDEPENDENT);
         }
+
+        /**
+         * Reads dataset metadata collectively, i.e. once for all processes
+         * instead of once per process.
+         * All processes must take part in every access to this dataset.
+         * Has no effect if not supported by the HDF5 library.
+         */
+        void setCollectiveMetadata()
+        {
+#if (PDC_COLL_METADATA==1)
+            if (dsetAccProperties == H5P_DATASET_ACCESS_DEFAULT)
+            {
+                dsetAccProperties = H5Pcreate(H5P_DATASET_ACCESS);
+                H5Pset_all_coll_metadata_ops(dsetAccProperties, true);
+            }
+#endif
+        }
     };
     /**
      * \endcond
@@ -25,6 +25,7 @@
 #define	DCPARALLELGROUP_HPP
 
 #include "splash/core/DCGroup.hpp"
+#include "splash/pdc_defines.hpp"
 
 namespace splash
 {
@@ -44,7 +45,27 @@ namespace splash
         
         virtual ~DCParallelGroup()
         {
-            
+            close();
+
+            if (groupAccProperties != H5P_DEFAULT)
+                H5Pclose(groupAccProperties);
+        }
+
+        /**
+         * Reads group metadata collectively, i.e. once for all processes
+         * instead of once per process.
+         * All processes must take part in every access to this group.
+         * Has no effect if not supported by the HDF5 library.
+         */
+        void setCollectiveMetadata()
+        {
+#if (PDC_COLL_METADATA==1)
+            if (groupAccProperties == H5P_DEFAULT)
+            {
+                groupAccProperties = H5Pcreate(H5P_GROUP_ACCESS);
+                H5Pset_all_coll_metadata_ops(groupAccProperties, true);
+            }
+#endif
         }
     };
     /**
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DCREPACK_HPP
+#define	DCREPACK_HPP
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <hdf5.h>
+
+#include "splash/Dimensions.hpp"
+#include "splash/DCException.hpp"
+
+namespace splash
+{
+
+    /**
+     * Copies all objects of a file to a new file, reclaiming the space
+     * of deleted or overwritten datasets.
+     * Datasets can be recompressed or rechunked while copying and
+     * the copied iterations can be restricted to a range of IDs.
+     * References are recreated to point to the copied objects.
+     * \cond HIDDEN_SYMBOLS
+     */
+    class DCRepack
+    {
+    public:
+
+        typedef struct
+        {
+            /** deflate level of all chunked datasets, 0 disables compression,
+             * -1 keeps the filters of each dataset */
+            int compression;
+            /** chunk size of all chunked datasets (libSplash order),
+             * a scalar size of 0 keeps the chunks of each dataset */
+            Dimensions chunkSize;
+            /** first and last iteration to copy, lastID -1 copies all iterations */
+            int32_t firstID;
+            int32_t lastID;
+            /** persistently track free space in the new file,
+             * see FileCreationAttr::trackFreeSpace */
+            bool trackFreeSpace;
+        } Parameters;
+
+        /**
+         * Sets parameters to copy a file without changes.
+         *
+         * @param params parameters to initialize
+         */
+        static void initParameters(Parameters &params);
+
+        /**
+         * Copies a file.
+         *
+         * @param srcFilename file to copy
+         * @param dstFilename new file, is overwritten
+         * @param params copy parameters
+         */
+        static void copyFile(const std::string &srcFilename,
+                const std::string &dstFilename,
+                const Parameters &params) throw (DCException);
+
+    private:
+
+        typedef struct
+        {
+            hid_t srcFile;
+            hid_t dstFile;
+            const Parameters *params;
+            /** paths of datasets of references, copied after all other objects */
+            std::vector<std::string> references;
+        } CopyState;
+
+        static void getLinkNames(hid_t group, std::vector<std::string> &names)
+        throw (DCException);
+
+        static void copyAttributes(hid_t src, hid_t dst) throw (DCException);
+
+        static void copyGroup(CopyState &state, hid_t src, hid_t dst,
+                const std::string &path) throw (DCException);
+
+        static void copyLink(CopyState &state, hid_t src, hid_t dst,
+                const std::string &path, const std::string &name) throw (DCException);
+
+        static void copyDataSet(CopyState &state, hid_t src, hid_t dst,
+                const std::string &path, const std::string &name) throw (DCException);
+
+        static void copyReferences(CopyState &state, const std::string &path)
+        throw (DCException);
+
+        static void updateMaxID(hid_t file) throw (DCException);
+
+        static bool isChanged(const Parameters &params, hid_t dcpl);
+
+        static void setLayout(const Parameters &params, hid_t dataspace, hid_t dcpl);
+
+        static std::string getExceptionString(std::string msg, std::string name);
+    };
+    /**
+     * \endcond
+     */
+
+}
+
+#endif	/* DCREPACK_HPP */
@@ -0,0 +1,133 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DCSTORAGE_HPP
+#define	DCSTORAGE_HPP
+
+#include <string>
+#include <hdf5.h>
+
+#include "splash/DCException.hpp"
+#include "splash/basetypes/basetypes_storage.hpp"
+
+namespace splash
+{
+
+    /**
+     * Describes how a dataset is stored if its storage datatype differs
+     * from the memory datatype and converts between both.
+     * The description is stored as the compound attribute \ref SDC_ATTR_STORAGE.
+     * \cond HIDDEN_SYMBOLS
+     */
+    class DCStorage
+    {
+    public:
+        /**
+         * Constructor, data is stored with its memory datatype.
+         */
+        DCStorage();
+
+        /**
+         * Uses the storage description of a datatype.
+         *
+         * @param colType storage datatype
+         */
+        void set(const ColTypeStorage &colType);
+
+        /**
+         * Resets to storing data with its memory datatype.
+         */
+        void reset();
+
+        /**
+         * @return true if data is stored with its memory datatype
+         */
+        bool isNative() const;
+
+        /**
+         * @return memory datatype
+         */
+        DCDataType getMemoryType() const;
+
+        /**
+         * @return size in bytes of the memory datatype
+         */
+        size_t getMemorySize() const;
+
+        /**
+         * @return HDF5 memory datatype
+         */
+        hid_t getMemoryH5Type() const;
+
+        /**
+         * Converts dense data from the memory to the storage datatype.
+         *
+         * @param src source buffer with memory datatype
+         * @param dst destination buffer with storage datatype
+         * @param count number of elements
+         * @param storageType HDF5 storage datatype
+         */
+        void toStorage(const void *src, void *dst, size_t count,
+                hid_t storageType) const throw (DCException);
+
+        /**
+         * Converts dense data from the storage to the memory datatype.
+         *
+         * @param src source buffer with storage datatype
+         * @param dst destination buffer with memory datatype
+         * @param count number of elements
+         * @param storageType HDF5 storage datatype
+         */
+        void fromStorage(const void *src, void *dst, size_t count,
+                hid_t storageType) const throw (DCException);
+
+        /**
+         * Writes the storage description to a dataset.
+         *
+         * @param dataset dataset handle
+         */
+        void writeAttribute(hid_t dataset) const throw (DCException);
+
+        /**
+         * Reads the storage description of a dataset.
+         * Resets to the memory datatype if the dataset has no description.
+         *
+         * @param dataset dataset handle
+         */
+        void readAttribute(hid_t dataset) throw (DCException);
+
+    private:
+        static std::string getExceptionString(std::string msg);
+
+        static hid_t createAttributeType();
+
+        DCStorageFormat format;
+        DCDataType memType;
+        double scale;
+    };
+    /**
+     * \endcond
+     */
+
+}
+
+#endif	/* DCSTORAGE_HPP */
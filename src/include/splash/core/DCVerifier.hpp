@@ -0,0 +1,129 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DCVERIFIER_HPP
+#define	DCVERIFIER_HPP
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <hdf5.h>
+
+namespace splash
+{
+
+    /**
+     * Verifies the structure and content of a libSplash file without
+     * external tools.
+     * Checks the header attributes, the group structure of all iterations,
+     * the extents of domain datasets against their domain annotations and,
+     * optionally, all data and the per-dataset checksums (\ref SDC_ATTR_CHECKSUM).
+     * Problems are reported per object, verification continues after
+     * a problem has been found.
+     * \cond HIDDEN_SYMBOLS
+     */
+    class DCVerifier
+    {
+    public:
+
+        typedef struct
+        {
+            /** absolute path of the damaged object in the file */
+            std::string path;
+            /** description of the problem */
+            std::string message;
+        } Problem;
+
+        typedef struct
+        {
+            /** number of threads used to decompress and checksum data */
+            uint32_t numThreads;
+            /** read all data, required to verify checksums */
+            bool readData;
+        } Parameters;
+
+        /**
+         * Sets parameters to verify the structure and all data
+         * with a single thread.
+         *
+         * @param params parameters to initialize
+         */
+        static void initParameters(Parameters &params);
+
+        /**
+         * Verifies a file.
+         *
+         * @param filename file to verify
+         * @param params verification parameters
+         * @param problems all problems found are appended to this list
+         * @return true if no problems have been found
+         */
+        static bool verifyFile(const std::string &filename,
+                const Parameters &params, std::vector<Problem> &problems);
+
+        /**
+         * Updates a checksum as stored in \ref SDC_ATTR_CHECKSUM.
+         * The checksum of a dataset is the CRC-32 of all its elements
+         * in the file datatype and in row-major order, starting with 0.
+         *
+         * @param checksum checksum of the preceding data
+         * @param data next data
+         * @param size size of \p data in bytes
+         * @param numThreads number of threads
+         * @return updated checksum
+         */
+        static uint32_t updateChecksum(uint32_t checksum, const void *data,
+                size_t size, uint32_t numThreads);
+
+    private:
+
+        typedef struct
+        {
+            const Parameters *params;
+            std::vector<Problem> *problems;
+        } VerifyState;
+
+        static void addProblem(VerifyState &state, const std::string &path,
+                const std::string &message);
+
+        static void verifyHeader(VerifyState &state, hid_t file);
+
+        static void verifyIterations(VerifyState &state, hid_t file);
+
+        static void verifyGroup(VerifyState &state, hid_t group,
+                const std::string &path);
+
+        static void verifyDataSet(VerifyState &state, hid_t dataset,
+                const std::string &path);
+
+        static void verifyDomain(VerifyState &state, hid_t dataset,
+                const std::string &path);
+
+        static void verifyData(VerifyState &state, hid_t dataset,
+                const std::string &path);
+    };
+    /**
+     * \endcond
+     */
+
+}
+
+#endif	/* DCVERIFIER_HPP */
@@ -100,18 +100,22 @@ namespace splash
          * @param baseFilename base filename part (w/o MPI/ext)
          * @param fileAccProperties from SerialDataCollector
          * @param flags from SerialDataCollector
+         * @param fileCreateProperties used when creating files
          */
         void open(Dimensions mpiSize, const std::string baseFilename,
-                hid_t fileAccProperties, unsigned flags);
+                hid_t fileAccProperties, unsigned flags,
+                hid_t fileCreateProperties = H5P_FILE_CREATE_DEFAULT);
 
         /**
          * Opens the handle manager for a single file/handle
          * @param fullFilename full filename (w/ MPI/ext)
          * @param fileAccProperties from SerialDataCollector
          * @param flags from SerialDataCollector
+         * @param fileCreateProperties used when creating files
          */
         void open(const std::string fullFilename,
-                hid_t fileAccProperties, unsigned flags);
+                hid_t fileAccProperties, unsigned flags,
+                hid_t fileCreateProperties = H5P_FILE_CREATE_DEFAULT);
 
         /**
          * Closes the handle manager, closes all open file handles.
@@ -162,6 +166,7 @@ namespace splash
         FileNameScheme fileNameScheme;
         
         hid_t fileAccProperties;
+        hid_t fileCreateProperties;
         unsigned fileFlags;
         bool singleFile;
 
@@ -58,7 +58,8 @@ namespace splash
         static void getReferenceData(const char* filename, int32_t* maxID, Dimensions *mpiSize)
         throw (DCException)
         {
-            log_msg(1, "loading reference data from %s", filename);
+            // header only, the category of the including file does not apply
+            log_cat_msg(splash::LOG_FILE, 1, "loading reference data from %s", filename);
 
             // open the file to get reference data from
             hid_t reference_file = H5Fopen(filename, H5F_ACC_RDONLY, H5P_FILE_ACCESS_DEFAULT);
@@ -66,15 +67,34 @@ namespace splash
                 throw DCException(getExceptionString(std::string("Failed to open reference file ") +
                     std::string(filename)));
 
-            // reference data is located in the header only
-            hid_t group_header = H5Gopen(reference_file, SDC_GROUP_HEADER, H5P_DEFAULT);
-            if (group_header < 0) {
+            try {
+                getReferenceData(reference_file, maxID, mpiSize);
+            } catch (DCException) {
                 H5Fclose(reference_file);
                 throw DCException(getExceptionString(
-                        std::string("Failed to open header group in reference file ") +
+                        std::string("Failed to read header of reference file ") +
                         std::string(filename)));
             }
 
+            // cleanup
+            H5Fclose(reference_file);
+        }
+
+        /**
+         * Reads reference data (header information) from an opened file.
+         *
+         * @param file the file to read from
+         * @param maxID pointer to hold max iteration. can be NULL
+         * @param mpiSize pointer to hold size of mpi grid. can be NULL
+         */
+        static void getReferenceData(hid_t file, int32_t* maxID, Dimensions *mpiSize)
+        throw (DCException)
+        {
+            // reference data is located in the header only
+            hid_t group_header = H5Gopen(file, SDC_GROUP_HEADER, H5P_DEFAULT);
+            if (group_header < 0)
+                throw DCException(getExceptionString("Failed to open header group"));
+
             try {
                 if (maxID != NULL) {
                     DCAttribute::readAttribute(SDC_ATTR_MAX_ID,
@@ -88,15 +108,11 @@ namespace splash
                 }
 
             } catch (DCException attr_exception) {
-                H5Fclose(reference_file);
-                throw DCException(getExceptionString(
-                        std::string("Failed to read attributes from reference file ") +
-                        std::string(filename)));
+                H5Gclose(group_header);
+                throw DCException(getExceptionString("Failed to read header attributes"));
             }
 
-            // cleanup
             H5Gclose(group_header);
-            H5Fclose(reference_file);
         }
 
         /**
@@ -0,0 +1,66 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SCOPEDID_HPP
+#define	SCOPEDID_HPP
+
+#include <hdf5.h>
+
+namespace splash
+{
+
+    /**
+     * Releases an HDF5 identifier of any type when leaving its scope.
+     * \cond HIDDEN_SYMBOLS
+     */
+    class ScopedID
+    {
+    public:
+
+        ScopedID(hid_t id) :
+        id(id)
+        {
+        }
+
+        ~ScopedID()
+        {
+            if (id >= 0)
+                H5Idec_ref(id);
+        }
+
+        operator hid_t() const
+        {
+            return id;
+        }
+
+    private:
+        ScopedID(const ScopedID &other);
+        ScopedID& operator=(const ScopedID &other);
+
+        hid_t id;
+    };
+    /**
+     * \endcond
+     */
+
+}
+
+#endif	/* SCOPEDID_HPP */
@@ -28,8 +28,37 @@
 # define EXTERN extern
 #endif
 
+/**
+ * maximum level of log messages compiled into libSplash,
+ * messages with higher levels are removed at compile time
+ */
+#ifndef SPLASH_LOG_MAX_LEVEL
+#define SPLASH_LOG_MAX_LEVEL 4
+#endif
+
+/**
+ * log category of a source file, must be defined before including any header
+ */
+#ifndef SPLASH_LOG_CATEGORY
+#define SPLASH_LOG_CATEGORY splash::LOG_GENERAL
+#endif
+
 namespace splash
 {
+    /**
+     * subsystems with separate verbosity levels,
+     * set by the environment variables SPLASH_VERBOSE_(CATEGORY)
+     */
+    enum LogCategory
+    {
+        LOG_GENERAL, LOG_COLLECTOR, LOG_DATASET, LOG_FILE, LOG_NUM_CATEGORIES
+    };
+
+    /**
+     * current verbosity level per category
+     */
+    extern int log_verbosity[LOG_NUM_CATEGORIES];
+
     /**
      * parses environment variables and sets internal configuration
      */
@@ -43,14 +72,47 @@ namespace splash
     EXTERN void setLogMpiRank(int rank);
 
     /**
-     * writes a log message for a given log level
+     * writes a log message unconditionally, use \ref log_msg instead
      * 
-     * @param level required log level
      * @param fmt format string (like printf)
      * @param ... arguments to \p fmt
      */
-    EXTERN void log_msg(int level, const char *fmt, ...);
+    EXTERN void log_write(const char *fmt, ...);
+
+    /**
+     * returns if messages of a level are written for a category
+     *
+     * @param category log category
+     * @param level required log level
+     * @return true if enabled
+     */
+    inline bool log_enabled(LogCategory category, int level)
+    {
+        return level <= SPLASH_LOG_MAX_LEVEL && level <= log_verbosity[category];
+    }
 }
 
-#endif	/* LOGGING_HPP */
+/**
+ * writes a log message for a given log level and category,
+ * arguments are only evaluated if the message is written
+ *
+ * @param category log category
+ * @param level required log level
+ * @param ... format string (like printf) and arguments
+ */
+#define log_cat_msg(category, level, ...) \
+    do \
+    { \
+        if (splash::log_enabled(category, level)) \
+            splash::log_write(__VA_ARGS__); \
+    } while (0)
 
+/**
+ * writes a log message for a given log level in the category of the source file
+ *
+ * @param level required log level
+ * @param ... format string (like printf) and arguments
+ */
+#define log_msg(level, ...) log_cat_msg(SPLASH_LOG_CATEGORY, level, __VA_ARGS__)
+
+#endif	/* LOGGING_HPP */
@@ -82,7 +82,10 @@ namespace splash
             const Dimensions &entryOffset = entry->getOffset();
             const Dimensions entryBack = entry->getBack(); // last index INSIDE
 
-            for (uint32_t i = 0; i < 3; ++i)
+            offset.setRank(entryBack.getRank(), 0);
+            size.setRank(entryBack.getRank(), 1);
+
+            for (uint32_t i = 0; i < entryBack.getRank(); ++i)
             {
                 offset[i] = std::min(entryOffset[i], offset[i]);
                 size[i] = std::max(entryBack[i] + 1 - offset[i], size[i]);
@@ -147,7 +150,7 @@ namespace splash
          */
         Dimensions getBack() const
         {
-            return offset + size - Dimensions(1, 1, 1);
+            return Domain(offset, size).getBack();
         }
 
         /**
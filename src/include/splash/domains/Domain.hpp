@@ -26,6 +26,7 @@
 
 #include <string>
 #include <sstream>
+#include <algorithm>
 #include <stdint.h>
 
 #include "splash/Dimensions.hpp"
@@ -34,7 +35,7 @@ namespace splash
 {
 
     /**
-     * Represents a (1-3)-dimensional logical domain or subdomain,
+     * Represents a (1-N)-dimensional logical domain or subdomain,
      * e.g. a logical grid in a simulation code.
      */
     class Domain
@@ -67,7 +68,7 @@ namespace splash
         /**
          * Returns the number of dimensions of this domain.
          * 
-         * @return Number of dimensions (1-3).
+         * @return Number of dimensions (1-\ref DSP_DIM_MAX).
          */
         uint32_t getDims() const
         {
@@ -122,7 +123,11 @@ namespace splash
          */
         Dimensions getBack() const
         {
-            return offset + size - Dimensions(1, 1, 1);
+            Dimensions back = offset + size;
+            for (uint32_t i = 0; i < back.getRank(); ++i)
+                back[i] -= 1;
+
+            return back;
         }
 
         bool operator==(Domain const& other) const
@@ -161,12 +166,14 @@ namespace splash
             Dimensions d1_end = d1.getBack();
             Dimensions d2_end = d2.getBack();
 
-            return (d1_offset[0] <= d2_end[0] && d1_end[0] >= d2_offset[0] &&
-                    d1_offset[1] <= d2_end[1] && d1_end[1] >= d2_offset[1] &&
-                    d1_offset[2] <= d2_end[2] && d1_end[2] >= d2_offset[2]) ||
-                    (d2_offset[0] <= d1_end[0] && d2_end[0] >= d1_offset[0] &&
-                    d2_offset[1] <= d1_end[1] && d2_end[1] >= d1_offset[1] &&
-                    d2_offset[2] <= d1_end[2] && d2_end[2] >= d1_offset[2]);
+            const uint32_t rank = std::max(d1_end.getRank(), d2_end.getRank());
+            for (uint32_t i = 0; i < rank; ++i)
+            {
+                if (!(d1_offset[i] <= d2_end[i] && d1_end[i] >= d2_offset[i]))
+                    return false;
+            }
+
+            return true;
         }
 
     protected:
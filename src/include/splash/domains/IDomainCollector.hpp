@@ -34,6 +34,8 @@
 #define DOMCOL_ATTR_OFFSET "_start"
 #define DOMCOL_ATTR_GLOBAL_OFFSET "_global_start"
 #define DOMCOL_ATTR_ELEMENTS "_elements"
+/* compound of class, size, start, global_size and global_start */
+#define DOMCOL_ATTR_DOMAIN "_domain"
 
 namespace splash
 {
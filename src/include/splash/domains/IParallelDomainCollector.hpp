@@ -118,6 +118,30 @@ namespace splash
                 const char* name,
                 const Domain domain,
                 DomDataClass dataClass) = 0;
+
+        /**
+         * Reads a domain collectively with a separate request domain per process.
+         *
+         * The dataset is read in large contiguous blocks by all processes
+         * collectively and redistributed to the requesting processes.
+         * For Grid data, each process receives the intersection of its
+         * request with the dataset domain.
+         * For Poly data, the elements are split evenly and in order among
+         * all processes with an intersecting (or empty) request, each
+         * of these processes receives its own contiguous range of elements.
+         * Must be called by all processes, errors on any process are
+         * thrown by all processes.
+         *
+         * @param id ID for iteration.
+         * @param name Name of the dataset.
+         * @param requestDomain Domain requested by the calling process.
+         * @param dataClass Returns the domain type annotation.
+         * @return DataContainer with at most one DomainData, must be deleted by the user
+         */
+        virtual DataContainer *readDomainDistributed(int32_t id,
+                const char* name,
+                const Domain requestDomain,
+                DomDataClass* dataClass) = 0;
     };
 
 }
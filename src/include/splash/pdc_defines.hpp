@@ -22,9 +22,27 @@
 #ifndef PDC_DEFINES_HPP
 #define	PDC_DEFINES_HPP
 
+#include <hdf5.h>
+
 namespace splash
 {
 #define PDC_ATTR_APPEND "pdc_fillsize"
+#define PDC_MAX_CHUNK_SIZE (4ULL * 1024 * 1024 * 1024)
+#define PDC_APPEND_CHUNK_SIZE (1024 * 1024)
+
+// collective metadata operations are available since HDF5 1.10.0
+#if H5_VERSION_GE(1, 10, 0)
+#define PDC_COLL_METADATA 1
+#else
+#define PDC_COLL_METADATA 0
+#endif
+
+// collective writes to filtered (compressed) datasets are available since HDF5 1.10.2
+#if H5_VERSION_GE(1, 10, 2)
+#define PDC_PARALLEL_FILTERS 1
+#else
+#define PDC_PARALLEL_FILTERS 0
+#endif
 }
 
 #endif	/* PDC_DEFINES_HPP */
@@ -39,8 +39,14 @@ namespace splash
 #define SDC_ATTR_GRID_SIZE "grid_size"
 #define SDC_ATTR_SIZE "client_size"
 #define SDC_ATTR_COMPRESSION "compression"
+#define SDC_ATTR_STORAGE "_storage"
+#define SDC_ATTR_CHECKSUM "_checksum"
 
-#define DSP_DIM_MAX 3
+/** maximum number of dimensions of datasets */
+#define DSP_DIM_MAX 6
+
+/** growth increment of in-memory files in bytes */
+#define SDC_CORE_INCREMENT (16 * 1024 * 1024)
 }
 
 #endif	/* SDC_DEFINES_H */
@@ -29,9 +29,11 @@
 
 #include "splash/SerialDataCollector.hpp"
 #include "splash/DomainCollector.hpp"
+#include "splash/RecordingCollector.hpp"
 
 #include "splash/ParallelDataCollector.hpp"
 #include "splash/ParallelDomainCollector.hpp"
+#include "splash/RepartitionCollector.hpp"
 
 #include "splash/basetypes/basetypes.hpp"
 
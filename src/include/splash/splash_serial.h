@@ -28,6 +28,7 @@
 
 #include "splash/SerialDataCollector.hpp"
 #include "splash/DomainCollector.hpp"
+#include "splash/RecordingCollector.hpp"
 
 #include "splash/basetypes/basetypes.hpp"
 
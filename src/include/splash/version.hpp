@@ -32,6 +32,6 @@
  *  changes in the minor number have to be backwards compatible
  */
 #define SPLASH_FILE_FORMAT_MAJOR 2
-#define SPLASH_FILE_FORMAT_MINOR 1
+#define SPLASH_FILE_FORMAT_MINOR 3
 
 #endif	/* VERSION_HPP */
@@ -24,13 +24,18 @@
 #include <cstdarg>
 
 #include "splash/core/logging.hpp"
+#include "splash/Tracing.hpp"
 
 namespace splash
 {
+    int log_verbosity[LOG_NUM_CATEGORIES] = {0, 0, 0, 0};
+
     /**
-     * current verbosity level for log messages
+     * names of the log categories in environment variables
      */
-    static int verbosity_level = 0;
+    static const char *log_category_names[LOG_NUM_CATEGORIES] = {
+        "GENERAL", "COLLECTOR", "DATASET", "FILE"
+    };
     
     /**
      * current MPI rank for log messages
@@ -42,8 +47,33 @@ namespace splash
         char *verbosity = getenv("SPLASH_VERBOSE");
         if (verbosity != NULL)
         {
-            verbosity_level = atoi(verbosity);
-            log_msg(1, "Setting verbosity level to %d\n", verbosity_level);
+            for (int i = 0; i < LOG_NUM_CATEGORIES; ++i)
+                log_verbosity[i] = atoi(verbosity);
+        }
+
+        // per category levels override SPLASH_VERBOSE
+        for (int i = 0; i < LOG_NUM_CATEGORIES; ++i)
+        {
+            char env_name[32];
+            snprintf(env_name, sizeof (env_name), "SPLASH_VERBOSE_%s", log_category_names[i]);
+
+            char *category_verbosity = getenv(env_name);
+            if (category_verbosity != NULL)
+                log_verbosity[i] = atoi(category_verbosity);
+        }
+
+        for (int i = 0; i < LOG_NUM_CATEGORIES; ++i)
+        {
+            log_cat_msg((LogCategory) i, 1, "Setting verbosity level of %s to %d\n",
+                    log_category_names[i], log_verbosity[i]);
+        }
+
+        // keep the trace file of previous DataCollectors
+        char *trace = getenv("SPLASH_TRACE");
+        if (trace != NULL && !Tracing::isEnabled())
+        {
+            Tracing::enable(trace);
+            log_msg(1, "Tracing to %s\n", trace);
         }
     }
     
@@ -52,20 +82,17 @@ namespace splash
         my_rank = rank;
     }
 
-    void log_msg(int level, const char *fmt, ...)
+    void log_write(const char *fmt, ...)
     {
         va_list argp;
-        
-        if (level <= verbosity_level)
-        {
-            fprintf(stderr, "[SPLASH_LOG:%d] ", my_rank);
-            
-            va_start(argp, fmt);
-            vfprintf(stderr, fmt, argp);
-            va_end(argp);
 
-            fprintf(stderr, "\n");
-        }
+        fprintf(stderr, "[SPLASH_LOG:%d] ", my_rank);
+
+        va_start(argp, fmt);
+        vfprintf(stderr, fmt, argp);
+        va_end(argp);
+
+        fprintf(stderr, "\n");
     }
 
 }
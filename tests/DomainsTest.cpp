@@ -33,6 +33,8 @@ CPPUNIT_TEST_SUITE_REGISTRATION(DomainsTest);
 const char* hdf5_file_grid = "h5/testDomainsGrid";
 const char* hdf5_file_poly = "h5/testDomainsPoly";
 const char* hdf5_file_append = "h5/testDomainsAppend";
+const char* hdf5_file_legacy = "h5/testDomainsLegacy";
+const char* hdf5_file_highdim = "h5/testDomainsHighDim";
 
 using namespace splash;
 
@@ -628,3 +630,234 @@ void DomainsTest::testAppendDomains()
 
     MPI_Barrier(MPI_COMM_WORLD);
 }
+
+void DomainsTest::testLegacyDomains()
+{
+    if (totalMpiRank == 0)
+    {
+        Dimensions mpi_size(1, 1, 1);
+        Dimensions mpi_position(0, 0, 0);
+        Dimensions grid_size(10, 4, 3);
+        const Domain local_domain(Dimensions(0, 0, 0), grid_size);
+        const Domain global_domain(Dimensions(5, 6, 7), grid_size);
+
+        DataCollector::FileCreationAttr fattr;
+        DataCollector::initFileCreationAttr(fattr);
+        fattr.fileAccType = DataCollector::FAT_CREATE;
+        fattr.mpiSize.set(mpi_size);
+        fattr.mpiPosition.set(mpi_position);
+
+        dataCollector->open(hdf5_file_legacy, fattr);
+
+        int *data_write = new int[grid_size.getScalarSize()];
+        for (size_t i = 0; i < grid_size.getScalarSize(); ++i)
+            data_write[i] = i;
+
+        dataCollector->write(0, ctInt, 3, Selection(grid_size), "legacy_data", data_write);
+
+        // annotate with separate attributes as written by older versions
+        ColTypeInt32 int_t;
+        ColTypeDim dim_t;
+        IDomainCollector::DomDataClass data_class = IDomainCollector::GridType;
+        dataCollector->writeAttribute(0, int_t, "legacy_data", DOMCOL_ATTR_CLASS, &data_class);
+        dataCollector->writeAttribute(0, dim_t, "legacy_data", DOMCOL_ATTR_SIZE,
+                local_domain.getSize().getPointer());
+        dataCollector->writeAttribute(0, dim_t, "legacy_data", DOMCOL_ATTR_OFFSET,
+                local_domain.getOffset().getPointer());
+        dataCollector->writeAttribute(0, dim_t, "legacy_data", DOMCOL_ATTR_GLOBAL_SIZE,
+                global_domain.getSize().getPointer());
+        dataCollector->writeAttribute(0, dim_t, "legacy_data", DOMCOL_ATTR_GLOBAL_OFFSET,
+                global_domain.getOffset().getPointer());
+
+        // datasets without domain annotation
+        dataCollector->write(0, ctInt, 1, Selection(Dimensions(1, 1, 1)), "plain/data",
+                data_write);
+
+        dataCollector->write(1, ctInt, 3, Selection(grid_size), "compound_data", data_write);
+
+        dataCollector->close();
+
+        // annotate with the 3-dimensional compound attribute of format version 2.2
+        typedef struct
+        {
+            int32_t dataClass;
+            hsize_t size[3];
+            hsize_t offset[3];
+            hsize_t globalSize[3];
+            hsize_t globalOffset[3];
+        } CompoundDomain;
+
+        CompoundDomain compound_domain;
+        compound_domain.dataClass = IDomainCollector::GridType;
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            compound_domain.size[i] = local_domain.getSize()[i];
+            compound_domain.offset[i] = local_domain.getOffset()[i];
+            compound_domain.globalSize[i] = global_domain.getSize()[i];
+            compound_domain.globalOffset[i] = global_domain.getOffset()[i];
+        }
+
+        const hsize_t dim[] = {3};
+        hid_t array_type = H5Tarray_create(H5T_NATIVE_HSIZE, 1, dim);
+        hid_t compound_type = H5Tcreate(H5T_COMPOUND, sizeof (CompoundDomain));
+        H5Tinsert(compound_type, "class", HOFFSET(CompoundDomain, dataClass), H5T_NATIVE_INT32);
+        H5Tinsert(compound_type, "size", HOFFSET(CompoundDomain, size), array_type);
+        H5Tinsert(compound_type, "start", HOFFSET(CompoundDomain, offset), array_type);
+        H5Tinsert(compound_type, "global_size", HOFFSET(CompoundDomain, globalSize), array_type);
+        H5Tinsert(compound_type, "global_start", HOFFSET(CompoundDomain, globalOffset), array_type);
+
+        std::string filename = std::string(hdf5_file_legacy) + "_0_0_0.h5";
+        hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+        hid_t dataset = H5Dopen2(file, "/data/1/compound_data", H5P_DEFAULT);
+        hid_t scalar_space = H5Screate(H5S_SCALAR);
+        hid_t attr = H5Acreate2(dataset, DOMCOL_ATTR_DOMAIN, compound_type, scalar_space,
+                H5P_DEFAULT, H5P_DEFAULT);
+        CPPUNIT_ASSERT(H5Awrite(attr, compound_type, &compound_domain) >= 0);
+
+        H5Aclose(attr);
+        H5Sclose(scalar_space);
+        H5Dclose(dataset);
+        H5Fclose(file);
+        H5Tclose(compound_type);
+        H5Tclose(array_type);
+
+        fattr.fileAccType = DataCollector::FAT_READ_MERGED;
+        dataCollector->open(hdf5_file_legacy, fattr);
+
+        CPPUNIT_ASSERT(dataCollector->getLocalDomain(0, "legacy_data").getSize() == grid_size);
+        CPPUNIT_ASSERT(dataCollector->getGlobalDomain(0, "legacy_data").getOffset() ==
+                global_domain.getOffset());
+
+        size_t num_entries = 0;
+        dataCollector->getEntriesForID(0, NULL, &num_entries);
+        CPPUNIT_ASSERT(num_entries == 2);
+
+        DataCollector::DCEntry entries[2];
+        dataCollector->getEntriesForID(0, entries, NULL);
+        CPPUNIT_ASSERT(entries[0].name == "legacy_data");
+        CPPUNIT_ASSERT(entries[1].name == "plain/data");
+
+        DomainCollector::DomainInfo info;
+        CPPUNIT_ASSERT(dataCollector->readDomainInfo(0, "legacy_data", info));
+        CPPUNIT_ASSERT(info.dataClass == IDomainCollector::GridType);
+        CPPUNIT_ASSERT(info.ndims == 3);
+        CPPUNIT_ASSERT(info.dataSize == grid_size);
+        CPPUNIT_ASSERT(info.dataType == DCDT_INT32);
+        CPPUNIT_ASSERT(info.localDomain.getSize() == grid_size);
+        CPPUNIT_ASSERT(info.globalDomain.getOffset() == global_domain.getOffset());
+        CPPUNIT_ASSERT(!dataCollector->readDomainInfo(0, "plain/data", info));
+
+        CPPUNIT_ASSERT(dataCollector->readDomainInfo(1, "compound_data", info));
+        CPPUNIT_ASSERT(info.dataClass == IDomainCollector::GridType);
+        CPPUNIT_ASSERT(info.localDomain.getSize() == grid_size);
+        CPPUNIT_ASSERT(info.localDomain.getSize().getRank() == 3);
+        CPPUNIT_ASSERT(info.globalDomain.getOffset() == global_domain.getOffset());
+        CPPUNIT_ASSERT(dataCollector->getGlobalDomain(1, "compound_data").getSize() == grid_size);
+
+        data_class = IDomainCollector::UndefinedType;
+        DataContainer *container = dataCollector->readDomain(0, "legacy_data",
+                global_domain, &data_class);
+
+        CPPUNIT_ASSERT(data_class == IDomainCollector::GridType);
+        CPPUNIT_ASSERT(container->getNumSubdomains() == 1);
+
+        DomainData *subdomain = container->getIndex(0);
+        CPPUNIT_ASSERT(subdomain->getSize() == grid_size);
+
+        int *subdomain_data = (int*) (subdomain->getData());
+        for (size_t i = 0; i < grid_size.getScalarSize(); ++i)
+            CPPUNIT_ASSERT(subdomain_data[i] == (int) i);
+
+        delete container;
+        delete[] data_write;
+
+        dataCollector->close();
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+void DomainsTest::testHighDimDomains()
+{
+    if (totalMpiRank == 0)
+    {
+        const hsize_t grid_values[] = {6, 5, 4, 3};
+        const hsize_t offset_values[] = {10, 0, 2, 1};
+        const hsize_t request_offset_values[] = {11, 1, 3, 1};
+        const hsize_t request_size_values[] = {4, 3, 2, 2};
+
+        Dimensions grid_size(4, grid_values);
+        const Domain local_domain(Dimensions(0, 0, 0), grid_size);
+        const Domain global_domain(Dimensions(4, offset_values), grid_size);
+        const Domain request(Dimensions(4, request_offset_values),
+                Dimensions(4, request_size_values));
+
+        DataCollector::FileCreationAttr fattr;
+        DataCollector::initFileCreationAttr(fattr);
+        fattr.fileAccType = DataCollector::FAT_CREATE;
+        fattr.mpiSize.set(1, 1, 1);
+        fattr.mpiPosition.set(0, 0, 0);
+
+        dataCollector->open(hdf5_file_highdim, fattr);
+
+        int *data_write = new int[grid_size.getScalarSize()];
+        for (size_t i = 0; i < grid_size.getScalarSize(); ++i)
+            data_write[i] = i;
+
+        dataCollector->writeDomain(0, ctInt, 4, Selection(grid_size), "grid4d",
+                local_domain, global_domain, IDomainCollector::GridType, data_write);
+
+        dataCollector->close();
+
+        fattr.fileAccType = DataCollector::FAT_READ_MERGED;
+        dataCollector->open(hdf5_file_highdim, fattr);
+
+        Dimensions size_read;
+        dataCollector->read(0, "grid4d", size_read, NULL);
+        CPPUNIT_ASSERT(size_read.getRank() == 4);
+        CPPUNIT_ASSERT(size_read == grid_size);
+
+        CPPUNIT_ASSERT(dataCollector->getGlobalDomain(0, "grid4d").getOffset() ==
+                global_domain.getOffset());
+        CPPUNIT_ASSERT(dataCollector->getGlobalDomain(0, "grid4d").getSize().getRank() == 4);
+
+        DomainCollector::DomainInfo info;
+        CPPUNIT_ASSERT(dataCollector->readDomainInfo(0, "grid4d", info));
+        CPPUNIT_ASSERT(info.dataClass == IDomainCollector::GridType);
+        CPPUNIT_ASSERT(info.ndims == 4);
+        CPPUNIT_ASSERT(info.dataSize == grid_size);
+        CPPUNIT_ASSERT(info.globalDomain.getOffset() == global_domain.getOffset());
+
+        IDomainCollector::DomDataClass data_class = IDomainCollector::UndefinedType;
+        DataContainer *container = dataCollector->readDomain(0, "grid4d",
+                request, &data_class);
+
+        CPPUNIT_ASSERT(data_class == IDomainCollector::GridType);
+        CPPUNIT_ASSERT(container->getNumSubdomains() == 1);
+
+        DomainData *subdomain = container->getIndex(0);
+        CPPUNIT_ASSERT(subdomain->getSize() == request.getSize());
+
+        int *subdomain_data = (int*) (subdomain->getData());
+        const Dimensions src = request.getOffset() - global_domain.getOffset();
+        size_t index = 0;
+        for (hsize_t w = 0; w < request_size_values[3]; ++w)
+            for (hsize_t z = 0; z < request_size_values[2]; ++z)
+                for (hsize_t y = 0; y < request_size_values[1]; ++y)
+                    for (hsize_t x = 0; x < request_size_values[0]; ++x)
+                    {
+                        const size_t expected = (((src[3] + w) * grid_size[2] +
+                                src[2] + z) * grid_size[1] + src[1] + y) *
+                                grid_size[0] + src[0] + x;
+                        CPPUNIT_ASSERT(subdomain_data[index] == (int) expected);
+                        index++;
+                    }
+
+        delete container;
+        delete[] data_write;
+
+        dataCollector->close();
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+}
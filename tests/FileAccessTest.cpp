@@ -23,9 +23,14 @@
 
 #include "FileAccessTest.h"
 
+#include <cstdio>
+#include <sys/stat.h>
+#include <vector>
+
 CPPUNIT_TEST_SUITE_REGISTRATION(FileAccessTest);
 
 #define HDF5_FILE "h5/testWriteAfterCreate"
+#define HDF5_MEMORY_FILE "h5/testInMemory"
 
 using namespace splash;
 
@@ -96,3 +101,74 @@ void FileAccessTest::testWriteAfterCreate()
     dataCollector->close();
 }
 
+
+void FileAccessTest::testInMemory()
+{
+    const size_t elements = 1000;
+    int data[elements];
+    for (size_t i = 0; i < elements; ++i)
+        data[i] = i * 7;
+
+    // remove a backing store of a previous run
+    remove(HDF5_MEMORY_FILE "_0_0_0.h5");
+
+    SerialDataCollector memoryCollector(1);
+
+    DataCollector::FileCreationAttr attr;
+    DataCollector::initFileCreationAttr(attr);
+    attr.fileAccType = DataCollector::FAT_CREATE_INMEMORY;
+
+    memoryCollector.open(HDF5_MEMORY_FILE, attr);
+    memoryCollector.write(3, ctInt, 1, Selection(Dimensions(elements, 1, 1)), "data", data);
+
+    // the image includes the updated header
+    size_t image_size = memoryCollector.getFileImage(NULL, 0);
+    CPPUNIT_ASSERT(image_size > elements * sizeof (int));
+
+    std::vector<char> image(image_size);
+    CPPUNIT_ASSERT_THROW(memoryCollector.getFileImage(&(image[0]), image_size / 2),
+            DCException);
+    CPPUNIT_ASSERT(memoryCollector.getFileImage(&(image[0]), image.size()) == image_size);
+    CPPUNIT_ASSERT_THROW(memoryCollector.mapDataset(3, "data"), DCException);
+    memoryCollector.close();
+
+    // nothing has been written to disk
+    struct stat file_info;
+    CPPUNIT_ASSERT(stat(HDF5_MEMORY_FILE "_0_0_0.h5", &file_info) != 0);
+
+    // read from the file image
+    SerialDataCollector imageCollector(1);
+    imageCollector.openImage(&(image[0]), image.size());
+    image.clear();
+
+    CPPUNIT_ASSERT(imageCollector.getMaxID() == 3);
+
+    int read_data[elements];
+    Dimensions data_size;
+    imageCollector.read(3, "data", data_size, read_data);
+    CPPUNIT_ASSERT(data_size == Dimensions(elements, 1, 1));
+    for (size_t i = 0; i < elements; ++i)
+        CPPUNIT_ASSERT(read_data[i] == data[i]);
+
+    CPPUNIT_ASSERT_THROW(imageCollector.write(4, ctInt, 1,
+            Selection(Dimensions(elements, 1, 1)), "data", data), DCException);
+    CPPUNIT_ASSERT_THROW(imageCollector.openImage(read_data, sizeof (read_data)), DCException);
+    imageCollector.close();
+
+    // invalid images
+    CPPUNIT_ASSERT_THROW(imageCollector.openImage(NULL, 0), DCException);
+    CPPUNIT_ASSERT_THROW(imageCollector.openImage(read_data, sizeof (read_data)), DCException);
+
+    // in-memory file with backing store
+    attr.backingStore = true;
+    memoryCollector.open(HDF5_MEMORY_FILE, attr);
+    memoryCollector.write(5, ctInt, 1, Selection(Dimensions(elements, 1, 1)), "data", data);
+    memoryCollector.close();
+
+    attr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_MEMORY_FILE, attr);
+    CPPUNIT_ASSERT(dataCollector->getMaxID() == 5);
+    dataCollector->read(5, "data", data_size, read_data);
+    CPPUNIT_ASSERT(read_data[elements - 1] == data[elements - 1]);
+    dataCollector->close();
+}
@@ -0,0 +1,206 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MappedDataTest.h"
+
+#include <string.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MappedDataTest);
+
+#define HDF5_FILE "h5/testMappedData"
+
+using namespace splash;
+
+MappedDataTest::MappedDataTest()
+{
+    dataCollector = new SerialDataCollector(10);
+}
+
+MappedDataTest::~MappedDataTest()
+{
+    if (dataCollector != NULL)
+    {
+        delete dataCollector;
+        dataCollector = NULL;
+    }
+}
+
+void MappedDataTest::testMapGrid()
+{
+    Dimensions size(13, 7, 5);
+    const size_t elements = size.getScalarSize();
+
+    int64_t *ints = new int64_t[elements];
+    double *doubles = new double[elements * 3];
+    for (size_t i = 0; i < elements; ++i)
+    {
+        ints[i] = ((int64_t) i - 100) * 1000003;
+        for (size_t j = 0; j < 3; ++j)
+            doubles[i * 3 + j] = (double) i + j * 0.25;
+    }
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    fileCAttr.contiguousLayout = true;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ColTypeInt64(), 3, Selection(size), "ints", ints);
+    dataCollector->write(0, ColTypeDouble3(), 2, Selection(Dimensions(65, 7, 1)),
+            "deep/doubles", doubles);
+
+    // mapping while writing flushes the file first
+    MappedData *mapped = dataCollector->mapDataset(0, "ints");
+    CPPUNIT_ASSERT(mapped->getSize() == size);
+    CPPUNIT_ASSERT(mapped->getNDims() == 3);
+    CPPUNIT_ASSERT(mapped->getDataType() == DCDT_INT64);
+    CPPUNIT_ASSERT(mapped->getTypeSize() == sizeof (int64_t));
+    CPPUNIT_ASSERT(memcmp(mapped->getData(), ints, elements * sizeof (int64_t)) == 0);
+    dataCollector->close();
+
+    // the mapping stays valid after closing the file
+    const int64_t *element = (const int64_t*) mapped->getElement(Dimensions(4, 3, 2));
+    CPPUNIT_ASSERT(*element == ints[(2 * size[1] + 3) * size[0] + 4]);
+    CPPUNIT_ASSERT_THROW(mapped->getElement(Dimensions(13, 0, 0)), DCException);
+    CPPUNIT_ASSERT_THROW(mapped->getElement(Dimensions(0, 0, 5)), DCException);
+    delete mapped;
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    mapped = dataCollector->mapDataset(0, "deep/doubles");
+    CPPUNIT_ASSERT(mapped->getSize() == Dimensions(65, 7, 1));
+    CPPUNIT_ASSERT(mapped->getNDims() == 2);
+    CPPUNIT_ASSERT(mapped->getTypeSize() == 3 * sizeof (double));
+
+    const double *mapped_doubles = (const double*) mapped->getData();
+    for (size_t i = 0; i < elements * 3; ++i)
+        CPPUNIT_ASSERT(mapped_doubles[i] == doubles[i]);
+
+    const double *last = (const double*) mapped->getElement(Dimensions(64, 6, 0));
+    CPPUNIT_ASSERT(last[2] == doubles[elements * 3 - 1]);
+    delete mapped;
+
+    CPPUNIT_ASSERT_THROW(dataCollector->mapDataset(0, "missing"), DCException);
+    CPPUNIT_ASSERT_THROW(dataCollector->mapDataset(0, NULL), DCException);
+
+    dataCollector->close();
+
+    CPPUNIT_ASSERT_THROW(dataCollector->mapDataset(0, "ints"), DCException);
+
+    delete[] ints;
+    delete[] doubles;
+}
+
+void MappedDataTest::testMapDomain()
+{
+    Dimensions size(32, 16, 1);
+    const size_t elements = size.getScalarSize();
+
+    float *data = new float[elements];
+    for (size_t i = 0; i < elements; ++i)
+        data[i] = (float) i * 0.5f;
+
+    DomainCollector *domainCollector = new DomainCollector(10);
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    fileCAttr.contiguousLayout = true;
+    domainCollector->open(HDF5_FILE, fileCAttr);
+
+    Domain domain(Dimensions(0, 0, 0), size);
+    domainCollector->writeDomain(1, ColTypeFloat(), 2, Selection(size), "grid",
+            domain, domain, IDomainCollector::GridType, data);
+    domainCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    domainCollector->open(HDF5_FILE, fileCAttr);
+
+    MappedData *mapped = domainCollector->mapDataset(1, "grid");
+    CPPUNIT_ASSERT(mapped->getSize() == size);
+    CPPUNIT_ASSERT(mapped->getDataType() == DCDT_FLOAT32);
+    CPPUNIT_ASSERT(memcmp(mapped->getData(), data, elements * sizeof (float)) == 0);
+    delete mapped;
+
+    domainCollector->close();
+    delete domainCollector;
+
+    delete[] data;
+}
+
+void MappedDataTest::testMapUnsupported()
+{
+    Dimensions size(100, 10, 1);
+    const size_t elements = size.getScalarSize();
+
+    float *data = new float[elements];
+    for (size_t i = 0; i < elements; ++i)
+        data[i] = (float) i;
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+
+    // chunked layout by default
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ColTypeFloat(), 2, Selection(size), "chunked", data);
+    CPPUNIT_ASSERT_THROW(dataCollector->mapDataset(0, "chunked"), DCException);
+    dataCollector->close();
+
+    fileCAttr.contiguousLayout = true;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    // storage types and appended data cannot be mapped
+    dataCollector->write(0, ColTypeFloat16(), 2, Selection(size), "half", data);
+    dataCollector->append(0, ColTypeFloat(), elements, "appended", data);
+    dataCollector->write(0, ColTypeFloat(), 3, Selection(Dimensions(0, 0, 0)), "empty", NULL);
+    dataCollector->close();
+
+    fileCAttr.enableCompression = true;
+    fileCAttr.fileAccType = DataCollector::FAT_WRITE;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ColTypeFloat(), 2, Selection(size), "compressed", data);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    CPPUNIT_ASSERT_THROW(dataCollector->mapDataset(0, "half"), DCException);
+    CPPUNIT_ASSERT_THROW(dataCollector->mapDataset(0, "appended"), DCException);
+    CPPUNIT_ASSERT_THROW(dataCollector->mapDataset(0, "compressed"), DCException);
+
+    // empty datasets are mapped to NULL
+    MappedData *mapped = dataCollector->mapDataset(0, "empty");
+    CPPUNIT_ASSERT(mapped->getData() == NULL);
+    CPPUNIT_ASSERT(mapped->getSize().getScalarSize() == 0);
+    CPPUNIT_ASSERT_THROW(mapped->getElement(Dimensions(0, 0, 0)), DCException);
+    delete mapped;
+
+    // the file is not affected by failed mappings
+    Dimensions size_read;
+    float *buffer = new float[elements];
+    dataCollector->read(0, "half", size_read, buffer);
+    CPPUNIT_ASSERT(size_read == size);
+    CPPUNIT_ASSERT(buffer[elements - 1] == data[elements - 1]);
+
+    dataCollector->close();
+
+    delete[] data;
+    delete[] buffer;
+}
@@ -24,6 +24,7 @@
 #include <time.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 
 #include "Parallel_DomainsTest.h"
 
@@ -32,6 +33,7 @@ CPPUNIT_TEST_SUITE_REGISTRATION(Parallel_DomainsTest);
 const char* hdf5_file_grid = "h5/testDomainsGridParallel";
 const char* hdf5_file_poly = "h5/testDomainsPolyParallel";
 const char* hdf5_file_append = "h5/testDomainsAppendParallel";
+const char* hdf5_file_distributed = "h5/testDomainsDistributedParallel";
 
 #define MPI_CHECK(cmd) \
         { \
@@ -595,3 +597,134 @@ void Parallel_DomainsTest::testAppendDomains()
 
     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 }
+
+void Parallel_DomainsTest::testReadDistributed()
+{
+    const Dimensions mpi_size(totalMpiSize, 1, 1);
+    const Dimensions local_grid_size(10, 5, 3);
+    const Dimensions global_grid_size = mpi_size * local_grid_size;
+    const Dimensions global_domain_offset(3, 11, 7);
+    Dimensions mpi_position;
+    indexToPos(myMpiRank, mpi_size, mpi_position);
+
+    ParallelDomainCollector *pdc =
+            new ParallelDomainCollector(MPI_COMM_WORLD, MPI_INFO_NULL, mpi_size, 1);
+    DataCollector::FileCreationAttr fAttr;
+    DataCollector::initFileCreationAttr(fAttr);
+    fAttr.fileAccType = DataCollector::FAT_CREATE;
+
+    pdc->open(hdf5_file_distributed, fAttr);
+
+    // grid data, each element holds its global position
+    const Dimensions local_offset = mpi_position * local_grid_size;
+    int *grid_data = new int[local_grid_size.getScalarSize()];
+    for (size_t z = 0; z < local_grid_size[2]; ++z)
+        for (size_t y = 0; y < local_grid_size[1]; ++y)
+            for (size_t x = 0; x < local_grid_size[0]; ++x)
+            {
+                size_t index = (z * local_grid_size[1] + y) * local_grid_size[0] + x;
+                grid_data[index] = (local_offset[0] + x) +
+                        1000 * (local_offset[1] + y) + 100000 * (local_offset[2] + z);
+            }
+
+    pdc->writeDomain(10, ctInt, 3, Selection(local_grid_size), "grid_data",
+            Domain(local_offset, local_grid_size),
+            Domain(global_domain_offset, global_grid_size),
+            IDomainCollector::GridType, grid_data);
+
+    delete[] grid_data;
+
+    // poly data, each process writes (rank + 1) elements
+    const size_t poly_elements = myMpiRank + 1;
+    float *poly_data = new float[poly_elements];
+    for (size_t i = 0; i < poly_elements; ++i)
+        poly_data[i] = (float) myMpiRank;
+
+    pdc->writeDomain(10, ctFloat, 1, Selection(Dimensions(poly_elements, 1, 1)), "poly_data",
+            Domain(local_offset, local_grid_size),
+            Domain(global_domain_offset, global_grid_size),
+            IDomainCollector::PolyType, poly_data);
+
+    delete[] poly_data;
+
+    pdc->close();
+
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+    fAttr.fileAccType = DataCollector::FAT_READ;
+    pdc->open(hdf5_file_distributed, fAttr);
+
+    // request a domain shifted by half a process domain
+    Dimensions request_offset = local_offset;
+    request_offset[0] += local_grid_size[0] / 2;
+    Domain request(global_domain_offset + request_offset, local_grid_size);
+
+    IDomainCollector::DomDataClass data_class = IDomainCollector::UndefinedType;
+    DataContainer *container = pdc->readDomainDistributed(10, "grid_data",
+            request, &data_class);
+
+    CPPUNIT_ASSERT(container);
+    CPPUNIT_ASSERT(data_class == IDomainCollector::GridType);
+    CPPUNIT_ASSERT(container->getNumSubdomains() == 1);
+
+    // the request is clipped to the dataset domain
+    Dimensions intersection_size(local_grid_size);
+    intersection_size[0] = std::min(request_offset[0] + local_grid_size[0],
+            global_grid_size[0]) - request_offset[0];
+    CPPUNIT_ASSERT(container->getIndex(0)->getSize() == intersection_size);
+    CPPUNIT_ASSERT(container->getIndex(0)->getOffset() ==
+            global_domain_offset + request_offset);
+
+    int *data = (int*) (container->getIndex(0)->getData());
+    for (size_t z = 0; z < intersection_size[2]; ++z)
+        for (size_t y = 0; y < intersection_size[1]; ++y)
+            for (size_t x = 0; x < intersection_size[0]; ++x)
+            {
+                size_t index = (z * intersection_size[1] + y) * intersection_size[0] + x;
+                CPPUNIT_ASSERT(data[index] == (int) ((request_offset[0] + x) +
+                        1000 * (request_offset[1] + y) + 100000 * (request_offset[2] + z)));
+            }
+
+    delete container;
+
+    // even processes request the complete poly data and share its elements,
+    // odd processes request a domain outside of the dataset
+    if (myMpiRank % 2 == 0)
+        request = Domain(global_domain_offset, global_grid_size);
+    else
+        request = Domain(global_domain_offset + global_grid_size, local_grid_size);
+
+    container = pdc->readDomainDistributed(10, "poly_data", request, &data_class);
+
+    CPPUNIT_ASSERT(container);
+    CPPUNIT_ASSERT(data_class == IDomainCollector::PolyType);
+
+    const size_t total_elements = totalMpiSize * (totalMpiSize + 1) / 2;
+    const size_t num_targets = (totalMpiSize + 1) / 2;
+    const size_t target = myMpiRank / 2;
+    const size_t first = total_elements * target / num_targets;
+    const size_t last = total_elements * (target + 1) / num_targets;
+
+    if (myMpiRank % 2 == 0 && last > first)
+    {
+        CPPUNIT_ASSERT(container->getNumSubdomains() == 1);
+        CPPUNIT_ASSERT(container->getNumElements() == last - first);
+
+        float *poly_read = (float*) (container->getIndex(0)->getData());
+        size_t index = 0;
+        for (int r = 0; r < totalMpiSize; ++r)
+            for (int i = 0; i <= r; ++i, ++index)
+                if (index >= first && index < last)
+                    CPPUNIT_ASSERT(poly_read[index - first] == (float) r);
+    } else
+        CPPUNIT_ASSERT(container->getNumSubdomains() == 0);
+
+    delete container;
+
+    pdc->close();
+
+    delete pdc;
+    pdc = NULL;
+
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+}
@@ -26,6 +26,7 @@
 #include <iostream>
 #include <sstream>
 #include <stdlib.h>
+#include <stdio.h>
 #include <cppunit/TestAssert.h>
 #include <vector>
 
@@ -128,3 +129,64 @@ void Parallel_ListFilesTest::testListFiles()
     delete dataCollector;
     delete[] tmp_ids;
 }
+
+void Parallel_ListFilesTest::testListFilesChanged()
+{
+    DataCollector::FileCreationAttr attr;
+    DataCollector::initFileCreationAttr(attr);
+
+    IParallelDataCollector *dataCollector = new ParallelDataCollector(
+            MPI_COMM_WORLD, MPI_INFO_NULL, Dimensions(MPI_SIZE_X, 1, 1), 1);
+
+    std::stringstream fileName;
+    fileName << TEST_FILE << "_changed_" << time(NULL);
+
+    int32_t dummy_data = 0;
+    size_t num_ids = 0;
+    dataCollector->open(fileName.str().c_str(), attr);
+    dataCollector->write(10, ctInt, 1, Dimensions(1, 1, 1), "data", &dummy_data);
+    dataCollector->getEntryIDs(NULL, &num_ids);
+    CPPUNIT_ASSERT(num_ids == 1);
+
+    /* files created by this collector are listed */
+    dataCollector->write(20, ctInt, 1, Dimensions(1, 1, 1), "data", &dummy_data);
+    dataCollector->getEntryIDs(NULL, &num_ids);
+    CPPUNIT_ASSERT(num_ids == 2);
+    CPPUNIT_ASSERT(dataCollector->getMaxID() == 20);
+
+    /* files created outside of the collector are detected */
+    if (mpiRank == 0)
+    {
+        std::stringstream extFileName;
+        extFileName << fileName.str() << "_30.h5";
+        FILE *extFile = fopen(extFileName.str().c_str(), "w");
+        CPPUNIT_ASSERT(extFile != NULL);
+        fclose(extFile);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    dataCollector->getEntryIDs(NULL, &num_ids);
+    CPPUNIT_ASSERT(num_ids == 3);
+    CPPUNIT_ASSERT(dataCollector->getMaxID() == 30);
+
+    /* the maximum id is reset if all files have been removed */
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (mpiRank == 0)
+    {
+        const int32_t file_ids[3] = {10, 20, 30};
+        for (int i = 0; i < 3; ++i)
+        {
+            std::stringstream rmFileName;
+            rmFileName << fileName.str() << "_" << file_ids[i] << ".h5";
+            CPPUNIT_ASSERT(remove(rmFileName.str().c_str()) == 0);
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    CPPUNIT_ASSERT(dataCollector->getMaxID() == -1);
+
+    dataCollector->close();
+
+    dataCollector->finalize();
+    delete dataCollector;
+}
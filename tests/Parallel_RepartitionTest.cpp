@@ -0,0 +1,286 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <mpi.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "Parallel_RepartitionTest.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(Parallel_RepartitionTest);
+
+#define HDF5_FILE "h5/testRepartition"
+#define ITERATION 10
+
+using namespace splash;
+
+static const Dimensions local_size(5, 4, 0);
+static const Dimensions global_offset(3, 5, 7);
+
+static size_t getNumParticles(const Dimensions filePos)
+{
+    return 2 + filePos[0] + 3 * filePos[1];
+}
+
+Parallel_RepartitionTest::Parallel_RepartitionTest() :
+ctInt(),
+ctFloat()
+{
+    int initialized;
+    MPI_Initialized(&initialized);
+    if (!initialized)
+        MPI_Init(NULL, NULL);
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+}
+
+Parallel_RepartitionTest::~Parallel_RepartitionTest()
+{
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized)
+        MPI_Finalize();
+}
+
+void Parallel_RepartitionTest::writeFiles()
+{
+    const Dimensions old_topology(2, mpiSize, 1);
+    const Dimensions file_size(local_size[0], local_size[1], mpiSize);
+    const Dimensions global_size = old_topology * file_size;
+
+    // files of a previous test might still be read by other processes
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    int *grid_data = new int[file_size.getScalarSize()];
+
+    for (size_t fx = 0; fx < 2; ++fx)
+    {
+        const Dimensions file_pos(fx, mpiRank, 0);
+        const Dimensions file_offset = file_pos * file_size;
+
+        DomainCollector dc(1);
+        DataCollector::FileCreationAttr fAttr;
+        DataCollector::initFileCreationAttr(fAttr);
+        fAttr.fileAccType = DataCollector::FAT_CREATE;
+        fAttr.mpiPosition.set(file_pos);
+        fAttr.mpiSize.set(old_topology);
+
+        dc.open(HDF5_FILE, fAttr);
+
+        // grid data, each element holds its global position
+        for (size_t z = 0; z < file_size[2]; ++z)
+            for (size_t y = 0; y < file_size[1]; ++y)
+                for (size_t x = 0; x < file_size[0]; ++x)
+                {
+                    size_t index = (z * file_size[1] + y) * file_size[0] + x;
+                    grid_data[index] = (file_offset[0] + x) +
+                            1000 * (file_offset[1] + y) + 100000 * (file_offset[2] + z);
+                }
+
+        dc.writeDomain(ITERATION, ctInt, 3, Selection(file_size), "grid",
+                Domain(file_offset, file_size), Domain(global_offset, global_size),
+                IDomainCollector::GridType, grid_data);
+
+        // particles with unique ids and positions within the file domain
+        const size_t num_particles = getNumParticles(file_pos);
+        int *ids = new int[num_particles];
+        float *pos[3];
+        for (uint32_t d = 0; d < 3; ++d)
+            pos[d] = new float[num_particles];
+
+        for (size_t i = 0; i < num_particles; ++i)
+        {
+            ids[i] = (fx + 2 * mpiRank) * 1000 + i;
+            pos[0][i] = global_offset[0] + file_offset[0] + fmod(i * 1.7f, file_size[0]);
+            pos[1][i] = global_offset[1] + file_offset[1] + fmod(i * 0.9f, file_size[1]);
+            pos[2][i] = global_offset[2] + file_offset[2] + fmod(i * 0.3f, file_size[2]);
+        }
+
+        // the last particle lies on the upper boundary of the global domain
+        pos[2][num_particles - 1] = global_offset[2] + global_size[2];
+
+        // z positions split into global cell index and cell-relative position
+        int *cell_z = new int[num_particles];
+        float *rel_z = new float[num_particles];
+        for (size_t i = 0; i < num_particles; ++i)
+        {
+            cell_z[i] = (int) floor(pos[2][i]);
+            rel_z[i] = pos[2][i] - cell_z[i];
+        }
+
+        const char *pos_names[3] = {"pos/x", "pos/y", "pos/z"};
+        const Selection poly_select(Dimensions(num_particles, 1, 1));
+
+        dc.writeDomain(ITERATION, ctInt, 1, poly_select, "ids",
+                Domain(file_offset, file_size), Domain(global_offset, global_size),
+                IDomainCollector::PolyType, ids);
+
+        for (uint32_t d = 0; d < 3; ++d)
+        {
+            dc.writeDomain(ITERATION, ctFloat, 1, poly_select, pos_names[d],
+                    Domain(file_offset, file_size), Domain(global_offset, global_size),
+                    IDomainCollector::PolyType, pos[d]);
+            delete[] pos[d];
+        }
+
+        dc.writeDomain(ITERATION, ctInt, 1, poly_select, "cell/z",
+                Domain(file_offset, file_size), Domain(global_offset, global_size),
+                IDomainCollector::PolyType, cell_z);
+        dc.writeDomain(ITERATION, ctFloat, 1, poly_select, "rel/z",
+                Domain(file_offset, file_size), Domain(global_offset, global_size),
+                IDomainCollector::PolyType, rel_z);
+
+        delete[] cell_z;
+        delete[] rel_z;
+        delete[] ids;
+        dc.close();
+    }
+
+    delete[] grid_data;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+void Parallel_RepartitionTest::testRepartitionGrid()
+{
+    writeFiles();
+
+    // restart with a decomposition along z
+    RepartitionCollector rc(MPI_COMM_WORLD, Dimensions(1, 1, mpiSize), 1);
+    DataCollector::FileCreationAttr fAttr;
+    DataCollector::initFileCreationAttr(fAttr);
+    fAttr.fileAccType = DataCollector::FAT_READ_MERGED;
+
+    rc.open(HDF5_FILE, fAttr);
+
+    Dimensions file_topology;
+    rc.getMPISize(file_topology);
+    CPPUNIT_ASSERT(file_topology == Dimensions(2, mpiSize, 1));
+
+    const Domain box = rc.getRepartitionedDomain(ITERATION, "grid");
+    CPPUNIT_ASSERT(box.getSize() == Dimensions(2 * local_size[0], mpiSize * local_size[1], 1));
+    CPPUNIT_ASSERT(box.getOffset() == global_offset + Dimensions(0, 0, mpiRank));
+
+    IDomainCollector::DomDataClass data_class = IDomainCollector::UndefinedType;
+    DataContainer *container = rc.readRepartitioned(ITERATION, "grid", &data_class);
+
+    CPPUNIT_ASSERT(data_class == IDomainCollector::GridType);
+    CPPUNIT_ASSERT(container->getNumSubdomains() == 1);
+
+    DomainData *subdomain = container->getIndex(0);
+    CPPUNIT_ASSERT(subdomain->getSize() == box.getSize());
+
+    const Dimensions box_offset = box.getOffset() - global_offset;
+    int *data = (int*) subdomain->getData();
+    for (size_t y = 0; y < box.getSize()[1]; ++y)
+        for (size_t x = 0; x < box.getSize()[0]; ++x)
+        {
+            CPPUNIT_ASSERT(data[y * box.getSize()[0] + x] == (int) ((box_offset[0] + x) +
+                    1000 * (box_offset[1] + y) + 100000 * box_offset[2]));
+        }
+
+    delete container;
+
+    rc.close();
+    rc.finalize();
+}
+
+void Parallel_RepartitionTest::testRepartitionPoly()
+{
+    writeFiles();
+
+    RepartitionCollector rc(MPI_COMM_WORLD, Dimensions(1, 1, mpiSize), 1);
+    DataCollector::FileCreationAttr fAttr;
+    DataCollector::initFileCreationAttr(fAttr);
+    fAttr.fileAccType = DataCollector::FAT_READ_MERGED;
+
+    rc.open(HDF5_FILE, fAttr);
+
+    const Domain box = rc.getRepartitionedDomain(ITERATION, "ids");
+
+    uint64_t total_particles = 0;
+    uint64_t total_ids = 0;
+    for (size_t fy = 0; fy < (size_t) mpiSize; ++fy)
+        for (size_t fx = 0; fx < 2; ++fx)
+        {
+            const size_t num_particles = getNumParticles(Dimensions(fx, fy, 0));
+            total_particles += num_particles;
+            for (size_t i = 0; i < num_particles; ++i)
+                total_ids += (fx + 2 * fy) * 1000 + i;
+        }
+
+    // re-bucketing by position
+    const char *pos_names[3] = {"pos/x", "pos/y", "pos/z"};
+    IDomainCollector::DomDataClass data_class = IDomainCollector::UndefinedType;
+    DataContainer *ids = rc.readRepartitioned(ITERATION, "ids", &data_class, pos_names);
+    DataContainer *pos_z = rc.readRepartitioned(ITERATION, "pos/z", NULL, pos_names);
+
+    CPPUNIT_ASSERT(data_class == IDomainCollector::PolyType);
+    CPPUNIT_ASSERT(ids->getNumElements() == pos_z->getNumElements());
+
+    // the last box includes the upper boundary
+    const bool last_box = (mpiRank == mpiSize - 1);
+    uint64_t local_counts[2] = {ids->getNumElements(), 0};
+    for (size_t i = 0; i < ids->getNumElements(); ++i)
+    {
+        float z = *((float*) pos_z->getElement(i));
+        const float box_end = box.getOffset()[2] + box.getSize()[2];
+        CPPUNIT_ASSERT(z >= box.getOffset()[2] && (z < box_end || (last_box && z == box_end)));
+        local_counts[1] += *((int*) ids->getElement(i));
+    }
+
+    uint64_t global_counts[2] = {0, 0};
+    MPI_Allreduce(local_counts, global_counts, 2, MPI_UNSIGNED_LONG_LONG,
+            MPI_SUM, MPI_COMM_WORLD);
+
+    CPPUNIT_ASSERT(global_counts[0] == total_particles);
+    CPPUNIT_ASSERT(global_counts[1] == total_ids);
+
+    // positions as the sum of cell-relative positions and cell indices
+    const char *rel_names[3] = {"pos/x", "pos/y", "rel/z"};
+    const char *cell_names[3] = {NULL, NULL, "cell/z"};
+    DataContainer *rel_ids = rc.readRepartitioned(ITERATION, "ids", NULL,
+            rel_names, cell_names);
+
+    CPPUNIT_ASSERT(rel_ids->getNumElements() == ids->getNumElements());
+    for (size_t i = 0; i < ids->getNumElements(); ++i)
+        CPPUNIT_ASSERT(*((int*) rel_ids->getElement(i)) == *((int*) ids->getElement(i)));
+
+    delete rel_ids;
+    delete ids;
+    delete pos_z;
+
+    // without positions, every file is read by exactly one process
+    ids = rc.readRepartitioned(ITERATION, "ids", NULL);
+
+    local_counts[0] = ids->getNumElements();
+    MPI_Allreduce(local_counts, global_counts, 1, MPI_UNSIGNED_LONG_LONG,
+            MPI_SUM, MPI_COMM_WORLD);
+
+    CPPUNIT_ASSERT(global_counts[0] == total_particles);
+
+    delete ids;
+
+    rc.close();
+    rc.finalize();
+}
@@ -515,3 +515,340 @@ void Parallel_SimpleDataTest::testFill()
 
     MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
 }
+
+void Parallel_SimpleDataTest::testDeclared()
+{
+    const int32_t iteration = 100;
+    const size_t elements = 10;
+    const Dimensions mpi_size(totalMpiSize, 1, 1);
+    const Dimensions local_size(elements, 1, 1);
+    const Dimensions global_size(elements * totalMpiSize, 1, 1);
+    const Dimensions global_offset(elements * myMpiRank, 0, 0);
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    fileCAttr.fileAccType = DataCollector::FAT_CREATE;
+
+    parallelDataCollector = new ParallelDataCollector(MPI_COMM_WORLD,
+            MPI_INFO_NULL, mpi_size, 1);
+    parallelDataCollector->open(HDF5_FILE, fileCAttr);
+
+    parallelDataCollector->declare(iteration, global_size, 1, ctInt, "declared/first");
+    parallelDataCollector->declare(iteration, global_size, 1, ctInt, "declared/second");
+
+    // declared datasets keep the storage datatype
+    ColTypeFloat16 ctFloat16;
+    parallelDataCollector->declare(iteration, global_size, 1, ctFloat16, "declared/half");
+    parallelDataCollector->createDeclared(iteration);
+
+    int data_write[elements];
+    for (size_t i = 0; i < elements; ++i)
+        data_write[i] = myMpiRank + 1;
+
+    parallelDataCollector->write(iteration, global_size, global_offset, ctInt, 1,
+            Selection(local_size), "declared/first", data_write);
+    parallelDataCollector->write(iteration, global_size, global_offset, ctInt, 1,
+            Selection(local_size), "declared/second", data_write);
+
+    float half_write[elements];
+    for (size_t i = 0; i < elements; ++i)
+        half_write[i] = myMpiRank + 0.5f;
+
+    parallelDataCollector->write(iteration, global_size, global_offset, ctFloat16, 1,
+            Selection(local_size), "declared/half", half_write);
+
+    // writes must match the declared global size
+    CPPUNIT_ASSERT_THROW(parallelDataCollector->write(iteration,
+            Dimensions(global_size[0] + 1, 1, 1), global_offset, ctInt, 1,
+            Selection(local_size), "declared/first", data_write), DCException);
+    parallelDataCollector->close();
+
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+    // read back using SerialDataCollector
+    if (myMpiRank == 0)
+    {
+        std::stringstream filename_stream;
+        filename_stream << HDF5_FILE << "_" << iteration << ".h5";
+
+        fileCAttr.fileAccType = DataCollector::FAT_READ;
+        DataCollector *dataCollector = new SerialDataCollector(1);
+        dataCollector->open(filename_stream.str().c_str(), fileCAttr);
+
+        int *data_read = new int[global_size.getScalarSize()];
+        const char *names[2] = {"declared/first", "declared/second"};
+
+        for (int n = 0; n < 2; ++n)
+        {
+            Dimensions size_read;
+            memset(data_read, 0, sizeof (int) * global_size.getScalarSize());
+            dataCollector->read(iteration, names[n], size_read, data_read);
+
+            CPPUNIT_ASSERT(size_read == global_size);
+            for (size_t i = 0; i < global_size.getScalarSize(); ++i)
+                CPPUNIT_ASSERT(data_read[i] == (int) (i / elements) + 1);
+        }
+
+        // stored with 2 bytes per element, read as float
+        hid_t file = H5Fopen(filename_stream.str().c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        hid_t dataset = H5Dopen(file, "/data/100/declared/half", H5P_DEFAULT);
+        hid_t datatype = H5Dget_type(dataset);
+        CPPUNIT_ASSERT(H5Tget_size(datatype) == 2);
+        H5Tclose(datatype);
+        H5Dclose(dataset);
+        H5Fclose(file);
+
+        float *half_read = new float[global_size.getScalarSize()];
+        Dimensions size_read;
+        dataCollector->read(iteration, "declared/half", size_read, half_read);
+
+        CPPUNIT_ASSERT(size_read == global_size);
+        for (size_t i = 0; i < global_size.getScalarSize(); ++i)
+            CPPUNIT_ASSERT(half_read[i] == (float) (i / elements) + 0.5f);
+
+        delete[] half_read;
+        delete[] data_read;
+        dataCollector->close();
+        delete dataCollector;
+    }
+
+    parallelDataCollector->finalize();
+    delete parallelDataCollector;
+    parallelDataCollector = NULL;
+
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+}
+
+void Parallel_SimpleDataTest::testCompression()
+{
+    const int32_t iteration = 101;
+    const Dimensions mpi_size(totalMpiSize, 1, 1);
+    const Dimensions grid_size(16, 8, 4);
+    const Dimensions full_grid_size(grid_size * mpi_size);
+
+    Dimensions mpi_pos;
+    indexToPos(myMpiRank, mpi_size, mpi_pos);
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    fileCAttr.fileAccType = DataCollector::FAT_CREATE;
+    fileCAttr.enableCompression = true;
+
+    parallelDataCollector = new ParallelDataCollector(MPI_COMM_WORLD,
+            MPI_INFO_NULL, mpi_size, 1);
+    parallelDataCollector->open(HDF5_FILE, fileCAttr);
+
+    int *data_write = new int[grid_size.getScalarSize()];
+    for (size_t i = 0; i < grid_size.getScalarSize(); ++i)
+        data_write[i] = myMpiRank + 1;
+
+    parallelDataCollector->write(iteration, ctInt, 3, grid_size,
+            "compressed/data", data_write);
+    parallelDataCollector->close();
+
+    delete[] data_write;
+
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+    // read back the block of this process
+    int *data_read = new int[grid_size.getScalarSize()];
+    memset(data_read, 0, sizeof (int) * grid_size.getScalarSize());
+
+    Dimensions size_read;
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    parallelDataCollector->open(HDF5_FILE, fileCAttr);
+    ((ParallelDataCollector*) parallelDataCollector)->read(iteration, grid_size,
+            grid_size * mpi_pos, "compressed/data", size_read, data_read);
+    parallelDataCollector->close();
+
+    CPPUNIT_ASSERT(size_read == grid_size);
+    for (size_t i = 0; i < grid_size.getScalarSize(); ++i)
+        CPPUNIT_ASSERT(data_read[i] == myMpiRank + 1);
+
+    delete[] data_read;
+
+    // read back everything using SerialDataCollector
+    if (myMpiRank == 0)
+    {
+        std::stringstream filename_stream;
+        filename_stream << HDF5_FILE << "_" << iteration << ".h5";
+
+        data_read = new int[full_grid_size.getScalarSize()];
+
+        DataCollector *dataCollector = new SerialDataCollector(1);
+        dataCollector->open(filename_stream.str().c_str(), fileCAttr);
+        dataCollector->read(iteration, "compressed/data", size_read, data_read);
+        dataCollector->close();
+        delete dataCollector;
+
+        CPPUNIT_ASSERT(size_read == full_grid_size);
+        CPPUNIT_ASSERT(testData(mpi_size, grid_size, data_read));
+
+        delete[] data_read;
+    }
+
+    parallelDataCollector->finalize();
+    delete parallelDataCollector;
+    parallelDataCollector = NULL;
+
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+}
+
+void Parallel_SimpleDataTest::testReserveAndAppend()
+{
+    const int32_t iteration = 102;
+    const size_t num_appends = 3;
+    const Dimensions mpi_size(totalMpiSize, 1, 1);
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    fileCAttr.fileAccType = DataCollector::FAT_CREATE;
+
+    parallelDataCollector = new ParallelDataCollector(MPI_COMM_WORLD,
+            MPI_INFO_NULL, mpi_size, 1);
+    parallelDataCollector->open(HDF5_FILE, fileCAttr);
+
+    // all processes, every other process, no process
+    size_t counts[num_appends] = {myMpiRank + 1,
+        (myMpiRank % 2 == 0) ? 5 : 0, 0};
+    size_t total_size = 0;
+    size_t offsets[num_appends];
+
+    for (size_t n = 0; n < num_appends; ++n)
+    {
+        int *data_write = new int[counts[n] + 1];
+        for (size_t i = 0; i < counts[n]; ++i)
+            data_write[i] = (n + 1) * 1000 + myMpiRank;
+
+        Dimensions global_offset;
+        parallelDataCollector->reserveAndAppend(iteration, ctInt, counts[n],
+                "appended/data", data_write, &global_offset);
+        offsets[n] = global_offset[0];
+
+        for (int r = 0; r < totalMpiSize; ++r)
+        {
+            size_t count = (n == 0) ? r + 1 : ((n == 1 && r % 2 == 0) ? 5 : 0);
+            if (r == myMpiRank)
+                CPPUNIT_ASSERT(offsets[n] == total_size);
+            total_size += count;
+        }
+
+        delete[] data_write;
+    }
+
+    // appending another datatype fails on all processes
+    ColTypeFloat ctFloat;
+    float float_write = 1.0f;
+    CPPUNIT_ASSERT_THROW(parallelDataCollector->reserveAndAppend(iteration, ctFloat, 1,
+            "appended/data", &float_write, NULL), DCException);
+    parallelDataCollector->close();
+
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+
+    // read back using SerialDataCollector
+    std::stringstream filename_stream;
+    filename_stream << HDF5_FILE << "_" << iteration << ".h5";
+
+    // chunks do not depend on the size of the first append
+    hid_t file = H5Fopen(filename_stream.str().c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t dataset = H5Dopen(file, "/data/102/appended/data", H5P_DEFAULT);
+    hid_t dcpl = H5Dget_create_plist(dataset);
+    hsize_t chunk_dims = 0;
+    CPPUNIT_ASSERT(H5Pget_chunk(dcpl, 1, &chunk_dims) == 1);
+    CPPUNIT_ASSERT(chunk_dims == PDC_APPEND_CHUNK_SIZE / sizeof (int));
+    H5Pclose(dcpl);
+    H5Dclose(dataset);
+    H5Fclose(file);
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    DataCollector *dataCollector = new SerialDataCollector(1);
+    dataCollector->open(filename_stream.str().c_str(), fileCAttr);
+
+    int *data_read = new int[total_size];
+    Dimensions size_read;
+    dataCollector->read(iteration, "appended/data", size_read, data_read);
+    CPPUNIT_ASSERT(size_read == Dimensions(total_size, 1, 1));
+
+    for (size_t n = 0; n < num_appends; ++n)
+        for (size_t i = 0; i < counts[n]; ++i)
+            CPPUNIT_ASSERT(data_read[offsets[n] + i] == (int) ((n + 1) * 1000 + myMpiRank));
+
+    delete[] data_read;
+    dataCollector->close();
+    delete dataCollector;
+
+    parallelDataCollector->finalize();
+    delete parallelDataCollector;
+    parallelDataCollector = NULL;
+
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+}
+
+void Parallel_SimpleDataTest::testComponents()
+{
+    const int32_t iteration = 103;
+    const Dimensions mpi_size(totalMpiSize, 1, 1);
+
+    // more than one slab for all but the first process
+    const size_t elements_per_rank = 200000;
+    const size_t local_elements = (myMpiRank + 1) * elements_per_rank;
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    fileCAttr.fileAccType = DataCollector::FAT_CREATE;
+
+    parallelDataCollector = new ParallelDataCollector(MPI_COMM_WORLD,
+            MPI_INFO_NULL, mpi_size, 1);
+    parallelDataCollector->open(HDF5_FILE, fileCAttr);
+
+    int *components[3];
+    for (size_t c = 0; c < 3; ++c)
+    {
+        components[c] = new int[local_elements];
+        for (size_t i = 0; i < local_elements; ++i)
+            components[c][i] = myMpiRank * 10 + c;
+    }
+
+    parallelDataCollector->writeComponents(iteration, ColTypeInt3(), 1,
+            Selection(Dimensions(local_elements, 1, 1)), "components/data",
+            (const void* const*) components);
+    parallelDataCollector->close();
+
+    for (size_t c = 0; c < 3; ++c)
+        delete[] components[c];
+
+    // read back all data into separate buffers
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    parallelDataCollector->open(HDF5_FILE, fileCAttr);
+
+    Dimensions size_read;
+    parallelDataCollector->readComponents(iteration, ctInt, "components/data",
+            Dimensions(0, 0, 0), Dimensions(0, 0, 0), size_read, NULL);
+
+    const size_t global_elements = elements_per_rank * totalMpiSize * (totalMpiSize + 1) / 2;
+    CPPUNIT_ASSERT(size_read == Dimensions(global_elements, 1, 1));
+
+    int *read_components[3];
+    for (size_t c = 0; c < 3; ++c)
+        read_components[c] = new int[global_elements];
+
+    parallelDataCollector->readComponents(iteration, ctInt, "components/data",
+            Dimensions(0, 0, 0), Dimensions(0, 0, 0), size_read,
+            (void* const*) read_components);
+    parallelDataCollector->close();
+
+    size_t index = 0;
+    for (int r = 0; r < totalMpiSize; ++r)
+        for (size_t i = 0; i < (r + 1) * elements_per_rank; ++i, ++index)
+            for (size_t c = 0; c < 3; ++c)
+                CPPUNIT_ASSERT(read_components[c][index] == (int) (r * 10 + c));
+
+    for (size_t c = 0; c < 3; ++c)
+        delete[] read_components[c];
+
+    parallelDataCollector->finalize();
+    delete parallelDataCollector;
+    parallelDataCollector = NULL;
+
+    MPI_CHECK(MPI_Barrier(MPI_COMM_WORLD));
+}
@@ -23,12 +23,19 @@
 
 #include <time.h>
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <vector>
+#include <algorithm>
 
 #include "RemoveTest.h"
+#include "splash/core/DCRepack.hpp"
+#include "splash/core/DCChunkIO.hpp"
+#include "splash/core/DCVerifier.hpp"
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RemoveTest);
 
 #define HDF5_FILE "h5/testRemove"
+#define HDF5_REPACK_FILE "h5/testRepack"
 
 using namespace splash;
 
@@ -112,3 +119,263 @@ void RemoveTest::testRemove()
     
     CPPUNIT_ASSERT(true);
 }
+
+void RemoveTest::testRemoveIDs()
+{
+    Dimensions gridSize(16, 1, 1);
+    std::vector<int> data(gridSize.getScalarSize(), 1);
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    for (int32_t id = 0; id < 5; ++id)
+        dataCollector->write(id, ctInt, 1, gridSize, "data", &(data[0]));
+
+    dataCollector->close();
+
+    SerialDataCollector *sdc = dynamic_cast<SerialDataCollector*> (dataCollector);
+    const int32_t ids[] = {4, 1, 3};
+
+    // removing must not be possible in FAT_READ mode
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    CPPUNIT_ASSERT_THROW(sdc->removeIDs(ids, 3), DCException);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_WRITE;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    CPPUNIT_ASSERT(dataCollector->getMaxID() == 4);
+
+    sdc->removeIDs(ids, 3);
+    CPPUNIT_ASSERT(dataCollector->getMaxID() == 2);
+
+    size_t num_ids = 0;
+    dataCollector->getEntryIDs(NULL, &num_ids);
+    CPPUNIT_ASSERT(num_ids == 2);
+
+    // removing a missing iteration fails
+    CPPUNIT_ASSERT_THROW(sdc->removeIDs(ids, 1), DCException);
+    dataCollector->close();
+
+    // the new maximum ID is stored in the file
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    CPPUNIT_ASSERT(dataCollector->getMaxID() == 2);
+    dataCollector->close();
+}
+
+static size_t getFileSize(const char *filename)
+{
+    struct stat file_stat;
+    if (stat(filename, &file_stat) != 0)
+        return 0;
+
+    return file_stat.st_size;
+}
+
+void RemoveTest::testRepack()
+{
+    Dimensions gridSize(64, 32, 16);
+    std::vector<int> data(gridSize.getScalarSize());
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = i;
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    for (int32_t id = 0; id < 4; ++id)
+    {
+        dataCollector->write(id, ctInt, 3, gridSize, "fields/data", &(data[0]));
+        dataCollector->writeAttribute(id, ctInt, "fields/data", "id", &id);
+        dataCollector->createReference(id, "fields/data", id, "fields/ref");
+    }
+
+    dataCollector->close();
+
+    const int32_t ids[] = {2, 3};
+    fileCAttr.fileAccType = DataCollector::FAT_WRITE;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dynamic_cast<SerialDataCollector*> (dataCollector)->removeIDs(ids, 2);
+    dataCollector->close();
+
+    // removing iterations does not free space, copying the file does
+    DCRepack::Parameters params;
+    DCRepack::initParameters(params);
+    DCRepack::copyFile(HDF5_FILE "_0_0_0.h5", HDF5_REPACK_FILE "_0_0_0.h5", params);
+    CPPUNIT_ASSERT(getFileSize(HDF5_REPACK_FILE "_0_0_0.h5") <
+            getFileSize(HDF5_FILE "_0_0_0.h5") * 3 / 4);
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_REPACK_FILE, fileCAttr);
+    CPPUNIT_ASSERT(dataCollector->getMaxID() == 1);
+
+    std::vector<int> dataRead(data.size(), -1);
+    Dimensions sizeRead;
+    int32_t idRead = -1;
+    dataCollector->read(1, "fields/data", sizeRead, &(dataRead[0]));
+    dataCollector->readAttribute(1, "fields/data", "id", &idRead);
+    CPPUNIT_ASSERT(sizeRead == gridSize);
+    CPPUNIT_ASSERT(dataRead == data);
+    CPPUNIT_ASSERT(idRead == 1);
+    dataCollector->close();
+
+    // extract a single iteration and rechunk/recompress it
+    params.firstID = 1;
+    params.lastID = 1;
+    params.compression = 1;
+    params.chunkSize.set(16, 16, 16);
+    DCRepack::copyFile(HDF5_FILE "_0_0_0.h5", HDF5_REPACK_FILE "_0_0_0.h5", params);
+
+    dataCollector->open(HDF5_REPACK_FILE, fileCAttr);
+    CPPUNIT_ASSERT(dataCollector->getMaxID() == 1);
+
+    size_t num_ids = 0;
+    dataCollector->getEntryIDs(NULL, &num_ids);
+    CPPUNIT_ASSERT(num_ids == 1);
+
+    dataRead.assign(data.size(), -1);
+    dataCollector->read(1, "fields/data", sizeRead, &(dataRead[0]));
+    CPPUNIT_ASSERT(dataRead == data);
+    dataCollector->close();
+
+    CPPUNIT_ASSERT_THROW(DCRepack::copyFile("h5/missing_0_0_0.h5",
+            HDF5_REPACK_FILE "_0_0_0.h5", params), DCException);
+}
+
+void RemoveTest::testTrackFreeSpace()
+{
+    Dimensions gridSize(64, 32, 16);
+    std::vector<int> data(gridSize.getScalarSize(), 1);
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    fileCAttr.trackFreeSpace = true;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    for (int32_t id = 0; id < 4; ++id)
+        dataCollector->write(id, ctInt, 3, gridSize, "fields/data", &(data[0]));
+
+    dataCollector->close();
+    const size_t size = getFileSize(HDF5_FILE "_0_0_0.h5");
+
+    const int32_t ids[] = {2, 3};
+    fileCAttr.fileAccType = DataCollector::FAT_WRITE;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dynamic_cast<SerialDataCollector*> (dataCollector)->removeIDs(ids, 2);
+    dataCollector->close();
+
+    // rewriting the removed iterations reuses their space
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    for (int32_t id = 2; id < 4; ++id)
+        dataCollector->write(id, ctInt, 3, gridSize, "fields/data", &(data[0]));
+
+    dataCollector->close();
+    CPPUNIT_ASSERT(getFileSize(HDF5_FILE "_0_0_0.h5") < size * 5 / 4);
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    CPPUNIT_ASSERT(dataCollector->getMaxID() == 3);
+
+    std::vector<int> dataRead(data.size(), -1);
+    Dimensions sizeRead;
+    dataCollector->read(3, "fields/data", sizeRead, &(dataRead[0]));
+    CPPUNIT_ASSERT(dataRead == data);
+    dataCollector->close();
+
+    // repacked files keep tracking free space
+    DCRepack::Parameters params;
+    DCRepack::initParameters(params);
+    params.trackFreeSpace = true;
+    DCRepack::copyFile(HDF5_FILE "_0_0_0.h5", HDF5_REPACK_FILE "_0_0_0.h5", params);
+
+    hid_t file = H5Fopen(HDF5_REPACK_FILE "_0_0_0.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+    CPPUNIT_ASSERT(file >= 0);
+    hid_t fcpl = H5Fget_create_plist(file);
+    H5F_fspace_strategy_t strategy;
+    hbool_t persist = false;
+    hsize_t threshold = 0;
+    CPPUNIT_ASSERT(H5Pget_file_space_strategy(fcpl, &strategy, &persist, &threshold) >= 0);
+    CPPUNIT_ASSERT(persist);
+    H5Pclose(fcpl);
+    H5Fclose(file);
+}
+
+void RemoveTest::testVerify()
+{
+    Dimensions gridSize(32, 16, 8);
+    std::vector<int> data(gridSize.getScalarSize());
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = i;
+
+    const Domain domain(Dimensions(0, 0, 0), gridSize);
+    const Domain halfDomain(Dimensions(0, 0, 0), Dimensions(32, 16, 4));
+    ColTypeUInt32 ctUInt32;
+
+    DomainCollector domainCollector(10);
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    fileCAttr.enableCompression = true;
+    domainCollector.open(HDF5_FILE, fileCAttr);
+
+    const char *names[] = {"fields/good", "fields/checksum", "fields/extent", "fields/chunk"};
+    for (size_t i = 0; i < 4; ++i)
+    {
+        domainCollector.writeDomain(0, ctInt, 3, Selection(gridSize), names[i],
+                (i == 2) ? halfDomain : domain, domain,
+                IDomainCollector::GridType, &(data[0]));
+    }
+
+    // the checksum covers all elements in the file datatype
+    uint32_t checksum = DCVerifier::updateChecksum(0, &(data[0]),
+            data.size() * sizeof (int), 4);
+    domainCollector.writeAttribute(0, ctUInt32, "fields/good", SDC_ATTR_CHECKSUM, &checksum);
+    checksum++;
+    domainCollector.writeAttribute(0, ctUInt32, "fields/checksum", SDC_ATTR_CHECKSUM, &checksum);
+    domainCollector.close();
+
+#if (DC_DIRECT_CHUNK_IO==1)
+    // replace a compressed chunk by garbage
+    hid_t file = H5Fopen(HDF5_FILE "_0_0_0.h5", H5F_ACC_RDWR, H5P_DEFAULT);
+    hid_t dataset = H5Dopen2(file, "/data/0/fields/chunk", H5P_DEFAULT);
+    CPPUNIT_ASSERT(dataset >= 0);
+    const hsize_t offset[] = {0, 0, 0};
+    std::vector<char> garbage(64, 'x');
+    CPPUNIT_ASSERT(H5Dwrite_chunk(dataset, H5P_DEFAULT, 0, offset,
+            garbage.size(), &(garbage[0])) >= 0);
+    H5Dclose(dataset);
+    H5Fclose(file);
+#endif
+
+    DCVerifier::Parameters params;
+    DCVerifier::initParameters(params);
+    params.numThreads = 4;
+
+    std::vector<DCVerifier::Problem> problems;
+    CPPUNIT_ASSERT(!DCVerifier::verifyFile(HDF5_FILE "_0_0_0.h5", params, problems));
+
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < problems.size(); ++i)
+        paths.push_back(problems[i].path);
+
+    std::vector<std::string> expected;
+    expected.push_back("/data/0/fields/checksum");
+#if (DC_DIRECT_CHUNK_IO==1)
+    expected.push_back("/data/0/fields/chunk");
+#endif
+    expected.push_back("/data/0/fields/extent");
+    std::sort(paths.begin(), paths.end());
+    CPPUNIT_ASSERT(paths == expected);
+
+    // only the structure is verified without reading data
+    params.readData = false;
+    problems.clear();
+    CPPUNIT_ASSERT(!DCVerifier::verifyFile(HDF5_FILE "_0_0_0.h5", params, problems));
+    CPPUNIT_ASSERT(problems.size() == 1);
+    CPPUNIT_ASSERT(problems[0].path == "/data/0/fields/extent");
+
+    problems.clear();
+    CPPUNIT_ASSERT(!DCVerifier::verifyFile("h5/missing_0_0_0.h5", params, problems));
+    CPPUNIT_ASSERT(problems.size() == 1);
+}
@@ -25,8 +25,14 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <limits.h>
+#include <string.h>
+
+#include <fstream>
+#include <sstream>
+#include <vector>
 
 #include "SimpleDataTest.h"
+#include "splash/core/DCVerifier.hpp"
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SimpleDataTest);
 
@@ -284,3 +290,530 @@ void SimpleDataTest::testNullWrite()
     delete[] buffer;
 }
 
+void SimpleDataTest::testDirectChunks()
+{
+    Dimensions size(173, 91, 29);
+    uint32_t *data = new uint32_t[size.getScalarSize()];
+    uint32_t *buffer = new uint32_t[size.getScalarSize()];
+
+    for (size_t i = 0; i < size.getScalarSize(); ++i)
+        data[i] = i % 1000;
+
+    // write with direct chunk access or the filter pipeline and
+    // read with the respective other one
+    for (uint32_t threads = 0; threads <= 4; threads += 4)
+    {
+        DataCollector::FileCreationAttr fileCAttr;
+        DataCollector::initFileCreationAttr(fileCAttr);
+        fileCAttr.enableCompression = true;
+        fileCAttr.compressionThreads = threads;
+
+        dataCollector->resetStatistics();
+        dataCollector->open(HDF5_FILE, fileCAttr);
+        dataCollector->write(20, ctUInt32, 3, Selection(size), "chunks/grid", data);
+        dataCollector->write(20, ctUInt32, 1, Selection(Dimensions(1234, 1, 1)),
+                "chunks/line", data);
+        dataCollector->close();
+
+        // uncompressed bytes are counted with and without direct chunk access
+        const uint64_t bytes = (size.getScalarSize() + 1234) * sizeof (uint32_t);
+        CPPUNIT_ASSERT(dataCollector->getStatistics().getTotal(
+                IOStatistics::OP_WRITE).bytes == bytes);
+
+        fileCAttr.fileAccType = DataCollector::FAT_READ;
+        fileCAttr.compressionThreads = 4 - threads;
+        dataCollector->open(HDF5_FILE, fileCAttr);
+
+        Dimensions size_read(0, 0, 0);
+        memset(buffer, 0, sizeof (uint32_t) * size.getScalarSize());
+        dataCollector->read(20, "chunks/grid", size_read, buffer);
+
+        CPPUNIT_ASSERT(size_read == size);
+        for (size_t i = 0; i < size.getScalarSize(); ++i)
+            CPPUNIT_ASSERT(buffer[i] == data[i]);
+
+        memset(buffer, 0, sizeof (uint32_t) * size.getScalarSize());
+        dataCollector->read(20, "chunks/line", size_read, buffer);
+
+        CPPUNIT_ASSERT(size_read == Dimensions(1234, 1, 1));
+        for (size_t i = 0; i < 1234; ++i)
+            CPPUNIT_ASSERT(buffer[i] == data[i]);
+
+        dataCollector->close();
+
+        CPPUNIT_ASSERT(dataCollector->getStatistics().getTotal(
+                IOStatistics::OP_READ).bytes == bytes);
+    }
+
+    delete[] data;
+    delete[] buffer;
+}
+
+void SimpleDataTest::testPartialChunks()
+{
+    Dimensions size(256, 128, 16);
+    const uint32_t fill_value = 7;
+    std::vector<uint32_t> data(size.getScalarSize());
+    std::vector<uint32_t> buffer(size.getScalarSize());
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = i;
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    fileCAttr.enableCompression = true;
+
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(40, ctUInt32, 3, Selection(size), "partial/full", &(data[0]));
+    dataCollector->close();
+
+    // reserve a dataset with the same filters and write only some of its chunks
+    hid_t file = H5Fopen(HDF5_FILE "_0_0_0.h5", H5F_ACC_RDWR, H5P_DEFAULT);
+    hid_t dataset = H5Dopen2(file, "/data/40/partial/full", H5P_DEFAULT);
+    hid_t dcpl = H5Dget_create_plist(dataset);
+    hid_t dataspace = H5Dget_space(dataset);
+    H5Dclose(dataset);
+
+    const hsize_t chunk_dims[3] = {4, 32, 64};
+    const hsize_t written_offset[3] = {4, 0, 0};
+    const hsize_t written_count[3] = {4, 64, size[0]};
+    CPPUNIT_ASSERT(H5Pset_chunk(dcpl, 3, chunk_dims) >= 0);
+    CPPUNIT_ASSERT(H5Pset_fill_value(dcpl, H5T_NATIVE_UINT32, &fill_value) >= 0);
+
+    dataset = H5Dcreate2(file, "/data/40/partial/reserved", H5T_NATIVE_UINT32,
+            dataspace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    CPPUNIT_ASSERT(dataset >= 0);
+
+    hid_t mem_space = H5Screate_simple(3, written_count, NULL);
+    H5Sselect_hyperslab(dataspace, H5S_SELECT_SET, written_offset, NULL,
+            written_count, NULL);
+    CPPUNIT_ASSERT(H5Dwrite(dataset, H5T_NATIVE_UINT32, mem_space, dataspace,
+            H5P_DEFAULT, &(data[0])) >= 0);
+
+    H5Sclose(mem_space);
+    H5Sclose(dataspace);
+    H5Pclose(dcpl);
+    H5Dclose(dataset);
+    H5Fclose(file);
+
+    // unwritten chunks read as the fill value with and without threads
+    for (uint32_t threads = 0; threads <= 4; threads += 4)
+    {
+        fileCAttr.fileAccType = DataCollector::FAT_READ;
+        fileCAttr.compressionThreads = threads;
+        dataCollector->resetStatistics();
+        dataCollector->open(HDF5_FILE, fileCAttr);
+
+        Dimensions size_read;
+        memset(&(buffer[0]), 0xff, buffer.size() * sizeof (uint32_t));
+        dataCollector->read(40, "partial/reserved", size_read, &(buffer[0]));
+        CPPUNIT_ASSERT(size_read == size);
+        CPPUNIT_ASSERT(dataCollector->getStatistics().getTotal(
+                IOStatistics::OP_READ).bytes == size.getScalarSize() * sizeof (uint32_t));
+
+        size_t index = 0;
+        for (hsize_t z = 0; z < size[2]; ++z)
+            for (hsize_t y = 0; y < size[1]; ++y)
+                for (hsize_t x = 0; x < size[0]; ++x)
+                {
+                    const bool written = (z >= written_offset[0]) &&
+                            (z < written_offset[0] + written_count[0]) &&
+                            (y < written_count[1]);
+                    const size_t src_index = ((z - written_offset[0]) *
+                            written_count[1] + y) * written_count[2] + x;
+
+                    if (written)
+                        CPPUNIT_ASSERT(buffer[index] == data[src_index]);
+                    else
+                        CPPUNIT_ASSERT(buffer[index] == fill_value);
+                    index++;
+                }
+
+        dataCollector->close();
+    }
+}
+
+void SimpleDataTest::testHighDimensions()
+{
+    const hsize_t size_values[] = {7, 3, 5, 2, 4};
+    const hsize_t buffer_values[] = {9, 3, 6, 2, 5};
+    const hsize_t offset_values[] = {2, 0, 1, 0, 1};
+    Dimensions size(5, size_values);
+    Dimensions dst_buffer(5, buffer_values);
+    Dimensions dst_offset(5, offset_values);
+
+    uint32_t *data = new uint32_t[size.getScalarSize()];
+    uint32_t *buffer = new uint32_t[dst_buffer.getScalarSize()];
+
+    for (size_t i = 0; i < size.getScalarSize(); ++i)
+        data[i] = i;
+
+    for (uint32_t compression = 0; compression < 2; ++compression)
+    {
+        DataCollector::FileCreationAttr fileCAttr;
+        DataCollector::initFileCreationAttr(fileCAttr);
+        fileCAttr.enableCompression = (compression == 1);
+        fileCAttr.compressionThreads = 2;
+
+        dataCollector->open(HDF5_FILE, fileCAttr);
+        dataCollector->write(30, ctUInt32, 5, Selection(size), "highdim/data", data);
+        dataCollector->close();
+
+        fileCAttr.fileAccType = DataCollector::FAT_READ;
+        dataCollector->open(HDF5_FILE, fileCAttr);
+
+        Dimensions size_read;
+        memset(buffer, 0, sizeof (uint32_t) * dst_buffer.getScalarSize());
+        dataCollector->read(30, "highdim/data", size_read, buffer);
+
+        CPPUNIT_ASSERT(size_read.getRank() == 5);
+        CPPUNIT_ASSERT(size_read == size);
+        for (size_t i = 0; i < size.getScalarSize(); ++i)
+            CPPUNIT_ASSERT(buffer[i] == data[i]);
+
+        // read into an offset of a larger buffer
+        memset(buffer, 0, sizeof (uint32_t) * dst_buffer.getScalarSize());
+        dataCollector->read(30, "highdim/data", dst_buffer, dst_offset, size_read, buffer);
+
+        CPPUNIT_ASSERT(size_read == size);
+        size_t index = 0;
+        for (hsize_t v = 0; v < size[4]; ++v)
+            for (hsize_t w = 0; w < size[3]; ++w)
+                for (hsize_t z = 0; z < size[2]; ++z)
+                    for (hsize_t y = 0; y < size[1]; ++y)
+                        for (hsize_t x = 0; x < size[0]; ++x)
+                        {
+                            const size_t dst_index = ((((dst_offset[4] + v) *
+                                    dst_buffer[3] + dst_offset[3] + w) *
+                                    dst_buffer[2] + dst_offset[2] + z) *
+                                    dst_buffer[1] + dst_offset[1] + y) *
+                                    dst_buffer[0] + dst_offset[0] + x;
+                            CPPUNIT_ASSERT(buffer[dst_index] == data[index]);
+                            index++;
+                        }
+
+        dataCollector->close();
+    }
+
+    // swapping lower-rank Dimensions pads sizes with 1 and offsets with 0
+    Dimensions swapped_size(7, 3, 5);
+    swapped_size.swapDims(5);
+    CPPUNIT_ASSERT(swapped_size.getRank() == 5);
+    CPPUNIT_ASSERT(swapped_size.getScalarSize() == 7 * 3 * 5);
+    CPPUNIT_ASSERT(swapped_size[0] == 1 && swapped_size[2] == 5 && swapped_size[4] == 7);
+
+    Dimensions swapped_offset(2, 0, 1);
+    swapped_offset.swapDims(5, 0);
+    CPPUNIT_ASSERT(swapped_offset[0] == 0 && swapped_offset[1] == 0 &&
+            swapped_offset[2] == 1 && swapped_offset[4] == 2);
+
+    delete[] data;
+    delete[] buffer;
+}
+
+void SimpleDataTest::testStatistics()
+{
+    const Dimensions size(64, 32, 2);
+    const size_t elements = size.getScalarSize();
+
+    uint32_t *data = new uint32_t[elements];
+    for (size_t i = 0; i < elements; ++i)
+        data[i] = i;
+
+    dataCollector->resetStatistics();
+
+    DataCollector::FileCreationAttr attr;
+    DataCollector::initFileCreationAttr(attr);
+    dataCollector->open(HDF5_FILE, attr);
+
+    dataCollector->write(4, ctUInt32, 3, Selection(size), "stats/data", data);
+    dataCollector->write(5, ctUInt32, 3, Selection(size), "stats/data", data);
+    dataCollector->writeAttribute(4, ctUInt32, "stats/data", "attr", data);
+    dataCollector->append(6, ctUInt32, 10, "stats/list", data);
+    dataCollector->remove(5);
+    dataCollector->close();
+
+    // statistics are accumulated over several files
+    attr.fileAccType = DataCollector::FAT_READ;
+    attr.statisticsFile = "h5/testStatistics.json";
+    dataCollector->open(HDF5_FILE, attr);
+
+    Dimensions size_read;
+    dataCollector->read(4, "stats/data", size_read, data);
+    CPPUNIT_ASSERT(size_read == size);
+
+    // failed operations are counted as well
+    CPPUNIT_ASSERT_THROW(dataCollector->read(4, "stats/missing", size_read, data),
+            DCException);
+
+    const IOStatistics &stats = dataCollector->getStatistics();
+
+    const IOStatistics::Counters &writes = stats.getTotal(IOStatistics::OP_WRITE);
+    CPPUNIT_ASSERT(writes.calls == 2);
+    CPPUNIT_ASSERT(writes.bytes == 2 * elements * sizeof (uint32_t));
+    CPPUNIT_ASSERT(writes.h5Calls >= 2);
+    CPPUNIT_ASSERT(writes.time > 0.0);
+    CPPUNIT_ASSERT(writes.maxTime <= writes.time);
+
+    size_t histogram_calls = 0;
+    for (size_t i = 0; i < IOSTAT_HISTOGRAM_BINS; ++i)
+        histogram_calls += writes.timeHistogram[i];
+    CPPUNIT_ASSERT(histogram_calls == 2);
+    // 16 KiB are counted in the bin for [2^14, 2^15)
+    CPPUNIT_ASSERT(writes.sizeHistogram[15] == 2);
+
+    const IOStatistics::Counters &reads = stats.getTotal(IOStatistics::OP_READ);
+    CPPUNIT_ASSERT(reads.calls == 2);
+    CPPUNIT_ASSERT(reads.bytes == elements * sizeof (uint32_t));
+
+    CPPUNIT_ASSERT(stats.getTotal(IOStatistics::OP_ATTRIBUTE).calls == 1);
+    CPPUNIT_ASSERT(stats.getTotal(IOStatistics::OP_ATTRIBUTE).bytes == sizeof (uint32_t));
+    CPPUNIT_ASSERT(stats.getTotal(IOStatistics::OP_APPEND).calls == 1);
+    CPPUNIT_ASSERT(stats.getTotal(IOStatistics::OP_APPEND).bytes == 10 * sizeof (uint32_t));
+    CPPUNIT_ASSERT(stats.getTotal(IOStatistics::OP_GROUP).calls == 1);
+
+    // per iteration and dataset
+    const IOStatistics::EntryMap &entries = stats.getEntries();
+    CPPUNIT_ASSERT(entries.size() == 5);
+
+    IOStatistics::EntryMap::const_iterator entry =
+            entries.find(IOStatistics::Key(4, "stats/data"));
+    CPPUNIT_ASSERT(entry != entries.end());
+    CPPUNIT_ASSERT(entry->second.operations[IOStatistics::OP_WRITE].calls == 1);
+    CPPUNIT_ASSERT(entry->second.operations[IOStatistics::OP_READ].calls == 1);
+    CPPUNIT_ASSERT(entry->second.operations[IOStatistics::OP_ATTRIBUTE].calls == 1);
+    CPPUNIT_ASSERT(entries.find(IOStatistics::Key(5, "")) != entries.end());
+
+    std::stringstream json;
+    stats.writeJSON(json);
+
+    dataCollector->close();
+
+    // the statistics are written on close
+    std::ifstream file("h5/testStatistics.json");
+    std::stringstream file_json;
+    file_json << file.rdbuf();
+    CPPUNIT_ASSERT(file_json.str() == json.str());
+    CPPUNIT_ASSERT(json.str().find("\"name\": \"stats/list\"") != std::string::npos);
+    CPPUNIT_ASSERT(json.str().find("\"append\": {\"calls\": 1, \"bytes\": 40") != std::string::npos);
+
+    dataCollector->resetStatistics();
+    CPPUNIT_ASSERT(dataCollector->getStatistics().getTotal(IOStatistics::OP_WRITE).calls == 0);
+    CPPUNIT_ASSERT(dataCollector->getStatistics().getEntries().empty());
+
+    delete[] data;
+}
+
+void SimpleDataTest::testTracing()
+{
+    const Dimensions size(16, 8, 1);
+    uint32_t data[16 * 8];
+    for (size_t i = 0; i < size.getScalarSize(); ++i)
+        data[i] = i;
+
+    // disabled by default, events are not recorded
+    CPPUNIT_ASSERT(!Tracing::isEnabled());
+    {
+        Tracing::Scope trace("test", "disabled");
+    }
+    CPPUNIT_ASSERT(Tracing::getNumEvents() == 0);
+
+    remove("h5/testTracing_0.json");
+    Tracing::enable("h5/testTracing");
+
+    DataCollector::FileCreationAttr attr;
+    DataCollector::initFileCreationAttr(attr);
+    dataCollector->open(HDF5_FILE, attr);
+    dataCollector->write(1, ctUInt32, 2, Selection(size), "trace/data", data);
+
+    // file open, group creation, dataset creation and write, collector operation
+    CPPUNIT_ASSERT(Tracing::getNumEvents() >= 5);
+
+    std::stringstream buffered;
+    Tracing::writeChromeTrace(buffered);
+    CPPUNIT_ASSERT(buffered.str().find("\"name\": \"DCDataSet::write\", \"cat\": \"dataset\"") !=
+            std::string::npos);
+    CPPUNIT_ASSERT(buffered.str().find("\"args\": {\"detail\": \"trace/data\"}") !=
+            std::string::npos);
+
+    dataCollector->close();
+    CPPUNIT_ASSERT(Tracing::getNumEvents() == 0);
+
+    // events of the next file are appended
+    attr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, attr);
+    Dimensions size_read;
+    dataCollector->read(1, "trace/data", size_read, data);
+    dataCollector->close();
+
+    Tracing::disable();
+    CPPUNIT_ASSERT(!Tracing::isEnabled());
+
+    std::ifstream file("h5/testTracing_0.json");
+    std::stringstream trace;
+    trace << file.rdbuf();
+    const std::string events = trace.str();
+
+    // both flushes form a single terminated JSON array
+    CPPUNIT_ASSERT(events.compare(0, 2, "[\n") == 0);
+    CPPUNIT_ASSERT(events.size() > 4 && events.compare(events.size() - 4, 4, "}\n]\n") == 0);
+    CPPUNIT_ASSERT(events.find("]", 1) == events.size() - 2);
+    CPPUNIT_ASSERT(events.find(",\n,") == std::string::npos);
+    CPPUNIT_ASSERT(events.find("\"name\": \"HandleMgr::get\"") != std::string::npos);
+    CPPUNIT_ASSERT(events.find("\"name\": \"DCGroup::create\"") != std::string::npos);
+    CPPUNIT_ASSERT(events.find("\"name\": \"write\", \"cat\": \"collector\"") !=
+            std::string::npos);
+    CPPUNIT_ASSERT(events.find("\"name\": \"DCDataSet::read\"") != std::string::npos);
+    CPPUNIT_ASSERT(events.find("\"name\": \"HandleMgr::get\"") <
+            events.find("\"name\": \"DCDataSet::read\""));
+}
+
+void SimpleDataTest::testRecording()
+{
+    const Dimensions size(16, 8, 1);
+    uint32_t data[16 * 8];
+    for (size_t i = 0; i < size.getScalarSize(); ++i)
+        data[i] = i;
+
+    CPPUNIT_ASSERT(RecordingCollector::getTypeCode(ctUInt32) == "u4");
+    CPPUNIT_ASSERT(RecordingCollector::getTypeCode(ColTypeDouble()) == "f8");
+    CPPUNIT_ASSERT(RecordingCollector::getTypeCode(ColTypeInt8()) == "i1");
+    CPPUNIT_ASSERT(RecordingCollector::getTypeCode(ColTypeDim()) == "o24");
+
+    {
+        RecordingCollector recorder(dataCollector, "h5/testRecording.trace");
+
+        DataCollector::FileCreationAttr attr;
+        DataCollector::initFileCreationAttr(attr);
+        recorder.open(HDF5_FILE, attr);
+        recorder.write(1, ctUInt32, 2, Selection(size, Dimensions(8, 4, 1),
+                Dimensions(2, 2, 0)), "record/data", data);
+        recorder.close();
+
+        attr.fileAccType = DataCollector::FAT_READ;
+        recorder.open(HDF5_FILE, attr);
+
+        // calls are forwarded
+        Dimensions size_read;
+        recorder.read(1, "record/data", size_read, NULL);
+        CPPUNIT_ASSERT(size_read == Dimensions(8, 4, 1));
+
+        // failed calls are recorded
+        CPPUNIT_ASSERT_THROW(recorder.read(1, "record/missing", size_read, NULL),
+                DCException);
+        recorder.close();
+    }
+
+    std::ifstream file("h5/testRecording.trace");
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        // skip start time and duration
+        if (line[0] != '#')
+            line = line.substr(line.find("\t", line.find("\t") + 1) + 1);
+        lines.push_back(line);
+    }
+
+    CPPUNIT_ASSERT(lines.size() == 8);
+    CPPUNIT_ASSERT(lines[0] == "# libSplash workload trace 1");
+    CPPUNIT_ASSERT(lines[1] == "ok\topen\t0\t0,0,0\t1,1,1\t0\t0\t" HDF5_FILE);
+    CPPUNIT_ASSERT(lines[2] == "ok\twrite\t1\trecord/data\tu4\t2\t16,8,1\t8,4,1\t2,2,0\t1,1,1\th0");
+    CPPUNIT_ASSERT(lines[3] == "ok\tclose");
+    CPPUNIT_ASSERT(lines[4] == "ok\topen\t1\t0,0,0\t1,1,1\t0\t0\t" HDF5_FILE);
+    CPPUNIT_ASSERT(lines[5] == "ok\tread\t1\trecord/data\t0\t8,4,1");
+    CPPUNIT_ASSERT(lines[6] == "error\tread\t1\trecord/missing\t0");
+    CPPUNIT_ASSERT(lines[7] == "ok\tclose");
+}
+
+void SimpleDataTest::testChecksums()
+{
+    Dimensions size(64, 33, 7);
+    std::vector<uint32_t> data(size.getScalarSize());
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = i * 7;
+
+    DCVerifier::Parameters params;
+    DCVerifier::initParameters(params);
+
+    for (uint32_t threads = 0; threads <= 4; threads += 4)
+    {
+        DataCollector::FileCreationAttr fileCAttr;
+        DataCollector::initFileCreationAttr(fileCAttr);
+        fileCAttr.enableCompression = (threads > 0);
+        fileCAttr.compressionThreads = threads;
+        fileCAttr.checksums = true;
+
+        // dense and strided sources, appended data extends the checksum
+        dataCollector->open(HDF5_FILE, fileCAttr);
+        dataCollector->write(1, ctUInt32, 3, Selection(size), "checksums/grid", &(data[0]));
+        dataCollector->write(1, ctUInt32, 3, Selection(size, Dimensions(32, 16, 7),
+                Dimensions(1, 0, 0), Dimensions(2, 2, 1)), "checksums/strided", &(data[0]));
+        dataCollector->append(1, ctUInt32, 100, "checksums/line", &(data[0]));
+        dataCollector->append(1, ctUInt32, 50, 10, 3, "checksums/line", &(data[0]));
+        dataCollector->close();
+
+        std::vector<DCVerifier::Problem> problems;
+        CPPUNIT_ASSERT(DCVerifier::verifyFile(HDF5_FILE "_0_0_0.h5", params, problems));
+
+        hid_t file = H5Fopen(HDF5_FILE "_0_0_0.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+        CPPUNIT_ASSERT(H5Aexists_by_name(file, "/data/1/checksums/grid",
+                SDC_ATTR_CHECKSUM, H5P_DEFAULT) > 0);
+        CPPUNIT_ASSERT(H5Aexists_by_name(file, "/data/1/checksums/line",
+                SDC_ATTR_CHECKSUM, H5P_DEFAULT) > 0);
+        H5Fclose(file);
+
+        // corrupt the data without updating the checksum
+        file = H5Fopen(HDF5_FILE "_0_0_0.h5", H5F_ACC_RDWR, H5P_DEFAULT);
+        hid_t dataset = H5Dopen2(file, "/data/1/checksums/grid", H5P_DEFAULT);
+        std::vector<uint32_t> corrupted(data);
+        corrupted[100] ^= 1;
+        CPPUNIT_ASSERT(H5Dwrite(dataset, H5T_NATIVE_UINT32, H5S_ALL, H5S_ALL,
+                H5P_DEFAULT, &(corrupted[0])) >= 0);
+        H5Dclose(dataset);
+        H5Fclose(file);
+
+        problems.clear();
+        CPPUNIT_ASSERT(!DCVerifier::verifyFile(HDF5_FILE "_0_0_0.h5", params, problems));
+        CPPUNIT_ASSERT(problems.size() == 1);
+        CPPUNIT_ASSERT(problems[0].path == "/data/1/checksums/grid");
+
+        fileCAttr.fileAccType = DataCollector::FAT_READ;
+        dataCollector->open(HDF5_FILE, fileCAttr);
+
+        Dimensions size_read;
+        std::vector<uint32_t> buffer(data.size() * 2);
+        CPPUNIT_ASSERT_THROW(dataCollector->read(1, "checksums/grid", size_read,
+                &(buffer[0])), DCException);
+
+        // verified reads into a larger buffer
+        dataCollector->read(1, "checksums/strided", Dimensions(33, 16, 7),
+                Dimensions(1, 0, 0), size_read, &(buffer[0]));
+        CPPUNIT_ASSERT(size_read == Dimensions(32, 16, 7));
+        CPPUNIT_ASSERT(buffer[1] == data[1]);
+        CPPUNIT_ASSERT(buffer[2] == data[3]);
+        CPPUNIT_ASSERT(buffer[34] == data[1 + 2 * size[0]]);
+
+        dataCollector->read(1, "checksums/line", size_read, &(buffer[0]));
+        CPPUNIT_ASSERT(size_read == Dimensions(150, 1, 1));
+        CPPUNIT_ASSERT(buffer[149] == data[10 + 49 * 3]);
+        dataCollector->close();
+
+        // verification is optional
+        fileCAttr.checksums = false;
+        dataCollector->open(HDF5_FILE, fileCAttr);
+        dataCollector->read(1, "checksums/grid", size_read, &(buffer[0]));
+        CPPUNIT_ASSERT(buffer[100] == corrupted[100]);
+        dataCollector->close();
+
+        // appending without checksums removes the stale checksum
+        fileCAttr.fileAccType = DataCollector::FAT_WRITE;
+        dataCollector->open(HDF5_FILE, fileCAttr);
+        dataCollector->append(1, ctUInt32, 10, "checksums/line", &(data[0]));
+        dataCollector->close();
+
+        file = H5Fopen(HDF5_FILE "_0_0_0.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+        CPPUNIT_ASSERT(H5Aexists_by_name(file, "/data/1/checksums/line",
+                SDC_ATTR_CHECKSUM, H5P_DEFAULT) == 0);
+        H5Fclose(file);
+    }
+}
@@ -0,0 +1,268 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "StorageTypesTest.h"
+
+#include <limits>
+#include <math.h>
+#include <string.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(StorageTypesTest);
+
+#define HDF5_FILE "h5/testStorageTypes"
+#define HDF5_FILE_FULL "h5/testStorageTypes_0_0_0.h5"
+
+using namespace splash;
+
+StorageTypesTest::StorageTypesTest()
+{
+    dataCollector = new SerialDataCollector(10);
+}
+
+StorageTypesTest::~StorageTypesTest()
+{
+    if (dataCollector != NULL)
+    {
+        delete dataCollector;
+        dataCollector = NULL;
+    }
+}
+
+size_t StorageTypesTest::getStoredTypeSize(const char *path)
+{
+    hid_t file = H5Fopen(HDF5_FILE_FULL, H5F_ACC_RDONLY, H5P_DEFAULT);
+    CPPUNIT_ASSERT(file >= 0);
+    hid_t dataset = H5Dopen(file, path, H5P_DEFAULT);
+    CPPUNIT_ASSERT(dataset >= 0);
+    hid_t datatype = H5Dget_type(dataset);
+    size_t size = H5Tget_size(datatype);
+
+    H5Tclose(datatype);
+    H5Dclose(dataset);
+    H5Fclose(file);
+    return size;
+}
+
+void StorageTypesTest::testFloat16()
+{
+    Dimensions size(67, 13, 5);
+    Dimensions dst_buffer(70, 15, 5);
+    Dimensions dst_offset(3, 2, 0);
+    float *data = new float[size.getScalarSize()];
+    float *buffer = new float[dst_buffer.getScalarSize()];
+
+    for (size_t i = 0; i < size.getScalarSize(); ++i)
+        data[i] = ((float) i - 2000.0f) * 0.37f;
+    // special values
+    data[0] = 0.0f;
+    data[1] = 1.0e-6f;
+    data[2] = 1.0e6f;
+    data[3] = -std::numeric_limits<float>::infinity();
+
+    ColTypeFloat16 ctFloat16;
+    CPPUNIT_ASSERT(ctFloat16.getSize() == sizeof (float));
+    CPPUNIT_ASSERT(ctFloat16.getStorageSize() == 2);
+
+    // copies own a separate storage datatype
+    {
+        ColTypeFloat16 copy(ctFloat16);
+        ColTypeFloat16 assigned;
+        assigned = copy;
+        CPPUNIT_ASSERT(copy.getStorageType() != ctFloat16.getStorageType());
+        CPPUNIT_ASSERT(assigned.getStorageSize() == 2);
+    }
+    CPPUNIT_ASSERT(H5Iis_valid(ctFloat16.getStorageType()) > 0);
+
+    for (uint32_t compression = 0; compression < 2; ++compression)
+    {
+        DataCollector::FileCreationAttr fileCAttr;
+        DataCollector::initFileCreationAttr(fileCAttr);
+        fileCAttr.enableCompression = (compression == 1);
+        fileCAttr.compressionThreads = 2;
+
+        dataCollector->open(HDF5_FILE, fileCAttr);
+        dataCollector->write(0, ctFloat16, 3, Selection(size), "half", data);
+        dataCollector->close();
+
+        CPPUNIT_ASSERT(getStoredTypeSize("/data/0/half") == 2);
+
+        fileCAttr.fileAccType = DataCollector::FAT_READ;
+        dataCollector->open(HDF5_FILE, fileCAttr);
+
+        Dimensions size_read;
+        for (size_t i = 0; i < dst_buffer.getScalarSize(); ++i)
+            buffer[i] = -1.0f;
+        dataCollector->read(0, "half", dst_buffer, dst_offset, size_read, buffer);
+        CPPUNIT_ASSERT(size_read == size);
+
+        size_t index = 0;
+        for (size_t z = 0; z < dst_buffer[2]; ++z)
+            for (size_t y = 0; y < dst_buffer[1]; ++y)
+                for (size_t x = 0; x < dst_buffer[0]; ++x)
+                {
+                    const float value = buffer[(z * dst_buffer[1] + y) * dst_buffer[0] + x];
+                    if (x < dst_offset[0] || y < dst_offset[1] || z < dst_offset[2])
+                    {
+                        // outside the selection, untouched
+                        CPPUNIT_ASSERT(value == -1.0f);
+                        continue;
+                    }
+
+                    const float expected = data[index++];
+                    if (index == 2)
+                        CPPUNIT_ASSERT(value > 0.0f && fabs(value - expected) < 1.0e-7f);
+                    else if (index == 3)
+                        CPPUNIT_ASSERT(value == std::numeric_limits<float>::infinity());
+                    else if (index == 4)
+                        CPPUNIT_ASSERT(value == -std::numeric_limits<float>::infinity());
+                    else
+                        CPPUNIT_ASSERT(fabs(value - expected) <= fabs(expected) / 2048.0f);
+                }
+
+        dataCollector->close();
+    }
+
+    delete[] data;
+    delete[] buffer;
+}
+
+void StorageTypesTest::testBFloat16()
+{
+    const size_t count = 1000;
+    double *data = new double[count * 2];
+    double *buffer = new double[count * 2];
+
+    for (size_t i = 0; i < count * 2; ++i)
+        data[i] = sin((double) i) * pow(10.0, (double) (i % 20) - 10.0);
+
+    ColTypeBFloat16 ctBFloat16(DCDT_FLOAT64);
+    CPPUNIT_ASSERT(ctBFloat16.getSize() == sizeof (double));
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    // write every second element
+    dataCollector->write(1, ctBFloat16, 1,
+            Selection(Dimensions(count * 2, 1, 1), Dimensions(count, 1, 1),
+            Dimensions(0, 0, 0), Dimensions(2, 1, 1)), "bf16", data);
+    dataCollector->append(1, ctBFloat16, count, 1, 2, "bf16_append", data);
+    dataCollector->append(1, ctBFloat16, count, 0, 2, "bf16_append", data);
+    dataCollector->close();
+
+    CPPUNIT_ASSERT(getStoredTypeSize("/data/1/bf16") == 2);
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    Dimensions size_read;
+    dataCollector->read(1, "bf16", size_read, buffer);
+    CPPUNIT_ASSERT(size_read == Dimensions(count, 1, 1));
+    for (size_t i = 0; i < count; ++i)
+        CPPUNIT_ASSERT(fabs(buffer[i] - data[i * 2]) <= fabs(data[i * 2]) / 256.0);
+
+    dataCollector->read(1, "bf16_append", size_read, buffer);
+    CPPUNIT_ASSERT(size_read == Dimensions(count * 2, 1, 1));
+    for (size_t i = 0; i < count; ++i)
+    {
+        CPPUNIT_ASSERT(fabs(buffer[i] - data[i * 2 + 1]) <= fabs(data[i * 2 + 1]) / 256.0);
+        CPPUNIT_ASSERT(fabs(buffer[count + i] - data[i * 2]) <= fabs(data[i * 2]) / 256.0);
+    }
+
+    dataCollector->close();
+
+    delete[] data;
+    delete[] buffer;
+}
+
+void StorageTypesTest::testFixedPoint()
+{
+    const size_t count = 100;
+    float data[count];
+    float buffer[count];
+
+    for (size_t i = 0; i < count; ++i)
+        data[i] = ((float) i - 50.0f) * 0.013f;
+    data[0] = 1.0e6f;
+    data[1] = -1.0e6f;
+    data[2] = std::numeric_limits<float>::quiet_NaN();
+
+    const double scale = 0.001;
+    ColTypeFixedPoint ctFixed(scale, 16);
+    CPPUNIT_ASSERT(ctFixed.getStorageSize() == 2);
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(2, ctFixed, 1, Selection(Dimensions(count, 1, 1)), "fixed", data);
+    dataCollector->close();
+
+    CPPUNIT_ASSERT(getStoredTypeSize("/data/2/fixed") == 2);
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    Dimensions size_read;
+    dataCollector->read(2, "fixed", size_read, buffer);
+    CPPUNIT_ASSERT(size_read == Dimensions(count, 1, 1));
+
+    // out of range values are clamped, NaN is stored as 0
+    CPPUNIT_ASSERT(fabs(buffer[0] - 32767 * scale) < 1.0e-5);
+    CPPUNIT_ASSERT(fabs(buffer[1] + 32768 * scale) < 1.0e-5);
+    CPPUNIT_ASSERT(buffer[2] == 0.0f);
+    for (size_t i = 3; i < count; ++i)
+        CPPUNIT_ASSERT(fabs(buffer[i] - data[i]) <= scale / 2.0 + 1.0e-6);
+
+    dataCollector->close();
+}
+
+void StorageTypesTest::testCustomFloat()
+{
+    const size_t count = 500;
+    float data[count];
+    float buffer[count];
+
+    for (size_t i = 0; i < count; ++i)
+        data[i] = ((float) i - 250.0f) * 123.456f;
+
+    ColTypeCustomFloat ctFloat24(7, 16);
+    CPPUNIT_ASSERT(ctFloat24.getStorageSize() == 3);
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(3, ctFloat24, 1, Selection(Dimensions(count, 1, 1)), "float24", data);
+    dataCollector->close();
+
+    CPPUNIT_ASSERT(getStoredTypeSize("/data/3/float24") == 3);
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    Dimensions size_read;
+    dataCollector->read(3, "float24", size_read, buffer);
+    CPPUNIT_ASSERT(size_read == Dimensions(count, 1, 1));
+    for (size_t i = 0; i < count; ++i)
+        CPPUNIT_ASSERT(fabs(buffer[i] - data[i]) <= fabs(data[i]) / 65536.0f);
+
+    dataCollector->close();
+}
@@ -26,6 +26,7 @@
 #include <time.h>
 #include <stdlib.h>
 #include <math.h>
+#include <vector>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(StridingTest);
 
@@ -188,3 +189,224 @@ void StridingTest::testStriding()
             }
 }
 
+void StridingTest::testHyperslabUnion()
+{
+    const Dimensions grid_size(10, 8, 4);
+    const Dimensions interior(8, 6, 2);
+    const Dimensions half(4, 6, 2);
+
+    int *data_write = new int[grid_size.getScalarSize()];
+    float *float_write = new float[grid_size.getScalarSize()];
+    for (size_t i = 0; i < grid_size.getScalarSize(); ++i)
+    {
+        data_write[i] = i;
+        float_write[i] = (float) i;
+    }
+
+    // interior without guard cells, as two halves
+    Selection select(grid_size);
+    select.addHyperslab(half, Dimensions(5, 1, 1));
+    select.addHyperslab(half, Dimensions(1, 1, 1));
+    CPPUNIT_ASSERT(select.isScattered());
+    CPPUNIT_ASSERT(select.count.getScalarSize() == interior.getScalarSize());
+    select.count = interior;
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ctInt, 3, select, "union", data_write);
+    dataCollector->write(0, ColTypeFloat16(), 3, select, "union_half", float_write);
+
+    // the number of selected elements must match count
+    select.count = Dimensions(3, 3, 3);
+    CPPUNIT_ASSERT_THROW(dataCollector->write(0, ctInt, 3, select, "invalid", data_write),
+            DCException);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    int *data_read = new int[interior.getScalarSize()];
+    float *float_read = new float[interior.getScalarSize()];
+    Dimensions size_read;
+    dataCollector->read(0, "union", size_read, data_read);
+    CPPUNIT_ASSERT(size_read == interior);
+    dataCollector->read(0, "union_half", size_read, float_read);
+    CPPUNIT_ASSERT(size_read == interior);
+    dataCollector->close();
+
+    // elements are written in row-major order of the source buffer
+    size_t index = 0;
+    for (size_t z = 1; z < grid_size[2] - 1; ++z)
+        for (size_t y = 1; y < grid_size[1] - 1; ++y)
+            for (size_t x = 1; x < grid_size[0] - 1; ++x)
+            {
+                const int expected = (z * grid_size[1] + y) * grid_size[0] + x;
+                CPPUNIT_ASSERT(data_read[index] == expected);
+                CPPUNIT_ASSERT(float_read[index] == (float) expected);
+                index++;
+            }
+
+    delete[] data_write;
+    delete[] float_write;
+    delete[] data_read;
+    delete[] float_read;
+}
+
+void StridingTest::testPoints()
+{
+    const size_t num_particles = 1000;
+    const Dimensions grid_size(6, 5, 4);
+
+    int *particles = new int[num_particles];
+    for (size_t i = 0; i < num_particles; ++i)
+        particles[i] = i * 3;
+
+    // every third particle, in reverse order
+    std::vector<hsize_t> indices;
+    for (size_t i = 0; i < num_particles; i += 3)
+        indices.push_back(num_particles - 1 - i);
+
+    Selection poly_select(Dimensions(num_particles, 1, 1));
+    poly_select.setPoints(&(indices[0]), indices.size(), 1);
+    CPPUNIT_ASSERT(poly_select.count == Dimensions(indices.size(), 1, 1));
+
+    // corners of the grid
+    int *grid = new int[grid_size.getScalarSize()];
+    for (size_t i = 0; i < grid_size.getScalarSize(); ++i)
+        grid[i] = i;
+
+    std::vector<hsize_t> corners;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        corners.push_back((i & 1) ? grid_size[0] - 1 : 0);
+        corners.push_back((i & 2) ? grid_size[1] - 1 : 0);
+        corners.push_back((i & 4) ? grid_size[2] - 1 : 0);
+    }
+
+    Selection grid_select(grid_size);
+    grid_select.setPoints(&(corners[0]), 8, 3);
+    grid_select.count = Dimensions(2, 2, 2);
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ctInt, 1, poly_select, "particles", particles);
+    dataCollector->write(0, ctInt, 3, grid_select, "corners", grid);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    Dimensions size_read;
+    int *particles_read = new int[indices.size()];
+    dataCollector->read(0, "particles", size_read, particles_read);
+    CPPUNIT_ASSERT(size_read[0] == indices.size());
+
+    int corners_read[8];
+    dataCollector->read(0, "corners", size_read, corners_read);
+    CPPUNIT_ASSERT(size_read == Dimensions(2, 2, 2));
+    dataCollector->close();
+
+    // points are written in the given order
+    for (size_t i = 0; i < indices.size(); ++i)
+        CPPUNIT_ASSERT(particles_read[i] == particles[indices[i]]);
+
+    for (size_t i = 0; i < 8; ++i)
+        CPPUNIT_ASSERT(corners_read[i] == (int) ((corners[i * 3 + 2] * grid_size[1] +
+                corners[i * 3 + 1]) * grid_size[0] + corners[i * 3]));
+
+    delete[] particles;
+    delete[] particles_read;
+    delete[] grid;
+}
+
+void StridingTest::testMask()
+{
+    const Dimensions grid_size(12, 7, 3);
+    const size_t elements = grid_size.getScalarSize();
+
+    int *data_write = new int[elements];
+    bool *mask = new bool[elements];
+    std::vector<int> expected;
+    for (size_t i = 0; i < elements; ++i)
+    {
+        data_write[i] = i;
+        mask[i] = (i % 5 != 0) && (i % 7 != 3);
+        if (mask[i])
+            expected.push_back(i);
+    }
+
+    Selection select(grid_size);
+    select.setMask(mask);
+    CPPUNIT_ASSERT(select.count == Dimensions(expected.size(), 1, 1));
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ctInt, 1, select, "masked", data_write);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    Dimensions size_read;
+    int *data_read = new int[expected.size()];
+    dataCollector->read(0, "masked", size_read, data_read);
+    CPPUNIT_ASSERT(size_read[0] == expected.size());
+    dataCollector->close();
+
+    for (size_t i = 0; i < expected.size(); ++i)
+        CPPUNIT_ASSERT(data_read[i] == expected[i]);
+
+    delete[] data_write;
+    delete[] mask;
+    delete[] data_read;
+}
+
+void StridingTest::testSparseMask()
+{
+    const Dimensions grid_size(128, 128, 32);
+    const size_t elements = grid_size.getScalarSize();
+
+    int *data_write = new int[elements];
+    bool *mask = new bool[elements];
+    std::vector<int> expected;
+
+    // pseudo-random mask with many short runs
+    uint32_t random = 12345;
+    for (size_t i = 0; i < elements; ++i)
+    {
+        random = random * 1103515245 + 12345;
+        data_write[i] = i;
+        mask[i] = ((random >> 16) % 4) == 0;
+        if (mask[i])
+            expected.push_back(i);
+    }
+
+    Selection select(grid_size);
+    select.setMask(mask);
+    CPPUNIT_ASSERT(select.count == Dimensions(expected.size(), 1, 1));
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ctInt, 1, select, "sparse", data_write);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    Dimensions size_read;
+    int *data_read = new int[expected.size()];
+    dataCollector->read(0, "sparse", size_read, data_read);
+    CPPUNIT_ASSERT(size_read[0] == expected.size());
+    dataCollector->close();
+
+    for (size_t i = 0; i < expected.size(); ++i)
+        CPPUNIT_ASSERT(data_read[i] == expected[i]);
+
+    delete[] data_write;
+    delete[] mask;
+    delete[] data_read;
+}
@@ -0,0 +1,501 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TypeConversionTest.h"
+
+#include <algorithm>
+#include <limits>
+#include <string.h>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TypeConversionTest);
+
+#define HDF5_FILE "h5/testTypeConversion"
+
+using namespace splash;
+
+/**
+ * Collection type for an arbitrary HDF5 datatype.
+ */
+class ColTypeH5 : public CollectionType
+{
+public:
+
+    ColTypeH5(hid_t h5Type)
+    {
+        this->type = H5Tcopy(h5Type);
+    }
+
+    ~ColTypeH5()
+    {
+        H5Tclose(this->type);
+    }
+
+    size_t getSize() const
+    {
+        return H5Tget_size(this->type);
+    }
+};
+
+TypeConversionTest::TypeConversionTest()
+{
+    dataCollector = new SerialDataCollector(10);
+}
+
+TypeConversionTest::~TypeConversionTest()
+{
+    if (dataCollector != NULL)
+    {
+        delete dataCollector;
+        dataCollector = NULL;
+    }
+}
+
+void TypeConversionTest::testIntegerFloat()
+{
+    Dimensions size(50, 20, 3);
+    Dimensions dst_buffer(52, 21, 3);
+    Dimensions dst_offset(2, 1, 0);
+    const size_t elements = size.getScalarSize();
+
+    int32_t *ints = new int32_t[elements];
+    double *doubles = new double[elements];
+    for (size_t i = 0; i < elements; ++i)
+    {
+        ints[i] = ((int32_t) i - 1000) * 4099;
+        doubles[i] = ((double) i - 1500.0) * 37.25;
+    }
+    doubles[0] = std::numeric_limits<double>::quiet_NaN();
+    doubles[1] = 1.0e20;
+    doubles[2] = -1.0e20;
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ColTypeInt32(), 3, Selection(size), "ints", ints);
+    dataCollector->write(0, ColTypeDouble(), 3, Selection(size), "doubles", doubles);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    // int32 as double, into an offset of a larger buffer
+    double *dbl_buffer = new double[dst_buffer.getScalarSize()];
+    for (size_t i = 0; i < dst_buffer.getScalarSize(); ++i)
+        dbl_buffer[i] = -1.0;
+
+    Dimensions size_read;
+    dataCollector->read(0, ColTypeDouble(), "ints", dst_buffer, dst_offset,
+            size_read, dbl_buffer);
+    CPPUNIT_ASSERT(size_read == size);
+
+    size_t index = 0;
+    for (size_t z = 0; z < dst_buffer[2]; ++z)
+        for (size_t y = 0; y < dst_buffer[1]; ++y)
+            for (size_t x = 0; x < dst_buffer[0]; ++x)
+            {
+                const double value = dbl_buffer[(z * dst_buffer[1] + y) * dst_buffer[0] + x];
+                if (x < dst_offset[0] || y < dst_offset[1] || z < dst_offset[2])
+                    CPPUNIT_ASSERT(value == -1.0);
+                else
+                    CPPUNIT_ASSERT(value == (double) ints[index++]);
+            }
+    CPPUNIT_ASSERT(index == elements);
+
+    // double as int16, clamped to the range of int16
+    int16_t *short_buffer = new int16_t[elements];
+    dataCollector->read(0, ColTypeInt16(), "doubles", Dimensions(0, 0, 0),
+            Dimensions(0, 0, 0), size_read, short_buffer);
+    CPPUNIT_ASSERT(size_read == size);
+
+    CPPUNIT_ASSERT(short_buffer[0] == 0);
+    CPPUNIT_ASSERT(short_buffer[1] == std::numeric_limits<int16_t>::max());
+    CPPUNIT_ASSERT(short_buffer[2] == std::numeric_limits<int16_t>::min());
+    for (size_t i = 3; i < elements; ++i)
+    {
+        double expected = std::max(std::min(doubles[i], 32767.0), -32768.0);
+        CPPUNIT_ASSERT(short_buffer[i] == (int16_t) expected);
+    }
+
+    // int32 as uint8
+    uint8_t *byte_buffer = new uint8_t[elements];
+    dataCollector->read(0, ColTypeUInt8(), "ints", Dimensions(0, 0, 0),
+            Dimensions(0, 0, 0), size_read, byte_buffer);
+    for (size_t i = 0; i < elements; ++i)
+    {
+        int32_t expected = std::max(std::min(ints[i], 255), 0);
+        CPPUNIT_ASSERT(byte_buffer[i] == expected);
+    }
+
+    // reading the size only
+    dataCollector->read(0, ColTypeFloat(), "ints", Dimensions(0, 0, 0),
+            Dimensions(0, 0, 0), size_read, NULL);
+    CPPUNIT_ASSERT(size_read == size);
+
+    dataCollector->close();
+
+    delete[] ints;
+    delete[] doubles;
+    delete[] dbl_buffer;
+    delete[] short_buffer;
+    delete[] byte_buffer;
+}
+
+void TypeConversionTest::testByteOrder()
+{
+    const size_t elements = 1000;
+    Dimensions size(elements, 1, 1);
+
+    int32_t *ints = new int32_t[elements];
+    int32_t *ints_be = new int32_t[elements];
+    double *doubles = new double[elements];
+    double *doubles_be = new double[elements];
+    for (size_t i = 0; i < elements; ++i)
+    {
+        ints[i] = ((int32_t) i - 500) * 1234567;
+        doubles[i] = ((double) i - 500.0) / 3.0;
+    }
+
+    // convert to big endian with HDF5
+    memcpy(ints_be, ints, elements * sizeof (int32_t));
+    memcpy(doubles_be, doubles, elements * sizeof (double));
+    CPPUNIT_ASSERT(H5Tconvert(H5T_NATIVE_INT32, H5T_STD_I32BE, elements,
+            ints_be, NULL, H5P_DEFAULT) >= 0);
+    CPPUNIT_ASSERT(H5Tconvert(H5T_NATIVE_DOUBLE, H5T_IEEE_F64BE, elements,
+            doubles_be, NULL, H5P_DEFAULT) >= 0);
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ColTypeH5(H5T_STD_I32BE), 1, Selection(size), "ints_be", ints_be);
+    dataCollector->write(0, ColTypeH5(H5T_IEEE_F64BE), 1, Selection(size), "doubles_be", doubles_be);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    Dimensions size_read;
+    int32_t *int_buffer = new int32_t[elements];
+    dataCollector->read(0, ColTypeInt32(), "ints_be", Dimensions(0, 0, 0),
+            Dimensions(0, 0, 0), size_read, int_buffer);
+    CPPUNIT_ASSERT(size_read == size);
+
+    double *dbl_buffer = new double[elements];
+    dataCollector->read(0, ColTypeDouble(), "doubles_be", Dimensions(0, 0, 0),
+            Dimensions(0, 0, 0), size_read, dbl_buffer);
+    CPPUNIT_ASSERT(size_read == size);
+
+    for (size_t i = 0; i < elements; ++i)
+    {
+        CPPUNIT_ASSERT(int_buffer[i] == ints[i]);
+        CPPUNIT_ASSERT(dbl_buffer[i] == doubles[i]);
+    }
+
+    // big endian int32 as native double
+    dataCollector->read(0, ColTypeDouble(), "ints_be", Dimensions(0, 0, 0),
+            Dimensions(0, 0, 0), size_read, dbl_buffer);
+    for (size_t i = 0; i < elements; ++i)
+        CPPUNIT_ASSERT(dbl_buffer[i] == (double) ints[i]);
+
+    dataCollector->close();
+
+    delete[] ints;
+    delete[] ints_be;
+    delete[] doubles;
+    delete[] doubles_be;
+    delete[] int_buffer;
+    delete[] dbl_buffer;
+}
+
+void TypeConversionTest::testCompound()
+{
+    Dimensions size(31, 17, 1);
+    const size_t elements = size.getScalarSize();
+
+    float *data = new float[elements * 3];
+    for (size_t i = 0; i < elements * 3; ++i)
+        data[i] = (float) i * 0.5f - 100.0f;
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ColTypeFloat3(), 2, Selection(size), "compound", data);
+    dataCollector->write(0, ColTypeFloat3Array(), 2, Selection(size), "array", data);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    // compound of float as compound of double
+    Dimensions size_read;
+    double *dbl_buffer = new double[elements * 3];
+    dataCollector->read(0, ColTypeDouble3(), "compound", Dimensions(0, 0, 0),
+            Dimensions(0, 0, 0), size_read, dbl_buffer);
+    CPPUNIT_ASSERT(size_read == size);
+    for (size_t i = 0; i < elements * 3; ++i)
+        CPPUNIT_ASSERT(dbl_buffer[i] == (double) data[i]);
+
+    // compound and array of float as planes of float (structure of arrays),
+    // into an offset of a larger buffer
+    Dimensions dst_buffer(size[0] + 1, size[1] + 2, 1);
+    Dimensions dst_offset(1, 2, 0);
+    const size_t plane_size = dst_buffer.getScalarSize();
+    float *planes = new float[plane_size * 3];
+
+    const char *names[] = {"compound", "array"};
+    for (size_t n = 0; n < 2; ++n)
+    {
+        for (size_t i = 0; i < plane_size * 3; ++i)
+            planes[i] = -1.0f;
+
+        dataCollector->read(0, ColTypeFloat(), names[n], dst_buffer, dst_offset,
+                size_read, planes);
+        CPPUNIT_ASSERT(size_read == size);
+
+        for (size_t plane = 0; plane < 3; ++plane)
+        {
+            size_t index = 0;
+            for (size_t y = 0; y < dst_buffer[1]; ++y)
+                for (size_t x = 0; x < dst_buffer[0]; ++x)
+                {
+                    const float value = planes[plane * plane_size + y * dst_buffer[0] + x];
+                    if (x < dst_offset[0] || y < dst_offset[1])
+                        CPPUNIT_ASSERT(value == -1.0f);
+                    else
+                        CPPUNIT_ASSERT(value == data[(index++) * 3 + plane]);
+                }
+            CPPUNIT_ASSERT(index == elements);
+        }
+    }
+
+    // array of float as array of int
+    int *int_buffer = new int[elements * 3];
+    dataCollector->read(0, ColTypeInt3Array(), "array", Dimensions(0, 0, 0),
+            Dimensions(0, 0, 0), size_read, int_buffer);
+    for (size_t i = 0; i < elements * 3; ++i)
+        CPPUNIT_ASSERT(int_buffer[i] == (int) data[i]);
+
+    dataCollector->close();
+
+    delete[] data;
+    delete[] dbl_buffer;
+    delete[] planes;
+    delete[] int_buffer;
+}
+
+void TypeConversionTest::testFallback()
+{
+    const size_t elements = 100;
+    Dimensions size(elements, 1, 1);
+
+    double *data = new double[elements];
+    float *floats = new float[elements];
+    for (size_t i = 0; i < elements; ++i)
+    {
+        data[i] = (double) i * 0.25;
+        floats[i] = (float) data[i];
+    }
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ColTypeDouble(), 1, Selection(size), "doubles", data);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    // long double is converted by HDF5
+    Dimensions size_read;
+    long double *buffer = new long double[elements];
+    dataCollector->read(0, ColTypeH5(H5T_NATIVE_LDOUBLE), "doubles", Dimensions(0, 0, 0),
+            Dimensions(0, 0, 0), size_read, buffer);
+    CPPUNIT_ASSERT(size_read == size);
+    for (size_t i = 0; i < elements; ++i)
+        CPPUNIT_ASSERT(buffer[i] == (long double) data[i]);
+
+    // conversions of storage types must be supported by libSplash
+    dataCollector->close();
+    fileCAttr.fileAccType = DataCollector::FAT_CREATE;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->write(0, ColTypeFloat16(), 1, Selection(size), "half", floats);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    CPPUNIT_ASSERT_THROW(dataCollector->read(0, ColTypeH5(H5T_NATIVE_LDOUBLE), "half",
+            Dimensions(0, 0, 0), Dimensions(0, 0, 0), size_read, buffer), DCException);
+    dataCollector->close();
+
+    delete[] data;
+    delete[] floats;
+    delete[] buffer;
+}
+
+void TypeConversionTest::testComponents()
+{
+    const Dimensions buffer_size(20, 12, 6);
+    const Dimensions count(8, 5, 3);
+    const Dimensions offset(1, 2, 0);
+    const Dimensions stride(2, 2, 2);
+    const size_t buffer_elements = buffer_size.getScalarSize();
+    const size_t elements = count.getScalarSize();
+
+    float *components[3];
+    for (size_t c = 0; c < 3; ++c)
+    {
+        components[c] = new float[buffer_elements];
+        for (size_t i = 0; i < buffer_elements; ++i)
+            components[c][i] = (float) (c * buffer_elements + i);
+    }
+
+    // expected values in the order of the selection
+    std::vector<size_t> selected;
+    for (size_t z = 0; z < count[2]; ++z)
+        for (size_t y = 0; y < count[1]; ++y)
+            for (size_t x = 0; x < count[0]; ++x)
+                selected.push_back(((offset[2] + z * stride[2]) * buffer_size[1] +
+                    offset[1] + y * stride[1]) * buffer_size[0] + offset[0] + x * stride[0]);
+
+    float *aos = new float[elements * 3];
+    const Dimensions dst_buffer(count[0] + 2, count[1], count[2] + 1);
+    const Dimensions dst_offset(2, 0, 1);
+    double *read_components[3];
+    for (size_t c = 0; c < 3; ++c)
+        read_components[c] = new double[dst_buffer.getScalarSize()];
+
+    for (uint32_t compression = 0; compression < 2; ++compression)
+    {
+        DataCollector::FileCreationAttr fileCAttr;
+        DataCollector::initFileCreationAttr(fileCAttr);
+        fileCAttr.enableCompression = (compression == 1);
+        fileCAttr.compressionThreads = 2;
+
+        dataCollector->open(HDF5_FILE, fileCAttr);
+        dataCollector->writeComponents(0, ColTypeFloat3(), 3,
+                Selection(buffer_size, count, offset, stride), "vectors",
+                (const void* const*) components);
+        dataCollector->writeComponents(0, ColTypeFloat3Array(), 3,
+                Selection(buffer_size, count, offset, stride), "arrays",
+                (const void* const*) components);
+
+        // atomic types have no components
+        CPPUNIT_ASSERT_THROW(dataCollector->writeComponents(0, ColTypeFloat(), 3,
+                Selection(buffer_size), "atomic", (const void* const*) components), DCException);
+        dataCollector->close();
+
+        fileCAttr.fileAccType = DataCollector::FAT_READ;
+        dataCollector->open(HDF5_FILE, fileCAttr);
+
+        const char *names[] = {"vectors", "arrays"};
+        for (size_t n = 0; n < 2; ++n)
+        {
+            // interleaved in the file
+            Dimensions size_read;
+            dataCollector->read(0, names[n], size_read, aos);
+            CPPUNIT_ASSERT(size_read == count);
+            for (size_t i = 0; i < elements; ++i)
+                for (size_t c = 0; c < 3; ++c)
+                    CPPUNIT_ASSERT(aos[i * 3 + c] == components[c][selected[i]]);
+
+            // separate buffers in memory
+            for (size_t c = 0; c < 3; ++c)
+                for (size_t i = 0; i < dst_buffer.getScalarSize(); ++i)
+                    read_components[c][i] = -1.0;
+
+            dataCollector->readComponents(0, ColTypeDouble(), names[n], dst_buffer,
+                    dst_offset, size_read, (void* const*) read_components);
+            CPPUNIT_ASSERT(size_read == count);
+
+            for (size_t c = 0; c < 3; ++c)
+            {
+                size_t index = 0;
+                for (size_t z = 0; z < dst_buffer[2]; ++z)
+                    for (size_t y = 0; y < dst_buffer[1]; ++y)
+                        for (size_t x = 0; x < dst_buffer[0]; ++x)
+                        {
+                            const double value = read_components[c][(z * dst_buffer[1] + y) *
+                                    dst_buffer[0] + x];
+                            if (x < dst_offset[0] || y < dst_offset[1] || z < dst_offset[2])
+                                CPPUNIT_ASSERT(value == -1.0);
+                            else
+                                CPPUNIT_ASSERT(value == (double) components[c][selected[index++]]);
+                        }
+                CPPUNIT_ASSERT(index == elements);
+            }
+        }
+
+        // component buffers must be atomic
+        Dimensions size_read;
+        CPPUNIT_ASSERT_THROW(dataCollector->readComponents(0, ColTypeDouble3(), "vectors",
+                Dimensions(0, 0, 0), Dimensions(0, 0, 0), size_read,
+                (void* const*) read_components), DCException);
+
+        dataCollector->close();
+    }
+
+    for (size_t c = 0; c < 3; ++c)
+    {
+        delete[] components[c];
+        delete[] read_components[c];
+    }
+    delete[] aos;
+}
+
+void TypeConversionTest::testComponentSlabs()
+{
+    // larger than a single slab
+    const size_t elements = 500000;
+    const Dimensions size(elements, 1, 1);
+
+    double *components[3];
+    for (size_t c = 0; c < 3; ++c)
+    {
+        components[c] = new double[elements];
+        for (size_t i = 0; i < elements; ++i)
+            components[c][i] = (double) i + c * 0.25;
+    }
+
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    dataCollector->open(HDF5_FILE, fileCAttr);
+    dataCollector->writeComponents(0, ColTypeDouble3Array(), 1, Selection(size),
+            "large", (const void* const*) components);
+    dataCollector->close();
+
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+    dataCollector->open(HDF5_FILE, fileCAttr);
+
+    Dimensions size_read;
+    double *aos = new double[elements * 3];
+    dataCollector->read(0, "large", size_read, aos);
+    CPPUNIT_ASSERT(size_read == size);
+    dataCollector->close();
+
+    for (size_t i = 0; i < elements; ++i)
+        for (size_t c = 0; c < 3; ++c)
+            CPPUNIT_ASSERT(aos[i * 3 + c] == components[c][i]);
+
+    for (size_t c = 0; c < 3; ++c)
+        delete[] components[c];
+    delete[] aos;
+}
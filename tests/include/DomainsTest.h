@@ -37,6 +37,8 @@ class DomainsTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST(testGridDomains);
     CPPUNIT_TEST(testPolyDomains);
     CPPUNIT_TEST(testAppendDomains);
+    CPPUNIT_TEST(testLegacyDomains);
+    CPPUNIT_TEST(testHighDimDomains);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -55,6 +57,17 @@ private:
             uint32_t iteration);
     
     void testAppendDomains();
+
+    /**
+     * Reads domains annotated with separate attributes and with the
+     * 3-dimensional compound attribute of older file formats.
+     */
+    void testLegacyDomains();
+
+    /**
+     * Reads a sub-domain of a 4-dimensional grid domain.
+     */
+    void testHighDimDomains();
     
     int totalMpiSize;
     int totalMpiRank;
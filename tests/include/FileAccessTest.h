@@ -35,6 +35,7 @@ class FileAccessTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST_SUITE(FileAccessTest);
 
     CPPUNIT_TEST(testWriteAfterCreate);
+    CPPUNIT_TEST(testInMemory);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -43,6 +44,12 @@ public:
     virtual ~FileAccessTest();
 private:
     void testWriteAfterCreate();
+
+    /**
+     * Creates files in memory, reads their file images and
+     * writes them to a backing store.
+     */
+    void testInMemory();
     
     ColTypeInt ctInt;
     DataCollector *dataCollector;
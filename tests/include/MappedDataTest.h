@@ -0,0 +1,68 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MAPPEDDATATEST_H
+#define	MAPPEDDATATEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "splash/splash.h"
+
+using namespace splash;
+
+class MappedDataTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(MappedDataTest);
+
+    CPPUNIT_TEST(testMapGrid);
+    CPPUNIT_TEST(testMapDomain);
+    CPPUNIT_TEST(testMapUnsupported);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    MappedDataTest();
+    virtual ~MappedDataTest();
+
+private:
+    /**
+     * Maps atomic and compound datasets with contiguous layout
+     * while writing and reading a file.
+     */
+    void testMapGrid();
+
+    /**
+     * Maps a dataset written by a DomainCollector.
+     */
+    void testMapDomain();
+
+    /**
+     * Tests datasets which cannot be mapped and empty datasets.
+     */
+    void testMapUnsupported();
+
+    SerialDataCollector *dataCollector;
+};
+
+#endif	/* MAPPEDDATATEST_H */
@@ -37,6 +37,7 @@ class Parallel_DomainsTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST(testGridDomains);
     CPPUNIT_TEST(testPolyDomains);
     CPPUNIT_TEST(testAppendDomains);
+    CPPUNIT_TEST(testReadDistributed);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -49,6 +50,7 @@ private:
     void testGridDomains();
     void testPolyDomains();
     void testAppendDomains();
+    void testReadDistributed();
     
     void subTestGridDomains(int32_t iteration,
             int currentMpiRank,
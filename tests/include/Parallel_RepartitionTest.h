@@ -0,0 +1,64 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#ifndef PARALLEL_REPARTITIONTEST_H
+#define	PARALLEL_REPARTITIONTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "splash/splash.h"
+
+using namespace splash;
+
+class Parallel_RepartitionTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(Parallel_RepartitionTest);
+
+    CPPUNIT_TEST(testRepartitionGrid);
+    CPPUNIT_TEST(testRepartitionPoly);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    Parallel_RepartitionTest();
+    virtual ~Parallel_RepartitionTest();
+
+private:
+    void testRepartitionGrid();
+    void testRepartitionPoly();
+
+    /**
+     * Writes files with the old topology (2, mpiSize, 1),
+     * each process writes two files.
+     */
+    void writeFiles();
+
+    int mpiRank;
+    int mpiSize;
+
+    ColTypeInt ctInt;
+    ColTypeFloat ctFloat;
+};
+
+#endif	/* PARALLEL_REPARTITIONTEST_H */
@@ -36,6 +36,10 @@ class Parallel_SimpleDataTest : public CPPUNIT_NS::TestFixture
 
     CPPUNIT_TEST(testWriteRead);
     CPPUNIT_TEST(testFill);
+    CPPUNIT_TEST(testDeclared);
+    CPPUNIT_TEST(testCompression);
+    CPPUNIT_TEST(testReserveAndAppend);
+    CPPUNIT_TEST(testComponents);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -53,6 +57,27 @@ private:
     
     void testFill();
 
+    /**
+     * Writes datasets which have been created collectively in advance.
+     */
+    void testDeclared();
+
+    /**
+     * Writes compressed data collectively and reads it again.
+     */
+    void testCompression();
+
+    /**
+     * Appends data of varying size per process several times.
+     */
+    void testReserveAndAppend();
+
+    /**
+     * Writes separate component buffers of varying size per process,
+     * resulting in a different number of slabs per process.
+     */
+    void testComponents();
+
     bool testData(const Dimensions mpiSize, const Dimensions gridSize,
             int *data);
 
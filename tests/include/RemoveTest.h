@@ -35,6 +35,10 @@ class RemoveTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST_SUITE(RemoveTest);
 
     CPPUNIT_TEST(testRemove);
+    CPPUNIT_TEST(testRemoveIDs);
+    CPPUNIT_TEST(testRepack);
+    CPPUNIT_TEST(testTrackFreeSpace);
+    CPPUNIT_TEST(testVerify);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -46,6 +50,27 @@ public:
 private:
     void testRemove();
 
+    /**
+     * Tests removing several iterations at once.
+     */
+    void testRemoveIDs();
+
+    /**
+     * Tests copying files with DCRepack after removing iterations.
+     */
+    void testRepack();
+
+    /**
+     * Tests reusing the space of removed iterations in files
+     * which track free space.
+     */
+    void testTrackFreeSpace();
+
+    /**
+     * Tests reporting damaged datasets with DCVerifier.
+     */
+    void testVerify();
+
     ColTypeInt ctInt;
     DataCollector *dataCollector;
 };
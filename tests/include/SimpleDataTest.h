@@ -36,6 +36,13 @@ class SimpleDataTest : public CPPUNIT_NS::TestFixture
 
     CPPUNIT_TEST(testWriteRead);
     CPPUNIT_TEST(testNullWrite);
+    CPPUNIT_TEST(testDirectChunks);
+    CPPUNIT_TEST(testPartialChunks);
+    CPPUNIT_TEST(testHighDimensions);
+    CPPUNIT_TEST(testStatistics);
+    CPPUNIT_TEST(testTracing);
+    CPPUNIT_TEST(testRecording);
+    CPPUNIT_TEST(testChecksums);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -56,6 +63,44 @@ private:
      */
     void testNullWrite();
 
+    /**
+     * Writes and reads compressed data using direct chunk access
+     * and the HDF5 filter pipeline interchangeably.
+     */
+    void testDirectChunks();
+
+    /**
+     * Reads a compressed dataset of which only some chunks have been
+     * written using direct chunk access and the HDF5 filter pipeline.
+     */
+    void testPartialChunks();
+
+    /**
+     * Writes and reads 5-dimensional data, with and without compression.
+     */
+    void testHighDimensions();
+
+    /**
+     * Tests the I/O statistics of writes, reads, attributes and
+     * group operations and their JSON output.
+     */
+    void testStatistics();
+
+    /**
+     * Tests that trace events are buffered and flushed on close.
+     */
+    void testTracing();
+
+    /**
+     * Tests that a RecordingCollector forwards all calls and records them.
+     */
+    void testRecording();
+
+    /**
+     * Tests storing dataset checksums on write and verifying them on read.
+     */
+    void testChecksums();
+
     /**
      * sub function for testWriteRead to allow several data/border sizes to be tested.
      */
@@ -0,0 +1,79 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef STORAGETYPESTEST_H
+#define	STORAGETYPESTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "splash/splash.h"
+
+using namespace splash;
+
+class StorageTypesTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(StorageTypesTest);
+
+    CPPUNIT_TEST(testFloat16);
+    CPPUNIT_TEST(testBFloat16);
+    CPPUNIT_TEST(testFixedPoint);
+    CPPUNIT_TEST(testCustomFloat);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    StorageTypesTest();
+    virtual ~StorageTypesTest();
+
+private:
+    /**
+     * Writes float data as half precision, with and without compression,
+     * and reads it back into an offset of a larger buffer.
+     */
+    void testFloat16();
+
+    /**
+     * Writes strided double data as bfloat16 and appends to it.
+     */
+    void testBFloat16();
+
+    /**
+     * Writes data as scaled integers, including values out of range.
+     */
+    void testFixedPoint();
+
+    /**
+     * Writes data as 24 bit floats.
+     */
+    void testCustomFloat();
+
+    /**
+     * Returns the size of the datatype of a dataset in the file.
+     */
+    size_t getStoredTypeSize(const char *path);
+
+    DataCollector *dataCollector;
+};
+
+#endif	/* STORAGETYPESTEST_H */
@@ -37,6 +37,10 @@ class StridingTest : public CPPUNIT_NS::TestFixture
     CPPUNIT_TEST_SUITE(StridingTest);
 
     CPPUNIT_TEST(testStriding);
+    CPPUNIT_TEST(testHyperslabUnion);
+    CPPUNIT_TEST(testPoints);
+    CPPUNIT_TEST(testMask);
+    CPPUNIT_TEST(testSparseMask);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -45,6 +49,26 @@ public:
     virtual ~StridingTest();
 private:
     void testStriding();
+
+    /**
+     * Writes the interior of a buffer with guard cells as a union of hyperslabs.
+     */
+    void testHyperslabUnion();
+
+    /**
+     * Writes Poly data selected by an index list and Grid data selected by points.
+     */
+    void testPoints();
+
+    /**
+     * Writes the elements of a buffer selected by a mask.
+     */
+    void testMask();
+
+    /**
+     * Writes the elements of a large buffer selected by a sparse mask.
+     */
+    void testSparseMask();
     
     bool subtestStriding(Dimensions gridSize, Dimensions striding, uint32_t dimensions);
     
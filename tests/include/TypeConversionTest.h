@@ -0,0 +1,89 @@
+/**
+ * Copyright 2014 Felix Schmitt
+ *
+ * This file is part of libSplash.
+ *
+ * libSplash is free software: you can redistribute it and/or modify
+ * it under the terms of of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * libSplash is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libSplash.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TYPECONVERSIONTEST_H
+#define	TYPECONVERSIONTEST_H
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdint.h>
+
+#include "splash/splash.h"
+
+using namespace splash;
+
+class TypeConversionTest : public CPPUNIT_NS::TestFixture
+{
+    CPPUNIT_TEST_SUITE(TypeConversionTest);
+
+    CPPUNIT_TEST(testIntegerFloat);
+    CPPUNIT_TEST(testByteOrder);
+    CPPUNIT_TEST(testCompound);
+    CPPUNIT_TEST(testFallback);
+    CPPUNIT_TEST(testComponents);
+    CPPUNIT_TEST(testComponentSlabs);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    TypeConversionTest();
+    virtual ~TypeConversionTest();
+
+private:
+    /**
+     * Reads integer data as floating point and vice versa,
+     * including values out of range.
+     */
+    void testIntegerFloat();
+
+    /**
+     * Reads big endian data as native data.
+     */
+    void testByteOrder();
+
+    /**
+     * Reads compound and array data as another compound type and
+     * as separate planes of an atomic type.
+     */
+    void testCompound();
+
+    /**
+     * Reads data with a memory type not supported by libSplash,
+     * which is converted by HDF5.
+     */
+    void testFallback();
+
+    /**
+     * Writes a strided selection of separate component buffers as
+     * compound data and reads it into separate buffers again.
+     */
+    void testComponents();
+
+    /**
+     * Writes components of a large dataset in several slabs.
+     */
+    void testComponentSlabs();
+
+    DataCollector *dataCollector;
+};
+
+#endif	/* TYPECONVERSIONTEST_H */
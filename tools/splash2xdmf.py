@@ -31,6 +31,7 @@ import argparse
 from xml.dom.minidom import Document
 
 SPLASH_CLASS_NAME = "_class"
+SPLASH_DOMAIN_NAME = "_domain"
 SPLASH_CLASS_TYPE_POLY = 10
 SPLASH_CLASS_TYPE_GRID = 20
 
@@ -380,6 +381,8 @@ def print_dataset(dset, level, h5filename):
     for attr in dset.attrs.keys():
         if attr == SPLASH_CLASS_NAME:
             eval_class_type(dset.attrs.get(attr), dset, level, h5filename)
+        if attr == SPLASH_DOMAIN_NAME:
+            eval_class_type(dset.attrs.get(attr)["class"], dset, level, h5filename)
     log("")
 
 
@@ -20,11 +20,21 @@
  */
 
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <vector>
+#include <map>
+#include <set>
+#include <queue>
+#include <algorithm>
+#include <functional>
 #include <math.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <limits.h>
 
 #define RESULT_OK 0
 #define RESULT_ERROR 1
@@ -34,6 +44,8 @@
 #endif
 
 #include "splash/splash.h"
+#include "splash/core/DCRepack.hpp"
+#include "splash/core/DCVerifier.hpp"
 
 using namespace splash;
 
@@ -45,12 +57,21 @@ typedef struct
     bool listEntries;
     bool parallelFile;
     bool verbose;
+    bool repack;
+    bool extractSteps;
+    bool trackFreeSpace;
+    bool xdmf;
+    bool xdmfUpdate;
     std::string filename;
+    std::string output;
     int32_t step;
+    int32_t lastStep;
+    int compression;
+    Dimensions chunkSize;
+    uint32_t numThreads;
     int mpiRank;
     int mpiSize;
-    int fileIndexStart;
-    int fileIndexEnd;
+    std::vector<int> fileIndices;
 } Options;
 
 int deleteFromStep(Options& options);
@@ -64,16 +85,31 @@ void initOptions(Options& options)
     options.deleteStep = false;
     options.listEntries = false;
     options.parallelFile = false;
-    options.fileIndexEnd = -1;
-    options.fileIndexStart = -1;
+    options.repack = false;
+    options.extractSteps = false;
+    options.trackFreeSpace = false;
+    options.xdmf = false;
+    options.xdmfUpdate = false;
+    options.fileIndices.clear();
     options.filename = "";
+    options.output = "";
     options.mpiRank = 0;
     options.mpiSize = 1;
     options.singleFile = false;
     options.step = 0;
+    options.lastStep = -1;
+    options.compression = -1;
+    options.chunkSize.set(0, 0, 0);
+    options.numThreads = 1;
     options.verbose = false;
 }
 
+bool isRewrite(const Options& options)
+{
+    return options.repack || options.trackFreeSpace || (options.compression >= 0) ||
+            (options.chunkSize.getScalarSize() > 0);
+}
+
 void deleteFromStepInFile(DataCollector *dc, int32_t step)
 {
     size_t num_entries = 0;
@@ -82,16 +118,28 @@ void deleteFromStepInFile(DataCollector *dc, int32_t step)
     int32_t *entries = new int32_t[num_entries];
     dc->getEntryIDs(entries, NULL);
 
+    std::vector<int32_t> ids;
     for (size_t i = 0; i < num_entries; ++i)
     {
         if (entries[i] >= step)
-        {
-            dc->remove(entries[i]);
-        }
+            ids.push_back(entries[i]);
     }
 
     delete[] entries;
     entries = NULL;
+
+    if (ids.empty())
+        return;
+
+    // remove all steps at once to determine the new maximum ID only once
+    SerialDataCollector *sdc = dynamic_cast<SerialDataCollector*> (dc);
+    if (sdc != NULL)
+        sdc->removeIDs(&(ids[0]), ids.size());
+    else
+    {
+        for (size_t i = 0; i < ids.size(); ++i)
+            dc->remove(ids[i]);
+    }
 }
 
 int parseCmdLine(int argc, char **argv, Options& options)
@@ -105,7 +153,16 @@ int parseCmdLine(int argc, char **argv, Options& options)
             " --file,-f\t<file>\t\t HDF5 libSplash file to edit" << std::endl <<
             " --delete,-d\t<step>\t\t Delete [d,*) simulation steps" << std::endl <<
             " --check,-c\t\t\t Check file integrity" << std::endl <<
+            " --threads\t<n>\t\t Threads per process for --check" << std::endl <<
             " --list,-l\t\t\t List all file entries" << std::endl <<
+            " --repack\t\t\t Rewrite files to reclaim unused space" << std::endl <<
+            " --recompress\t<level>\t\t Rewrite chunked datasets with deflate level (0 = none)" << std::endl <<
+            " --rechunk\t<x,y,z>\t\t Rewrite chunked datasets with chunk size" << std::endl <<
+            " --track-free-space\t\t Rewrite files to reuse the space of deleted datasets" << std::endl <<
+            " --extract-steps <f>[:<l>]\t Copy steps [f,l] to new files" << std::endl <<
+            " --xdmf\t\t\t Create XDMF descriptions of all domain datasets" << std::endl <<
+            " --xdmf-update\t\t\t Append new steps to existing XDMF descriptions" << std::endl <<
+            " --output,-o\t<file>\t\t Output file(s) for --extract-steps and --xdmf" << std::endl <<
 #if (SPLASH_SUPPORTED_PARALLEL==1)
             " --parallel,-p\t\t\t Input is parallel libSplash file" << std::endl <<
 #endif
@@ -151,6 +208,119 @@ int parseCmdLine(int argc, char **argv, Options& options)
             }
 
             options.step = atoi(next_option);
+            options.deleteStep = true;
+            i++;
+            continue;
+        }
+
+        // repack
+        if (strcmp(option, "--repack") == 0)
+        {
+            options.repack = true;
+            continue;
+        }
+
+        // track free space
+        if (strcmp(option, "--track-free-space") == 0)
+        {
+            options.trackFreeSpace = true;
+            continue;
+        }
+
+        // recompress
+        if (strcmp(option, "--recompress") == 0)
+        {
+            if (!has_next_option)
+            {
+                std::cerr << "Option recompress requires argument" << std::endl;
+                return RESULT_ERROR;
+            }
+
+            options.compression = atoi(next_option);
+            if (options.compression < 0 || options.compression > 9)
+            {
+                std::cerr << "Invalid deflate level " << next_option << std::endl;
+                return RESULT_ERROR;
+            }
+            i++;
+            continue;
+        }
+
+        // rechunk
+        if (strcmp(option, "--rechunk") == 0)
+        {
+            if (!has_next_option)
+            {
+                std::cerr << "Option rechunk requires argument" << std::endl;
+                return RESULT_ERROR;
+            }
+
+            hsize_t chunk_dims[DSP_DIM_MAX];
+            uint32_t ndims = 0;
+            std::stringstream chunk_stream(next_option);
+            std::string extent;
+            while (std::getline(chunk_stream, extent, ',') && ndims < DSP_DIM_MAX)
+                chunk_dims[ndims++] = strtoull(extent.c_str(), NULL, 10);
+
+            if (ndims == 0)
+            {
+                std::cerr << "Invalid chunk size " << next_option << std::endl;
+                return RESULT_ERROR;
+            }
+
+            options.chunkSize = Dimensions(ndims, chunk_dims);
+            if (options.chunkSize.getScalarSize() == 0)
+            {
+                std::cerr << "Invalid chunk size " << next_option << std::endl;
+                return RESULT_ERROR;
+            }
+            i++;
+            continue;
+        }
+
+        // extract steps
+        if (strcmp(option, "--extract-steps") == 0)
+        {
+            if (!has_next_option)
+            {
+                std::cerr << "Option extract-steps requires argument" << std::endl;
+                return RESULT_ERROR;
+            }
+
+            options.extractSteps = true;
+            options.step = atoi(next_option);
+            const char *last = strchr(next_option, ':');
+            if (last != NULL)
+                options.lastStep = atoi(last + 1);
+            i++;
+            continue;
+        }
+
+        // xdmf
+        if (strcmp(option, "--xdmf") == 0)
+        {
+            options.xdmf = true;
+            continue;
+        }
+
+        // xdmf update
+        if (strcmp(option, "--xdmf-update") == 0)
+        {
+            options.xdmf = true;
+            options.xdmfUpdate = true;
+            continue;
+        }
+
+        // output
+        if ((strcmp(option, "-o") == 0) || (strcmp(option, "--output") == 0))
+        {
+            if (!has_next_option)
+            {
+                std::cerr << "Option output requires argument" << std::endl;
+                return RESULT_ERROR;
+            }
+
+            options.output.assign(next_option);
             i++;
             continue;
         }
@@ -176,6 +346,20 @@ int parseCmdLine(int argc, char **argv, Options& options)
             continue;
         }
 
+        // threads
+        if (strcmp(option, "--threads") == 0)
+        {
+            if (!has_next_option)
+            {
+                std::cerr << "Option threads requires argument" << std::endl;
+                return RESULT_ERROR;
+            }
+
+            options.numThreads = std::max(atoi(next_option), 1);
+            i++;
+            continue;
+        }
+
         // list
         if ((strcmp(option, "-l") == 0) || (strcmp(option, "--list") == 0))
         {
@@ -204,6 +388,13 @@ int parseCmdLine(int argc, char **argv, Options& options)
         return RESULT_ERROR;
     }
 
+    if (options.extractSteps && options.output.size() == 0)
+    {
+        std::cerr << "Option extract-steps requires an output filename" << std::endl;
+        std::cerr << usage_stream.str() << std::endl;
+        return RESULT_ERROR;
+    }
+
     if (options.filename.find(".h5") != std::string::npos)
     {
         options.singleFile = true;
@@ -217,77 +408,75 @@ int parseCmdLine(int argc, char **argv, Options& options)
 
 int testIntegrity(Options &options, std::string filename)
 {
-    // test file integrity using h5check
-    char *command = NULL;
-    const char *h5CheckCmd = "h5check -v0";
-    const char *devNull = "> /dev/null";
-    char checkStr[256];
-    int status = 0;
-
-    int len = strlen(h5CheckCmd) + 1 + filename.length() + 1 + strlen(devNull);
-    command = new char[len + 1];
-    sprintf(command, "%s %s %s", h5CheckCmd, filename.c_str(), devNull);
+    DCVerifier::Parameters params;
+    DCVerifier::initParameters(params);
+    params.numThreads = options.numThreads;
 
-    FILE *file = popen(command, "r");
-    if (!file)
+    std::vector<DCVerifier::Problem> problems;
+    if (DCVerifier::verifyFile(filename, params, problems))
     {
-        std::cout << "[" << options.mpiRank << "] " <<
-                "failed to execute '" << command << "'" << std::endl;
-        delete[] command;
-        return RESULT_ERROR;
-    }
-
-    delete[] command;
-    while (fgets(checkStr, 256, file) != NULL)
-        printf("%s", checkStr);
-
-    status = pclose(file);
-    if (status == -1)
-    {
-        std::cout << "[" << options.mpiRank << "] " <<
-                "popen failed with status " << status << std::endl;
-        return RESULT_ERROR;
-    } else
-    {
-        if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+        if (options.verbose)
         {
             std::cout << "[" << options.mpiRank << "] " <<
-                    "h5check returned error (status " << status << ") for file '" <<
-                    filename << "'" << std::endl;
-            return RESULT_ERROR;
-        } else
-        {
-            if (options.verbose)
-            {
-                std::cout << "[" << options.mpiRank << "] " <<
-                        "file '" << filename << "' ok" << std::endl;
-            }
-            return RESULT_OK;
+                    "file '" << filename << "' ok" << std::endl;
         }
+        return RESULT_OK;
+    }
+
+    for (size_t i = 0; i < problems.size(); ++i)
+    {
+        std::cout << "[" << options.mpiRank << "] " << filename << ": " <<
+                problems[i].path << ": " << problems[i].message << std::endl;
     }
 
     return RESULT_ERROR;
 }
 
-void filesToProcesses(Options& options, int fileMPISize)
+void filesToProcesses(Options& options, const std::vector<std::string> &filenames)
 {
-    if (options.mpiSize >= fileMPISize)
+    const size_t num_files = filenames.size();
+    std::vector<uint64_t> sizes(num_files, 0);
+
+    // every process determines the sizes of a subset of all files
+    for (size_t i = options.mpiRank; i < num_files; i += options.mpiSize)
     {
-        // more or equal number of MPI processes than files
-        if (options.mpiRank < fileMPISize)
-        {
-            options.fileIndexStart = options.mpiRank;
-            options.fileIndexEnd = options.mpiRank;
-        }
-    } else
+        struct stat file_stat;
+        if (stat(filenames[i].c_str(), &file_stat) == 0)
+            sizes[i] = file_stat.st_size;
+    }
+
+#if (ENABLE_MPI==1)
+    if (num_files > 0)
+        MPI_Allreduce(MPI_IN_PLACE, &(sizes[0]), num_files, MPI_UNSIGNED_LONG_LONG,
+            MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+    // assign the largest remaining file to the process with the least work
+    std::vector<std::pair<uint64_t, int> > files;
+    for (size_t i = 0; i < num_files; ++i)
+        files.push_back(std::make_pair(sizes[i], -((int) i)));
+    std::sort(files.begin(), files.end(), std::greater<std::pair<uint64_t, int> >());
+
+    typedef std::pair<uint64_t, int> Load;
+    std::priority_queue<Load, std::vector<Load>, std::greater<Load> > loads;
+    for (int rank = 0; rank < options.mpiSize; ++rank)
+        loads.push(std::make_pair(0, rank));
+
+    options.fileIndices.clear();
+    for (size_t i = 0; i < num_files; ++i)
     {
-        // less MPI processes than files
-        int filesPerProcess = floor((float) fileMPISize / (float) (options.mpiSize));
-        options.fileIndexStart = options.mpiRank * filesPerProcess;
-        options.fileIndexEnd = (options.mpiRank + 1) * filesPerProcess - 1;
-        if (options.mpiRank == options.mpiSize - 1)
-            options.fileIndexEnd = fileMPISize - 1;
+        Load load = loads.top();
+        loads.pop();
+
+        if (load.second == options.mpiRank)
+            options.fileIndices.push_back(-files[i].second);
+
+        // empty files still require some work
+        load.first += files[i].first + 1;
+        loads.push(load);
     }
+
+    std::sort(options.fileIndices.begin(), options.fileIndices.end());
 }
 
 void indexToPos(int index, Dimensions mpiSize, Dimensions &mpiPos)
@@ -333,6 +522,56 @@ int detectFileMPISize(Options& options, Dimensions &fileMPISizeDim)
     return result;
 }
 
+int getRunFilenames(Options& options, std::vector<std::string> &filenames)
+{
+    int result = RESULT_OK;
+
+    // open master file to detect number of files
+    uint64_t fileMPISizeBuffer[3] = {0, 0, 0};
+    Dimensions fileMPISizeDim(0, 0, 0);
+    int fileMPISize = 0;
+
+    if (options.mpiRank == 0)
+    {
+        result = detectFileMPISize(options, fileMPISizeDim);
+
+        for (int i = 0; i < 3; ++i)
+            fileMPISizeBuffer[i] = fileMPISizeDim[i];
+    }
+
+#if (ENABLE_MPI==1)
+    MPI_Bcast(fileMPISizeBuffer, 3, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD);
+#endif
+
+    if (options.mpiRank != 0)
+        fileMPISizeDim.set(fileMPISizeBuffer[0], fileMPISizeBuffer[1], fileMPISizeBuffer[2]);
+
+    if (fileMPISizeDim.getScalarSize() == 0)
+        return RESULT_ERROR;
+
+    fileMPISize = fileMPISizeBuffer[0] * fileMPISizeBuffer[1] * fileMPISizeBuffer[2];
+
+    for (int i = 0; i < fileMPISize; ++i)
+    {
+        Dimensions mpi_pos(0, 0, 0);
+        // get mpi position from index
+        indexToPos(i, fileMPISizeDim, mpi_pos);
+
+        std::stringstream mpiFilename;
+#if (SPLASH_SUPPORTED_PARALLEL==1)
+        if (options.parallelFile)
+            mpiFilename << options.filename << "_" << i << ".h5";
+        else
+#endif
+            mpiFilename << options.filename << "_" << mpi_pos[0] << "_" <<
+                mpi_pos[1] << "_" << mpi_pos[2] << ".h5";
+
+        filenames.push_back(mpiFilename.str());
+    }
+
+    return result;
+}
+
 /* tool functions */
 
 int executeToolFunction(Options& options,
@@ -360,35 +599,15 @@ int executeToolFunction(Options& options,
         }
     } else
     {
-        // open master file to detect number of files
-        uint64_t fileMPISizeBuffer[3] = {0, 0, 0};
-        Dimensions fileMPISizeDim(0, 0, 0);
-        int fileMPISize = 0;
-
-        if (options.mpiRank == 0)
-        {
-            result = detectFileMPISize(options, fileMPISizeDim);
-
-            for (int i = 0; i < 3; ++i)
-                fileMPISizeBuffer[i] = fileMPISizeDim[i];
-        }
-
-#if (ENABLE_MPI==1)
-        MPI_Bcast(fileMPISizeBuffer, 3, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD);
-#endif
-
-        if (options.mpiRank != 0)
-            fileMPISizeDim.set(fileMPISizeBuffer[0], fileMPISizeBuffer[1], fileMPISizeBuffer[2]);
-
-        if (fileMPISizeDim.getScalarSize() == 0)
+        std::vector<std::string> filenames;
+        result = getRunFilenames(options, filenames);
+        if (filenames.empty())
             return RESULT_ERROR;
 
-        fileMPISize = fileMPISizeBuffer[0] * fileMPISizeBuffer[1] * fileMPISizeBuffer[2];
-
-        // get file index range for each process
-        filesToProcesses(options, fileMPISize);
+        // distribute files to processes by their size
+        filesToProcesses(options, filenames);
 
-        if (options.fileIndexStart == -1)
+        if (options.fileIndices.empty())
             return RESULT_OK;
 
 #if (SPLASH_SUPPORTED_PARALLEL==1)
@@ -399,24 +618,8 @@ int executeToolFunction(Options& options,
 #endif
             dc = new SerialDataCollector(1);
 
-        for (int i = options.fileIndexStart; i <= options.fileIndexEnd; ++i)
-        {
-            Dimensions mpi_pos(0, 0, 0);
-            // get mpi position from index
-            indexToPos(i, fileMPISizeDim, mpi_pos);
-
-            // delete steps in this file
-            std::stringstream mpiFilename;
-#if (SPLASH_SUPPORTED_PARALLEL==1)
-            if (options.parallelFile)
-                mpiFilename << options.filename << "_" << i << ".h5";
-            else
-#endif
-                mpiFilename << options.filename << "_" << mpi_pos[0] << "_" <<
-                    mpi_pos[1] << "_" << mpi_pos[2] << ".h5";
-
-            result |= toolFunc(options, dc, mpiFilename.str().c_str());
-        }
+        for (size_t i = 0; i < options.fileIndices.size(); ++i)
+            result |= toolFunc(options, dc, filenames[options.fileIndices[i]].c_str());
 
         delete dc;
         dc = NULL;
@@ -456,6 +659,88 @@ int deleteFromStep(Options& options, DataCollector *dc, const char *filename)
     return result;
 }
 
+uint64_t getFileSize(const std::string &filename)
+{
+    struct stat file_stat;
+    if (stat(filename.c_str(), &file_stat) != 0)
+        return 0;
+
+    return file_stat.st_size;
+}
+
+int copyFile(Options& options, const char *filename, const std::string &dstFilename,
+        const DCRepack::Parameters &params)
+{
+    try
+    {
+        DCRepack::copyFile(filename, dstFilename, params);
+    } catch (DCException e)
+    {
+        std::cerr << "[" << options.mpiRank << "] " <<
+                "Copying file " << filename << " failed!" << std::endl <<
+                e.what() << std::endl;
+        remove(dstFilename.c_str());
+        return RESULT_ERROR;
+    }
+
+    return RESULT_OK;
+}
+
+int rewriteFile(Options& options, DataCollector* /*dc*/, const char* filename)
+{
+    DCRepack::Parameters params;
+    DCRepack::initParameters(params);
+    params.compression = options.compression;
+    params.chunkSize = options.chunkSize;
+    params.trackFreeSpace = options.trackFreeSpace;
+
+    // the file is replaced after it has been copied successfully
+    const std::string tmp_filename = std::string(filename) + ".repack";
+    const uint64_t old_size = getFileSize(filename);
+    int result = copyFile(options, filename, tmp_filename, params);
+
+    if (result == RESULT_OK && rename(tmp_filename.c_str(), filename) != 0)
+    {
+        std::cerr << "[" << options.mpiRank << "] " <<
+                "Replacing file " << filename << " failed!" << std::endl;
+        remove(tmp_filename.c_str());
+        result = RESULT_ERROR;
+    }
+
+    if (result == RESULT_OK && options.verbose)
+    {
+        std::cout << "[" << options.mpiRank << "] Rewrote file " << filename <<
+                " (" << old_size << " -> " << getFileSize(filename) << " bytes)" << std::endl;
+    }
+
+    return result;
+}
+
+int extractStepsFromFile(Options& options, DataCollector* /*dc*/, const char* filename)
+{
+    DCRepack::Parameters params;
+    DCRepack::initParameters(params);
+    params.compression = options.compression;
+    params.chunkSize = options.chunkSize;
+    params.trackFreeSpace = options.trackFreeSpace;
+    params.firstID = options.step;
+    params.lastID = options.lastStep;
+
+    // the output replaces the common part of all filenames
+    std::string dst_filename = options.output;
+    if (!options.singleFile)
+        dst_filename += std::string(filename).substr(options.filename.size());
+
+    int result = copyFile(options, filename, dst_filename, params);
+    if (result == RESULT_OK && options.verbose)
+    {
+        std::cout << "[" << options.mpiRank << "] Extracted steps from file " <<
+                filename << " to " << dst_filename << std::endl;
+    }
+
+    return result;
+}
+
 int testFileIntegrity(Options& options, DataCollector* /*dc*/, const char* filename)
 {
     return testIntegrity(options, filename);
@@ -507,6 +792,561 @@ int listAvailableDatasets(Options& options, DataCollector *dc, const char* /*fil
     return RESULT_OK;
 }
 
+/* XDMF export */
+
+#define XDMF_HEADER "<?xml version=\"1.0\" ?>\n" \
+    "<!DOCTYPE Xdmf SYSTEM \"Xdmf.dtd\" []>\n" \
+    "<Xdmf Version=\"2.0\">\n" \
+    " <Domain>\n"
+#define XDMF_TRAILER "  </Grid>\n </Domain>\n</Xdmf>\n"
+#define XDMF_TIME_TAG "<Time Value=\""
+
+/**
+ * XDMF descriptions of all Grid and Poly datasets of one step in one file
+ */
+typedef struct
+{
+    int32_t id;
+    int32_t fileIndex;
+    std::string grids;
+    std::string polys;
+} XdmfStep;
+
+bool operator<(const XdmfStep &a, const XdmfStep &b)
+{
+    return (a.id < b.id) || ((a.id == b.id) && (a.fileIndex < b.fileIndex));
+}
+
+std::string escapeXml(const std::string &text)
+{
+    std::string result;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        switch (text[i])
+        {
+            case '&': result += "&amp;";
+                break;
+            case '<': result += "&lt;";
+                break;
+            case '>': result += "&gt;";
+                break;
+            case '"': result += "&quot;";
+                break;
+            default: result += text[i];
+        }
+    }
+
+    return result;
+}
+
+std::string getDirectory(const std::string &filename)
+{
+    const size_t pos = filename.rfind('/');
+    if (pos == std::string::npos)
+        return ".";
+
+    return filename.substr(0, pos);
+}
+
+std::string getXdmfBaseName(const Options &options)
+{
+    std::string base = options.output;
+    if (base.empty())
+    {
+        base = options.filename;
+        if (options.singleFile && base.rfind(".h5") == base.size() - 3)
+            base.erase(base.size() - 3);
+    }
+
+    if (base.size() > 4 && base.rfind(".xmf") == base.size() - 4)
+        base.erase(base.size() - 4);
+
+    return base;
+}
+
+/**
+ * Returns the HDF5 filename as referenced from the XDMF files,
+ * relative to the XDMF files if both are in the same directory.
+ */
+std::string getXdmfFileReference(const Options &options, const std::string &filename)
+{
+    if (getDirectory(filename) == getDirectory(getXdmfBaseName(options)))
+        return filename.substr(filename.rfind('/') + 1);
+
+    char full_path[PATH_MAX];
+    if (realpath(filename.c_str(), full_path) == NULL)
+        return filename;
+
+    return full_path;
+}
+
+bool getXdmfNumberType(DCDataType type, std::string &numberType, std::string &precision)
+{
+    switch (type)
+    {
+        case DCDT_FLOAT32: numberType = "Float";
+            precision = "4";
+            return true;
+        case DCDT_FLOAT64: numberType = "Float";
+            precision = "8";
+            return true;
+        case DCDT_INT32: numberType = "Int";
+            precision = "4";
+            return true;
+        case DCDT_INT64: numberType = "Int";
+            precision = "8";
+            return true;
+        case DCDT_UINT32: numberType = "UInt";
+            precision = "4";
+            return true;
+        case DCDT_UINT64: numberType = "UInt";
+            precision = "8";
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Formats the first ndims entries of dims in HDF5 (slowest varying first) order.
+ */
+std::string getXdmfDims(const Dimensions dims, uint32_t ndims)
+{
+    std::stringstream stream;
+    for (uint32_t i = ndims; i > 0; --i)
+    {
+        stream << dims[i - 1];
+        if (i > 1)
+            stream << " ";
+    }
+
+    return stream.str();
+}
+
+/**
+ * Creates the XDMF descriptions of all domain datasets of one step.
+ * Datasets with the same domain share a single uniform grid.
+ */
+void createXdmfStep(const Options &options, DomainCollector &dc,
+        const std::string &fileReference, XdmfStep &step)
+{
+    size_t num_entries = 0;
+    dc.getEntriesForID(step.id, NULL, &num_entries);
+    if (num_entries == 0)
+        return;
+
+    std::vector<DataCollector::DCEntry> entries(num_entries);
+    dc.getEntriesForID(step.id, &(entries[0]), NULL);
+
+    // uniform grids and their attributes, by topology and geometry
+    std::map<std::string, std::string> grids;
+    std::map<std::string, std::string> polys;
+
+    for (size_t i = 0; i < num_entries; ++i)
+    {
+        const char *name = entries[i].name.c_str();
+        DomainCollector::DomainInfo info;
+        std::string number_type, precision;
+
+        if (!dc.readDomainInfo(step.id, name, info))
+            continue;
+
+        if (!getXdmfNumberType(info.dataType, number_type, precision))
+        {
+            if (options.verbose)
+                std::cout << "[" << options.mpiRank << "] Skipping dataset " <<
+                    name << " with unsupported type" << std::endl;
+            continue;
+        }
+
+        std::stringstream attribute;
+        attribute << "     <Attribute Name=\"" << escapeXml(name) <<
+                "\" AttributeType=\"Scalar\" Center=\"Node\">\n" <<
+                "      <DataItem Dimensions=\"" << getXdmfDims(info.dataSize, info.ndims) <<
+                "\" NumberType=\"" << number_type << "\" Precision=\"" << precision <<
+                "\" Format=\"HDF\">" << escapeXml(fileReference) << ":" <<
+                SDC_GROUP_DATA << "/" << step.id << "/" << escapeXml(name) <<
+                "</DataItem>\n" <<
+                "     </Attribute>\n";
+
+        std::stringstream topology;
+        if (info.dataClass == IDomainCollector::GridType)
+        {
+            // XDMF has no 1D meshes
+            const uint32_t ndims = std::max(info.ndims, (uint32_t) 2);
+            const Dimensions origin = info.localDomain.getOffset() +
+                    info.globalDomain.getOffset();
+
+            topology << "     <Topology TopologyType=\"" << ndims <<
+                    "DCoRectMesh\" Dimensions=\"" << getXdmfDims(info.dataSize, ndims) <<
+                    "\"/>\n" <<
+                    "     <Geometry GeometryType=\"" <<
+                    (ndims == 3 ? "ORIGIN_DXDYDZ" : "ORIGIN_DXDY") << "\">\n" <<
+                    "      <DataItem Format=\"XML\" Dimensions=\"" << ndims << "\">" <<
+                    getXdmfDims(origin, ndims) << "</DataItem>\n" <<
+                    "      <DataItem Format=\"XML\" Dimensions=\"" << ndims << "\">" <<
+                    getXdmfDims(Dimensions(1, 1, 1), ndims) << "</DataItem>\n" <<
+                    "     </Geometry>\n";
+
+            grids[topology.str()] += attribute.str();
+        } else
+            if (info.dataClass == IDomainCollector::PolyType)
+        {
+            topology << "     <Topology TopologyType=\"Polyvertex\" NodesPerElement=\"" <<
+                    info.dataSize.getScalarSize() << "\"/>\n";
+
+            polys[topology.str()] += attribute.str();
+        }
+    }
+
+    const std::map<std::string, std::string> *collections[2] = {&grids, &polys};
+    std::string *results[2] = {&(step.grids), &(step.polys)};
+    const char *prefixes[2] = {"Grid", "Poly"};
+
+    for (size_t c = 0; c < 2; ++c)
+    {
+        size_t index = 0;
+        std::map<std::string, std::string>::const_iterator iter = collections[c]->begin();
+        for (; iter != collections[c]->end(); ++iter, ++index)
+        {
+            std::stringstream grid;
+            grid << "    <Grid Name=\"" << prefixes[c] << "_" << step.id << "_" <<
+                    step.fileIndex << "_" << index << "\" GridType=\"Uniform\">\n" <<
+                    iter->first << iter->second << "    </Grid>\n";
+            *(results[c]) += grid.str();
+        }
+    }
+}
+
+int createXdmfForFile(Options &options, const std::set<int32_t> &exportedIDs,
+        const std::string &filename, int32_t fileIndex, std::vector<XdmfStep> &steps)
+{
+    DomainCollector dc(1);
+    DataCollector::FileCreationAttr fileCAttr;
+    DataCollector::initFileCreationAttr(fileCAttr);
+    fileCAttr.fileAccType = DataCollector::FAT_READ;
+
+    try
+    {
+        dc.open(filename.c_str(), fileCAttr);
+
+        size_t num_ids = 0;
+        dc.getEntryIDs(NULL, &num_ids);
+        std::vector<int32_t> ids(num_ids);
+        if (num_ids > 0)
+            dc.getEntryIDs(&(ids[0]), NULL);
+
+        const std::string file_reference = getXdmfFileReference(options, filename);
+        for (size_t i = 0; i < num_ids; ++i)
+        {
+            if (exportedIDs.find(ids[i]) != exportedIDs.end())
+                continue;
+
+            XdmfStep step;
+            step.id = ids[i];
+            step.fileIndex = fileIndex;
+            createXdmfStep(options, dc, file_reference, step);
+            steps.push_back(step);
+        }
+
+        dc.close();
+    } catch (DCException e)
+    {
+        std::cerr << "[" << options.mpiRank << "] " <<
+                "Creating XDMF for file " << filename << " failed!" << std::endl <<
+                e.what() << std::endl;
+        return RESULT_ERROR;
+    }
+
+    if (options.verbose)
+        std::cout << "[" << options.mpiRank << "] Created XDMF for file " <<
+            filename << std::endl;
+
+    return RESULT_OK;
+}
+
+/**
+ * Reads the steps of an existing XDMF file created by splashtools.
+ *
+ * @return false if the file exists but has not been created by splashtools
+ */
+bool readXdmfFile(const std::string &filename, std::string &content, std::set<int32_t> &ids)
+{
+    content.clear();
+    std::ifstream file(filename.c_str());
+    if (!file.is_open())
+        return true;
+
+    std::stringstream stream;
+    stream << file.rdbuf();
+    content = stream.str();
+
+    const size_t trailer_size = strlen(XDMF_TRAILER);
+    if (content.size() < trailer_size ||
+            content.compare(content.size() - trailer_size, trailer_size, XDMF_TRAILER) != 0)
+        return false;
+
+    size_t pos = content.find(XDMF_TIME_TAG);
+    while (pos != std::string::npos)
+    {
+        pos += strlen(XDMF_TIME_TAG);
+        ids.insert(atoi(content.c_str() + pos));
+        pos = content.find(XDMF_TIME_TAG, pos);
+    }
+
+    return true;
+}
+
+/**
+ * Writes all steps of one data class as a temporal collection,
+ * appending to existing content.
+ */
+int writeXdmfFile(Options &options, const std::string &filename, std::string content,
+        const std::vector<XdmfStep> &steps, bool grids)
+{
+    if (content.empty())
+    {
+        content = XDMF_HEADER;
+        content += std::string("  <Grid Name=\"") + (grids ? "Grids" : "Polys") +
+                "\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+    } else
+        content.erase(content.size() - strlen(XDMF_TRAILER));
+
+    bool has_steps = false;
+    for (size_t i = 0; i < steps.size();)
+    {
+        // one spatial collection with the grids of all files per step
+        const int32_t id = steps[i].id;
+        std::stringstream step;
+        step << "   <Grid Name=\"" << (grids ? "Grids_" : "Polys_") << id <<
+                "\" GridType=\"Collection\" CollectionType=\"Spatial\">\n" <<
+                "    " << XDMF_TIME_TAG << id << "\"/>\n";
+
+        bool has_grids = false;
+        for (; i < steps.size() && steps[i].id == id; ++i)
+        {
+            const std::string &step_grids = grids ? steps[i].grids : steps[i].polys;
+            step << step_grids;
+            has_grids |= !step_grids.empty();
+        }
+
+        step << "   </Grid>\n";
+        if (has_grids)
+        {
+            content += step.str();
+            has_steps = true;
+        }
+    }
+
+    if (!has_steps)
+        return RESULT_OK;
+
+    content += XDMF_TRAILER;
+
+    // replace the file at once, the XDMF file may be in use by a viewer
+    const std::string tmp_filename = filename + ".tmp";
+    std::ofstream file(tmp_filename.c_str());
+    file << content;
+    file.close();
+
+    if (file.fail() || rename(tmp_filename.c_str(), filename.c_str()) != 0)
+    {
+        std::cerr << "[0] Writing XDMF file " << filename << " failed!" << std::endl;
+        remove(tmp_filename.c_str());
+        return RESULT_ERROR;
+    }
+
+    if (options.verbose)
+        std::cout << "[0] Wrote XDMF file " << filename << std::endl;
+
+    return RESULT_OK;
+}
+
+/**
+ * Returns all files of a parallel run, one file per step.
+ */
+int getIterationFilenames(Options &options, std::vector<std::string> &filenames,
+        std::vector<int32_t> &ids)
+{
+    const std::string dir_path = getDirectory(options.filename);
+    const std::string name = options.filename.substr(options.filename.rfind('/') + 1) + "_";
+
+    DIR *dirp = opendir(dir_path.c_str());
+    if (!dirp)
+    {
+        std::cerr << "[" << options.mpiRank << "] Failed to open directory " <<
+                dir_path << std::endl;
+        return RESULT_ERROR;
+    }
+
+    std::map<int32_t, std::string> files;
+    dirent *dp = NULL;
+    while ((dp = readdir(dirp)) != NULL)
+    {
+        const std::string fname(dp->d_name);
+        if (fname.size() <= name.size() + 3 || fname.compare(0, name.size(), name) != 0 ||
+                fname.rfind(".h5") != fname.size() - 3)
+            continue;
+
+        // extract id from filename (part between "prefix_" and ".h5")
+        const std::string id_str = fname.substr(name.size(), fname.size() - name.size() - 3);
+        char *end_ptr = NULL;
+        const int32_t id = strtol(id_str.c_str(), &end_ptr, 10);
+        if (end_ptr && *end_ptr == 0)
+            files[id] = dir_path + "/" + fname;
+    }
+    (void) closedir(dirp);
+
+    std::map<int32_t, std::string>::const_iterator iter = files.begin();
+    for (; iter != files.end(); ++iter)
+    {
+        ids.push_back(iter->first);
+        filenames.push_back(iter->second);
+    }
+
+    return RESULT_OK;
+}
+
+#if (ENABLE_MPI==1)
+/**
+ * Collects the steps of all processes on the first process.
+ */
+void gatherXdmfSteps(Options &options, std::vector<XdmfStep> &steps)
+{
+    std::stringstream stream;
+    for (size_t i = 0; i < steps.size(); ++i)
+    {
+        stream << steps[i].id << " " << steps[i].fileIndex << " " <<
+                steps[i].grids.size() << " " << steps[i].polys.size() << "\n" <<
+                steps[i].grids << steps[i].polys;
+    }
+
+    const std::string buffer = stream.str();
+    int size = buffer.size();
+    std::vector<int> sizes(options.mpiSize, 0);
+    MPI_Gather(&size, 1, MPI_INT, &(sizes[0]), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    std::vector<int> offsets(options.mpiSize, 0);
+    for (int i = 1; i < options.mpiSize; ++i)
+        offsets[i] = offsets[i - 1] + sizes[i - 1];
+
+    std::vector<char> all(offsets[options.mpiSize - 1] + sizes[options.mpiSize - 1] + 1);
+    MPI_Gatherv((void*) buffer.c_str(), size, MPI_CHAR, &(all[0]), &(sizes[0]),
+            &(offsets[0]), MPI_CHAR, 0, MPI_COMM_WORLD);
+
+    if (options.mpiRank != 0)
+        return;
+
+    steps.clear();
+    const char *pos = &(all[0]);
+    const char *end = pos + all.size() - 1;
+    while (pos < end)
+    {
+        XdmfStep step;
+        size_t grids_size = 0, polys_size = 0;
+        char *next = NULL;
+        step.id = strtol(pos, &next, 10);
+        step.fileIndex = strtol(next, &next, 10);
+        grids_size = strtoull(next, &next, 10);
+        polys_size = strtoull(next, &next, 10);
+        pos = next + 1;
+
+        step.grids.assign(pos, grids_size);
+        pos += grids_size;
+        step.polys.assign(pos, polys_size);
+        pos += polys_size;
+        steps.push_back(step);
+    }
+}
+#endif
+
+int createXdmf(Options &options)
+{
+    int result = RESULT_OK;
+    const std::string base_name = getXdmfBaseName(options);
+    const std::string filenames_xdmf[2] = {base_name + "_grid.xmf", base_name + "_poly.xmf"};
+    std::string contents[2];
+
+    // steps in existing XDMF files are not exported again
+    std::vector<int32_t> exported;
+    if (options.mpiRank == 0 && options.xdmfUpdate)
+    {
+        std::set<int32_t> ids;
+        for (size_t i = 0; i < 2; ++i)
+        {
+            if (!readXdmfFile(filenames_xdmf[i], contents[i], ids))
+            {
+                std::cerr << "[0] Cannot update " << filenames_xdmf[i] <<
+                        ", not created by splashtools" << std::endl;
+                result = RESULT_ERROR;
+            }
+        }
+
+        exported.assign(ids.begin(), ids.end());
+    }
+
+#if (ENABLE_MPI==1)
+    int header[2] = {result, (int) exported.size()};
+    MPI_Bcast(header, 2, MPI_INT, 0, MPI_COMM_WORLD);
+    result = header[0];
+    exported.resize(header[1]);
+    if (header[1] > 0)
+        MPI_Bcast(&(exported[0]), header[1], MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+
+    if (result != RESULT_OK)
+        return result;
+
+    const std::set<int32_t> exported_ids(exported.begin(), exported.end());
+
+    std::vector<std::string> filenames;
+    if (options.singleFile)
+        filenames.push_back(options.filename);
+    else
+        if (options.parallelFile)
+    {
+        // parallel runs write one file per step, existing steps are skipped
+        std::vector<std::string> all_filenames;
+        std::vector<int32_t> ids;
+        result = getIterationFilenames(options, all_filenames, ids);
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            if (exported_ids.find(ids[i]) == exported_ids.end())
+                filenames.push_back(all_filenames[i]);
+        }
+    } else
+        result = getRunFilenames(options, filenames);
+
+    if (result != RESULT_OK)
+        return result;
+
+    if (options.singleFile)
+    {
+        options.fileIndices.assign(options.mpiRank == 0 ? 1 : 0, 0);
+    } else
+        filesToProcesses(options, filenames);
+
+    std::vector<XdmfStep> steps;
+    for (size_t i = 0; i < options.fileIndices.size(); ++i)
+    {
+        const int32_t index = options.fileIndices[i];
+        result |= createXdmfForFile(options, exported_ids, filenames[index], index, steps);
+    }
+
+#if (ENABLE_MPI==1)
+    gatherXdmfSteps(options, steps);
+#endif
+
+    if (options.mpiRank == 0)
+    {
+        std::sort(steps.begin(), steps.end());
+        for (size_t i = 0; i < 2; ++i)
+            result |= writeXdmfFile(options, filenames_xdmf[i], contents[i], steps, i == 0);
+    }
+
+    return result;
+}
+
 /* main */
 
 int main(int argc, char **argv)
@@ -532,6 +1372,14 @@ int main(int argc, char **argv)
 
         if (options.listEntries)
             result = executeToolFunction(options, listAvailableDatasets);
+
+        if (options.xdmf)
+            result = createXdmf(options);
+
+        if (options.extractSteps)
+            result = executeToolFunction(options, extractStepsFromFile);
+        else if (isRewrite(options))
+            result = executeToolFunction(options, rewriteFile);
     }
 
 #if (ENABLE_MPI==1)